@@ -0,0 +1,357 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures throughput and end-to-end latency of provizio_dds publishers and subscribers, sweeping payload size,
+// reliability kind, transport and number of subscribers. Results are output as JSON.
+//
+// Usage: pub_sub_bench [--duration <seconds>] [--output <file.json>] [--quick]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fastrtps/xmlparser/XMLProfileManager.h>
+
+#include "provizio/dds/publisher.h"
+#include "provizio/dds/subscriber.h"
+
+#include <sensor_msgs/msg/PointCloud2PubSubTypes.h>
+#include <std_msgs/msg/StringPubSubTypes.h>
+
+namespace
+{
+    using clock_type = std::chrono::system_clock;
+
+    // Enough to record all latencies of a second of small samples, anything above is counted but not recorded
+    constexpr std::size_t max_recorded_latencies = 1000000;
+    constexpr std::chrono::seconds match_timeout{5};
+    constexpr std::chrono::milliseconds settle_time{500};
+
+    std::int64_t now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now().time_since_epoch()).count();
+    }
+
+    template <typename pub_sub_type> struct payload;
+
+    // The timestamp is the leading digits of the string, padded to the payload size
+    template <> struct payload<std_msgs::msg::StringPubSubType>
+    {
+        static constexpr const char *kind = "string";
+
+        static void make(std_msgs::msg::String &message, const std::size_t bytes)
+        {
+            message.data(std::string(std::max<std::size_t>(bytes, 24), 'x'));
+        }
+
+        static void stamp(std_msgs::msg::String &message, const std::int64_t timestamp_ns)
+        {
+            std::ostringstream stream;
+            stream << std::setw(20) << std::setfill('0') << timestamp_ns;
+            message.data().replace(0, 20, stream.str());
+        }
+
+        static std::int64_t stamp_of(const std_msgs::msg::String &message)
+        {
+            return std::strtoll(message.data().c_str(), nullptr, 10);
+        }
+    };
+
+    template <> struct payload<sensor_msgs::msg::PointCloud2PubSubType>
+    {
+        static constexpr const char *kind = "point_cloud2";
+        static constexpr std::uint32_t point_step = 16;
+
+        static void make(sensor_msgs::msg::PointCloud2 &message, const std::size_t bytes)
+        {
+            const auto points = static_cast<std::uint32_t>(bytes / point_step);
+            message.height(1);
+            message.width(points);
+            message.point_step(point_step);
+            message.row_step(points * point_step);
+            message.is_dense(true);
+            message.data().assign(static_cast<std::size_t>(points) * point_step, 0);
+        }
+
+        static void stamp(sensor_msgs::msg::PointCloud2 &message, const std::int64_t timestamp_ns)
+        {
+            message.header().stamp().sec(static_cast<std::int32_t>(timestamp_ns / 1000000000));
+            message.header().stamp().nanosec(static_cast<std::uint32_t>(timestamp_ns % 1000000000));
+        }
+
+        static std::int64_t stamp_of(const sensor_msgs::msg::PointCloud2 &message)
+        {
+            return static_cast<std::int64_t>(message.header().stamp().sec()) * 1000000000 +
+                   static_cast<std::int64_t>(message.header().stamp().nanosec());
+        }
+    };
+
+    struct bench_case
+    {
+        std::string payload_kind;
+        std::size_t payload_bytes;
+        provizio::dds::ReliabilityQosPolicyKind reliability_kind;
+        provizio::dds::transport_profile transport;
+        int subscribers;
+    };
+
+    struct bench_result
+    {
+        std::uint64_t sent = 0;
+        std::uint64_t received = 0;
+        double seconds = 0;
+        std::vector<std::int64_t> latencies_ns;
+    };
+
+    struct subscriber_state
+    {
+        std::mutex mutex;
+        std::vector<std::int64_t> latencies_ns;
+        std::uint64_t received = 0;
+    };
+
+    const char *to_string(const provizio::dds::ReliabilityQosPolicyKind reliability_kind)
+    {
+        return reliability_kind == provizio::dds::RELIABLE_RELIABILITY_QOS ? "reliable" : "best_effort";
+    }
+
+    const char *to_string(const provizio::dds::transport_profile transport)
+    {
+        switch (transport)
+        {
+        case provizio::dds::transport_profile::shm_only:
+            return "shm";
+        case provizio::dds::transport_profile::udp_only:
+            return "udp";
+        case provizio::dds::transport_profile::shm_and_udp:
+            return "shm_and_udp";
+        case provizio::dds::transport_profile::large_data_tcp:
+            return "large_data_tcp";
+        default:
+            return "builtin";
+        }
+    }
+
+    template <typename pub_sub_type>
+    bench_result run(const bench_case &params, const std::string &topic_name,
+                     const std::chrono::duration<double> duration)
+    {
+        using data_type = typename pub_sub_type::type;
+
+        std::mutex matched_mutex;
+        std::condition_variable matched_condition;
+        int matched = 0;
+
+        std::vector<std::unique_ptr<subscriber_state>> states;
+        std::vector<std::shared_ptr<provizio::dds::subscriber_handle<pub_sub_type>>> subscribers;
+        for (int i = 0; i < params.subscribers; ++i)
+        {
+            states.emplace_back(new subscriber_state());
+            auto &state = *states.back();
+            state.latencies_ns.reserve(max_recorded_latencies);
+
+            // A participant per subscriber, so samples actually go through the transport
+            subscribers.push_back(provizio::dds::make_subscriber<pub_sub_type>(
+                provizio::dds::make_domain_participant(0, params.transport), topic_name,
+                [&state](const data_type &message) {
+                    const std::int64_t latency = now_ns() - payload<pub_sub_type>::stamp_of(message);
+                    std::lock_guard<std::mutex> lock{state.mutex};
+                    ++state.received;
+                    if (state.latencies_ns.size() < state.latencies_ns.capacity())
+                    {
+                        state.latencies_ns.push_back(latency);
+                    }
+                },
+                [&](const bool has_publisher) {
+                    std::lock_guard<std::mutex> lock{matched_mutex};
+                    matched += has_publisher ? 1 : -1;
+                    matched_condition.notify_all();
+                },
+                params.reliability_kind));
+        }
+
+        auto publisher = provizio::dds::make_publisher<pub_sub_type>(
+            provizio::dds::make_domain_participant(0, params.transport), topic_name, params.reliability_kind);
+
+        {
+            std::unique_lock<std::mutex> lock{matched_mutex};
+            matched_condition.wait_for(lock, match_timeout, [&]() { return matched == params.subscribers; });
+        }
+        std::this_thread::sleep_for(settle_time);
+
+        data_type message;
+        payload<pub_sub_type>::make(message, params.payload_bytes);
+
+        bench_result result;
+        const auto started = std::chrono::steady_clock::now();
+        const auto finish = started + std::chrono::duration_cast<std::chrono::steady_clock::duration>(duration);
+        while (std::chrono::steady_clock::now() < finish)
+        {
+            payload<pub_sub_type>::stamp(message, now_ns());
+            result.sent += publisher->publish(message) ? 1 : 0;
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        // Let the samples in flight arrive
+        std::this_thread::sleep_for(settle_time);
+        publisher.reset();
+        subscribers.clear();
+
+        for (auto &state : states)
+        {
+            std::lock_guard<std::mutex> lock{state->mutex};
+            result.received += state->received;
+            result.latencies_ns.insert(result.latencies_ns.end(), state->latencies_ns.begin(),
+                                       state->latencies_ns.end());
+        }
+
+        return result;
+    }
+
+    double percentile_us(const std::vector<std::int64_t> &sorted_latencies_ns, const double fraction)
+    {
+        if (sorted_latencies_ns.empty())
+        {
+            return 0;
+        }
+
+        const auto rank = static_cast<std::size_t>(fraction * static_cast<double>(sorted_latencies_ns.size()));
+        const auto index = std::min(sorted_latencies_ns.size() - 1, rank);
+        return static_cast<double>(sorted_latencies_ns[index]) / 1000.0;
+    }
+
+    void write_json(std::ostream &output, const bench_case &params, bench_result &result)
+    {
+        std::sort(result.latencies_ns.begin(), result.latencies_ns.end());
+
+        const double received_per_subscriber =
+            static_cast<double>(result.received) / static_cast<double>(std::max(params.subscribers, 1));
+        const double messages_per_second = result.seconds > 0 ? received_per_subscriber / result.seconds : 0;
+
+        output << "{\"payload\":\"" << params.payload_kind << "\",\"payload_bytes\":" << params.payload_bytes
+               << ",\"reliability\":\"" << to_string(params.reliability_kind) << "\",\"transport\":\""
+               << to_string(params.transport) << "\",\"subscribers\":" << params.subscribers
+               << ",\"sent\":" << result.sent << ",\"received\":" << result.received
+               << ",\"seconds\":" << result.seconds << ",\"msgs_per_s\":" << messages_per_second
+               << ",\"mb_per_s\":"
+               << messages_per_second * static_cast<double>(params.payload_bytes) / (1024.0 * 1024.0)
+               << ",\"latency_us\":{\"p50\":" << percentile_us(result.latencies_ns, 0.5)
+               << ",\"p99\":" << percentile_us(result.latencies_ns, 0.99)
+               << ",\"p999\":" << percentile_us(result.latencies_ns, 0.999)
+               << ",\"max\":" << percentile_us(result.latencies_ns, 1.0) << "}}";
+    }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    std::chrono::duration<double> duration{1.0};
+    std::string output_path;
+    bool quick = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--duration") == 0 && i + 1 < argc)
+        {
+            duration = std::chrono::duration<double>{std::atof(argv[++i])};
+        }
+        else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+        {
+            output_path = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--quick") == 0)
+        {
+            quick = true;
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--duration <seconds>] [--output <file.json>] [--quick]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    // Otherwise samples between participants of the same process bypass the transports
+    eprosima::fastrtps::LibrarySettingsAttributes library_settings;
+    library_settings.intraprocess_delivery = eprosima::fastrtps::INTRAPROCESS_OFF;
+    eprosima::fastrtps::xmlparser::XMLProfileManager::library_settings(library_settings);
+
+    const std::vector<std::pair<std::string, std::size_t>> payloads =
+        quick ? std::vector<std::pair<std::string, std::size_t>>{{"string", 64}, {"point_cloud2", 1024 * 1024}}
+              : std::vector<std::pair<std::string, std::size_t>>{{"string", 64},
+                                                                 {"string", 1024},
+                                                                 {"point_cloud2", 64 * 1024},
+                                                                 {"point_cloud2", 1024 * 1024},
+                                                                 {"point_cloud2", 4 * 1024 * 1024}};
+    const std::vector<provizio::dds::ReliabilityQosPolicyKind> reliability_kinds{
+        provizio::dds::BEST_EFFORT_RELIABILITY_QOS, provizio::dds::RELIABLE_RELIABILITY_QOS};
+    const std::vector<provizio::dds::transport_profile> transports{provizio::dds::transport_profile::udp_only,
+                                                                   provizio::dds::transport_profile::shm_only};
+    const std::vector<int> subscriber_counts = quick ? std::vector<int>{1} : std::vector<int>{1, 4};
+
+    std::ofstream output_file;
+    if (!output_path.empty())
+    {
+        output_file.open(output_path);
+        if (!output_file)
+        {
+            std::cerr << "pub_sub_bench: Can't open " << output_path << std::endl;
+            return 1;
+        }
+    }
+    std::ostream &output = output_path.empty() ? std::cout : output_file;
+
+    output << "{\"benchmark\":\"pub_sub\",\"duration_s\":" << duration.count() << ",\"results\":[";
+    int index = 0;
+    for (const auto &payload_params : payloads)
+    {
+        for (const auto reliability_kind : reliability_kinds)
+        {
+            for (const auto transport : transports)
+            {
+                for (const int subscribers : subscriber_counts)
+                {
+                    const bench_case params{payload_params.first, payload_params.second, reliability_kind, transport,
+                                            subscribers};
+                    const std::string topic_name{"provizio_dds_bench_topic_" + std::to_string(index)};
+
+                    auto result = params.payload_kind == payload<std_msgs::msg::StringPubSubType>::kind
+                                      ? run<std_msgs::msg::StringPubSubType>(params, topic_name, duration)
+                                      : run<sensor_msgs::msg::PointCloud2PubSubType>(params, topic_name, duration);
+
+                    output << (index > 0 ? "," : "") << "\n  ";
+                    write_json(output, params, result);
+                    std::cerr << "pub_sub_bench: " << ++index << " / "
+                              << payloads.size() * reliability_kinds.size() * transports.size() *
+                                     subscriber_counts.size()
+                              << " done" << std::endl;
+                }
+            }
+        }
+    }
+    output << "\n]}" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,220 @@
+#!/usr/bin/env python3
+
+# Copyright 2023 Provizio Ltd.
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""
+Measures throughput and end-to-end latency of provizio_dds Python publishers
+and subscribers, sweeping payload size, reliability kind and number of
+subscribers. Results are output as JSON, in the same format as pub_sub_bench.
+Fast-DDS intraprocess delivery is disabled, so FASTRTPS_DEFAULT_PROFILES_FILE
+is overridden.
+
+Usage: python_bench.py [--duration <seconds>] [--output <file.json>] [--quick]
+"""
+import argparse
+import array
+import atexit
+import json
+import os
+import sys
+import tempfile
+import threading
+import time
+
+# Otherwise samples between participants of the same process bypass the transports, as in pub_sub_bench. Fast-DDS
+# loads the library settings from the default XML profiles file on creating the first participant.
+LIBRARY_SETTINGS_XML = """<?xml version="1.0" encoding="UTF-8" ?>
+<dds xmlns="http://www.eprosima.com/XMLSchemas/fastRTPS_Profiles">
+    <library_settings>
+        <intraprocess_delivery>OFF</intraprocess_delivery>
+    </library_settings>
+</dds>
+"""
+with tempfile.NamedTemporaryFile("w", suffix=".xml", delete=False) as library_settings_file:
+    library_settings_file.write(LIBRARY_SETTINGS_XML)
+atexit.register(os.remove, library_settings_file.name)
+os.environ["FASTRTPS_DEFAULT_PROFILES_FILE"] = library_settings_file.name
+
+import provizio_dds  # noqa: E402
+
+MATCH_TIMEOUT = 5
+SETTLE_TIME = 0.5
+POINT_STEP = 16
+
+
+class StringPayload:
+    """The timestamp is the leading digits of the string, padded to the payload size"""
+    kind = "string"
+    pub_sub_type = provizio_dds.StringPubSubType
+    data_type = provizio_dds.String
+
+    @staticmethod
+    def make(size):
+        message = provizio_dds.String()
+        message.data("x" * max(size, 24))
+        return message
+
+    @staticmethod
+    def stamp(message, timestamp_ns):
+        message.data(f"{timestamp_ns:020d}" + message.data()[20:])
+
+    @staticmethod
+    def stamp_of(message):
+        return int(message.data()[:20])
+
+
+class PointCloud2Payload:
+    kind = "point_cloud2"
+    pub_sub_type = provizio_dds.PointCloud2PubSubType
+    data_type = provizio_dds.PointCloud2
+
+    @staticmethod
+    def make(size):
+        points = size // POINT_STEP
+        message = provizio_dds.PointCloud2()
+        message.height(1)
+        message.width(points)
+        message.point_step(POINT_STEP)
+        message.row_step(points * POINT_STEP)
+        message.is_dense(True)
+        message.data(array.array('B', bytes(points * POINT_STEP)))
+        return message
+
+    @staticmethod
+    def stamp(message, timestamp_ns):
+        message.header().stamp().sec(timestamp_ns // 1000000000)
+        message.header().stamp().nanosec(timestamp_ns % 1000000000)
+
+    @staticmethod
+    def stamp_of(message):
+        return message.header().stamp().sec() * 1000000000 + message.header().stamp().nanosec()
+
+
+def run(payload, size, reliability_kind, subscribers_count, topic_name, duration):
+    cv = threading.Condition()
+    matched = [0]
+    lock = threading.Lock()
+    latencies_ns = []
+    received = [0]
+
+    def on_message(message):
+        latency = time.time_ns() - payload.stamp_of(message)
+        with lock:
+            received[0] += 1
+            latencies_ns.append(latency)
+
+    def on_has_publisher_changed(has_publisher):
+        with cv:
+            matched[0] += 1 if has_publisher else -1
+            cv.notify_all()
+
+    # A participant per subscriber, so samples actually go through the builtin transports (intraprocess delivery is
+    # disabled by LIBRARY_SETTINGS_XML)
+    subscribers = [provizio_dds.Subscriber(provizio_dds.make_domain_participant(), topic_name, payload.pub_sub_type,
+                                           payload.data_type, on_message, on_has_publisher_changed, reliability_kind)
+                   for _ in range(subscribers_count)]
+    publisher = provizio_dds.Publisher(provizio_dds.make_domain_participant(
+    ), topic_name, payload.pub_sub_type, None, reliability_kind)
+
+    with cv:
+        cv.wait_for(lambda: matched[0] == subscribers_count, MATCH_TIMEOUT)
+    time.sleep(SETTLE_TIME)
+
+    message = payload.make(size)
+    sent = 0
+    started = time.monotonic()
+    finish = started + duration
+    while time.monotonic() < finish:
+        payload.stamp(message, time.time_ns())
+        sent += 1 if publisher.publish(message) else 0
+    seconds = time.monotonic() - started
+
+    # Let the samples in flight arrive
+    time.sleep(SETTLE_TIME)
+    del publisher
+    del subscribers
+
+    with lock:
+        latencies_ns.sort()
+        received_count = received[0]
+
+    def percentile_us(fraction):
+        if not latencies_ns:
+            return 0
+        return latencies_ns[min(len(latencies_ns) - 1, int(fraction * len(latencies_ns)))] / 1000.0
+
+    messages_per_second = received_count / \
+        max(subscribers_count, 1) / seconds if seconds > 0 else 0
+    return {
+        "payload": payload.kind,
+        "payload_bytes": size,
+        "reliability": "reliable" if reliability_kind == provizio_dds.RELIABLE_RELIABILITY_QOS else "best_effort",
+        "transport": "builtin",
+        "subscribers": subscribers_count,
+        "sent": sent,
+        "received": received_count,
+        "seconds": seconds,
+        "msgs_per_s": messages_per_second,
+        "mb_per_s": messages_per_second * size / (1024.0 * 1024.0),
+        "latency_us": {
+            "p50": percentile_us(0.5),
+            "p99": percentile_us(0.99),
+            "p999": percentile_us(0.999),
+            "max": percentile_us(1.0),
+        },
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="provizio_dds Python pub/sub benchmark")
+    parser.add_argument("--duration", type=float, default=1.0,
+                        help="Publishing duration of each case, in seconds")
+    parser.add_argument("--output", default=None,
+                        help="JSON output file, stdout if not specified")
+    parser.add_argument("--quick", action="store_true",
+                        help="Only run a reduced set of cases")
+    args = parser.parse_args()
+
+    if args.quick:
+        payloads = [(StringPayload, 64), (PointCloud2Payload, 1024 * 1024)]
+        subscriber_counts = [1]
+    else:
+        payloads = [(StringPayload, 64), (StringPayload, 1024), (PointCloud2Payload, 64 * 1024),
+                    (PointCloud2Payload, 1024 * 1024), (PointCloud2Payload, 4 * 1024 * 1024)]
+        subscriber_counts = [1, 4]
+    reliability_kinds = [provizio_dds.BEST_EFFORT_RELIABILITY_QOS,
+                         provizio_dds.RELIABLE_RELIABILITY_QOS]
+
+    cases = [(payload, size, reliability_kind, subscribers_count) for (payload, size) in payloads
+             for reliability_kind in reliability_kinds for subscribers_count in subscriber_counts]
+    results = []
+    for index, (payload, size, reliability_kind, subscribers_count) in enumerate(cases):
+        results.append(run(payload, size, reliability_kind, subscribers_count,
+                           f"provizio_dds_python_bench_topic_{index}", args.duration))
+        print(f"python_bench: {index + 1} / {len(cases)} done",
+              file=sys.stderr)
+
+    report = {"benchmark": "python_pub_sub",
+              "duration_s": args.duration, "results": results}
+    if args.output:
+        with open(args.output, "w") as output:
+            json.dump(report, output, indent=2)
+    else:
+        json.dump(report, sys.stdout, indent=2)
+        print()
+
+
+if __name__ == "__main__":
+    main()
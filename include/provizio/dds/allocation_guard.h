@@ -0,0 +1,150 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DDS_ALLOCATION_GUARD
+#define DDS_ALLOCATION_GUARD
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace provizio
+{
+    namespace dds
+    {
+        namespace detail
+        {
+            /**
+             * @brief Number of heap allocations made by the calling thread, as counted by the allocation hook
+             */
+            inline std::uint64_t &thread_allocations() noexcept
+            {
+                // Trivially constructed, so it's safe to use from within operator new
+                static thread_local std::uint64_t allocations = 0;
+                return allocations;
+            }
+
+            /**
+             * @brief Set when the allocation hook is installed with PROVIZIO_DDS_ALLOCATION_HOOK
+             */
+            inline bool &allocation_hook_installed() noexcept
+            {
+                static bool installed = false;
+                return installed;
+            }
+
+            /**
+             * @brief Counts a heap allocation made by the calling thread. Invoked by the allocation hook.
+             */
+            inline void *counted_allocation(const std::size_t size) noexcept
+            {
+                ++thread_allocations();
+                return std::malloc(size > 0 ? size : 1);
+            }
+        } // namespace detail
+
+        /**
+         * @brief Counts the heap allocations made by the calling thread during the lifetime of the guard, f.e. to
+         * verify in tests that no allocations take place on publishing and receiving in a steady state. Requires the
+         * debug allocation hook, installed by PROVIZIO_DDS_ALLOCATION_HOOK in exactly one source file of the
+         * executable, otherwise no allocations are counted.
+         *
+         * @see provizio::dds::publisher_handle::warm_up
+         * @see provizio::dds::default_qos_policies::preallocate
+         */
+        class allocation_guard final
+        {
+          public:
+            allocation_guard() noexcept : initial_allocations(detail::thread_allocations())
+            {
+            }
+
+            /**
+             * @return Number of heap allocations made by the calling thread since the guard was constructed
+             */
+            std::uint64_t allocations() const noexcept
+            {
+                return detail::thread_allocations() - initial_allocations;
+            }
+
+            /**
+             * @return Number of heap allocations made by the calling thread so far, f.e. to count the allocations of
+             * a thread that can't hold a guard, such as a thread invoking subscriber functions, between invocations
+             */
+            static std::uint64_t thread_allocations() noexcept
+            {
+                return detail::thread_allocations();
+            }
+
+            /**
+             * @return true if the allocation hook is installed, so the allocations are actually counted
+             */
+            static bool hook_installed() noexcept
+            {
+                return detail::allocation_hook_installed();
+            }
+
+          private:
+            std::uint64_t initial_allocations;
+        };
+    } // namespace dds
+} // namespace provizio
+
+/**
+ * @brief Installs the debug allocation hook used by provizio::dds::allocation_guard, by replacing the global operator
+ * new and operator delete. To be used in exactly one source file of an executable (normally a test), at global
+ * scope. Aborts when out of memory.
+ */
+#define PROVIZIO_DDS_ALLOCATION_HOOK()                                                                                 \
+    void *operator new(std::size_t size)                                                                               \
+    {                                                                                                                  \
+        void *memory = provizio::dds::detail::counted_allocation(size);                                                \
+        if (memory == nullptr)                                                                                         \
+        {                                                                                                              \
+            std::abort();                                                                                              \
+        }                                                                                                              \
+        return memory;                                                                                                 \
+    }                                                                                                                  \
+    void *operator new[](std::size_t size)                                                                             \
+    {                                                                                                                  \
+        return operator new(size);                                                                                     \
+    }                                                                                                                  \
+    void *operator new(std::size_t size, const std::nothrow_t &) noexcept                                              \
+    {                                                                                                                  \
+        return provizio::dds::detail::counted_allocation(size);                                                        \
+    }                                                                                                                  \
+    void *operator new[](std::size_t size, const std::nothrow_t &) noexcept                                            \
+    {                                                                                                                  \
+        return provizio::dds::detail::counted_allocation(size);                                                        \
+    }                                                                                                                  \
+    void operator delete(void *memory) noexcept                                                                        \
+    {                                                                                                                  \
+        std::free(memory);                                                                                             \
+    }                                                                                                                  \
+    void operator delete[](void *memory) noexcept                                                                      \
+    {                                                                                                                  \
+        std::free(memory);                                                                                             \
+    }                                                                                                                  \
+    void operator delete(void *memory, std::size_t) noexcept                                                           \
+    {                                                                                                                  \
+        std::free(memory);                                                                                             \
+    }                                                                                                                  \
+    void operator delete[](void *memory, std::size_t) noexcept                                                         \
+    {                                                                                                                  \
+        std::free(memory);                                                                                             \
+    }                                                                                                                  \
+    static const bool provizio_dds_allocation_hook_installed = (provizio::dds::detail::allocation_hook_installed() =   \
+                                                                    true)
+
+#endif // DDS_ALLOCATION_GUARD
@@ -15,6 +15,10 @@
 #ifndef DDS_COMMON
 #define DDS_COMMON
 
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
 #include <fastdds/dds/domain/DomainParticipant.hpp>
 
 namespace provizio
@@ -25,6 +29,29 @@ namespace provizio
          * @brief Makes Fast-DDS entities available in provizio::dds
          */
         using namespace eprosima::fastdds::dds;
+
+        namespace detail
+        {
+            /**
+             * @brief Converts a std::chrono duration to a Fast-DDS one
+             */
+            inline Duration_t to_duration(const std::chrono::nanoseconds duration)
+            {
+                const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(duration);
+                return Duration_t{static_cast<std::int32_t>(seconds.count()),
+                                  static_cast<std::uint32_t>((duration - seconds).count())};
+            }
+
+            /**
+             * @brief Returns the handle, or nullptr if it failed to create its DDS DataWriter or DataReader, f.e. as
+             * its topic exists with another type. Used by the make_ functions, so such failures surface on creation.
+             */
+            template <typename handle_type>
+            std::shared_ptr<handle_type> created_or_null(std::shared_ptr<handle_type> handle)
+            {
+                return handle->instance_handle() != HANDLE_NIL ? std::move(handle) : nullptr;
+            }
+        } // namespace detail
     } // namespace dds
 } // namespace provizio
 
@@ -0,0 +1,386 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DDS_DISPATCHER
+#define DDS_DISPATCHER
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace provizio
+{
+    namespace dds
+    {
+        /**
+         * @brief Options of a provizio::dds::dispatcher
+         */
+        struct dispatcher_options
+        {
+            /**
+             * @brief Default capacity of a per subscriber queue of a dispatcher
+             */
+            static constexpr std::size_t default_queue_capacity = 64;
+
+            /**
+             * @brief Number of worker threads, at least 1. Each subscriber is served by a single worker thread, so its
+             * samples are always dispatched in order.
+             */
+            std::size_t worker_threads = 1;
+
+            /**
+             * @brief CPUs to pin worker threads to: worker i is pinned to cpu_affinity[i % cpu_affinity.size()]. Empty
+             * to not pin the workers. Only supported in Linux.
+             */
+            std::vector<int> cpu_affinity;
+
+            /**
+             * @brief Capacity of the queue of samples of each subscriber. When full, newly received samples are
+             * dropped.
+             */
+            std::size_t queue_capacity = default_queue_capacity;
+        };
+
+        /**
+         * @brief A snapshot of the counters of a single subscriber queue of a dispatcher
+         */
+        struct dispatch_statistics
+        {
+            /**
+             * @brief Name of the queue, as provided to provizio::dds::dispatched
+             */
+            std::string name;
+
+            /**
+             * @brief Number of samples, dispatched to the subscriber function
+             */
+            std::uint64_t dispatched = 0;
+
+            /**
+             * @brief Number of samples, dropped due to the queue being full
+             */
+            std::uint64_t dropped = 0;
+
+            /**
+             * @brief Number of samples currently in the queue
+             */
+            std::size_t queue_depth = 0;
+
+            /**
+             * @brief Maximum number of samples ever in the queue
+             */
+            std::size_t max_queue_depth = 0;
+
+            /**
+             * @brief Total and maximum time samples have spent in the queue before being dispatched
+             */
+            std::chrono::nanoseconds total_wait_time{0};
+            std::chrono::nanoseconds max_wait_time{0};
+
+            /**
+             * @brief Total and maximum time spent in the subscriber function
+             */
+            std::chrono::nanoseconds total_callback_time{0};
+            std::chrono::nanoseconds max_callback_time{0};
+        };
+
+        class dispatcher;
+
+        namespace detail
+        {
+            /**
+             * @brief A lock-free bounded multi-producer queue, based on the algorithm by Dmitry Vyukov
+             */
+            template <typename value_type> class bounded_queue final
+            {
+              public:
+                explicit bounded_queue(const std::size_t min_capacity)
+                    : mask(round_up_to_power_of_two(min_capacity) - 1), cells(new cell[mask + 1])
+                {
+                    for (std::size_t i = 0; i <= mask; ++i)
+                    {
+                        cells[i].sequence.store(i, std::memory_order_relaxed);
+                    }
+                }
+
+                bounded_queue(const bounded_queue &) = delete;
+                bounded_queue &operator=(const bounded_queue &) = delete;
+
+                bool try_push(value_type &&value)
+                {
+                    std::size_t position = enqueue_position.load(std::memory_order_relaxed);
+                    for (;;)
+                    {
+                        cell &target = cells[position & mask];
+                        const auto difference =
+                            static_cast<std::intptr_t>(target.sequence.load(std::memory_order_acquire)) -
+                            static_cast<std::intptr_t>(position);
+                        if (difference == 0)
+                        {
+                            if (enqueue_position.compare_exchange_weak(position, position + 1,
+                                                                       std::memory_order_relaxed))
+                            {
+                                target.value = std::move(value);
+                                target.sequence.store(position + 1, std::memory_order_release);
+                                return true;
+                            }
+                        }
+                        else if (difference < 0)
+                        {
+                            // Full
+                            return false;
+                        }
+                        else
+                        {
+                            position = enqueue_position.load(std::memory_order_relaxed);
+                        }
+                    }
+                }
+
+                bool try_pop(value_type &value)
+                {
+                    std::size_t position = dequeue_position.load(std::memory_order_relaxed);
+                    for (;;)
+                    {
+                        cell &target = cells[position & mask];
+                        const auto difference =
+                            static_cast<std::intptr_t>(target.sequence.load(std::memory_order_acquire)) -
+                            static_cast<std::intptr_t>(position + 1);
+                        if (difference == 0)
+                        {
+                            if (dequeue_position.compare_exchange_weak(position, position + 1,
+                                                                       std::memory_order_relaxed))
+                            {
+                                value = std::move(target.value);
+                                target.value = value_type{};
+                                target.sequence.store(position + mask + 1, std::memory_order_release);
+                                return true;
+                            }
+                        }
+                        else if (difference < 0)
+                        {
+                            // Empty
+                            return false;
+                        }
+                        else
+                        {
+                            position = dequeue_position.load(std::memory_order_relaxed);
+                        }
+                    }
+                }
+
+                std::size_t size() const noexcept
+                {
+                    const std::size_t dequeued = dequeue_position.load(std::memory_order_acquire);
+                    const std::size_t enqueued = enqueue_position.load(std::memory_order_acquire);
+                    return enqueued > dequeued ? enqueued - dequeued : 0;
+                }
+
+                std::size_t capacity() const noexcept
+                {
+                    return mask + 1;
+                }
+
+              private:
+                struct cell
+                {
+                    std::atomic<std::size_t> sequence{0};
+                    value_type value;
+                };
+
+                static std::size_t round_up_to_power_of_two(const std::size_t value)
+                {
+                    std::size_t result = 2;
+                    while (result < value)
+                    {
+                        result <<= 1U;
+                    }
+                    return result;
+                }
+
+                const std::size_t mask;
+                std::unique_ptr<cell[]> cells;
+                std::atomic<std::size_t> enqueue_position{0};
+                std::atomic<std::size_t> dequeue_position{0};
+            };
+
+            /**
+             * @brief Type-erased base of a subscriber queue served by a dispatcher, which also keeps its counters
+             */
+            class dispatch_queue_base
+            {
+              public:
+                explicit dispatch_queue_base(std::string name);
+                virtual ~dispatch_queue_base() = default;
+
+                dispatch_queue_base(const dispatch_queue_base &) = delete;
+                dispatch_queue_base &operator=(const dispatch_queue_base &) = delete;
+
+                /**
+                 * @brief Dispatches up to max_count queued samples. Invoked by a dispatcher worker thread only.
+                 *
+                 * @return Number of dispatched samples
+                 */
+                virtual std::size_t drain(std::size_t max_count) = 0;
+
+                /**
+                 * @return Number of samples currently in the queue
+                 */
+                virtual std::size_t size() const noexcept = 0;
+
+                /**
+                 * @return A snapshot of the counters of the queue
+                 */
+                dispatch_statistics statistics() const;
+
+              protected:
+                void count_enqueued(std::size_t depth) noexcept;
+                void count_dropped() noexcept;
+                void count_dispatched(std::chrono::nanoseconds wait_time,
+                                      std::chrono::nanoseconds callback_time) noexcept;
+
+              private:
+                const std::string name;
+                std::atomic<std::uint64_t> dispatched{0};
+                std::atomic<std::uint64_t> dropped{0};
+                std::atomic<std::size_t> max_queue_depth{0};
+                std::atomic<std::int64_t> total_wait_time_ns{0};
+                std::atomic<std::int64_t> max_wait_time_ns{0};
+                std::atomic<std::int64_t> total_callback_time_ns{0};
+                std::atomic<std::int64_t> max_callback_time_ns{0};
+
+                // Managed by the dispatcher
+                std::size_t worker_index = 0;
+                std::atomic<bool> detached{false};
+
+                friend class provizio::dds::dispatcher;
+            };
+        } // namespace detail
+
+        /**
+         * @brief Executes subscriber functions in its own pool of worker threads rather than in the Fast-DDS listener
+         * thread, so a slow subscriber function doesn't block receiving data on other DataReaders of the same DDS
+         * Domain Participant. Received samples are passed to the workers through a lock-free bounded queue per
+         * subscriber, with no heap allocations in a steady state.
+         *
+         * A dispatcher can be shared by multiple subscribers (f.e. all subscribers of a participant), or be dedicated
+         * to a single one, f.e. to pin its function to an isolated CPU core. Subscribers use a dispatcher when their
+         * function is wrapped with provizio::dds::dispatched.
+         *
+         * @see provizio::dds::make_dispatcher
+         * @see provizio::dds::dispatched
+         */
+        class dispatcher final
+        {
+          public:
+            /**
+             * @brief Constructs a new dispatcher object and starts its worker threads
+             *
+             * @param options Number of worker threads, their CPU affinity and the queue capacity
+             */
+            explicit dispatcher(const dispatcher_options &options = {});
+
+            /**
+             * @brief Stops the worker threads. Samples still in the queues are not dispatched.
+             */
+            ~dispatcher();
+
+            dispatcher(const dispatcher &) = delete;
+            dispatcher &operator=(const dispatcher &) = delete;
+
+            /**
+             * @return The capacity of the queue of each subscriber
+             */
+            std::size_t queue_capacity() const noexcept;
+
+            /**
+             * @return Snapshots of the counters of all subscriber queues of the dispatcher
+             */
+            std::vector<dispatch_statistics> statistics() const;
+
+            /**
+             * @brief Starts serving a subscriber queue. Normally invoked by a subscriber only.
+             */
+            void add(std::shared_ptr<detail::dispatch_queue_base> queue);
+
+            /**
+             * @brief Stops serving a subscriber queue. Once returned, the queue is guaranteed not to be used by the
+             * worker threads, unless invoked from the queue's own worker thread. Normally invoked by a subscriber only.
+             */
+            void remove(const detail::dispatch_queue_base *queue);
+
+            /**
+             * @brief Wakes up the worker thread of a subscriber queue after a sample has been pushed to it. Normally
+             * invoked by a subscriber only.
+             */
+            void notify(const detail::dispatch_queue_base *queue);
+
+          private:
+            struct worker;
+
+            const std::size_t capacity;
+            std::vector<std::unique_ptr<worker>> workers;
+            mutable std::mutex queues_mutex;
+            std::vector<std::shared_ptr<detail::dispatch_queue_base>> queues;
+            std::size_t next_worker = 0;
+        };
+
+        /**
+         * @brief Creates a new dispatcher as a shared_ptr, to be passed to provizio::dds::dispatched
+         *
+         * @param options Number of worker threads, their CPU affinity and the queue capacity
+         * @return std::shared_ptr<dispatcher>
+         */
+        std::shared_ptr<dispatcher> make_dispatcher(const dispatcher_options &options = {});
+
+        /**
+         * @brief A subscriber function to be executed by a dispatcher, as created by provizio::dds::dispatched
+         *
+         * @tparam on_data_function_type Type of the wrapped function / function object
+         */
+        template <typename on_data_function_type> struct dispatched_function
+        {
+            std::shared_ptr<dispatcher> executor;
+            on_data_function_type function;
+            std::string name;
+        };
+
+        /**
+         * @brief Wraps a function / function object to be passed to provizio::dds::make_subscriber, so that it's
+         * executed by a dispatcher worker thread rather than in the Fast-DDS listener thread
+         *
+         * @param executor The dispatcher, as created by provizio::dds::make_dispatcher
+         * @param on_data_function Function / function object to be invoked on receiving data, takes the same
+         * arguments as in provizio::dds::make_subscriber
+         * @param name Name of the subscriber queue, to be reported in dispatch_statistics
+         * @return The wrapped function
+         * @see provizio::dds::make_subscriber
+         */
+        template <typename on_data_function_type>
+        dispatched_function<on_data_function_type> dispatched(std::shared_ptr<dispatcher> executor,
+                                                              on_data_function_type on_data_function,
+                                                              std::string name = {})
+        {
+            return {std::move(executor), std::move(on_data_function), std::move(name)};
+        }
+    } // namespace dds
+} // namespace provizio
+
+#endif // DDS_DISPATCHER
@@ -15,9 +15,14 @@
 #ifndef DDS_DOMAIN_PARTICIPANT
 #define DDS_DOMAIN_PARTICIPANT
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <fastdds/dds/domain/DomainParticipant.hpp>
+#include <fastdds/rtps/flowcontrol/FlowControllerDescriptor.hpp>
 
 #include "provizio/dds/common.h"
 
@@ -35,6 +40,460 @@ namespace provizio
          * @see https://fast-dds.docs.eprosima.com/en/latest/fastdds/api_reference/dds_pim/domain/domainparticipant.html
          */
         std::shared_ptr<DomainParticipant> make_domain_participant(DomainId_t domain_id = 0);
+
+        /**
+         * @brief Defines the set of transports used by a DDS Domain Participant
+         *
+         * @see https://fast-dds.docs.eprosima.com/en/latest/fastdds/transport/transport.html
+         */
+        enum class transport_profile
+        {
+            /**
+             * @brief Fast-DDS builtin transports, i.e. UDPv4 and shared memory
+             */
+            builtin,
+
+            /**
+             * @brief Shared memory only, which limits communication to the same host, but avoids UDP loopback
+             * fragmentation of large samples
+             */
+            shm_only,
+
+            /**
+             * @brief UDPv4 only
+             */
+            udp_only,
+
+            /**
+             * @brief Shared memory for the same host communication and UDPv4 for other hosts, with the shared memory
+             * segment sized to fit large samples
+             */
+            shm_and_udp,
+
+            /**
+             * @brief Shared memory for the same host communication and TCPv4 for other hosts, which avoids UDP
+             * fragmentation of large samples. UDPv4 is still used for participants discovery.
+             */
+            large_data_tcp
+        };
+
+        /**
+         * @brief Defines a flow controller, which limits the bandwidth used by asynchronous data writers referring to
+         * it by name
+         *
+         * @see provizio::dds::publish_mode_options
+         * @see https://fast-dds.docs.eprosima.com/en/latest/fastdds/property_policies/flow_controllers.html
+         */
+        struct flow_controller_options
+        {
+            /**
+             * @brief Name of the flow controller, to be referred by data writers
+             */
+            std::string name;
+
+            /**
+             * @brief Maximum number of bytes to be sent per period, 0 for no limit
+             */
+            std::int32_t max_bytes_per_period = 0;
+
+            /**
+             * @brief Period, in milliseconds, max_bytes_per_period applies to
+             */
+            std::uint64_t period_ms = 100;
+
+            /**
+             * @brief Defines the order of sending samples of different data writers sharing the flow controller
+             */
+            eprosima::fastdds::rtps::FlowControllerSchedulerPolicy scheduler =
+                eprosima::fastdds::rtps::FlowControllerSchedulerPolicy::FIFO;
+        };
+
+        /**
+         * @brief Transport options to be used along with a transport_profile
+         */
+        struct transport_options
+        {
+            /**
+             * @brief Default size of a shared memory segment, large enough to fit a few multi-megabyte samples
+             */
+            static constexpr std::uint32_t default_shm_segment_size = 16 * 1024 * 1024;
+
+            /**
+             * @brief Size of the shared memory segment of the participant, in bytes. Must fit at least one largest
+             * serialized sample.
+             */
+            std::uint32_t shm_segment_size = default_shm_segment_size;
+
+            /**
+             * @brief Port to accept TCP connections on in large_data_tcp profile, has to be set (i.e. not 0) and unique
+             * per participant of the host, unless the participant hosts a Discovery Server, which accepts connections
+             * on the port of the server instead. Fast-DDS 2.8 doesn't reliably assign an available port automatically,
+             * so large_data_tcp participants can't be created with the default 0.
+             */
+            std::uint16_t tcp_listening_port = 0;
+
+            /**
+             * @brief Flow controllers to be registered in the participant, so asynchronous publishers can refer to them
+             * by name
+             */
+            std::vector<flow_controller_options> flow_controllers;
+        };
+
+        /**
+         * @brief Creates a new DDS Domain Participant with the specified transports as a shared_ptr. The participant
+         * is automatically deleted correctly on destroying its last shared_ptr.
+         *
+         * @param domain_id domain_id
+         * @param profile The set of transports to be used
+         * @param options Transport options, f.e. shared memory segment size or flow controllers
+         * @return std::shared_ptr<DomainParticipant>, nullptr if it can't be created, f.e. due to a missing
+         * tcp_listening_port in large_data_tcp profile
+         * @see https://en.cppreference.com/w/cpp/memory/shared_ptr
+         * @see https://fast-dds.docs.eprosima.com/en/latest/fastdds/api_reference/dds_pim/domain/domainparticipant.html
+         * @see https://fast-dds.docs.eprosima.com/en/latest/fastdds/transport/shared_memory/shared_memory.html
+         */
+        std::shared_ptr<DomainParticipant> make_domain_participant(DomainId_t domain_id, transport_profile profile,
+                                                                   const transport_options &options = {});
+
+        /**
+         * @brief Returns the DDS Domain Participant shared in the process by all callers of the same domain_id and
+         * transport profile, creating it if there is none. As every participant runs its own threads, sockets, shared
+         * memory segments and discovery, sharing one per domain saves resources and startup time compared to
+         * creating one per publisher or subscriber with make_domain_participant. The participant is cached weakly, so
+         * it's deleted as usual on destroying its last shared_ptr and re-created on the next call. Raw (serialized)
+         * publishers, subscribers, recorders and replayers of a data type can't share a participant with regular ones
+         * of the same type, so they need a participant of their own, f.e. one from make_domain_participant.
+         *
+         * @param domain_id domain_id, 0 by default
+         * @param profile The set of transports to be used, builtin by default
+         * @return std::shared_ptr<DomainParticipant>, nullptr if it can't be created, which is always the case in
+         * large_data_tcp profile, as it requires a tcp_listening_port of its own
+         * @see provizio::dds::make_domain_participant
+         */
+        std::shared_ptr<DomainParticipant> get_domain_participant(
+            DomainId_t domain_id = 0, transport_profile profile = transport_profile::builtin);
+
+        /**
+         * @brief Defines how a DDS Domain Participant discovers other participants and their endpoints
+         *
+         * @see https://fast-dds.docs.eprosima.com/en/latest/fastdds/discovery/discovery.html
+         */
+        enum class discovery_mode
+        {
+            /**
+             * @brief Simple discovery: participants announce themselves via multicast and exchange all their endpoints
+             * with each other
+             */
+            simple,
+
+            /**
+             * @brief Discovery Server client: participants only exchange discovery data with the discovery servers,
+             * which avoids multicast traffic and speeds up matching of many participants
+             *
+             * @see https://fast-dds.docs.eprosima.com/en/latest/fastdds/discovery/discovery_server.html
+             */
+            discovery_server_client,
+
+            /**
+             * @brief Hosts a Discovery Server in the participant, so that no separate server process is required
+             */
+            discovery_server,
+
+            /**
+             * @brief Simple participant discovery with static endpoint discovery, i.e. endpoints are described by an
+             * XML file rather than announced, which makes matching deterministic and faster
+             *
+             * @see https://fast-dds.docs.eprosima.com/en/latest/fastdds/discovery/static.html
+             */
+            static_edp
+        };
+
+        /**
+         * @brief Locator and GUID prefix of a Discovery Server. It's reached over the network transport of the
+         * transport_profile: TCPv4 in large_data_tcp (so a server hosted with it listens to its port over TCP) and
+         * UDPv4 otherwise. Discovery Servers are not supported in shm_only, which has no network transport.
+         */
+        struct discovery_server_options
+        {
+            /**
+             * @brief IPv4 address of the server
+             */
+            std::string address = "127.0.0.1";
+
+            /**
+             * @brief UDP or TCP port of the server, depending on the transport_profile
+             */
+            std::uint16_t port = 11811;
+
+            /**
+             * @brief GUID prefix of the server, the one of the Fast-DDS server with id 0 by default
+             */
+            std::string guid_prefix = "44.53.00.5f.45.50.52.4f.53.49.4d.41";
+        };
+
+        /**
+         * @brief Kind of a statically discovered endpoint
+         */
+        enum class static_endpoint_kind
+        {
+            writer,
+            reader
+        };
+
+        /**
+         * @brief Associates publishers or subscribers of a topic with an endpoint of the static EDP XML description,
+         * by user id
+         */
+        struct static_endpoint
+        {
+            /**
+             * @brief A DDS Topic Name
+             */
+            std::string topic_name;
+
+            /**
+             * @brief Whether the publishers (writer) or the subscribers (reader) of the topic are described
+             */
+            static_endpoint_kind kind = static_endpoint_kind::writer;
+
+            /**
+             * @brief userId of the endpoint in the static EDP XML description, a positive number
+             */
+            std::int16_t user_id = 0;
+        };
+
+        /**
+         * @brief Discovery options of a DDS Domain Participant. The default timings are tuned for a fast start in a
+         * local network, rather than the Fast-DDS defaults.
+         *
+         * @see provizio::dds::make_domain_participant
+         */
+        struct discovery_options
+        {
+            /**
+             * @brief The discovery mode
+             */
+            discovery_mode mode = discovery_mode::simple;
+
+            /**
+             * @brief Name of the participant, has to match the name in the static EDP XML description in static_edp
+             * mode
+             */
+            std::string participant_name;
+
+            /**
+             * @brief Servers to connect to in discovery_server_client mode, or the single server to be hosted in
+             * discovery_server mode
+             */
+            std::vector<discovery_server_options> servers{discovery_server_options{}};
+
+            /**
+             * @brief Static EDP XML description of the remote endpoints in static_edp mode: either a path to the file
+             * or the XML itself
+             */
+            std::string static_edp_xml;
+
+            /**
+             * @brief User ids of the local publishers and subscribers in static_edp mode
+             */
+            std::vector<static_endpoint> static_endpoints;
+
+            /**
+             * @brief Time, in milliseconds, after which a remote participant is considered gone, unless it announces
+             * itself again
+             */
+            std::uint32_t lease_duration_ms = 10000;
+
+            /**
+             * @brief Period, in milliseconds, of the participant announcements
+             */
+            std::uint32_t announcement_period_ms = 1000;
+
+            /**
+             * @brief Number of quick announcements on start
+             */
+            std::uint32_t initial_announcements_count = 10;
+
+            /**
+             * @brief Period, in milliseconds, of the quick announcements on start
+             */
+            std::uint32_t initial_announcements_period_ms = 20;
+
+            /**
+             * @brief Period, in milliseconds, of a Discovery Server client pinging the servers until it's connected
+             */
+            std::uint32_t client_sync_period_ms = 50;
+        };
+
+        /**
+         * @brief Creates a new DDS Domain Participant with the specified transports and discovery as a shared_ptr. The
+         * participant is automatically deleted correctly on destroying its last shared_ptr.
+         *
+         * @param domain_id domain_id
+         * @param profile The set of transports to be used
+         * @param options Transport options, f.e. shared memory segment size or flow controllers
+         * @param discovery Discovery options, f.e. Discovery Server client mode or static endpoint discovery
+         * @return std::shared_ptr<DomainParticipant>, nullptr if it can't be created, f.e. due to invalid discovery
+         * options or a missing tcp_listening_port in large_data_tcp profile
+         * @see provizio::dds::discovery_options
+         * @see https://fast-dds.docs.eprosima.com/en/latest/fastdds/discovery/discovery.html
+         */
+        std::shared_ptr<DomainParticipant> make_domain_participant(DomainId_t domain_id, transport_profile profile,
+                                                                   const transport_options &options,
+                                                                   const discovery_options &discovery);
+
+        /**
+         * @brief Scheduling policy of a thread
+         */
+        enum class thread_scheduling
+        {
+            /**
+             * @brief Keeps the policy and priority of the creating thread
+             */
+            inherit,
+
+            /**
+             * @brief SCHED_OTHER, the default time-sharing policy
+             */
+            other,
+
+            /**
+             * @brief SCHED_FIFO real time policy, usually requires CAP_SYS_NICE
+             */
+            fifo,
+
+            /**
+             * @brief SCHED_RR real time policy, usually requires CAP_SYS_NICE
+             */
+            round_robin
+        };
+
+        /**
+         * @brief CPU affinity, scheduling and stack size of threads. The defaults keep the settings of the creating
+         * thread. Only supported in Linux.
+         */
+        struct thread_settings
+        {
+            /**
+             * @brief CPUs the threads may run on, empty to keep the affinity of the creating thread
+             */
+            std::vector<int> cpu_affinity;
+
+            /**
+             * @brief Scheduling policy of the threads
+             */
+            thread_scheduling scheduling = thread_scheduling::inherit;
+
+            /**
+             * @brief Priority of the threads in the scheduling policy, f.e. 1 to 99 for fifo and round_robin
+             */
+            int priority = 0;
+
+            /**
+             * @brief Stack size of the threads in bytes, 0 to keep the default. Only supported with glibc, where it's
+             * applied to the process wide default thread attributes while the threads are created, so threads that
+             * other threads of the process happen to start meanwhile get it too.
+             */
+            std::size_t stack_size = 0;
+        };
+
+        /**
+         * @brief Settings of the threads a DDS Domain Participant runs internally. Fast-DDS 2.8 doesn't configure its
+         * threads: they inherit the CPU affinity and scheduling of the thread that creates them, and get the default
+         * stack size. So the settings are applied to the calling thread while it creates the participant (or an
+         * asynchronous DataWriter), with the previous settings restored afterwards.
+         *
+         * @see provizio::dds::make_domain_participant
+         */
+        struct participant_thread_options
+        {
+            /**
+             * @brief Settings of the threads created along with the participant: transport receive threads (one per
+             * listening locator of each transport, incl. shared memory listeners), the event thread and the discovery
+             * threads. The number of receive threads is defined by the transport_profile, f.e. shm_only only uses
+             * shared memory listeners.
+             */
+            thread_settings internal;
+
+            /**
+             * @brief Settings of the threads sending the samples of asynchronous publishers, created along with the
+             * first asynchronous DataWriter of a flow controller
+             */
+            thread_settings async_writer;
+        };
+
+        /**
+         * @brief Creates a new DDS Domain Participant with the specified transports, discovery and settings of its
+         * internal threads as a shared_ptr, f.e. to keep them off the CPUs of a perception pipeline. The participant
+         * is automatically deleted correctly on destroying its last shared_ptr.
+         *
+         * @param domain_id domain_id
+         * @param profile The set of transports to be used
+         * @param options Transport options, f.e. shared memory segment size or flow controllers
+         * @param discovery Discovery options, f.e. Discovery Server client mode or static endpoint discovery
+         * @param threads Settings of the internal threads of the participant
+         * @return std::shared_ptr<DomainParticipant>, nullptr if it can't be created, f.e. due to invalid discovery
+         * options or a missing tcp_listening_port in large_data_tcp profile
+         * @see provizio::dds::participant_thread_options
+         */
+        std::shared_ptr<DomainParticipant> make_domain_participant(DomainId_t domain_id, transport_profile profile,
+                                                                   const transport_options &options,
+                                                                   const discovery_options &discovery,
+                                                                   const participant_thread_options &threads);
+
+        /**
+         * @brief Applies thread_settings to the calling thread for its lifetime, so that the threads created
+         * meanwhile inherit them, and then restores the previous settings. The stack size is applied to the process
+         * wide default thread attributes, which are shared with all threads of the process: scopes with a stack size
+         * are serialized process wide (nesting in the same thread is allowed), so that each of them restores the
+         * default it found, and should be kept as short as creating the threads takes. Normally used by
+         * make_domain_participant and publisher handles only.
+         */
+        class scoped_thread_settings final
+        {
+          public:
+            explicit scoped_thread_settings(const thread_settings &settings);
+            ~scoped_thread_settings();
+
+            scoped_thread_settings(const scoped_thread_settings &) = delete;
+            scoped_thread_settings &operator=(const scoped_thread_settings &) = delete;
+
+            /**
+             * @return true if all the settings were applied, false if any of them couldn't be, f.e. due to missing
+             * privileges for real time scheduling or not being supported on the platform
+             */
+            bool applied() const noexcept
+            {
+                return all_applied;
+            }
+
+          private:
+            struct saved_settings;
+
+            std::unique_ptr<saved_settings> saved;
+            bool all_applied = true;
+        };
+
+        /**
+         * @brief Looks up the async writer thread settings of a participant, as specified by
+         * provizio::dds::participant_thread_options::async_writer. Used by publisher handles.
+         *
+         * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+         * @return The thread settings, the defaults if not specified
+         */
+        thread_settings async_writer_thread_settings(const std::shared_ptr<DomainParticipant> &domain_participant);
+
+        /**
+         * @brief Looks up the static EDP user id of publishers or subscribers of a topic, as specified by
+         * provizio::dds::discovery_options::static_endpoints. Used by publisher and subscriber handles.
+         *
+         * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+         * @param topic_name A DDS Topic Name
+         * @param kind Whether a publisher (writer) or a subscriber (reader) is looked up
+         * @return The user id, or -1 if not specified
+         */
+        std::int16_t static_endpoint_user_id(const std::shared_ptr<DomainParticipant> &domain_participant,
+                                             const std::string &topic_name, static_endpoint_kind kind);
     } // namespace dds
 } // namespace provizio
 
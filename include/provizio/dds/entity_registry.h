@@ -0,0 +1,73 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DDS_ENTITY_REGISTRY
+#define DDS_ENTITY_REGISTRY
+
+#include <memory>
+#include <string>
+
+#include <fastdds/dds/domain/DomainParticipant.hpp>
+#include <fastdds/dds/publisher/Publisher.hpp>
+#include <fastdds/dds/subscriber/Subscriber.hpp>
+#include <fastdds/dds/topic/Topic.hpp>
+#include <fastdds/dds/topic/TypeSupport.hpp>
+
+#include "provizio/dds/common.h"
+
+namespace provizio
+{
+    namespace dds
+    {
+        /**
+         * @brief Acquires a DDS Topic shared by all provizio::dds handles of the same DDS Domain Participant and topic
+         * name, registering the type when creating the topic. The topic is reference-counted, and deleted on
+         * destroying the last shared_ptr to it.
+         *
+         * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+         * @param topic_name A DDS Topic Name
+         * @param type_support DDS Type Support of the topic data type
+         * @return std::shared_ptr to the topic, or nullptr if it can't be created, f.e. when the topic already exists
+         * with a different type, or the type is registered in its serialized form while type_support isn't a
+         * provizio::dds::serialized_pub_sub_type (or vice versa)
+         * @see https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/topic/topic.html
+         */
+        std::shared_ptr<Topic> acquire_topic(std::shared_ptr<DomainParticipant> domain_participant,
+                                             const std::string &topic_name, const TypeSupport &type_support);
+
+        /**
+         * @brief Acquires a DDS Publisher shared by all provizio::dds publisher handles of the same DDS Domain
+         * Participant. The publisher is reference-counted, and deleted on destroying the last shared_ptr to it. All
+         * its DataWriters must be deleted by then.
+         *
+         * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+         * @return std::shared_ptr to the publisher, or nullptr if it can't be created
+         * @see https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/publisher/publisher/publisher.html
+         */
+        std::shared_ptr<Publisher> acquire_publisher(std::shared_ptr<DomainParticipant> domain_participant);
+
+        /**
+         * @brief Acquires a DDS Subscriber shared by all provizio::dds subscriber handles of the same DDS Domain
+         * Participant. The subscriber is reference-counted, and deleted on destroying the last shared_ptr to it. All
+         * its DataReaders must be deleted by then.
+         *
+         * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+         * @return std::shared_ptr to the subscriber, or nullptr if it can't be created
+         * @see https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/subscriber/subscriber/subscriber.html
+         */
+        std::shared_ptr<Subscriber> acquire_subscriber(std::shared_ptr<DomainParticipant> domain_participant);
+    } // namespace dds
+} // namespace provizio
+
+#endif // DDS_ENTITY_REGISTRY
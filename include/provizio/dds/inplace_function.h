@@ -0,0 +1,188 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DDS_INPLACE_FUNCTION
+#define DDS_INPLACE_FUNCTION
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace provizio
+{
+    namespace dds
+    {
+        /**
+         * @brief Default capacity of provizio::dds::inplace_function, enough for a lambda capturing a few pointers
+         */
+        constexpr std::size_t default_inplace_function_capacity = 4 * sizeof(void *);
+
+        template <typename signature, std::size_t capacity = default_inplace_function_capacity> class inplace_function;
+
+        /**
+         * @brief A type-erased function / function object stored in place, with no heap allocations, as a lightweight
+         * alternative to std::function. Passing it to provizio::dds::make_subscriber or make_publisher rather than a
+         * lambda makes all the subscribers / publishers of a data type share a single listener and handle type, which
+         * reduces the code size when there are many of them. Invoking it takes a single indirect call.
+         *
+         * @tparam result_type Result type of the function
+         * @tparam argument_types Argument types of the function
+         * @tparam capacity Max size of the stored function object, checked at compile time
+         * @see provizio::dds::data_callback
+         */
+        template <typename result_type, typename... argument_types, std::size_t capacity>
+        class inplace_function<result_type(argument_types...), capacity> final
+        {
+          public:
+            inplace_function() noexcept = default;
+
+            /**
+             * @brief Constructs an inplace_function storing a copy of a function / function object
+             *
+             * @param function A function / function object invocable with argument_types, not larger than capacity
+             */
+            template <typename function_type,
+                      typename stored_type = typename std::decay<function_type>::type,
+                      typename = typename std::enable_if<!std::is_same<stored_type, inplace_function>::value>::type>
+            inplace_function(function_type &&function) // NOLINT: implicit, as std::function
+            {
+                static_assert(sizeof(stored_type) <= capacity,
+                              "The function object is too large, increase the inplace_function capacity");
+                static_assert(alignof(stored_type) <= alignof(std::max_align_t),
+                              "The function object is over-aligned for inplace_function");
+                static_assert(std::is_copy_constructible<stored_type>::value,
+                              "inplace_function requires copy constructible function objects, as std::function");
+
+                new (&storage) stored_type(std::forward<function_type>(function));
+                invoker = &invoke<stored_type>;
+                manager = &manage<stored_type>;
+            }
+
+            inplace_function(const inplace_function &other) : invoker(other.invoker), manager(other.manager)
+            {
+                if (manager != nullptr)
+                {
+                    manager(operation::copy, &storage, &other.storage);
+                }
+            }
+
+            inplace_function(inplace_function &&other) noexcept : invoker(other.invoker), manager(other.manager)
+            {
+                if (manager != nullptr)
+                {
+                    manager(operation::move, &storage, &other.storage);
+                }
+            }
+
+            inplace_function &operator=(const inplace_function &other)
+            {
+                if (this != &other)
+                {
+                    inplace_function copy{other};
+                    *this = std::move(copy);
+                }
+                return *this;
+            }
+
+            inplace_function &operator=(inplace_function &&other) noexcept
+            {
+                if (this != &other)
+                {
+                    reset();
+                    invoker = other.invoker;
+                    manager = other.manager;
+                    if (manager != nullptr)
+                    {
+                        manager(operation::move, &storage, &other.storage);
+                    }
+                }
+                return *this;
+            }
+
+            ~inplace_function()
+            {
+                reset();
+            }
+
+            /**
+             * @brief Invokes the stored function, which must not be empty
+             */
+            result_type operator()(argument_types... arguments) const
+            {
+                return invoker(&storage, std::forward<argument_types>(arguments)...);
+            }
+
+            /**
+             * @return true if a function is stored, false if empty
+             */
+            explicit operator bool() const noexcept
+            {
+                return invoker != nullptr;
+            }
+
+          private:
+            enum class operation
+            {
+                copy,
+                move,
+                destroy
+            };
+
+            using storage_type = typename std::aligned_storage<capacity, alignof(std::max_align_t)>::type;
+
+            template <typename stored_type>
+            static result_type invoke(const storage_type *storage, argument_types... arguments)
+            {
+                // Invoked as non-const, as std::function
+                return (*const_cast<stored_type *>(reinterpret_cast<const stored_type *>(storage)))(
+                    std::forward<argument_types>(arguments)...);
+            }
+
+            template <typename stored_type>
+            static void manage(const operation kind, storage_type *destination, const storage_type *source)
+            {
+                auto *stored = const_cast<stored_type *>(reinterpret_cast<const stored_type *>(source));
+                switch (kind)
+                {
+                case operation::copy:
+                    new (destination) stored_type(*stored);
+                    break;
+                case operation::move:
+                    new (destination) stored_type(std::move(*stored));
+                    break;
+                case operation::destroy:
+                    stored->~stored_type();
+                    break;
+                }
+            }
+
+            void reset() noexcept
+            {
+                if (manager != nullptr)
+                {
+                    manager(operation::destroy, nullptr, &storage);
+                    invoker = nullptr;
+                    manager = nullptr;
+                }
+            }
+
+            storage_type storage;
+            result_type (*invoker)(const storage_type *, argument_types...) = nullptr;
+            void (*manager)(operation, storage_type *, const storage_type *) = nullptr;
+        };
+    } // namespace dds
+} // namespace provizio
+
+#endif // DDS_INPLACE_FUNCTION
@@ -0,0 +1,565 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DDS_INTRA_PROCESS
+#define DDS_INTRA_PROCESS
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "provizio/dds/common.h"
+#include "provizio/dds/publisher.h"
+#include "provizio/dds/sample_pool.h"
+#include "provizio/dds/subscriber.h"
+
+namespace provizio
+{
+    namespace dds
+    {
+        namespace detail
+        {
+            /**
+             * @brief Acquires the intra-process channel of a DDS Domain Participant and topic name, shared by all the
+             * intra-process publishers and subscribers of the topic. The channel is kept while any of them exists.
+             *
+             * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+             * @param topic_name A DDS Topic Name
+             * @param type_name DDS type name of the topic
+             * @param make_channel Creates a new channel if there is none yet
+             * @return std::shared_ptr to the channel, or nullptr if domain_participant is nullptr or the topic already
+             * has a channel of a different type
+             */
+            std::shared_ptr<void> acquire_intra_process_channel(
+                const std::shared_ptr<DomainParticipant> &domain_participant, const std::string &topic_name,
+                const std::string &type_name, std::shared_ptr<void> (*make_channel)());
+
+            /**
+             * @brief A function of an intra-process subscriber. It's never invoked concurrently, and never invoked
+             * again once cancelled. It's invoked with no lock held, so it may publish, including to its own topic.
+             * Samples delivered while it's being invoked are queued and passed to it by the invoking thread as soon as
+             * it returns, so delivering never waits for another thread, which could deadlock with functions publishing
+             * to each other's topics.
+             */
+            template <typename data_type> class intra_process_subscription final
+            {
+              public:
+                using function_type = std::function<void(const std::shared_ptr<const data_type> &)>;
+
+                explicit intra_process_subscription(function_type function) : function(std::move(function))
+                {
+                }
+
+                void deliver(const std::shared_ptr<const data_type> &sample)
+                {
+                    std::unique_lock<std::mutex> lock{mutex};
+                    if (!active)
+                    {
+                        return;
+                    }
+                    if (invoking_thread != std::thread::id{})
+                    {
+                        // Left to the invoking thread, which may be this one, publishing from the function
+                        pending.push_back(sample);
+                        return;
+                    }
+
+                    invoking_thread = std::this_thread::get_id();
+                    std::shared_ptr<const data_type> next = sample;
+                    while (next)
+                    {
+                        lock.unlock();
+                        function(next);
+                        lock.lock();
+
+                        next.reset();
+                        if (active && !pending.empty())
+                        {
+                            next = std::move(pending.front());
+                            pending.pop_front();
+                        }
+                    }
+                    pending.clear();
+                    invoking_thread = std::thread::id{};
+                    lock.unlock();
+                    idle.notify_all();
+                }
+
+                /**
+                 * @brief Waits for the function to return if it's being invoked by another thread, then disables it
+                 */
+                void cancel()
+                {
+                    std::unique_lock<std::mutex> lock{mutex};
+                    active = false;
+                    if (invoking_thread != std::this_thread::get_id())
+                    {
+                        idle.wait(lock, [this]() { return invoking_thread == std::thread::id{}; });
+                    }
+                    lock.unlock();
+                    idle.notify_all();
+                }
+
+              private:
+                std::mutex mutex;
+                std::condition_variable idle;
+                bool active = true;
+                std::thread::id invoking_thread;
+                std::deque<std::shared_ptr<const data_type>> pending;
+                function_type function;
+            };
+
+            /**
+             * @brief Intra-process subscriptions, DataReaders and DataWriters of a topic of a DDS Domain Participant
+             */
+            template <typename data_type> class intra_process_channel final
+            {
+              public:
+                using subscriptions_type = std::vector<std::shared_ptr<intra_process_subscription<data_type>>>;
+
+                void subscribe(std::shared_ptr<intra_process_subscription<data_type>> subscription)
+                {
+                    std::lock_guard<std::mutex> lock{mutex};
+                    auto updated = std::make_shared<subscriptions_type>(*subscriptions);
+                    updated->push_back(std::move(subscription));
+                    subscriptions = std::move(updated);
+                }
+
+                void unsubscribe(const intra_process_subscription<data_type> *subscription)
+                {
+                    std::lock_guard<std::mutex> lock{mutex};
+                    auto updated = std::make_shared<subscriptions_type>(*subscriptions);
+                    updated->erase(std::remove_if(updated->begin(), updated->end(),
+                                                  [subscription](const std::shared_ptr<
+                                                                 intra_process_subscription<data_type>> &next) {
+                                                      return next.get() == subscription;
+                                                  }),
+                                   updated->end());
+                    subscriptions = std::move(updated);
+                }
+
+                /**
+                 * @brief Delivers a sample to all the subscriptions in the calling thread, or queues it for the threads
+                 * already invoking them
+                 *
+                 * @return Number of subscriptions the sample was delivered to
+                 */
+                std::size_t deliver(const std::shared_ptr<const data_type> &sample) const
+                {
+                    // Delivered with no lock held, so the subscriptions can publish to the same topic
+                    std::shared_ptr<const subscriptions_type> current;
+                    {
+                        std::lock_guard<std::mutex> lock{mutex};
+                        current = subscriptions;
+                    }
+                    for (const auto &subscription : *current)
+                    {
+                        subscription->deliver(sample);
+                    }
+                    return current->size();
+                }
+
+                void add_reader(const InstanceHandle_t &reader)
+                {
+                    std::lock_guard<std::mutex> lock{mutex};
+                    readers.push_back(reader);
+                }
+
+                void remove_reader(const InstanceHandle_t &reader)
+                {
+                    std::lock_guard<std::mutex> lock{mutex};
+                    remove(readers, reader);
+                }
+
+                bool is_local_reader(const InstanceHandle_t &reader) const
+                {
+                    std::lock_guard<std::mutex> lock{mutex};
+                    return std::find(readers.begin(), readers.end(), reader) != readers.end();
+                }
+
+                void add_writer(const InstanceHandle_t &writer)
+                {
+                    std::lock_guard<std::mutex> lock{mutex};
+                    writers.push_back(writer);
+                }
+
+                void remove_writer(const InstanceHandle_t &writer)
+                {
+                    std::lock_guard<std::mutex> lock{mutex};
+                    remove(writers, writer);
+                }
+
+                bool is_local_writer(const InstanceHandle_t &writer) const
+                {
+                    std::lock_guard<std::mutex> lock{mutex};
+                    return std::find(writers.begin(), writers.end(), writer) != writers.end();
+                }
+
+              private:
+                static void remove(std::vector<InstanceHandle_t> &handles, const InstanceHandle_t &handle)
+                {
+                    const auto found = std::find(handles.begin(), handles.end(), handle);
+                    if (found != handles.end())
+                    {
+                        handles.erase(found);
+                    }
+                }
+
+                mutable std::mutex mutex;
+                // Replaced rather than modified, so a sample can be delivered while subscriptions change
+                std::shared_ptr<const subscriptions_type> subscriptions = std::make_shared<subscriptions_type>();
+                std::vector<InstanceHandle_t> readers;
+                std::vector<InstanceHandle_t> writers;
+            };
+
+            template <typename data_pub_sub_type>
+            std::shared_ptr<intra_process_channel<typename data_pub_sub_type::type>> acquire_intra_process_channel(
+                const std::shared_ptr<DomainParticipant> &domain_participant, const std::string &topic_name)
+            {
+                using channel_type = intra_process_channel<typename data_pub_sub_type::type>;
+                return std::static_pointer_cast<channel_type>(acquire_intra_process_channel(
+                    domain_participant, topic_name, data_pub_sub_type{}.getName(),
+                    []() -> std::shared_ptr<void> { return std::make_shared<channel_type>(); }));
+            }
+
+            /**
+             * @brief Receives the samples published by DataWriters other than the intra-process ones of the same
+             * channel, which are delivered to the subscription directly
+             */
+            template <typename data_type> class intra_process_data_listener final : public counting_data_reader_listener
+            {
+              public:
+                intra_process_data_listener(std::shared_ptr<intra_process_channel<data_type>> channel,
+                                            std::shared_ptr<intra_process_subscription<data_type>> subscription,
+                                            const std::size_t sample_pool_size = sample_pool<data_type>::default_size)
+                    : channel(std::move(channel)), subscription(std::move(subscription)), samples(sample_pool_size)
+                {
+                }
+
+                void on_data_available(DataReader *reader) override
+                {
+                    SampleInfo info;
+                    const auto sample = samples.acquire();
+                    if (reader->take_next_sample(sample.get().get(), &info) == ReturnCode_t::RETCODE_OK &&
+                        info.valid_data && !channel->is_local_writer(info.publication_handle))
+                    {
+                        counters.count_received(info.source_timestamp);
+                        counters.count_received_bytes(received_bytes(*sample.get()));
+                        detail::scoped_callback_timer timer{counters};
+                        subscription->deliver(std::shared_ptr<const data_type>{sample.get()});
+                    }
+                }
+
+              private:
+                std::shared_ptr<intra_process_channel<data_type>> channel;
+                std::shared_ptr<intra_process_subscription<data_type>> subscription;
+                sample_pool<data_type> samples;
+            };
+
+            template <typename data_type, typename on_data_function_type>
+            std::function<void(const std::shared_ptr<const data_type> &)> make_intra_process_function(
+                on_data_function_type on_data_function, std::true_type /*takes_shared_sample*/)
+            {
+                return on_data_function;
+            }
+
+            template <typename data_type, typename on_data_function_type>
+            std::function<void(const std::shared_ptr<const data_type> &)> make_intra_process_function(
+                on_data_function_type on_data_function, std::false_type /*takes_shared_sample*/)
+            {
+                return [on_data_function](const std::shared_ptr<const data_type> &sample) mutable {
+                    on_data_function(*sample);
+                };
+            }
+        } // namespace detail
+
+        /**
+         * @brief Publishes samples as shared_ptrs, passing them directly to the intra-process subscribers of the same
+         * DDS Domain Participant and topic, with no serialization, deserialization or copying. Samples are only
+         * published over DDS when other subscribers (f.e. in other processes) are matched. Normally created with
+         * provizio::dds::make_intra_process_publisher.
+         *
+         * @tparam data_pub_sub_type DDS data pub/sub type, f.e. sensor_msgs::msg::PointCloud2PubSubType
+         * @see provizio::dds::make_intra_process_publisher
+         * @see provizio::dds::intra_process_subscriber
+         */
+        template <typename data_pub_sub_type> class intra_process_publisher final
+        {
+          public:
+            using data_type = typename data_pub_sub_type::type;
+
+          public:
+            /**
+             * @brief Constructs a new intra_process_publisher object
+             *
+             * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+             * @param topic_name A DDS Topic Name
+             * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS
+             * DataWriter, as in provizio::dds::publisher_handle
+             * @param publish_mode Defines whether to publish over DDS synchronously or asynchronously, as defined in
+             * qos_defaults by default
+             */
+            intra_process_publisher(
+                const std::shared_ptr<DomainParticipant> &domain_participant, const std::string &topic_name,
+                ReliabilityQosPolicyKind reliability_kind =
+                    qos_defaults<data_pub_sub_type>::datawriter_reliability_kind,
+                const publish_mode_options &publish_mode = publish_mode_options::defaults<data_pub_sub_type>())
+                : channel(detail::acquire_intra_process_channel<data_pub_sub_type>(domain_participant, topic_name)),
+                  publisher(domain_participant, topic_name, reliability_kind, publish_mode)
+            {
+                if (channel)
+                {
+                    channel->add_writer(publisher.instance_handle());
+                }
+            }
+
+            ~intra_process_publisher()
+            {
+                if (channel)
+                {
+                    channel->remove_writer(publisher.instance_handle());
+                }
+            }
+
+            intra_process_publisher(const intra_process_publisher &) = delete;
+            intra_process_publisher &operator=(const intra_process_publisher &) = delete;
+
+            /**
+             * @brief Delivers the sample to the intra-process subscribers in the calling thread (or queues it for the
+             * threads already invoking their functions), then publishes it over DDS if any other subscribers are
+             * matched. The sample must not be modified afterwards, as the subscribers may retain it.
+             *
+             * @param sample Actual DDS data to be published
+             * @return true if published successfully, false otherwise
+             */
+            bool publish(const std::shared_ptr<const data_type> &sample)
+            {
+                if (!sample || !channel)
+                {
+                    return false;
+                }
+
+                delivered.fetch_add(channel->deliver(sample), std::memory_order_relaxed);
+                if (!has_remote_subscribers())
+                {
+                    return true;
+                }
+
+                // DDS DataWriters only read the samples they write
+                return publisher.publish(const_cast<data_type &>(*sample));
+            }
+
+            /**
+             * @return true if any subscribers other than the intra-process ones of the same DDS Domain Participant are
+             * matched, so that the samples are also published over DDS
+             */
+            bool has_remote_subscribers() const
+            {
+                const auto &local_channel = channel;
+                return publisher.any_matched_subscription([&local_channel](const InstanceHandle_t &reader) {
+                    return !local_channel->is_local_reader(reader);
+                });
+            }
+
+            /**
+             * @return Number of deliveries to intra-process subscribers, one per sample per subscriber
+             */
+            std::uint64_t intra_process_deliveries() const noexcept
+            {
+                return delivered.load(std::memory_order_relaxed);
+            }
+
+            /**
+             * @return The instance handle of the DDS DataWriter, or HANDLE_NIL if it or the intra-process channel
+             * couldn't be created
+             */
+            InstanceHandle_t instance_handle() const
+            {
+                return channel ? publisher.instance_handle() : HANDLE_NIL;
+            }
+
+            /**
+             * @return A snapshot of the counters of publishing over DDS
+             */
+            publisher_metrics metrics() const
+            {
+                return publisher.metrics();
+            }
+
+          private:
+            std::shared_ptr<detail::intra_process_channel<data_type>> channel;
+            publisher_handle<data_pub_sub_type> publisher;
+            std::atomic<std::uint64_t> delivered{0};
+        };
+
+        /**
+         * @brief Receives samples of a topic both from the intra-process publishers of the same DDS Domain Participant,
+         * as shared_ptrs with no deserialization or copying, and over DDS from any other publishers. Normally created
+         * with provizio::dds::make_intra_process_subscriber.
+         *
+         * @tparam data_pub_sub_type DDS data pub/sub type, f.e. sensor_msgs::msg::PointCloud2PubSubType
+         * @see provizio::dds::make_intra_process_subscriber
+         * @see provizio::dds::intra_process_publisher
+         */
+        template <typename data_pub_sub_type> class intra_process_subscriber final
+        {
+          public:
+            using data_type = typename data_pub_sub_type::type;
+
+          public:
+            /**
+             * @brief Constructs a new intra_process_subscriber object
+             *
+             * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+             * @param topic_name A DDS Topic Name
+             * @param on_data_function Function to be invoked on receiving data, never concurrently. Intra-process
+             * samples are delivered in the publishing thread, others in the Fast-DDS listener thread, unless the
+             * function is being invoked by another thread, which then also invokes it with the samples delivered
+             * meanwhile.
+             * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS
+             * DataReader, as in provizio::dds::subscriber_handle
+             */
+            intra_process_subscriber(
+                const std::shared_ptr<DomainParticipant> &domain_participant, const std::string &topic_name,
+                typename detail::intra_process_subscription<data_type>::function_type on_data_function,
+                ReliabilityQosPolicyKind reliability_kind =
+                    qos_defaults<data_pub_sub_type>::datareader_reliability_kind)
+                : channel(detail::acquire_intra_process_channel<data_pub_sub_type>(domain_participant, topic_name)),
+                  subscription(subscribe(channel, std::move(on_data_function))),
+                  subscriber(domain_participant, topic_name,
+                             channel ? std::make_shared<detail::intra_process_data_listener<data_type>>(channel,
+                                                                                                         subscription)
+                                     : nullptr,
+                             reliability_kind)
+            {
+                // Until the DataReader is known to be local, intra-process publishers publish over DDS too, with such
+                // duplicates ignored by the listener
+                if (channel)
+                {
+                    channel->add_reader(subscriber.instance_handle());
+                }
+            }
+
+            ~intra_process_subscriber()
+            {
+                if (channel)
+                {
+                    channel->unsubscribe(subscription.get());
+                    subscription->cancel();
+                    channel->remove_reader(subscriber.instance_handle());
+                }
+            }
+
+            intra_process_subscriber(const intra_process_subscriber &) = delete;
+            intra_process_subscriber &operator=(const intra_process_subscriber &) = delete;
+
+            /**
+             * @return The instance handle of the DDS DataReader, or HANDLE_NIL if it or the intra-process channel
+             * couldn't be created
+             */
+            InstanceHandle_t instance_handle() const
+            {
+                return channel ? subscriber.instance_handle() : HANDLE_NIL;
+            }
+
+            /**
+             * @return A snapshot of the counters of receiving over DDS
+             */
+            subscriber_metrics metrics() const
+            {
+                return subscriber.metrics();
+            }
+
+          private:
+            static std::shared_ptr<detail::intra_process_subscription<data_type>> subscribe(
+                const std::shared_ptr<detail::intra_process_channel<data_type>> &channel,
+                typename detail::intra_process_subscription<data_type>::function_type on_data_function)
+            {
+                auto subscription =
+                    std::make_shared<detail::intra_process_subscription<data_type>>(std::move(on_data_function));
+                if (channel)
+                {
+                    channel->subscribe(subscription);
+                }
+                return subscription;
+            }
+
+            std::shared_ptr<detail::intra_process_channel<data_type>> channel;
+            std::shared_ptr<detail::intra_process_subscription<data_type>> subscription;
+            subscriber_handle<data_pub_sub_type> subscriber;
+        };
+
+        /**
+         * @brief Creates a new intra_process_publisher object as a shared_ptr
+         *
+         * @tparam data_pub_sub_type DDS data pub/sub type, f.e. sensor_msgs::msg::PointCloud2PubSubType
+         * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+         * @param topic_name A DDS Topic Name
+         * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS DataWriter
+         * @param publish_mode Defines whether to publish over DDS synchronously or asynchronously
+         * @return std::shared_ptr to the created intra_process_publisher, nullptr if its DDS DataWriter or
+         * intra-process channel couldn't be created
+         * @see provizio::dds::intra_process_publisher
+         */
+        template <typename data_pub_sub_type>
+        std::shared_ptr<intra_process_publisher<data_pub_sub_type>> make_intra_process_publisher(
+            const std::shared_ptr<DomainParticipant> &domain_participant, const std::string &topic_name,
+            ReliabilityQosPolicyKind reliability_kind = qos_defaults<data_pub_sub_type>::datawriter_reliability_kind,
+            const publish_mode_options &publish_mode = publish_mode_options::defaults<data_pub_sub_type>())
+        {
+            return detail::created_or_null(std::make_shared<intra_process_publisher<data_pub_sub_type>>(
+                domain_participant, topic_name, reliability_kind, publish_mode));
+        }
+
+        /**
+         * @brief Creates a new intra_process_subscriber object as a shared_ptr
+         *
+         * @tparam data_pub_sub_type DDS data pub/sub type, f.e. sensor_msgs::msg::PointCloud2PubSubType
+         * @tparam on_data_function_type Type of a function / function object to be invoked on receiving data, takes a
+         * const reference to the data type or a std::shared_ptr to the const data type, as in
+         * provizio::dds::make_subscriber
+         * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+         * @param topic_name A DDS Topic Name
+         * @param on_data_function Function / function object to be invoked on receiving data, never concurrently
+         * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS DataReader
+         * @return std::shared_ptr to the created intra_process_subscriber, nullptr if its DDS DataReader or
+         * intra-process channel couldn't be created
+         * @see provizio::dds::intra_process_subscriber
+         */
+        template <typename data_pub_sub_type, typename on_data_function_type>
+        std::shared_ptr<intra_process_subscriber<data_pub_sub_type>> make_intra_process_subscriber(
+            const std::shared_ptr<DomainParticipant> &domain_participant, const std::string &topic_name,
+            on_data_function_type on_data_function,
+            ReliabilityQosPolicyKind reliability_kind = qos_defaults<data_pub_sub_type>::datareader_reliability_kind)
+        {
+            using data_type = typename data_pub_sub_type::type;
+            return detail::created_or_null(std::make_shared<intra_process_subscriber<data_pub_sub_type>>(
+                domain_participant, topic_name,
+                detail::make_intra_process_function<data_type>(
+                    std::move(on_data_function), detail::takes_shared_sample<on_data_function_type, data_type>{}),
+                reliability_kind));
+        }
+    } // namespace dds
+} // namespace provizio
+
+#endif // DDS_INTRA_PROCESS
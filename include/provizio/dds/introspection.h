@@ -0,0 +1,235 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DDS_INTROSPECTION
+#define DDS_INTROSPECTION
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <fastdds/dds/domain/DomainParticipant.hpp>
+#include <fastdds/dds/publisher/DataWriter.hpp>
+#include <fastdds/dds/subscriber/DataReader.hpp>
+
+#include "provizio/dds/common.h"
+#include "provizio/dds/metrics.h"
+
+namespace provizio
+{
+    namespace dds
+    {
+        /**
+         * @brief Kind of a provizio::dds handle listed by provizio::dds::introspect
+         */
+        enum class entity_kind
+        {
+            publisher,
+            subscriber
+        };
+
+        /**
+         * @brief Topic-level traffic statistics and memory accounting of a single publisher or subscriber handle
+         *
+         * @see provizio::dds::introspect
+         */
+        struct entity_report
+        {
+            /**
+             * @brief Identifier of the handle, unique in the process for its lifetime
+             */
+            std::uint64_t id = 0;
+
+            entity_kind kind = entity_kind::publisher;
+            std::string topic_name;
+            std::string type_name;
+
+            /**
+             * @brief Number of currently matched subscriptions of a publisher or publications of a subscriber
+             */
+            std::int32_t matched = 0;
+
+            /**
+             * @brief Transports of the participant, f.e. "shm+udpv4", prefixed with "data_sharing+" if data sharing is
+             * enabled for the DataWriter or DataReader, in which case same-host peers may bypass the transports
+             */
+            std::string transport;
+
+            /**
+             * @brief Number of samples the history reserves on creation, i.e. the resource limits allocated_samples
+             */
+            std::uint64_t history_samples = 0;
+
+            /**
+             * @brief Maximum serialized size of a sample of the type, in bytes, as reported by its TopicDataType. For
+             * types with unbounded strings or sequences it's an estimate based on default bounds rather than a limit,
+             * so actual samples, and so the history pool, may be larger.
+             */
+            std::uint64_t max_sample_bytes = 0;
+
+            /**
+             * @brief Estimated size of the history pool, in bytes: history_samples of max_sample_bytes each. Pools of
+             * PREALLOCATED_WITH_REALLOC_MEMORY_MODE may grow beyond it, up to the resource limits max_samples.
+             */
+            std::uint64_t history_bytes = 0;
+
+            /**
+             * @brief Total number of samples published or received
+             *
+             * @see provizio::dds::publisher_metrics::published
+             * @see provizio::dds::subscriber_metrics::received
+             */
+            std::uint64_t samples = 0;
+
+            /**
+             * @brief Total serialized size of the samples published or received, in bytes. Only counted for data types
+             * that are not plain once enabled for the handle.
+             *
+             * @see provizio::dds::publisher_metrics::published_bytes
+             * @see provizio::dds::subscriber_metrics::received_bytes
+             */
+            std::uint64_t bytes = 0;
+
+            /**
+             * @brief Rate of samples since the handle creation, or since the previous report of the same
+             * provizio::dds::introspector
+             */
+            double samples_per_second = 0.0;
+
+            /**
+             * @brief Rate of bytes since the handle creation, or since the previous report of the same
+             * provizio::dds::introspector
+             */
+            double bytes_per_second = 0.0;
+        };
+
+        /**
+         * @brief Reports of all the publisher and subscriber handles of a DDS Domain Participant
+         *
+         * @see provizio::dds::introspect
+         */
+        struct participant_report
+        {
+            std::vector<entity_report> entities;
+        };
+
+        /**
+         * @brief Lists every publisher and subscriber handle created with a DDS Domain Participant, f.e. to find the
+         * topics using most of the memory or the bandwidth, or to size qos_defaults resource limits from real data.
+         * Thread-safe. Rates are averaged since the creation of each handle, see provizio::dds::introspector for
+         * rates since the previous report.
+         *
+         * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+         * @return Reports of the handles, ordered by creation, with no entities if domain_participant is nullptr
+         * @see provizio::dds::to_json
+         * @see provizio::dds::to_prometheus
+         */
+        participant_report introspect(const std::shared_ptr<DomainParticipant> &domain_participant);
+
+        /**
+         * @brief Reports the handles of a DDS Domain Participant periodically, f.e. for a monitoring loop, measuring
+         * rates since its own previous report. Separate introspectors of the same participant don't affect each
+         * other's rates. Thread-safe.
+         *
+         * @see provizio::dds::introspect
+         */
+        class introspector final
+        {
+          public:
+            /**
+             * @brief Constructs a new introspector object
+             *
+             * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+             */
+            explicit introspector(std::shared_ptr<DomainParticipant> domain_participant);
+
+            /**
+             * @brief Reports the handles of the participant, as provizio::dds::introspect does
+             *
+             * @return Reports of the handles, with rates since the previous report, or since the handle creation for
+             * handles not reported before
+             */
+            participant_report introspect();
+
+          private:
+            struct measurement
+            {
+                std::chrono::steady_clock::time_point measured;
+                std::uint64_t samples = 0;
+                std::uint64_t bytes = 0;
+            };
+
+            std::shared_ptr<DomainParticipant> domain_participant;
+            std::mutex mutex;
+            std::map<std::uint64_t, measurement> measurements;
+        };
+
+        /**
+         * @brief Formats a participant_report as a JSON object, with an "entities" array of the handles' reports
+         *
+         * @param report The report to format
+         * @return JSON text
+         */
+        std::string to_json(const participant_report &report);
+
+        /**
+         * @brief Formats a participant_report as Prometheus text exposition format, with provizio_dds_* metrics
+         * labelled by the id, kind, topic, type and transport of each handle
+         *
+         * @param report The report to format
+         * @return Prometheus text
+         * @see https://prometheus.io/docs/instrumenting/exposition_formats/
+         */
+        std::string to_prometheus(const participant_report &report);
+
+        namespace detail
+        {
+            /**
+             * @brief Registers a DataWriter of a publisher handle to be listed by provizio::dds::introspect
+             *
+             * @param domain_participant The participant of the DataWriter
+             * @param data_writer The DataWriter, which must stay alive until it's unregistered
+             * @param metrics Returns the counters of the publisher, invoked while listing it
+             * @return Identifier to unregister it with, 0 if data_writer is nullptr
+             */
+            std::uint64_t register_introspected(const std::shared_ptr<DomainParticipant> &domain_participant,
+                                                DataWriter *data_writer, std::function<publisher_metrics()> metrics);
+
+            /**
+             * @brief Registers a DataReader of a subscriber handle to be listed by provizio::dds::introspect
+             *
+             * @param domain_participant The participant of the DataReader
+             * @param data_reader The DataReader, which must stay alive until it's unregistered
+             * @param metrics Returns the counters of the subscriber, invoked while listing it
+             * @return Identifier to unregister it with, 0 if data_reader is nullptr
+             */
+            std::uint64_t register_introspected(const std::shared_ptr<DomainParticipant> &domain_participant,
+                                                DataReader *data_reader, std::function<subscriber_metrics()> metrics);
+
+            /**
+             * @brief Unregisters a DataWriter or DataReader, waiting for an ongoing introspection to finish with it
+             *
+             * @param id Identifier returned by register_introspected, ignored if 0
+             */
+            void unregister_introspected(std::uint64_t id);
+        } // namespace detail
+    } // namespace dds
+} // namespace provizio
+
+#endif // DDS_INTROSPECTION
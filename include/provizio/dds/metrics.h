@@ -0,0 +1,355 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DDS_METRICS
+#define DDS_METRICS
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include <fastdds/rtps/common/Time_t.h>
+
+namespace provizio
+{
+    namespace dds
+    {
+        /**
+         * @brief A snapshot of a latency_histogram
+         */
+        struct latency_histogram_snapshot
+        {
+            /**
+             * @brief Number of buckets. Bucket 0 counts durations below 2 microseconds, bucket i counts durations in
+             * [2^i, 2^(i+1)) microseconds, and the last bucket also counts all longer durations.
+             */
+            static constexpr std::size_t bucket_count = 24;
+
+            std::array<std::uint64_t, bucket_count> buckets{};
+            std::uint64_t count = 0;
+            std::chrono::nanoseconds total{0};
+            std::chrono::nanoseconds max{0};
+
+            /**
+             * @return Mean duration, 0 if nothing has been recorded
+             */
+            std::chrono::nanoseconds mean() const noexcept
+            {
+                return count > 0 ? total / static_cast<std::int64_t>(count) : std::chrono::nanoseconds{0};
+            }
+
+            /**
+             * @brief Estimates a percentile as the upper bound of the bucket it falls into
+             *
+             * @param fraction Percentile as a fraction, f.e. 0.99 for p99
+             * @return Estimated percentile duration, 0 if nothing has been recorded
+             */
+            std::chrono::nanoseconds percentile(const double fraction) const noexcept
+            {
+                const auto rank = static_cast<std::uint64_t>(fraction * static_cast<double>(count));
+                std::uint64_t accumulated = 0;
+                for (std::size_t i = 0; i < bucket_count; ++i)
+                {
+                    accumulated += buckets[i];
+                    if (accumulated > rank || (accumulated == count && accumulated > 0))
+                    {
+                        return i + 1 < bucket_count ? bucket_upper_bound(i) : max;
+                    }
+                }
+                return std::chrono::nanoseconds{0};
+            }
+
+            /**
+             * @return The exclusive upper bound of a bucket
+             */
+            static std::chrono::nanoseconds bucket_upper_bound(const std::size_t bucket) noexcept
+            {
+                return std::chrono::microseconds{std::int64_t{2} << bucket};
+            }
+        };
+
+        /**
+         * @brief Lock-free histogram of durations with logarithmic buckets, for the counters to be always on with
+         * negligible overhead
+         */
+        class latency_histogram final
+        {
+          public:
+            void record(const std::chrono::nanoseconds duration) noexcept
+            {
+                const std::int64_t nanoseconds = duration.count() > 0 ? duration.count() : 0;
+
+                std::size_t bucket = 0;
+                for (std::int64_t microseconds = nanoseconds / 1000;
+                     microseconds > 1 && bucket + 1 < latency_histogram_snapshot::bucket_count; microseconds >>= 1)
+                {
+                    ++bucket;
+                }
+
+                buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+                count.fetch_add(1, std::memory_order_relaxed);
+                total_ns.fetch_add(nanoseconds, std::memory_order_relaxed);
+                std::int64_t current_max = max_ns.load(std::memory_order_relaxed);
+                while (current_max < nanoseconds &&
+                       !max_ns.compare_exchange_weak(current_max, nanoseconds, std::memory_order_relaxed))
+                {
+                }
+            }
+
+            latency_histogram_snapshot snapshot() const noexcept
+            {
+                latency_histogram_snapshot result;
+                for (std::size_t i = 0; i < latency_histogram_snapshot::bucket_count; ++i)
+                {
+                    result.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+                }
+                result.count = count.load(std::memory_order_relaxed);
+                result.total = std::chrono::nanoseconds{total_ns.load(std::memory_order_relaxed)};
+                result.max = std::chrono::nanoseconds{max_ns.load(std::memory_order_relaxed)};
+                return result;
+            }
+
+          private:
+            std::array<std::atomic<std::uint64_t>, latency_histogram_snapshot::bucket_count> buckets{};
+            std::atomic<std::uint64_t> count{0};
+            std::atomic<std::int64_t> total_ns{0};
+            std::atomic<std::int64_t> max_ns{0};
+        };
+
+        /**
+         * @brief A snapshot of the counters of a publisher
+         *
+         * @see provizio::dds::publisher_handle::metrics
+         */
+        struct publisher_metrics
+        {
+            /**
+             * @brief Number of samples successfully written (or queued, in asynchronous publish mode)
+             */
+            std::uint64_t published = 0;
+
+            /**
+             * @brief Total serialized size of the published samples, in bytes. Only counted for data types that are
+             * not plain once enabled with provizio::dds::publisher_handle::count_published_bytes, as it takes
+             * computing the serialized size of every sample.
+             */
+            std::uint64_t published_bytes = 0;
+
+            /**
+             * @brief Number of samples that failed to be written
+             */
+            std::uint64_t write_failures = 0;
+
+            /**
+             * @brief Number of missed deadlines offered by the DataWriter, if a DeadlineQosPolicy is set
+             */
+            std::uint64_t deadlines_missed = 0;
+        };
+
+        /**
+         * @brief A snapshot of the counters of a subscriber
+         *
+         * @see provizio::dds::subscriber_handle::metrics
+         */
+        struct subscriber_metrics
+        {
+            /**
+             * @brief Number of valid samples received
+             */
+            std::uint64_t received = 0;
+
+            /**
+             * @brief Total serialized size of the received samples, in bytes. Only counted for data types that are
+             * not plain once enabled with provizio::dds::subscriber_handle::count_received_bytes, as it takes
+             * computing the serialized size of every sample. Always counted by raw subscribers (see
+             * provizio::dds::make_raw_subscriber).
+             */
+            std::uint64_t received_bytes = 0;
+
+            /**
+             * @brief Number of samples lost, i.e. never received, as reported by Fast-DDS
+             */
+            std::uint64_t samples_lost = 0;
+
+            /**
+             * @brief Number of samples rejected, f.e. due to resource limits, as reported by Fast-DDS
+             */
+            std::uint64_t samples_rejected = 0;
+
+            /**
+             * @brief Number of missed deadlines requested by the DataReader, if a DeadlineQosPolicy is set
+             */
+            std::uint64_t deadlines_missed = 0;
+
+            /**
+             * @brief End-to-end latency, from the source timestamp of a sample to taking it from the DataReader. Only
+             * meaningful when publisher and subscriber clocks are synchronized.
+             */
+            latency_histogram_snapshot latency;
+
+            /**
+             * @brief Duration of the subscriber function invocations
+             */
+            latency_histogram_snapshot callback_duration;
+        };
+
+        namespace detail
+        {
+            /**
+             * @brief Lock-free counters of a publisher
+             */
+            class publisher_counters final
+            {
+              public:
+                void count_published(const std::uint32_t bytes) noexcept
+                {
+                    published.fetch_add(1, std::memory_order_relaxed);
+                    published_bytes.fetch_add(bytes, std::memory_order_relaxed);
+                }
+
+                void count_write_failure() noexcept
+                {
+                    write_failures.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                void count_deadlines_missed(const std::int32_t change) noexcept
+                {
+                    deadlines_missed.fetch_add(change > 0 ? static_cast<std::uint64_t>(change) : 0,
+                                               std::memory_order_relaxed);
+                }
+
+                publisher_metrics snapshot() const noexcept
+                {
+                    publisher_metrics result;
+                    result.published = published.load(std::memory_order_relaxed);
+                    result.published_bytes = published_bytes.load(std::memory_order_relaxed);
+                    result.write_failures = write_failures.load(std::memory_order_relaxed);
+                    result.deadlines_missed = deadlines_missed.load(std::memory_order_relaxed);
+                    return result;
+                }
+
+              private:
+                std::atomic<std::uint64_t> published{0};
+                std::atomic<std::uint64_t> published_bytes{0};
+                std::atomic<std::uint64_t> write_failures{0};
+                std::atomic<std::uint64_t> deadlines_missed{0};
+            };
+
+            /**
+             * @brief Lock-free counters of a subscriber
+             */
+            class subscriber_counters final
+            {
+              public:
+                /**
+                 * @brief Counts a received sample and records its end-to-end latency from its source timestamp
+                 */
+                void count_received(const eprosima::fastrtps::rtps::Time_t &source_timestamp) noexcept
+                {
+                    received.fetch_add(1, std::memory_order_relaxed);
+
+                    // Fast-DDS timestamps are based on the system clock
+                    const std::int64_t source_ns = source_timestamp.to_ns();
+                    if (source_ns > 0)
+                    {
+                        const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::system_clock::now().time_since_epoch());
+                        latency.record(now - std::chrono::nanoseconds{source_ns});
+                    }
+                }
+
+                void count_received_bytes(const std::size_t bytes) noexcept
+                {
+                    received_bytes.fetch_add(bytes, std::memory_order_relaxed);
+                }
+
+                void count_callback(const std::chrono::nanoseconds duration) noexcept
+                {
+                    callback_duration.record(duration);
+                }
+
+                void count_samples_lost(const std::int32_t change) noexcept
+                {
+                    add(samples_lost, change);
+                }
+
+                void count_samples_rejected(const std::int64_t change) noexcept
+                {
+                    add(samples_rejected, change);
+                }
+
+                void count_deadlines_missed(const std::int32_t change) noexcept
+                {
+                    add(deadlines_missed, change);
+                }
+
+                subscriber_metrics snapshot() const noexcept
+                {
+                    subscriber_metrics result;
+                    result.received = received.load(std::memory_order_relaxed);
+                    result.received_bytes = received_bytes.load(std::memory_order_relaxed);
+                    result.samples_lost = samples_lost.load(std::memory_order_relaxed);
+                    result.samples_rejected = samples_rejected.load(std::memory_order_relaxed);
+                    result.deadlines_missed = deadlines_missed.load(std::memory_order_relaxed);
+                    result.latency = latency.snapshot();
+                    result.callback_duration = callback_duration.snapshot();
+                    return result;
+                }
+
+              private:
+                static void add(std::atomic<std::uint64_t> &counter, const std::int64_t change) noexcept
+                {
+                    counter.fetch_add(change > 0 ? static_cast<std::uint64_t>(change) : 0, std::memory_order_relaxed);
+                }
+
+                std::atomic<std::uint64_t> received{0};
+                std::atomic<std::uint64_t> received_bytes{0};
+                std::atomic<std::uint64_t> samples_lost{0};
+                std::atomic<std::uint64_t> samples_rejected{0};
+                std::atomic<std::uint64_t> deadlines_missed{0};
+                latency_histogram latency;
+                latency_histogram callback_duration;
+            };
+
+            /**
+             * @brief Measures the duration of the scope, f.e. of a subscriber function invocation
+             */
+            class scoped_callback_timer final
+            {
+              public:
+                explicit scoped_callback_timer(subscriber_counters &counters)
+                    : counters(counters), started(std::chrono::steady_clock::now())
+                {
+                }
+
+                ~scoped_callback_timer()
+                {
+                    counters.count_callback(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - started));
+                }
+
+                scoped_callback_timer(const scoped_callback_timer &) = delete;
+                scoped_callback_timer &operator=(const scoped_callback_timer &) = delete;
+
+              private:
+                subscriber_counters &counters;
+                const std::chrono::steady_clock::time_point started;
+            };
+        } // namespace detail
+    } // namespace dds
+} // namespace provizio
+
+#endif // DDS_METRICS
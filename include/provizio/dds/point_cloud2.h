@@ -0,0 +1,1289 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DDS_POINT_CLOUD2
+#define DDS_POINT_CLOUD2
+
+#include <algorithm>
+#include <cstddef>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <sensor_msgs/msg/PointCloud2.h>
+
+namespace provizio
+{
+    namespace dds
+    {
+        /**
+         * @brief Data types of sensor_msgs::msg::PointField, as in sensor_msgs/msg/PointField.msg
+         *
+         * @see https://docs.ros2.org/latest/api/sensor_msgs/msg/PointField.html
+         */
+        enum class point_field_datatype : std::uint8_t
+        {
+            int8 = 1,
+            uint8 = 2,
+            int16 = 3,
+            uint16 = 4,
+            int32 = 5,
+            uint32 = 6,
+            float32 = 7,
+            float64 = 8
+        };
+
+        /**
+         * @brief Maps a C++ type to its point_field_datatype, specialized for all supported types
+         */
+        template <typename field_value_type> struct point_field_datatype_of;
+
+        template <> struct point_field_datatype_of<std::int8_t>
+        {
+            static constexpr point_field_datatype value = point_field_datatype::int8;
+        };
+
+        template <> struct point_field_datatype_of<std::uint8_t>
+        {
+            static constexpr point_field_datatype value = point_field_datatype::uint8;
+        };
+
+        template <> struct point_field_datatype_of<std::int16_t>
+        {
+            static constexpr point_field_datatype value = point_field_datatype::int16;
+        };
+
+        template <> struct point_field_datatype_of<std::uint16_t>
+        {
+            static constexpr point_field_datatype value = point_field_datatype::uint16;
+        };
+
+        template <> struct point_field_datatype_of<std::int32_t>
+        {
+            static constexpr point_field_datatype value = point_field_datatype::int32;
+        };
+
+        template <> struct point_field_datatype_of<std::uint32_t>
+        {
+            static constexpr point_field_datatype value = point_field_datatype::uint32;
+        };
+
+        template <> struct point_field_datatype_of<float>
+        {
+            static constexpr point_field_datatype value = point_field_datatype::float32;
+        };
+
+        template <> struct point_field_datatype_of<double>
+        {
+            static constexpr point_field_datatype value = point_field_datatype::float64;
+        };
+
+        /**
+         * @return Size of a single value of a point_field_datatype in bytes, 0 if not a valid datatype
+         */
+        inline std::size_t point_field_datatype_size(const point_field_datatype datatype) noexcept
+        {
+            switch (datatype)
+            {
+            case point_field_datatype::int8:
+            case point_field_datatype::uint8:
+                return 1;
+
+            case point_field_datatype::int16:
+            case point_field_datatype::uint16:
+                return 2;
+
+            case point_field_datatype::int32:
+            case point_field_datatype::uint32:
+            case point_field_datatype::float32:
+                return 4;
+
+            case point_field_datatype::float64:
+                return 8;
+
+            default:
+                return 0;
+            }
+        }
+
+        /**
+         * @brief Finds a field of a point cloud by name
+         *
+         * @return The field, or nullptr if the cloud has no such field
+         */
+        inline const sensor_msgs::msg::PointField *find_point_field(const sensor_msgs::msg::PointCloud2 &cloud,
+                                                                    const std::string &name) noexcept
+        {
+            for (const auto &field : cloud.fields())
+            {
+                if (field.name() == name)
+                {
+                    return &field;
+                }
+            }
+            return nullptr;
+        }
+
+        namespace detail
+        {
+            inline bool is_host_big_endian() noexcept
+            {
+                const std::uint16_t value = 1;
+                std::uint8_t first_byte = 0;
+                std::memcpy(&first_byte, &value, 1);
+                return first_byte == 0;
+            }
+
+            // Point data is not necessarily aligned, so it's always accessed through memcpy, which the compilers
+            // reduce to a plain (unaligned) load / store
+            template <typename value_type> value_type load(const std::uint8_t *address) noexcept
+            {
+                value_type value;
+                std::memcpy(&value, address, sizeof(value_type));
+                return value;
+            }
+
+            template <typename value_type> void store(std::uint8_t *address, const value_type value) noexcept
+            {
+                std::memcpy(address, &value, sizeof(value_type));
+            }
+
+            template <typename value_type> value_type load_swapped(const std::uint8_t *address) noexcept
+            {
+                std::uint8_t bytes[sizeof(value_type)];
+                for (std::size_t i = 0; i < sizeof(value_type); ++i)
+                {
+                    bytes[i] = address[sizeof(value_type) - 1 - i];
+                }
+                return load<value_type>(bytes);
+            }
+
+            /**
+             * @brief Converts count values of a field of source_type spaced by step bytes into a contiguous array.
+             * Kept as a separate tight loop per source type, so compilers can vectorize it.
+             */
+            template <typename source_type, typename output_type>
+            void convert_field(const std::uint8_t *first, const std::size_t step, const std::size_t count,
+                               const bool swap_bytes, output_type *output) noexcept
+            {
+                if (swap_bytes && sizeof(source_type) > 1)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        output[i] = static_cast<output_type>(load_swapped<source_type>(first + i * step));
+                    }
+                }
+                else if (std::is_same<source_type, output_type>::value && step == sizeof(source_type))
+                {
+                    std::memcpy(static_cast<void *>(output), first, count * sizeof(output_type));
+                }
+                else
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        output[i] = static_cast<output_type>(load<source_type>(first + i * step));
+                    }
+                }
+            }
+
+            /**
+             * @return Number of points in the cloud which data actually holds, so corrupted clouds are never read
+             * beyond their data
+             */
+            inline std::size_t available_points(const sensor_msgs::msg::PointCloud2 &cloud,
+                                                const std::size_t end_offset) noexcept
+            {
+                const std::size_t points = static_cast<std::size_t>(cloud.width()) * cloud.height();
+                const std::size_t step = cloud.point_step();
+                const std::size_t data_size = cloud.data().size();
+                if (points == 0 || step == 0 || data_size < end_offset)
+                {
+                    return 0;
+                }
+
+                const std::size_t available = (data_size - end_offset) / step + 1;
+                return available < points ? available : points;
+            }
+        } // namespace detail
+
+        /**
+         * @brief A reference to a single value of a point field in a mutable point cloud, as returned by
+         * provizio::dds::mutable_point_field_view
+         *
+         * @tparam field_value_type C++ type of the field, f.e. float for point_field_datatype::float32
+         */
+        template <typename field_value_type> class point_field_reference final
+        {
+          public:
+            explicit point_field_reference(std::uint8_t *address) noexcept : address(address)
+            {
+            }
+
+            point_field_reference(const point_field_reference &) noexcept = default;
+
+            operator field_value_type() const noexcept
+            {
+                return detail::load<field_value_type>(address);
+            }
+
+            point_field_reference &operator=(const field_value_type value) noexcept
+            {
+                detail::store(address, value);
+                return *this;
+            }
+
+            point_field_reference &operator=(const point_field_reference &other) noexcept
+            {
+                return *this = static_cast<field_value_type>(other);
+            }
+
+          private:
+            std::uint8_t *address;
+        };
+
+        /**
+         * @brief A random access iterator over the values of a single field of all points of a point cloud, i.e.
+         * spaced by the point step of the cloud
+         *
+         * @tparam field_value_type C++ type of the field, f.e. float for point_field_datatype::float32
+         * @tparam byte_type const std::uint8_t for read-only access, std::uint8_t for mutable access
+         */
+        template <typename field_value_type, typename byte_type> class point_field_iterator final
+        {
+          public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = field_value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = typename std::conditional<std::is_const<byte_type>::value, field_value_type,
+                                                        point_field_reference<field_value_type>>::type;
+
+          public:
+            point_field_iterator() noexcept = default;
+            point_field_iterator(byte_type *address, const std::size_t step) noexcept
+                : address(address), step(static_cast<difference_type>(step))
+            {
+            }
+
+            reference operator*() const noexcept
+            {
+                return dereference(address);
+            }
+
+            reference operator[](const difference_type index) const noexcept
+            {
+                return dereference(address + index * step);
+            }
+
+            point_field_iterator &operator++() noexcept
+            {
+                address += step;
+                return *this;
+            }
+
+            point_field_iterator operator++(int) noexcept
+            {
+                point_field_iterator result = *this;
+                address += step;
+                return result;
+            }
+
+            point_field_iterator &operator--() noexcept
+            {
+                address -= step;
+                return *this;
+            }
+
+            point_field_iterator operator--(int) noexcept
+            {
+                point_field_iterator result = *this;
+                address -= step;
+                return result;
+            }
+
+            point_field_iterator &operator+=(const difference_type offset) noexcept
+            {
+                address += offset * step;
+                return *this;
+            }
+
+            point_field_iterator &operator-=(const difference_type offset) noexcept
+            {
+                address -= offset * step;
+                return *this;
+            }
+
+            point_field_iterator operator+(const difference_type offset) const noexcept
+            {
+                return {address + offset * step, static_cast<std::size_t>(step)};
+            }
+
+            point_field_iterator operator-(const difference_type offset) const noexcept
+            {
+                return {address - offset * step, static_cast<std::size_t>(step)};
+            }
+
+            friend point_field_iterator operator+(const difference_type offset,
+                                                  const point_field_iterator &iterator) noexcept
+            {
+                return iterator + offset;
+            }
+
+            difference_type operator-(const point_field_iterator &other) const noexcept
+            {
+                return step != 0 ? (address - other.address) / step : 0;
+            }
+
+            bool operator==(const point_field_iterator &other) const noexcept
+            {
+                return address == other.address;
+            }
+
+            bool operator!=(const point_field_iterator &other) const noexcept
+            {
+                return address != other.address;
+            }
+
+            bool operator<(const point_field_iterator &other) const noexcept
+            {
+                return address < other.address;
+            }
+
+            bool operator>(const point_field_iterator &other) const noexcept
+            {
+                return address > other.address;
+            }
+
+            bool operator<=(const point_field_iterator &other) const noexcept
+            {
+                return address <= other.address;
+            }
+
+            bool operator>=(const point_field_iterator &other) const noexcept
+            {
+                return address >= other.address;
+            }
+
+          private:
+            static field_value_type dereference(const std::uint8_t *at) noexcept
+            {
+                return detail::load<field_value_type>(at);
+            }
+
+            static point_field_reference<field_value_type> dereference(std::uint8_t *at) noexcept
+            {
+                return point_field_reference<field_value_type>{at};
+            }
+
+            byte_type *address = nullptr;
+            difference_type step = 0;
+        };
+
+        /**
+         * @brief A typed view of a single field of all points of a point cloud, with no copying. Normally created
+         * with provizio::dds::make_point_field_view or provizio::dds::make_mutable_point_field_view. A view is only
+         * valid as long as the data of the cloud is not resized or reassigned.
+         *
+         * @tparam field_value_type C++ type of the field, f.e. float for point_field_datatype::float32
+         * @tparam byte_type const std::uint8_t for read-only access, std::uint8_t for mutable access
+         * @see provizio::dds::point_field_view
+         * @see provizio::dds::mutable_point_field_view
+         */
+        template <typename field_value_type, typename byte_type> class basic_point_field_view final
+        {
+          public:
+            using iterator = point_field_iterator<field_value_type, byte_type>;
+            using reference = typename iterator::reference;
+
+          public:
+            /**
+             * @brief Constructs an invalid view, i.e. of a field not present in a cloud
+             */
+            basic_point_field_view() noexcept = default;
+
+            /**
+             * @brief Constructs a new basic_point_field_view object
+             *
+             * @param first Address of the value of the field of the first point
+             * @param step Point step, in bytes
+             * @param size Number of points
+             */
+            basic_point_field_view(byte_type *first, const std::size_t step, const std::size_t size) noexcept
+                : first(first), step(step), points(size), is_valid(true)
+            {
+            }
+
+            /**
+             * @return true if the field is present in the cloud and has the requested type, false otherwise
+             */
+            bool valid() const noexcept
+            {
+                return is_valid;
+            }
+
+            explicit operator bool() const noexcept
+            {
+                return is_valid;
+            }
+
+            std::size_t size() const noexcept
+            {
+                return points;
+            }
+
+            bool empty() const noexcept
+            {
+                return points == 0;
+            }
+
+            iterator begin() const noexcept
+            {
+                return {first, step};
+            }
+
+            iterator end() const noexcept
+            {
+                return {first + points * step, step};
+            }
+
+            reference operator[](const std::size_t index) const noexcept
+            {
+                return begin()[static_cast<std::ptrdiff_t>(index)];
+            }
+
+          private:
+            byte_type *first = nullptr;
+            std::size_t step = 0;
+            std::size_t points = 0;
+            bool is_valid = false;
+        };
+
+        /**
+         * @brief A read-only typed view of a single field of all points of a point cloud
+         */
+        template <typename field_value_type>
+        using point_field_view = basic_point_field_view<field_value_type, const std::uint8_t>;
+
+        /**
+         * @brief A mutable typed view of a single field of all points of a point cloud
+         */
+        template <typename field_value_type>
+        using mutable_point_field_view = basic_point_field_view<field_value_type, std::uint8_t>;
+
+        namespace detail
+        {
+            template <typename field_value_type, typename byte_type, typename cloud_type>
+            basic_point_field_view<field_value_type, byte_type> make_point_field_view(cloud_type &cloud,
+                                                                                     const std::string &name,
+                                                                                     const std::uint32_t element)
+            {
+                const sensor_msgs::msg::PointField *field = find_point_field(cloud, name);
+                if (field == nullptr ||
+                    field->datatype() != static_cast<std::uint8_t>(point_field_datatype_of<field_value_type>::value) ||
+                    element >= field->count() || cloud.is_bigendian() != is_host_big_endian())
+                {
+                    return {};
+                }
+
+                const std::size_t offset = field->offset() + element * sizeof(field_value_type);
+                const std::size_t points = available_points(cloud, offset + sizeof(field_value_type));
+                return {points > 0 ? cloud.data().data() + offset : cloud.data().data(), cloud.point_step(), points};
+            }
+        } // namespace detail
+
+        /**
+         * @brief Creates a read-only typed view of a single field of all points of a point cloud, with no copying
+         *
+         * @tparam field_value_type C++ type of the field, which has to match its datatype exactly, f.e. float for
+         * point_field_datatype::float32. Use provizio::dds::read_point_field for converting values of other types.
+         * @param cloud The point cloud
+         * @param name Name of the field, f.e. "x"
+         * @param element Index of the element, for fields with count > 1
+         * @return The view, which is invalid if the cloud has no such field, the field has a different datatype, or
+         * the cloud uses a different byte order than the host
+         * @see provizio::dds::read_point_field
+         */
+        template <typename field_value_type>
+        point_field_view<field_value_type> make_point_field_view(const sensor_msgs::msg::PointCloud2 &cloud,
+                                                                 const std::string &name,
+                                                                 const std::uint32_t element = 0)
+        {
+            return detail::make_point_field_view<field_value_type, const std::uint8_t>(cloud, name, element);
+        }
+
+        /**
+         * @brief Creates a mutable typed view of a single field of all points of a point cloud, to modify it in place
+         *
+         * @tparam field_value_type C++ type of the field, which has to match its datatype exactly, f.e. float for
+         * point_field_datatype::float32
+         * @param cloud The point cloud
+         * @param name Name of the field, f.e. "x"
+         * @param element Index of the element, for fields with count > 1
+         * @return The view, which is invalid if the cloud has no such field, the field has a different datatype, or
+         * the cloud uses a different byte order than the host
+         */
+        template <typename field_value_type>
+        mutable_point_field_view<field_value_type> make_mutable_point_field_view(sensor_msgs::msg::PointCloud2 &cloud,
+                                                                                 const std::string &name,
+                                                                                 const std::uint32_t element = 0)
+        {
+            return detail::make_point_field_view<field_value_type, std::uint8_t>(cloud, name, element);
+        }
+
+        namespace detail
+        {
+            /**
+             * @brief Prefix of the names of the marker fields of quantized fields, followed by the name of the
+             * quantized field, a dot and the scale as 8 hexadecimal digits of its IEEE-754 bits, f.e.
+             * "provizio_dds.scale.x.3c23d70a" for x with a scale of 0.01
+             */
+            constexpr const char *quantization_marker_prefix = "provizio_dds.scale.";
+
+            /**
+             * @brief Quantized value of NaN, so quantized values range from -32767 to 32767
+             */
+            constexpr std::int16_t quantized_nan = std::numeric_limits<std::int16_t>::min();
+
+            inline bool is_quantization_marker(const sensor_msgs::msg::PointField &field) noexcept
+            {
+                return field.name().compare(0, std::strlen(quantization_marker_prefix), quantization_marker_prefix) ==
+                       0;
+            }
+
+            inline std::string quantization_marker_name(const std::string &field_name, const float scale)
+            {
+                std::uint32_t bits = 0;
+                std::memcpy(&bits, &scale, sizeof(bits));
+                char hex[9];
+                std::snprintf(hex, sizeof(hex), "%08x", static_cast<unsigned int>(bits));
+                return quantization_marker_prefix + field_name + "." + hex;
+            }
+
+            /**
+             * @return Scale of the quantized field if the marker is of the field, 0 otherwise
+             */
+            inline float quantization_marker_scale(const sensor_msgs::msg::PointField &marker,
+                                                   const std::string &field_name) noexcept
+            {
+                const std::string &name = marker.name();
+                const std::size_t prefix_size = std::strlen(quantization_marker_prefix);
+                if (name.size() != prefix_size + field_name.size() + 9 || !is_quantization_marker(marker) ||
+                    name.compare(prefix_size, field_name.size(), field_name) != 0 ||
+                    name[prefix_size + field_name.size()] != '.')
+                {
+                    return 0;
+                }
+
+                std::uint32_t bits = 0;
+                for (std::size_t i = name.size() - 8; i < name.size(); ++i)
+                {
+                    const char digit = name[i];
+                    const int value = digit >= '0' && digit <= '9'   ? digit - '0'
+                                      : digit >= 'a' && digit <= 'f' ? digit - 'a' + 10
+                                                                     : -1;
+                    if (value < 0)
+                    {
+                        return 0;
+                    }
+                    bits = (bits << 4U) | static_cast<std::uint32_t>(value);
+                }
+
+                float scale = 0;
+                std::memcpy(&scale, &bits, sizeof(scale));
+                return std::isfinite(scale) && scale > 0 ? scale : 0;
+            }
+
+            /**
+             * @brief Scales count quantized values in place, restoring NaNs. Kept as a separate tight loop, so
+             * compilers can vectorize it.
+             */
+            template <typename output_type>
+            void dequantize_values(output_type *values, const std::size_t count, const float scale) noexcept
+            {
+                const auto nan = std::numeric_limits<output_type>::quiet_NaN();
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    values[i] = values[i] == static_cast<output_type>(quantized_nan) ? nan : values[i] * scale;
+                }
+            }
+
+            template <typename output_type>
+            void dequantize_values(output_type *values, const std::size_t count, const float scale,
+                                   std::true_type /*is_floating_point*/) noexcept
+            {
+                dequantize_values(values, count, scale);
+            }
+
+            template <typename output_type>
+            void dequantize_values(output_type *values, const std::size_t count, const float scale,
+                                   std::false_type /*is_floating_point*/) noexcept
+            {
+                // Integer outputs get the quantized values as they are
+                (void)values;
+                (void)count;
+                (void)scale;
+            }
+        } // namespace detail
+
+        /**
+         * @brief Returns the scale of a field quantized by provizio::dds::quantize_point_cloud, i.e. the real value
+         * of a single unit of its point_field_datatype::int16 values
+         *
+         * @param cloud The point cloud
+         * @param name Name of the field, f.e. "x"
+         * @return The scale, or 0 if the field is not quantized
+         */
+        inline float point_field_scale(const sensor_msgs::msg::PointCloud2 &cloud, const std::string &name) noexcept
+        {
+            for (const auto &field : cloud.fields())
+            {
+                const float scale = detail::quantization_marker_scale(field, name);
+                if (scale > 0)
+                {
+                    return scale;
+                }
+            }
+            return 0;
+        }
+
+        /**
+         * @brief Extracts a single field of all points of a point cloud into a contiguous array (i.e. in a
+         * structure-of-arrays layout), converting the values to output_type and to the host byte order as necessary
+         *
+         * @tparam output_type Type of the output values, f.e. float
+         * @param cloud The point cloud
+         * @param name Name of the field, f.e. "x"
+         * @param output Array of at least width * height values to extract to
+         * @param element Index of the element, for fields with count > 1
+         * @return Number of extracted values, i.e. width * height unless the data of the cloud is smaller, or 0 if
+         * the cloud has no such field
+         * @note Fields quantized by provizio::dds::quantize_point_cloud are dequantized to floating point outputs
+         */
+        template <typename output_type>
+        std::size_t read_point_field(const sensor_msgs::msg::PointCloud2 &cloud, const std::string &name,
+                                     output_type *output, const std::uint32_t element = 0)
+        {
+            const sensor_msgs::msg::PointField *field = find_point_field(cloud, name);
+            const auto datatype = field != nullptr ? static_cast<point_field_datatype>(field->datatype())
+                                                   : point_field_datatype{};
+            const std::size_t value_size = point_field_datatype_size(datatype);
+            if (value_size == 0 || element >= field->count())
+            {
+                return 0;
+            }
+
+            const std::size_t offset = field->offset() + static_cast<std::size_t>(element) * value_size;
+            const std::size_t points = detail::available_points(cloud, offset + value_size);
+            if (points == 0)
+            {
+                return 0;
+            }
+
+            const std::uint8_t *first = cloud.data().data() + offset;
+            const std::size_t step = cloud.point_step();
+            const bool swap_bytes = cloud.is_bigendian() != detail::is_host_big_endian();
+            switch (datatype)
+            {
+            case point_field_datatype::int8:
+                detail::convert_field<std::int8_t>(first, step, points, swap_bytes, output);
+                break;
+            case point_field_datatype::uint8:
+                detail::convert_field<std::uint8_t>(first, step, points, swap_bytes, output);
+                break;
+            case point_field_datatype::int16:
+                detail::convert_field<std::int16_t>(first, step, points, swap_bytes, output);
+                break;
+            case point_field_datatype::uint16:
+                detail::convert_field<std::uint16_t>(first, step, points, swap_bytes, output);
+                break;
+            case point_field_datatype::int32:
+                detail::convert_field<std::int32_t>(first, step, points, swap_bytes, output);
+                break;
+            case point_field_datatype::uint32:
+                detail::convert_field<std::uint32_t>(first, step, points, swap_bytes, output);
+                break;
+            case point_field_datatype::float32:
+                detail::convert_field<float>(first, step, points, swap_bytes, output);
+                break;
+            default:
+                detail::convert_field<double>(first, step, points, swap_bytes, output);
+                break;
+            }
+
+            const float scale = datatype == point_field_datatype::int16 ? point_field_scale(cloud, name) : 0;
+            if (scale > 0)
+            {
+                detail::dequantize_values(output, points, scale, std::is_floating_point<output_type>{});
+            }
+            return points;
+        }
+
+        /**
+         * @brief Extracts a single field of all points of a point cloud into a vector, converting the values as
+         * necessary. The vector is resized to the number of extracted values, and keeps its capacity otherwise.
+         *
+         * @return Number of extracted values, 0 if the cloud has no such field
+         * @see provizio::dds::read_point_field
+         */
+        template <typename output_type>
+        std::size_t read_point_field(const sensor_msgs::msg::PointCloud2 &cloud, const std::string &name,
+                                     std::vector<output_type> &output, const std::uint32_t element = 0)
+        {
+            output.resize(static_cast<std::size_t>(cloud.width()) * cloud.height());
+            output.resize(read_point_field(cloud, name, output.data(), element));
+            return output.size();
+        }
+
+        /**
+         * @brief A point of a radar point cloud, as created by provizio::dds::make_radar_point_cloud. Its memory
+         * layout matches the layout of the points of such a cloud.
+         */
+        struct radar_point
+        {
+            float x;
+            float y;
+            float z;
+            float radar_relative_radial_velocity;
+            float signal_to_noise_ratio;
+            float ground_relative_radial_velocity;
+        };
+
+        static_assert(sizeof(radar_point) == 6 * sizeof(float) && std::is_standard_layout<radar_point>::value,
+                      "radar_point is expected to match the layout of radar point cloud points");
+
+        /**
+         * @brief Radar point cloud fields in the structure-of-arrays layout, as extracted by
+         * provizio::dds::read_radar_points. Reusing the same object for multiple clouds keeps the vectors capacity,
+         * so no allocations take place in a steady state.
+         */
+        struct radar_points_soa
+        {
+            std::vector<float> x;
+            std::vector<float> y;
+            std::vector<float> z;
+            std::vector<float> radar_relative_radial_velocity;
+            std::vector<float> signal_to_noise_ratio;
+            std::vector<float> ground_relative_radial_velocity;
+
+            std::size_t size() const noexcept
+            {
+                return x.size();
+            }
+
+            void resize(const std::size_t points)
+            {
+                x.resize(points);
+                y.resize(points);
+                z.resize(points);
+                radar_relative_radial_velocity.resize(points);
+                signal_to_noise_ratio.resize(points);
+                ground_relative_radial_velocity.resize(points);
+            }
+        };
+
+        /**
+         * @return Names of the fields of a radar point cloud, in the order of provizio::dds::radar_point members
+         */
+        inline const char *const *radar_point_field_names() noexcept
+        {
+            static const char *const names[] = {"x",
+                                                "y",
+                                                "z",
+                                                "radar_relative_radial_velocity",
+                                                "signal_to_noise_ratio",
+                                                "ground_relative_radial_velocity"};
+            return names;
+        }
+
+        /**
+         * @return Number of fields of a radar point cloud
+         */
+        constexpr std::size_t radar_point_field_count() noexcept
+        {
+            return sizeof(radar_point) / sizeof(float);
+        }
+
+        /**
+         * @return Fields of a radar point cloud, as in make_radar_point_cloud of point_cloud2.py: all of
+         * point_field_datatype::float32, in the order of provizio::dds::radar_point members
+         */
+        inline std::vector<sensor_msgs::msg::PointField> radar_point_cloud_fields()
+        {
+            std::vector<sensor_msgs::msg::PointField> fields(radar_point_field_count());
+            for (std::size_t i = 0; i < fields.size(); ++i)
+            {
+                fields[i].name(radar_point_field_names()[i]);
+                fields[i].offset(static_cast<std::uint32_t>(i * sizeof(float)));
+                fields[i].datatype(static_cast<std::uint8_t>(point_field_datatype::float32));
+                fields[i].count(1);
+            }
+            return fields;
+        }
+
+        namespace detail
+        {
+            /**
+             * @return true if the fields of the cloud are exactly the fields of a radar point cloud
+             */
+            inline bool has_radar_point_cloud_fields(const sensor_msgs::msg::PointCloud2 &cloud) noexcept
+            {
+                const auto &fields = cloud.fields();
+                if (fields.size() != radar_point_field_count())
+                {
+                    return false;
+                }
+
+                for (std::size_t i = 0; i < fields.size(); ++i)
+                {
+                    if (fields[i].name() != radar_point_field_names()[i] || fields[i].offset() != i * sizeof(float) ||
+                        fields[i].datatype() != static_cast<std::uint8_t>(point_field_datatype::float32) ||
+                        fields[i].count() != 1)
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+        } // namespace detail
+
+        /**
+         * @brief Extracts the fields of all points of a radar point cloud into the structure-of-arrays layout, f.e.
+         * for vectorized processing. Clouds created by provizio::dds::make_radar_point_cloud (or
+         * make_radar_point_cloud of point_cloud2.py) are extracted in a single pass with a fixed point layout, other
+         * clouds are extracted field by field, converting the values as necessary.
+         *
+         * @param cloud The point cloud
+         * @param points The extracted points. Fields other than x, y and z which are missing in the cloud are filled
+         * with NaN.
+         * @return true if extracted successfully, false if the cloud doesn't have x, y or z fields
+         */
+        inline bool read_radar_points(const sensor_msgs::msg::PointCloud2 &cloud, radar_points_soa &points)
+        {
+            const std::size_t point_count = static_cast<std::size_t>(cloud.width()) * cloud.height();
+            if (detail::has_radar_point_cloud_fields(cloud) && cloud.point_step() == sizeof(radar_point) &&
+                cloud.is_bigendian() == detail::is_host_big_endian() &&
+                cloud.data().size() >= point_count * sizeof(radar_point))
+            {
+                points.resize(point_count);
+                const std::uint8_t *data = cloud.data().data();
+                for (std::size_t i = 0; i < point_count; ++i)
+                {
+                    const std::uint8_t *point = data + i * sizeof(radar_point);
+                    points.x[i] = detail::load<float>(point);
+                    points.y[i] = detail::load<float>(point + sizeof(float));
+                    points.z[i] = detail::load<float>(point + 2 * sizeof(float));
+                    points.radar_relative_radial_velocity[i] = detail::load<float>(point + 3 * sizeof(float));
+                    points.signal_to_noise_ratio[i] = detail::load<float>(point + 4 * sizeof(float));
+                    points.ground_relative_radial_velocity[i] = detail::load<float>(point + 5 * sizeof(float));
+                }
+                return true;
+            }
+
+            // Generic layout
+            std::vector<float> *const outputs[] = {&points.x,
+                                                   &points.y,
+                                                   &points.z,
+                                                   &points.radar_relative_radial_velocity,
+                                                   &points.signal_to_noise_ratio,
+                                                   &points.ground_relative_radial_velocity};
+            points.resize(point_count);
+            std::size_t extracted = point_count;
+            for (std::size_t i = 0; i < radar_point_field_count(); ++i)
+            {
+                const std::size_t field_extracted =
+                    read_point_field(cloud, radar_point_field_names()[i], outputs[i]->data());
+                if (field_extracted == 0 && i >= 3)
+                {
+                    // Optional field
+                    std::fill(outputs[i]->begin(), outputs[i]->end(), std::numeric_limits<float>::quiet_NaN());
+                    continue;
+                }
+
+                extracted = field_extracted < extracted ? field_extracted : extracted;
+                if (extracted == 0 && point_count > 0)
+                {
+                    points.resize(0);
+                    return false;
+                }
+            }
+            points.resize(extracted);
+            return true;
+        }
+
+        /**
+         * @brief Fills a radar point cloud in place, f.e. a loaned or reused PointCloud2 sample, matching
+         * make_radar_point_cloud of point_cloud2.py. The data of the cloud keeps its capacity, and the fields are only
+         * rewritten if they differ, so refilling the same cloud doesn't allocate in a steady state.
+         *
+         * @param cloud The point cloud to fill
+         * @param header The point cloud header
+         * @param points The points
+         * @param count Number of points
+         * @param is_dense true if there are no invalid points
+         */
+        inline void fill_radar_point_cloud(sensor_msgs::msg::PointCloud2 &cloud, const std_msgs::msg::Header &header,
+                                           const radar_point *points, const std::size_t count,
+                                           const bool is_dense = true)
+        {
+            cloud.header(header);
+            cloud.height(1);
+            cloud.width(static_cast<std::uint32_t>(count));
+            if (!detail::has_radar_point_cloud_fields(cloud))
+            {
+                cloud.fields(radar_point_cloud_fields());
+            }
+            cloud.is_bigendian(detail::is_host_big_endian());
+            cloud.point_step(static_cast<std::uint32_t>(sizeof(radar_point)));
+            cloud.row_step(static_cast<std::uint32_t>(count * sizeof(radar_point)));
+            cloud.is_dense(is_dense);
+
+            // radar_point matches the layout of the cloud points exactly
+            cloud.data().resize(count * sizeof(radar_point));
+            if (count > 0)
+            {
+                std::memcpy(cloud.data().data(), static_cast<const void *>(points), count * sizeof(radar_point));
+            }
+        }
+
+        /**
+         * @brief Creates a radar point cloud, matching make_radar_point_cloud of point_cloud2.py
+         *
+         * @param header The point cloud header
+         * @param points The points
+         * @param is_dense true if there are no invalid points
+         * @return The point cloud
+         * @see provizio::dds::fill_radar_point_cloud
+         */
+        inline sensor_msgs::msg::PointCloud2 make_radar_point_cloud(const std_msgs::msg::Header &header,
+                                                                    const std::vector<radar_point> &points,
+                                                                    const bool is_dense = true)
+        {
+            sensor_msgs::msg::PointCloud2 cloud;
+            fill_radar_point_cloud(cloud, header, points.data(), points.size(), is_dense);
+            return cloud;
+        }
+
+        /**
+         * @brief A field to be quantized by provizio::dds::quantize_point_cloud
+         */
+        struct point_field_quantization
+        {
+            /**
+             * @brief Name of the field, which has to be of point_field_datatype::float32 or float64 with count 1
+             */
+            std::string name;
+
+            /**
+             * @brief Real value of a single quantized unit, f.e. 0.01 for centimeters when the field holds meters.
+             * Values beyond +/- 32767 units saturate.
+             */
+            float scale = 0;
+        };
+
+        /**
+         * @return Default quantization of a radar point cloud: 2 centimeters for x, y and z (i.e. up to +/- 655 meters,
+         * beyond the range of automotive radars), and centimeters per second for the velocities (up to +/- 327 meters
+         * per second), signal_to_noise_ratio is kept intact
+         */
+        inline std::vector<point_field_quantization> radar_point_cloud_quantization()
+        {
+            return {{"x", 0.02F},
+                    {"y", 0.02F},
+                    {"z", 0.02F},
+                    {"radar_relative_radial_velocity", 0.01F},
+                    {"ground_relative_radial_velocity", 0.01F}};
+        }
+
+        namespace detail
+        {
+            template <typename source_type>
+            void quantize_field(const std::uint8_t *first, const std::size_t step, const std::size_t count,
+                                const float scale, std::uint8_t *output, const std::size_t output_step) noexcept
+            {
+                const float units_per_value = 1.0F / scale;
+                constexpr float max_quantized = std::numeric_limits<std::int16_t>::max();
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    const float value = static_cast<float>(load<source_type>(first + i * step)) * units_per_value;
+                    const float clamped = value > max_quantized ? max_quantized
+                                          : value < -max_quantized ? -max_quantized
+                                                                   : value;
+                    const std::int16_t quantized =
+                        std::isnan(value) ? quantized_nan
+                                          : static_cast<std::int16_t>(clamped >= 0 ? clamped + 0.5F : clamped - 0.5F);
+                    store(output + i * output_step, quantized);
+                }
+            }
+
+            /**
+             * @brief Dequantizes count values spaced by step bytes into float32 values spaced by output_step bytes.
+             * Kept as a separate tight loop with no per-field dispatch, so compilers can vectorize it.
+             */
+            inline void dequantize_field(const std::uint8_t *first, const std::size_t step, const std::size_t count,
+                                         const float scale, std::uint8_t *output,
+                                         const std::size_t output_step) noexcept
+            {
+                const float nan = std::numeric_limits<float>::quiet_NaN();
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    const auto quantized = load<std::int16_t>(first + i * step);
+                    store(output + i * output_step,
+                          quantized == quantized_nan ? nan : static_cast<float>(quantized) * scale);
+                }
+            }
+
+            inline void copy_field(const std::uint8_t *first, const std::size_t step, const std::size_t count,
+                                   const std::size_t size, std::uint8_t *output, const std::size_t output_step) noexcept
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    std::memcpy(output + i * output_step, first + i * step, size);
+                }
+            }
+
+            inline const point_field_quantization *find_quantization(
+                const std::vector<point_field_quantization> &quantization, const std::string &name) noexcept
+            {
+                for (const auto &field : quantization)
+                {
+                    if (field.name == name)
+                    {
+                        return &field;
+                    }
+                }
+                return nullptr;
+            }
+
+            /**
+             * @return Number of the points of the cloud, or 0 if its data is too small or not in the host byte order
+             */
+            inline std::size_t convertible_points(const sensor_msgs::msg::PointCloud2 &cloud) noexcept
+            {
+                const std::size_t points = static_cast<std::size_t>(cloud.width()) * cloud.height();
+                return cloud.is_bigendian() == is_host_big_endian() && cloud.point_step() > 0 &&
+                               cloud.data().size() >= points * cloud.point_step()
+                           ? points
+                           : 0;
+            }
+
+            inline void copy_cloud_metadata(const sensor_msgs::msg::PointCloud2 &source,
+                                            sensor_msgs::msg::PointCloud2 &destination, const std::size_t point_step)
+            {
+                destination.header(source.header());
+                destination.height(source.height());
+                destination.width(source.width());
+                destination.is_bigendian(source.is_bigendian());
+                destination.is_dense(source.is_dense());
+                destination.point_step(static_cast<std::uint32_t>(point_step));
+                destination.row_step(static_cast<std::uint32_t>(point_step * source.width()));
+                destination.data().resize(static_cast<std::size_t>(source.width()) * source.height() * point_step);
+            }
+        } // namespace detail
+
+        /**
+         * @brief Quantizes floating point fields of a point cloud into fixed point point_field_datatype::int16 values
+         * with a per-field scale, f.e. to halve the size of x, y, z and velocities of radar point clouds sent over a
+         * bandwidth-limited link. The other fields are kept intact, and the points are packed.
+         *
+         * The result is a PointCloud2 with the quantized fields in their int16 units, which consumers unaware of the
+         * quantization misread, so it's to be published on a topic of its own, as provizio::dds::quantized_topic_name
+         * (see provizio::dds::make_quantized_point_cloud2_publisher) while plain consumers keep the float fields. Each
+         * quantized field is marked with an extra uint8 field that overlaps it, named by
+         * provizio::dds::detail::quantization_marker_prefix and carrying the scale.
+         * provizio::dds::read_point_field and provizio::dds::read_radar_points dequantize the marked fields on reading,
+         * and provizio::dds::dequantize_point_cloud restores the cloud. NaN values are preserved.
+         *
+         * @param source The point cloud to quantize, in the host byte order
+         * @param quantized The quantized point cloud, f.e. a loaned or reused sample to publish. Its data keeps
+         * its capacity, so requantizing into the same cloud doesn't reallocate it. Can't be source.
+         * @param quantization The fields to quantize
+         * @return true if quantized, false if a field can't be quantized (missing, not of a floating point datatype
+         * or with a count other than 1, or with a non-positive scale) or the source is not in the host byte order or
+         * is already quantized
+         * @see provizio::dds::radar_point_cloud_quantization
+         * @see provizio::dds::point_field_scale
+         */
+        inline bool quantize_point_cloud(const sensor_msgs::msg::PointCloud2 &source,
+                                         sensor_msgs::msg::PointCloud2 &quantized,
+                                         const std::vector<point_field_quantization> &quantization)
+        {
+            const std::size_t points = detail::convertible_points(source);
+            if (&source == &quantized || (points == 0 && source.width() * source.height() > 0))
+            {
+                return false;
+            }
+
+            for (const auto &field : quantization)
+            {
+                const auto *source_field = find_point_field(source, field.name);
+                if (source_field == nullptr || source_field->count() != 1 || !std::isfinite(field.scale) ||
+                    field.scale <= 0 ||
+                    (source_field->datatype() != static_cast<std::uint8_t>(point_field_datatype::float32) &&
+                     source_field->datatype() != static_cast<std::uint8_t>(point_field_datatype::float64)))
+                {
+                    return false;
+                }
+            }
+
+            std::vector<sensor_msgs::msg::PointField> fields;
+            fields.reserve(source.fields().size() + quantization.size());
+            std::size_t point_step = 0;
+            for (const auto &source_field : source.fields())
+            {
+                if (detail::is_quantization_marker(source_field))
+                {
+                    return false;
+                }
+
+                const bool is_quantized = detail::find_quantization(quantization, source_field.name()) != nullptr;
+                fields.push_back(source_field);
+                fields.back().offset(static_cast<std::uint32_t>(point_step));
+                if (is_quantized)
+                {
+                    fields.back().datatype(static_cast<std::uint8_t>(point_field_datatype::int16));
+                }
+                point_step += point_field_datatype_size(static_cast<point_field_datatype>(fields.back().datatype())) *
+                              fields.back().count();
+            }
+            for (const auto &field : quantization)
+            {
+                sensor_msgs::msg::PointField marker;
+                marker.name(detail::quantization_marker_name(field.name, field.scale));
+                for (const auto &quantized_field : fields)
+                {
+                    if (quantized_field.name() == field.name)
+                    {
+                        // Overlaps the quantized field, so it takes no extra space in the points
+                        marker.offset(quantized_field.offset());
+                        break;
+                    }
+                }
+                marker.datatype(static_cast<std::uint8_t>(point_field_datatype::uint8));
+                marker.count(1);
+                fields.push_back(std::move(marker));
+            }
+
+            detail::copy_cloud_metadata(source, quantized, point_step);
+            const std::uint8_t *source_data = source.data().data();
+            std::uint8_t *quantized_data = quantized.data().data();
+            for (std::size_t i = 0; i < source.fields().size(); ++i)
+            {
+                const auto &source_field = source.fields()[i];
+                const auto *field_quantization = detail::find_quantization(quantization, source_field.name());
+                const std::uint8_t *first = source_data + source_field.offset();
+                std::uint8_t *output = quantized_data + fields[i].offset();
+                if (field_quantization == nullptr)
+                {
+                    detail::copy_field(first, source.point_step(), points,
+                                       point_field_datatype_size(
+                                           static_cast<point_field_datatype>(source_field.datatype())) *
+                                           source_field.count(),
+                                       output, point_step);
+                }
+                else if (source_field.datatype() == static_cast<std::uint8_t>(point_field_datatype::float32))
+                {
+                    detail::quantize_field<float>(first, source.point_step(), points, field_quantization->scale,
+                                                  output, point_step);
+                }
+                else
+                {
+                    detail::quantize_field<double>(first, source.point_step(), points, field_quantization->scale,
+                                                   output, point_step);
+                }
+            }
+            quantized.fields(std::move(fields));
+            return true;
+        }
+
+        /**
+         * @brief Restores a point cloud quantized by provizio::dds::quantize_point_cloud, with the quantized fields as
+         * point_field_datatype::float32 and no marker fields. Clouds with no quantized fields are copied as they are,
+         * so received clouds can be dequantized regardless.
+         *
+         * @param quantized The quantized point cloud, in the host byte order
+         * @param dequantized The restored point cloud. Its data keeps its capacity, so dequantizing into the same
+         * cloud doesn't reallocate it. Can't be quantized.
+         * @return true if restored, false if the cloud is not in the host byte order or its data is too small
+         */
+        inline bool dequantize_point_cloud(const sensor_msgs::msg::PointCloud2 &quantized,
+                                           sensor_msgs::msg::PointCloud2 &dequantized)
+        {
+            const std::size_t points = detail::convertible_points(quantized);
+            if (&quantized == &dequantized || (points == 0 && quantized.width() * quantized.height() > 0))
+            {
+                return false;
+            }
+
+            std::vector<sensor_msgs::msg::PointField> fields;
+            std::vector<float> scales;
+            fields.reserve(quantized.fields().size());
+            scales.reserve(quantized.fields().size());
+            std::size_t point_step = 0;
+            for (const auto &quantized_field : quantized.fields())
+            {
+                if (detail::is_quantization_marker(quantized_field))
+                {
+                    continue;
+                }
+
+                const float scale =
+                    quantized_field.datatype() == static_cast<std::uint8_t>(point_field_datatype::int16) &&
+                            quantized_field.count() == 1
+                        ? point_field_scale(quantized, quantized_field.name())
+                        : 0;
+                fields.push_back(quantized_field);
+                fields.back().offset(static_cast<std::uint32_t>(point_step));
+                if (scale > 0)
+                {
+                    fields.back().datatype(static_cast<std::uint8_t>(point_field_datatype::float32));
+                }
+                scales.push_back(scale);
+                point_step += point_field_datatype_size(static_cast<point_field_datatype>(fields.back().datatype())) *
+                              fields.back().count();
+            }
+
+            detail::copy_cloud_metadata(quantized, dequantized, point_step);
+            const std::uint8_t *quantized_data = quantized.data().data();
+            std::uint8_t *dequantized_data = dequantized.data().data();
+            for (std::size_t i = 0; i < fields.size(); ++i)
+            {
+                const auto *quantized_field = find_point_field(quantized, fields[i].name());
+                const std::uint8_t *first = quantized_data + quantized_field->offset();
+                std::uint8_t *output = dequantized_data + fields[i].offset();
+                if (scales[i] > 0)
+                {
+                    detail::dequantize_field(first, quantized.point_step(), points, scales[i], output, point_step);
+                }
+                else
+                {
+                    detail::copy_field(first, quantized.point_step(), points,
+                                       point_field_datatype_size(
+                                           static_cast<point_field_datatype>(quantized_field->datatype())) *
+                                           quantized_field->count(),
+                                       output, point_step);
+                }
+            }
+            dequantized.fields(std::move(fields));
+            return true;
+        }
+    } // namespace dds
+} // namespace provizio
+
+#endif // DDS_POINT_CLOUD2
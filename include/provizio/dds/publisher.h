@@ -15,8 +15,15 @@
 #ifndef DDS_PUBLISHER
 #define DDS_PUBLISHER
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <fastdds/dds/publisher/DataWriter.hpp>
 #include <fastdds/dds/publisher/DataWriterListener.hpp>
@@ -25,7 +32,12 @@
 
 #include "provizio/dds/common.h"
 #include "provizio/dds/domain_participant.h"
+#include "provizio/dds/entity_registry.h"
+#include "provizio/dds/inplace_function.h"
+#include "provizio/dds/introspection.h"
+#include "provizio/dds/metrics.h"
 #include "provizio/dds/qos_defaults.h"
+#include "provizio/dds/serialized_pub_sub_type.h"
 
 namespace provizio
 {
@@ -35,8 +47,288 @@ namespace provizio
         {
             template <typename data_pub_sub_type, typename on_has_subscriber_changed_function_type = void *>
             class data_writer_listener;
+
+            /**
+             * @brief Instance handles of the DataReaders matched with a DataWriter, as reported to its listener
+             */
+            class matched_subscriptions final
+            {
+              public:
+                void update(const PublicationMatchedStatus &status)
+                {
+                    std::lock_guard<std::mutex> lock{mutex};
+                    const auto found = std::find(handles.begin(), handles.end(), status.last_subscription_handle);
+                    if (status.current_count_change > 0 && found == handles.end())
+                    {
+                        handles.push_back(status.last_subscription_handle);
+                    }
+                    else if (status.current_count_change < 0 && found != handles.end())
+                    {
+                        handles.erase(found);
+                    }
+                }
+
+                template <typename predicate_type> bool any_of(predicate_type predicate) const
+                {
+                    std::lock_guard<std::mutex> lock{mutex};
+                    return std::any_of(handles.begin(), handles.end(), predicate);
+                }
+
+              private:
+                mutable std::mutex mutex;
+                std::vector<InstanceHandle_t> handles;
+            };
+
+            /**
+             * @brief Counts missed deadlines and tracks matched subscriptions of a DataWriter with no
+             * on_has_subscriber_changed function
+             */
+            class counting_data_writer_listener final : public DataWriterListener
+            {
+              public:
+                counting_data_writer_listener(publisher_counters &counters, matched_subscriptions &subscriptions)
+                    : counters(counters), subscriptions(subscriptions)
+                {
+                }
+
+                void on_publication_matched(DataWriter *writer, const PublicationMatchedStatus &info) override
+                {
+                    (void)writer;
+                    subscriptions.update(info);
+                }
+
+                void on_offered_deadline_missed(DataWriter *writer, const OfferedDeadlineMissedStatus &status) override
+                {
+                    (void)writer;
+                    counters.count_deadlines_missed(status.total_count_change);
+                }
+
+              private:
+                publisher_counters &counters;
+                matched_subscriptions &subscriptions;
+            };
         } // namespace detail
 
+        template <typename data_pub_sub_type> class data_publisher;
+
+        /**
+         * @brief Defines whether a publisher writes samples synchronously, i.e. sends them in the calling thread, or
+         * asynchronously, i.e. queues them to be sent by a Fast-DDS thread, optionally limited by a flow controller.
+         *
+         * Asynchronous publishing keeps the publishing thread from being blocked by sending large samples or by
+         * reliable subscribers applying backpressure. An asynchronous publisher never blocks on a full history, so
+         * that a sample that can't be queued is dropped instead.
+         *
+         * @see provizio::dds::make_publisher
+         * @see provizio::dds::flow_controller_options
+         * @see
+         * https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/core/policy/eprosimaExtensions.html#publishmodeqospolicy
+         */
+        struct publish_mode_options final
+        {
+            /**
+             * @brief SYNCHRONOUS_PUBLISH_MODE or ASYNCHRONOUS_PUBLISH_MODE
+             */
+            PublishModeQosPolicyKind kind = SYNCHRONOUS_PUBLISH_MODE;
+
+            /**
+             * @brief Name of a flow controller registered in the DDS Domain Participant (see
+             * provizio::dds::transport_options::flow_controllers) to limit asynchronous publishing, or empty for the
+             * default Fast-DDS flow controller, which doesn't limit the bandwidth
+             */
+            std::string flow_controller_name;
+
+            /**
+             * @brief Publish mode options defined by qos_defaults of a DDS data type
+             *
+             * @tparam data_pub_sub_type DDS data pub/sub type, f.e. std_msgs::msg::StringPubSubType
+             */
+            template <typename data_pub_sub_type> static publish_mode_options defaults()
+            {
+                publish_mode_options options;
+                options.kind = detail::qos_policies_of<data_pub_sub_type>::publish_mode_kind;
+                return options;
+            }
+
+            /**
+             * @brief Asynchronous publish mode options
+             *
+             * @param flow_controller_name Name of a flow controller registered in the DDS Domain Participant, or empty
+             * for the default Fast-DDS flow controller
+             */
+            static publish_mode_options asynchronous(std::string flow_controller_name = {})
+            {
+                publish_mode_options options;
+                options.kind = ASYNCHRONOUS_PUBLISH_MODE;
+                options.flow_controller_name = std::move(flow_controller_name);
+                return options;
+            }
+        };
+
+        /**
+         * @brief Result of publishing a sample
+         */
+        enum class publish_status
+        {
+            /**
+             * @brief The sample was sent (synchronous publish mode)
+             */
+            published,
+
+            /**
+             * @brief The sample was queued to be sent asynchronously (asynchronous publish mode)
+             */
+            queued,
+
+            /**
+             * @brief The sample was neither sent nor queued, f.e. because the history is full of unacknowledged
+             * samples
+             */
+            dropped
+        };
+
+        /**
+         * @brief A sample loaned from a data_publisher, to be filled in place and then published with
+         * data_publisher::publish_loaned. If not published, the loan is returned automatically on destruction.
+         *
+         * When the DDS data type is plain (i.e. has a fixed size and no dynamic members) the sample is allocated by
+         * Fast-DDS directly in the DataWriter history, so that no extra copy is made on publishing, and it's delivered
+         * via the data-sharing transport to the same host subscribers when possible. For other types (f.e.
+         * sensor_msgs::msg::PointCloud2) it's a sample owned by the publisher and reused between publications, so the
+         * capacity of its dynamic members (f.e. data vector) is preserved and no reallocations take place in a steady
+         * state.
+         *
+         * @tparam data_pub_sub_type DDS data pub/sub type, f.e. std_msgs::msg::StringPubSubType
+         * @see provizio::dds::data_publisher::loan
+         * @see https://fast-dds.docs.eprosima.com/en/latest/fastdds/use_cases/zero_copy/zero_copy.html
+         */
+        template <typename data_pub_sub_type> class loaned_sample final
+        {
+          public:
+            using data_type = typename data_pub_sub_type::type;
+
+          public:
+            /**
+             * @brief Constructs an empty loaned_sample, which doesn't hold any sample
+             */
+            loaned_sample() = default;
+
+            /**
+             * @brief Constructs a new loaned_sample object. Normally invoked by a data_publisher implementation only.
+             *
+             * @param owner data_publisher the sample is loaned from
+             * @param sample The loaned sample
+             * @param middleware_owned true if the sample is allocated by Fast-DDS, false if by the data_publisher
+             */
+            loaned_sample(data_publisher<data_pub_sub_type> &owner, data_type *sample, bool middleware_owned)
+                : owner(&owner), sample(sample), middleware_owned(middleware_owned)
+            {
+            }
+
+            loaned_sample(const loaned_sample &) = delete;
+            loaned_sample(loaned_sample &&other) noexcept
+                : owner(other.owner), sample(other.sample), middleware_owned(other.middleware_owned)
+            {
+                other.owner = nullptr;
+                other.sample = nullptr;
+            }
+
+            ~loaned_sample()
+            {
+                reset();
+            }
+
+            loaned_sample &operator=(const loaned_sample &) = delete;
+            loaned_sample &operator=(loaned_sample &&other) noexcept
+            {
+                if (this != &other)
+                {
+                    reset();
+                    owner = other.owner;
+                    sample = other.sample;
+                    middleware_owned = other.middleware_owned;
+                    other.owner = nullptr;
+                    other.sample = nullptr;
+                }
+                return *this;
+            }
+
+            /**
+             * @brief Returns the loan without publishing, if the sample is held
+             */
+            void reset()
+            {
+                if (sample != nullptr)
+                {
+                    owner->discard_loan(sample, middleware_owned);
+                    owner = nullptr;
+                    sample = nullptr;
+                }
+            }
+
+            /**
+             * @brief Releases the ownership over the sample without returning the loan. Normally invoked by a
+             * data_publisher implementation only.
+             *
+             * @return The loaned sample
+             */
+            data_type *release() noexcept
+            {
+                data_type *result = sample;
+                owner = nullptr;
+                sample = nullptr;
+                return result;
+            }
+
+            /**
+             * @return true if there is a sample held, false if the loan failed or the sample was already published
+             */
+            explicit operator bool() const noexcept
+            {
+                return sample != nullptr;
+            }
+
+            /**
+             * @return The loaned sample or nullptr if none is held
+             */
+            data_type *get() const noexcept
+            {
+                return sample;
+            }
+
+            data_type &operator*() const noexcept
+            {
+                return *sample;
+            }
+
+            data_type *operator->() const noexcept
+            {
+                return sample;
+            }
+
+            /**
+             * @return true if the sample is allocated by Fast-DDS (zero-copy), false if by the data_publisher
+             */
+            bool is_middleware_owned() const noexcept
+            {
+                return middleware_owned;
+            }
+
+            /**
+             * @param publisher A data_publisher
+             * @return true if the sample is held and was loaned from the publisher, false otherwise
+             */
+            bool is_loaned_from(const data_publisher<data_pub_sub_type> &publisher) const noexcept
+            {
+                return sample != nullptr && owner == &publisher;
+            }
+
+          private:
+            data_publisher<data_pub_sub_type> *owner = nullptr;
+            data_type *sample = nullptr;
+            bool middleware_owned = false;
+        };
+
         /**
          * @brief Abstract interface that provides publishing functionality for a DDS data type. Normally created using
          * provizio::dds::make_publisher.
@@ -64,6 +356,72 @@ namespace provizio
              * @return true if published successfully, false otherwise
              */
             virtual bool publish(data_type &data) = 0;
+
+            /**
+             * @brief Publishes the DDS data, reporting whether it was sent, queued to be sent asynchronously or
+             * dropped. By default reports the result of publish as either published or dropped.
+             *
+             * @param data Actual DDS data to be published, f.e. std_msgs::msg::String
+             * @return The publish_status
+             */
+            virtual publish_status publish_with_status(data_type &data)
+            {
+                return publish(data) ? publish_status::published : publish_status::dropped;
+            }
+
+            /**
+             * @brief Loans a sample to be filled in place and then published with publish_loaned, which avoids copying
+             * the data where possible. By default a newly allocated sample is loaned, which is deleted once published
+             * or discarded.
+             *
+             * @return The loaned sample, empty if no sample can be loaned at the moment (f.e. when all history
+             * samples are loaned already)
+             * @see provizio::dds::loaned_sample
+             */
+            virtual loaned_sample<data_pub_sub_type> loan()
+            {
+                return {*this, new data_type(), false};
+            }
+
+            /**
+             * @brief Publishes a sample previously loaned with loan. The loan is returned regardless of the result.
+             * Samples loaned from other publishers are not published. By default publishes the sample with publish.
+             *
+             * @param sample The loaned sample, filled with actual DDS data to be published
+             * @return true if published successfully, false otherwise
+             */
+            virtual bool publish_loaned(loaned_sample<data_pub_sub_type> &&sample)
+            {
+                const bool result = sample.is_loaned_from(*this) && publish(*sample);
+                sample.reset();
+                return result;
+            }
+
+            /**
+             * @brief Reads the counters of the publisher. The counters are lock-free, so they can be read at any time
+             * from any thread. By default all counters are 0.
+             *
+             * @return A snapshot of the counters
+             */
+            virtual publisher_metrics metrics() const
+            {
+                return {};
+            }
+
+          protected:
+            /**
+             * @brief Returns a loaned sample back without publishing it. By default deletes the sample allocated by
+             * the default loan.
+             *
+             * @param sample The loaned sample
+             * @param middleware_owned true if the sample is allocated by Fast-DDS, false if by the data_publisher
+             */
+            virtual void discard_loan(data_type *sample, bool /*middleware_owned*/)
+            {
+                delete sample;
+            }
+
+            friend class loaned_sample<data_pub_sub_type>;
         };
 
         /**
@@ -95,16 +453,21 @@ namespace provizio
              * @param topic_name A DDS Topic Name
              * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS
              * DataWriter, which makes publishing slower but more reliable
+             * @param publish_mode Defines whether to publish synchronously or asynchronously, as defined in
+             * qos_defaults by default
              * @note Using BEST_EFFORT_RELIABILITY_QOS reliability_kind makes it incompatible with reliable subscribers
              * @see provizio::dds::make_publisher
              * @see provizio::dds::make_domain_participant
              * @see provizio::dds::publisher_policies
+             * @see provizio::dds::publish_mode_options
              * @see
              * https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/core/policy/standardQosPolicies.html#reliabilityqospolicy
              */
             publisher_handle(std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
                              ReliabilityQosPolicyKind reliability_kind =
-                                 qos_defaults<data_pub_sub_type>::datawriter_reliability_kind);
+                                 qos_defaults<data_pub_sub_type>::datawriter_reliability_kind,
+                             const publish_mode_options &publish_mode =
+                                 publish_mode_options::defaults<data_pub_sub_type>());
 
             /**
              * @brief Constructs a new publisher_handle object with an on_has_subscriber_changed function to be invoked
@@ -117,17 +480,67 @@ namespace provizio
              * subscriber is matched, false when the last subscriber is unmatched.
              * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS
              * DataWriter, which makes publishing slower but more reliable
+             * @param publish_mode Defines whether to publish synchronously or asynchronously, as defined in
+             * qos_defaults by default
              * @note Using BEST_EFFORT_RELIABILITY_QOS reliability_kind makes it incompatible with reliable subscribers
              * @see provizio::dds::make_publisher
              * @see provizio::dds::make_domain_participant
              * @see provizio::dds::publisher_policies
+             * @see provizio::dds::publish_mode_options
              * @see
              * https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/core/policy/standardQosPolicies.html#reliabilityqospolicy
              */
             publisher_handle(std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
                              on_has_subscriber_changed_function_type on_has_subscriber_changed_function,
                              ReliabilityQosPolicyKind reliability_kind =
-                                 qos_defaults<data_pub_sub_type>::datawriter_reliability_kind);
+                                 qos_defaults<data_pub_sub_type>::datawriter_reliability_kind,
+                             const publish_mode_options &publish_mode =
+                                 publish_mode_options::defaults<data_pub_sub_type>());
+
+            /**
+             * @brief Constructs a new publisher_handle object with a DDS Type Support of its own rather than a default
+             * constructed data_pub_sub_type, f.e. a provizio::dds::serialized_pub_sub_type of a type name only known
+             * at run time.
+             *
+             * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+             * @param topic_name A DDS Topic Name
+             * @param type_support DDS Type Support holding a data_pub_sub_type
+             * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS
+             * DataWriter, which makes publishing slower but more reliable
+             * @param publish_mode Defines whether to publish synchronously or asynchronously, as defined in
+             * qos_defaults by default
+             * @see provizio::dds::serialized_pub_sub_type
+             */
+            publisher_handle(std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+                             dds::TypeSupport type_support,
+                             ReliabilityQosPolicyKind reliability_kind =
+                                 qos_defaults<data_pub_sub_type>::datawriter_reliability_kind,
+                             const publish_mode_options &publish_mode =
+                                 publish_mode_options::defaults<data_pub_sub_type>());
+
+            /**
+             * @brief Constructs a new publisher_handle object with a DDS Type Support of its own rather than a default
+             * constructed data_pub_sub_type, and an on_has_subscriber_changed function to be invoked on matching first
+             * / umatching last subscriber.
+             *
+             * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+             * @param topic_name A DDS Topic Name
+             * @param type_support DDS Type Support holding a data_pub_sub_type
+             * @param on_has_subscriber_changed_function Function to be invoked on matching first / umatching last
+             * subscriber, as in the constructor without type_support
+             * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS
+             * DataWriter, which makes publishing slower but more reliable
+             * @param publish_mode Defines whether to publish synchronously or asynchronously, as defined in
+             * qos_defaults by default
+             * @see provizio::dds::serialized_pub_sub_type
+             */
+            publisher_handle(std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+                             dds::TypeSupport type_support,
+                             on_has_subscriber_changed_function_type on_has_subscriber_changed_function,
+                             ReliabilityQosPolicyKind reliability_kind =
+                                 qos_defaults<data_pub_sub_type>::datawriter_reliability_kind,
+                             const publish_mode_options &publish_mode =
+                                 publish_mode_options::defaults<data_pub_sub_type>());
             ~publisher_handle();
 
             /**
@@ -138,22 +551,254 @@ namespace provizio
              */
             bool publish(data_type &data) override;
 
+            /**
+             * @brief Publishes the DDS data, reporting whether it was sent, queued to be sent asynchronously or
+             * dropped. In asynchronous publish mode it never blocks on a full history.
+             *
+             * @param data Actual DDS data to be published, f.e. std_msgs::msg::String
+             * @return The publish_status
+             */
+            publish_status publish_with_status(data_type &data) override;
+
+            /**
+             * @brief Registers an instance of a keyed DDS data type, so that its samples can be published by the
+             * instance handle, which saves computing the key on every publication. Samples of a keyed type are
+             * delivered, filtered and taken per instance (f.e. the data of a single radar sharing the topic with
+             * others).
+             *
+             * @param key_holder A sample with the key members of the instance filled in
+             * @return The instance handle, or HANDLE_NIL if the data type is not keyed or the instance can't be
+             * registered (f.e. due to resource limits)
+             * @see
+             * https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/topic/instances.html
+             */
+            InstanceHandle_t register_instance(data_type &key_holder);
+
+            /**
+             * @brief Publishes the DDS data as a sample of a registered instance
+             *
+             * @param data Actual DDS data to be published, its key members must match the instance
+             * @param instance Instance handle, as returned by register_instance
+             * @return true if published successfully, false otherwise
+             */
+            bool publish(data_type &data, const InstanceHandle_t &instance);
+
+            /**
+             * @brief Unregisters an instance, notifying the subscribers that it has no more data from this publisher
+             *
+             * @param key_holder A sample with the key members of the instance filled in
+             * @param instance Instance handle, as returned by register_instance
+             * @return true if unregistered successfully, false otherwise
+             */
+            bool unregister_instance(data_type &key_holder, const InstanceHandle_t &instance);
+
+            /**
+             * @brief Disposes an instance, notifying the subscribers that it no longer exists
+             *
+             * @param key_holder A sample with the key members of the instance filled in
+             * @param instance Instance handle, as returned by register_instance
+             * @return true if disposed successfully, false otherwise
+             */
+            bool dispose_instance(data_type &key_holder, const InstanceHandle_t &instance);
+
+            /**
+             * @brief Loans a sample from the DDS DataWriter if the data type is plain, or the publisher-owned reusable
+             * sample otherwise.
+             *
+             * @return The loaned sample, empty if no sample can be loaned at the moment
+             * @see provizio::dds::loaned_sample
+             */
+            loaned_sample<data_pub_sub_type> loan() override;
+
+            /**
+             * @brief Publishes a sample previously loaned with loan
+             *
+             * @param sample The loaned sample
+             * @return true if published successfully, false otherwise
+             */
+            bool publish_loaned(loaned_sample<data_pub_sub_type> &&sample) override;
+
+            /**
+             * @brief Reads the counters of the publisher: published samples and bytes, write failures and missed
+             * deadlines
+             *
+             * @return A snapshot of the counters
+             */
+            publisher_metrics metrics() const override;
+
+            /**
+             * @brief Enables or disables counting the published bytes of a data type that is not plain, which takes
+             * computing the serialized size of every published sample. Published bytes of plain data types are always
+             * counted, as their serialized size is fixed. Disabled by default.
+             *
+             * @param enabled true to count the published bytes, false otherwise
+             * @see provizio::dds::publisher_metrics::published_bytes
+             */
+            void count_published_bytes(bool enabled);
+
+            /**
+             * @brief Blocks until all the published samples are acknowledged by the reliable subscribers, f.e. before
+             * destroying the publisher, which would otherwise discard the samples not delivered yet
+             *
+             * @param timeout Max time to wait
+             * @return true if all the samples are acknowledged, false on timeout or error
+             */
+            bool wait_for_acknowledgments(std::chrono::milliseconds timeout);
+
+            /**
+             * @brief Asserts the publisher is alive without publishing, f.e. while it has nothing to publish. Required
+             * with the manual liveliness kinds of qos_defaults to stay alive within the lease duration: with
+             * MANUAL_BY_TOPIC_LIVELINESS_QOS it asserts this publisher only, with MANUAL_BY_PARTICIPANT_LIVELINESS_QOS
+             * all the publishers of the DDS Domain Participant of such kind.
+             *
+             * @return true if asserted successfully, false otherwise, f.e. if the DataWriter couldn't be created
+             * @see provizio::dds::default_qos_policies::liveliness_kind
+             */
+            bool assert_liveliness();
+
+            /**
+             * @brief Prepares the publisher for publishing with no allocations in a steady state, f.e. at system start
+             * rather than on the first publications. For plain data types all the samples of the DataWriter history
+             * are loaned and returned, so that their memory is in place. For other types the reusable sample returned
+             * by loan is assigned the prototype, so that its dynamic members get enough capacity. Best combined with
+             * the preallocate policy of qos_defaults, which preallocates the whole history on creation.
+             *
+             * @param prototype A sample of the largest expected size, it's not published
+             * @return true if warmed up, false if the DataWriter couldn't be created, the reusable sample is loaned or,
+             * for plain data types, allocated_samples of the DataWriter history is not positive, so there is nothing
+             * to warm up
+             * @see provizio::dds::default_qos_policies::preallocate
+             * @see provizio::dds::allocation_guard to verify no allocations take place
+             */
+            bool warm_up(const data_type &prototype);
+
+            /**
+             * @return Instance handle of the DDS DataWriter, as reported to subscribers in
+             * SampleInfo::publication_handle, or HANDLE_NIL if the DataWriter couldn't be created
+             */
+            InstanceHandle_t instance_handle() const;
+
+            /**
+             * @brief Checks the DDS DataReaders currently matched with the publisher, f.e. to find out whether any of
+             * them is in another process
+             *
+             * @param predicate Function / function object that takes the instance handle of a DataReader and returns
+             * a bool. It must not create or destroy DDS entities.
+             * @return true if the predicate holds for any of the matched DataReaders, false otherwise
+             */
+            template <typename predicate_type> bool any_matched_subscription(predicate_type predicate) const
+            {
+                return subscriptions.any_of(predicate);
+            }
+
+          protected:
+            void discard_loan(data_type *sample, bool middleware_owned) override;
+
           private:
             publisher_handle(std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+                             dds::TypeSupport type_support,
                              on_has_subscriber_changed_function_type on_has_subscriber_changed_function,
-                             std::unique_ptr<DataWriterListener> &&listener, ReliabilityQosPolicyKind reliability_kind);
+                             std::unique_ptr<DataWriterListener> &&listener, ReliabilityQosPolicyKind reliability_kind,
+                             const publish_mode_options &publish_mode);
+
+            bool write(data_type *data, const InstanceHandle_t &instance = HANDLE_NIL);
 
             std::shared_ptr<DomainParticipant> domain_participant;
             dds::TypeSupport type_support;
             on_has_subscriber_changed_function_type on_has_subscriber_changed_function;
             std::unique_ptr<DataWriterListener> listener;
-            Topic *topic = nullptr;
-            Publisher *publisher = nullptr;
+            std::shared_ptr<Topic> topic;
+            std::shared_ptr<Publisher> publisher;
+            std::string flow_controller_name;
+            bool asynchronous = false;
             DataWriter *data_writer = nullptr;
+            std::uint64_t introspection_id = 0;
+            data_type reusable_sample;
+            std::atomic<bool> reusable_sample_loaned{false};
+            detail::publisher_counters counters;
+            std::atomic<bool> counting_published_bytes{false};
+            detail::matched_subscriptions subscriptions;
 
             friend class detail::data_writer_listener<data_pub_sub_type, on_has_subscriber_changed_function_type>;
         };
 
+        /**
+         * @brief An on_has_subscriber_changed function of a publisher, stored with no heap allocations. Unlike
+         * lambdas, which make each publisher a publisher_handle type of its own, all the publishers of a data type
+         * created with a has_subscriber_changed_callback share one.
+         *
+         * @tparam data_pub_sub_type DDS data pub/sub type, f.e. std_msgs::msg::StringPubSubType
+         * @tparam capacity Max size of the stored function object
+         * @see provizio::dds::make_publisher
+         */
+        template <typename data_pub_sub_type, std::size_t capacity = default_inplace_function_capacity>
+        using has_subscriber_changed_callback =
+            inplace_function<void(data_publisher<data_pub_sub_type> &, bool), capacity>;
+
+        /**
+         * @brief A non-owning reference to any publisher_handle of a data type, regardless of its
+         * on_has_subscriber_changed function type. Publishing through it takes a single indirect call of a function
+         * that invokes the final publisher_handle::publish directly, rather than the virtual dispatch of
+         * data_publisher, f.e. for containers of publishers on the hot path. Code templated on the publisher type can
+         * use publisher_handle directly, as it's final.
+         *
+         * @tparam data_pub_sub_type DDS data pub/sub type, f.e. std_msgs::msg::StringPubSubType
+         */
+        template <typename data_pub_sub_type> class publisher_ref final
+        {
+          public:
+            using data_type = typename data_pub_sub_type::type;
+
+          public:
+            /**
+             * @brief Constructs a publisher_ref object referring to a publisher, which must outlive it
+             */
+            template <typename on_has_subscriber_changed_function_type>
+            publisher_ref( // NOLINT: implicit, so that publishers can be passed where a publisher_ref is expected
+                publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type> &publisher) noexcept
+                : publisher(&publisher),
+                  publish_function(&publish_with<publisher_type<on_has_subscriber_changed_function_type>>),
+                  publish_with_status_function(
+                      &publish_with_status_with<publisher_type<on_has_subscriber_changed_function_type>>)
+            {
+            }
+
+            /**
+             * @brief Publishes the DDS data, as publisher_handle::publish
+             */
+            bool publish(data_type &data) const
+            {
+                return publish_function(publisher, data);
+            }
+
+            /**
+             * @brief Publishes the DDS data, as publisher_handle::publish_with_status
+             */
+            publish_status publish_with_status(data_type &data) const
+            {
+                return publish_with_status_function(publisher, data);
+            }
+
+          private:
+            template <typename on_has_subscriber_changed_function_type>
+            using publisher_type = publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>;
+
+            template <typename target_type> static bool publish_with(void *publisher, data_type &data)
+            {
+                return static_cast<target_type *>(publisher)->publish(data);
+            }
+
+            template <typename target_type>
+            static publish_status publish_with_status_with(void *publisher, data_type &data)
+            {
+                return static_cast<target_type *>(publisher)->publish_with_status(data);
+            }
+
+            void *publisher;
+            bool (*publish_function)(void *, data_type &);
+            publish_status (*publish_with_status_function)(void *, data_type &);
+        };
+
         /**
          * @brief Creates a new publisher_handle object as a shared_ptr. The publisher_handle is automatically
          * deleted correctly on destroying its last shared_ptr.
@@ -163,9 +808,13 @@ namespace provizio
          * @param topic_name A DDS Topic Name
          * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS DataWriter,
          * which makes publishing slower but more reliable
-         * @return std::shared_ptr to the created publisher_handle
+         * @param publish_mode Defines whether to publish synchronously or asynchronously, as defined in qos_defaults
+         * by default
+         * @return std::shared_ptr to the created publisher_handle, or nullptr if its DDS DataWriter can't be created,
+         * f.e. as the topic exists with another type
          * @note Using BEST_EFFORT_RELIABILITY_QOS reliability_kind makes it incompatible with reliable subscribers
          * @see provizio::dds::publisher_handle
+         * @see provizio::dds::publish_mode_options
          * @see https://en.cppreference.com/w/cpp/memory/shared_ptr
          * @see
          * https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/core/policy/standardQosPolicies.html#reliabilityqospolicy
@@ -173,10 +822,11 @@ namespace provizio
         template <typename data_pub_sub_type>
         std::shared_ptr<publisher_handle<data_pub_sub_type>> make_publisher(
             std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
-            ReliabilityQosPolicyKind reliability_kind = qos_defaults<data_pub_sub_type>::datawriter_reliability_kind)
+            ReliabilityQosPolicyKind reliability_kind = qos_defaults<data_pub_sub_type>::datawriter_reliability_kind,
+            const publish_mode_options &publish_mode = publish_mode_options::defaults<data_pub_sub_type>())
         {
-            return std::make_shared<publisher_handle<data_pub_sub_type>>(std::move(domain_participant), topic_name,
-                                                                         reliability_kind);
+            return detail::created_or_null(std::make_shared<publisher_handle<data_pub_sub_type>>(
+                std::move(domain_participant), topic_name, reliability_kind, publish_mode));
         }
 
         /**
@@ -194,9 +844,13 @@ namespace provizio
          * @param on_has_subscriber_changed_function The on_has_subscriber_changed function
          * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS DataWriter,
          * which makes publishing slower but more reliable
-         * @return std::shared_ptr to the created publisher_handle
+         * @param publish_mode Defines whether to publish synchronously or asynchronously, as defined in qos_defaults
+         * by default
+         * @return std::shared_ptr to the created publisher_handle, or nullptr if its DDS DataWriter can't be created,
+         * f.e. as the topic exists with another type
          * @note Using BEST_EFFORT_RELIABILITY_QOS reliability_kind makes it incompatible with reliable subscribers
          * @see provizio::dds::publisher_handle
+         * @see provizio::dds::publish_mode_options
          * @see https://en.cppreference.com/w/cpp/memory/shared_ptr
          * @see
          * https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/core/policy/standardQosPolicies.html#reliabilityqospolicy
@@ -205,11 +859,68 @@ namespace provizio
         std::shared_ptr<publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>> make_publisher(
             std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
             on_has_subscriber_changed_function_type on_has_subscriber_changed_function,
-            ReliabilityQosPolicyKind reliability_kind = qos_defaults<data_pub_sub_type>::datawriter_reliability_kind)
+            ReliabilityQosPolicyKind reliability_kind = qos_defaults<data_pub_sub_type>::datawriter_reliability_kind,
+            const publish_mode_options &publish_mode = publish_mode_options::defaults<data_pub_sub_type>())
+        {
+            return detail::created_or_null(
+                std::make_shared<publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>>(
+                    std::move(domain_participant), topic_name, std::move(on_has_subscriber_changed_function),
+                    reliability_kind, publish_mode));
+        }
+
+        /**
+         * @brief Creates a new publisher_handle object as a shared_ptr, that publishes samples already serialized, f.e.
+         * as received by a provizio::dds::make_raw_subscriber, with no serialization. Use
+         * provizio::dds::serialized_sample::refer to publish serialized bytes without copying them into the sample.
+         *
+         * @tparam data_pub_sub_type DDS data pub/sub type of the topic, f.e. sensor_msgs::msg::PointCloud2PubSubType
+         * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant. It
+         * can't be shared with regular subscribers or publishers of the same data type.
+         * @param topic_name A DDS Topic Name
+         * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS DataWriter,
+         * which makes publishing slower but more reliable
+         * @param publish_mode Defines whether to publish synchronously or asynchronously, as defined in qos_defaults
+         * by default
+         * @return std::shared_ptr to the created publisher_handle, or nullptr if its DDS DataWriter can't be created,
+         * f.e. as the topic exists with another type
+         * @see provizio::dds::serialized_pub_sub_type_of
+         */
+        template <typename data_pub_sub_type>
+        std::shared_ptr<publisher_handle<serialized_pub_sub_type_of<data_pub_sub_type>>> make_raw_publisher(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            ReliabilityQosPolicyKind reliability_kind = qos_defaults<data_pub_sub_type>::datawriter_reliability_kind,
+            const publish_mode_options &publish_mode = publish_mode_options::defaults<data_pub_sub_type>())
+        {
+            return make_publisher<serialized_pub_sub_type_of<data_pub_sub_type>>(std::move(domain_participant),
+                                                                                 topic_name, reliability_kind,
+                                                                                 publish_mode);
+        }
+
+        /**
+         * @brief Creates a new publisher_handle object as a shared_ptr, that publishes samples already serialized, for
+         * a DDS data type only known by its name at run time
+         *
+         * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant. It
+         * can't be shared with regular subscribers or publishers of the same data type.
+         * @param topic_name A DDS Topic Name
+         * @param type_name DDS type name of the topic, f.e. "std_msgs::msg::dds_::String_"
+         * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS DataWriter,
+         * which makes publishing slower but more reliable
+         * @param publish_mode Defines whether to publish synchronously or asynchronously
+         * @return std::shared_ptr to the created publisher_handle, or nullptr if its DDS DataWriter can't be created,
+         * f.e. as the topic exists with another type
+         * @see provizio::dds::serialized_pub_sub_type
+         */
+        inline std::shared_ptr<publisher_handle<serialized_pub_sub_type>> make_raw_publisher(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            const std::string &type_name,
+            ReliabilityQosPolicyKind reliability_kind =
+                qos_defaults<serialized_pub_sub_type>::datawriter_reliability_kind,
+            const publish_mode_options &publish_mode = publish_mode_options::defaults<serialized_pub_sub_type>())
         {
-            return std::make_shared<publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>>(
-                std::move(domain_participant), topic_name, std::move(on_has_subscriber_changed_function),
-                reliability_kind);
+            return detail::created_or_null(std::make_shared<publisher_handle<serialized_pub_sub_type>>(
+                std::move(domain_participant), topic_name, dds::TypeSupport(new serialized_pub_sub_type(type_name)),
+                reliability_kind, publish_mode));
         }
 
         namespace detail
@@ -227,6 +938,7 @@ namespace provizio
                 void on_publication_matched(DataWriter *writer, const PublicationMatchedStatus &info) override
                 {
                     (void)writer;
+                    publisher.subscriptions.update(info);
                     if (info.current_count > 0 && info.current_count_change == info.current_count)
                     {
                         // Just matched the first publisher
@@ -239,6 +951,12 @@ namespace provizio
                     }
                 }
 
+                void on_offered_deadline_missed(DataWriter *writer, const OfferedDeadlineMissedStatus &status) override
+                {
+                    (void)writer;
+                    publisher.counters.count_deadlines_missed(status.total_count_change);
+                }
+
               private:
                 publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type> &publisher;
             };
@@ -247,9 +965,9 @@ namespace provizio
         template <typename data_pub_sub_type, typename on_has_subscriber_changed_function_type>
         publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>::publisher_handle(
             std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
-            const ReliabilityQosPolicyKind reliability_kind)
-            : publisher_handle(std::move(domain_participant), topic_name, nullptr,
-                               std::unique_ptr<DataWriterListener>{}, reliability_kind)
+            const ReliabilityQosPolicyKind reliability_kind, const publish_mode_options &publish_mode)
+            : publisher_handle(std::move(domain_participant), topic_name, dds::TypeSupport(new data_pub_sub_type()),
+                               reliability_kind, publish_mode)
         {
         }
 
@@ -257,59 +975,328 @@ namespace provizio
         publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>::publisher_handle(
             std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
             on_has_subscriber_changed_function_type on_has_subscriber_changed_function,
-            const ReliabilityQosPolicyKind reliability_kind)
+            const ReliabilityQosPolicyKind reliability_kind, const publish_mode_options &publish_mode)
+            : publisher_handle(std::move(domain_participant), topic_name, dds::TypeSupport(new data_pub_sub_type()),
+                               std::move(on_has_subscriber_changed_function), reliability_kind, publish_mode)
+        {
+        }
+
+        template <typename data_pub_sub_type, typename on_has_subscriber_changed_function_type>
+        publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>::publisher_handle(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            dds::TypeSupport type_support, const ReliabilityQosPolicyKind reliability_kind,
+            const publish_mode_options &publish_mode)
+            : publisher_handle(std::move(domain_participant), topic_name, std::move(type_support), nullptr,
+                               std::unique_ptr<DataWriterListener>{}, reliability_kind, publish_mode)
+        {
+        }
+
+        template <typename data_pub_sub_type, typename on_has_subscriber_changed_function_type>
+        publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>::publisher_handle(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            dds::TypeSupport type_support, on_has_subscriber_changed_function_type on_has_subscriber_changed_function,
+            const ReliabilityQosPolicyKind reliability_kind, const publish_mode_options &publish_mode)
             : publisher_handle(
-                  std::move(domain_participant), topic_name, std::move(on_has_subscriber_changed_function),
+                  std::move(domain_participant), topic_name, std::move(type_support),
+                  std::move(on_has_subscriber_changed_function),
                   std::make_unique<
                       detail::data_writer_listener<data_pub_sub_type, on_has_subscriber_changed_function_type>>(*this),
-                  reliability_kind)
+                  reliability_kind, publish_mode)
         {
         }
 
         template <typename data_pub_sub_type, typename on_has_subscriber_changed_function_type>
         publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>::publisher_handle(
             std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
-            on_has_subscriber_changed_function_type on_has_subscriber_changed_function,
-            std::unique_ptr<DataWriterListener> &&listener, const ReliabilityQosPolicyKind reliability_kind)
-            : domain_participant(std::move(domain_participant)), type_support(new data_pub_sub_type()),
+            dds::TypeSupport type_support, on_has_subscriber_changed_function_type on_has_subscriber_changed_function,
+            std::unique_ptr<DataWriterListener> &&listener, const ReliabilityQosPolicyKind reliability_kind,
+            const publish_mode_options &publish_mode)
+            : domain_participant(std::move(domain_participant)), type_support(std::move(type_support)),
               on_has_subscriber_changed_function(std::move(on_has_subscriber_changed_function)),
-              listener(std::move(listener))
+              listener(std::move(listener)), flow_controller_name(publish_mode.flow_controller_name),
+              asynchronous(publish_mode.kind == ASYNCHRONOUS_PUBLISH_MODE)
         {
-            const auto &topic_qos = TOPIC_QOS_DEFAULT;
-            const auto &publisher_qos = PUBLISHER_QOS_DEFAULT;
             auto datawriter_qos = DATAWRITER_QOS_DEFAULT;
             datawriter_qos.reliability().kind = reliability_kind;
-            datawriter_qos.endpoint().history_memory_policy = qos_defaults<data_pub_sub_type>::memory_policy;
+            detail::apply_qos_defaults<data_pub_sub_type>(datawriter_qos, this->type_support);
+            datawriter_qos.endpoint().user_defined_id =
+                static_endpoint_user_id(this->domain_participant, topic_name, static_endpoint_kind::writer);
+            datawriter_qos.publish_mode().kind = publish_mode.kind;
+            if (asynchronous)
+            {
+                // Drop rather than block the publishing thread when the history is full of unacknowledged samples
+                datawriter_qos.reliability().max_blocking_time = Duration_t{0, 0};
+                if (!flow_controller_name.empty())
+                {
+                    // Kept alive by the handle, as Fast-DDS only stores the pointer
+                    datawriter_qos.publish_mode().flow_controller_name = flow_controller_name.c_str();
+                }
+            }
 
-            type_support.register_type(this->domain_participant.get());
-            topic = this->domain_participant->create_topic(topic_name, type_support->getName(), topic_qos);
-            publisher = this->domain_participant->create_publisher(publisher_qos);
-            data_writer = publisher->create_datawriter(topic, datawriter_qos, this->listener.get());
+            if (!this->listener)
+            {
+                this->listener = std::make_unique<detail::counting_data_writer_listener>(counters, subscriptions);
+            }
+
+            topic = acquire_topic(this->domain_participant, topic_name, this->type_support);
+            publisher = acquire_publisher(this->domain_participant);
+            if (topic && publisher)
+            {
+                // Fast-DDS starts the sending thread of a flow controller along with its first asynchronous DataWriter
+                const scoped_thread_settings writer_thread_settings{
+                    asynchronous ? async_writer_thread_settings(this->domain_participant) : thread_settings{}};
+                data_writer = publisher->create_datawriter(topic.get(), datawriter_qos, this->listener.get());
+                introspection_id = detail::register_introspected(this->domain_participant, data_writer,
+                                                                 [this]() { return counters.snapshot(); });
+            }
         }
 
         template <typename data_pub_sub_type, typename on_has_subscriber_changed_function_type>
         publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>::~publisher_handle()
         {
+            detail::unregister_introspected(introspection_id);
             if (data_writer != nullptr)
             {
                 publisher->delete_datawriter(data_writer);
             }
+        }
+
+        template <typename data_pub_sub_type, typename on_has_subscriber_changed_function_type>
+        bool publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>::publish(data_type &data)
+        {
+            return write(&data);
+        }
+
+        template <typename data_pub_sub_type, typename on_has_subscriber_changed_function_type>
+        publish_status
+        publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>::publish_with_status(
+            data_type &data)
+        {
+            if (!write(&data))
+            {
+                return publish_status::dropped;
+            }
+
+            return asynchronous ? publish_status::queued : publish_status::published;
+        }
+
+        template <typename data_pub_sub_type, typename on_has_subscriber_changed_function_type>
+        InstanceHandle_t
+        publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>::register_instance(
+            data_type &key_holder)
+        {
+            return data_writer != nullptr ? data_writer->register_instance(&key_holder) : HANDLE_NIL;
+        }
+
+        template <typename data_pub_sub_type, typename on_has_subscriber_changed_function_type>
+        bool publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>::publish(
+            data_type &data, const InstanceHandle_t &instance)
+        {
+            return write(&data, instance);
+        }
+
+        template <typename data_pub_sub_type, typename on_has_subscriber_changed_function_type>
+        bool publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>::unregister_instance(
+            data_type &key_holder, const InstanceHandle_t &instance)
+        {
+            return data_writer != nullptr &&
+                   data_writer->unregister_instance(&key_holder, instance) == ReturnCode_t::RETCODE_OK;
+        }
+
+        template <typename data_pub_sub_type, typename on_has_subscriber_changed_function_type>
+        bool publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>::dispose_instance(
+            data_type &key_holder, const InstanceHandle_t &instance)
+        {
+            return data_writer != nullptr && data_writer->dispose(&key_holder, instance) == ReturnCode_t::RETCODE_OK;
+        }
+
+        template <typename data_pub_sub_type, typename on_has_subscriber_changed_function_type>
+        loaned_sample<data_pub_sub_type> publisher_handle<data_pub_sub_type,
+                                                          on_has_subscriber_changed_function_type>::loan()
+        {
+            if (data_writer == nullptr)
+            {
+                return {};
+            }
 
-            if (publisher != nullptr)
+            if (type_support->is_plain())
             {
-                domain_participant->delete_publisher(publisher);
+                void *sample = nullptr;
+                if (data_writer->loan_sample(sample,
+                                             DataWriter::LoanInitializationKind::CONSTRUCTED_LOAN_INITIALIZATION) ==
+                    ReturnCode_t::RETCODE_OK)
+                {
+                    return {*this, static_cast<data_type *>(sample), true};
+                }
+
+                return {};
             }
 
-            if (topic != nullptr)
+            bool expected = false;
+            if (reusable_sample_loaned.compare_exchange_strong(expected, true))
             {
-                domain_participant->delete_topic(topic);
+                return {*this, &reusable_sample, false};
             }
+
+            return {};
         }
 
         template <typename data_pub_sub_type, typename on_has_subscriber_changed_function_type>
-        bool publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>::publish(data_type &data)
+        bool publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>::publish_loaned(
+            loaned_sample<data_pub_sub_type> &&sample)
         {
-            return data_writer->write(&data);
+            if (!sample.is_loaned_from(*this))
+            {
+                // Returned to the publisher it was loaned from, if any
+                sample.reset();
+                return false;
+            }
+
+            if (!sample.is_middleware_owned())
+            {
+                const bool result = write(sample.get());
+                sample.reset();
+                return result;
+            }
+
+            // On success the loan is taken back by the DataWriter, otherwise it has to be discarded
+            if (write(sample.get()))
+            {
+                sample.release();
+                return true;
+            }
+
+            sample.reset();
+            return false;
+        }
+
+        template <typename data_pub_sub_type, typename on_has_subscriber_changed_function_type>
+        publisher_metrics publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>::metrics() const
+        {
+            return counters.snapshot();
+        }
+
+        template <typename data_pub_sub_type, typename on_has_subscriber_changed_function_type>
+        void publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>::count_published_bytes(
+            const bool enabled)
+        {
+            counting_published_bytes.store(enabled, std::memory_order_relaxed);
+        }
+
+        template <typename data_pub_sub_type, typename on_has_subscriber_changed_function_type>
+        bool publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>::wait_for_acknowledgments(
+            const std::chrono::milliseconds timeout)
+        {
+            return data_writer != nullptr &&
+                   data_writer->wait_for_acknowledgments(detail::to_duration(timeout)) == ReturnCode_t::RETCODE_OK;
+        }
+
+        template <typename data_pub_sub_type, typename on_has_subscriber_changed_function_type>
+        bool publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>::assert_liveliness()
+        {
+            return data_writer != nullptr && data_writer->assert_liveliness() == ReturnCode_t::RETCODE_OK;
+        }
+
+        template <typename data_pub_sub_type, typename on_has_subscriber_changed_function_type>
+        bool publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>::warm_up(
+            const data_type &prototype)
+        {
+            if (data_writer == nullptr)
+            {
+                return false;
+            }
+
+            if (type_support->is_plain())
+            {
+                // Loaning all samples at once makes the history allocate (and touch) each of them
+                const std::int32_t allocated_samples = data_writer->get_qos().resource_limits().allocated_samples;
+                if (allocated_samples <= 0)
+                {
+                    return false;
+                }
+
+                const auto samples_count = static_cast<std::size_t>(allocated_samples);
+                std::vector<void *> loaned;
+                loaned.reserve(samples_count);
+                void *sample = nullptr;
+                while (loaned.size() < samples_count &&
+                       data_writer->loan_sample(
+                           sample, DataWriter::LoanInitializationKind::NO_LOAN_INITIALIZATION) ==
+                           ReturnCode_t::RETCODE_OK)
+                {
+                    loaned.push_back(sample);
+                }
+                for (void *loaned_data : loaned)
+                {
+                    data_writer->discard_loan(loaned_data);
+                }
+                return true;
+            }
+
+            bool expected = false;
+            if (!reusable_sample_loaned.compare_exchange_strong(expected, true))
+            {
+                return false;
+            }
+
+            reusable_sample = prototype;
+            reusable_sample_loaned = false;
+            return true;
+        }
+
+        template <typename data_pub_sub_type, typename on_has_subscriber_changed_function_type>
+        InstanceHandle_t publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>::instance_handle()
+            const
+        {
+            return data_writer != nullptr ? data_writer->get_instance_handle() : HANDLE_NIL;
+        }
+
+        template <typename data_pub_sub_type, typename on_has_subscriber_changed_function_type>
+        bool publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>::write(
+            data_type *data, const InstanceHandle_t &instance)
+        {
+            if (data_writer == nullptr)
+            {
+                counters.count_write_failure();
+                return false;
+            }
+
+            // Computed in advance, as a loaned sample is not to be accessed once written
+            std::uint32_t bytes = 0;
+            if (type_support->is_plain())
+            {
+                bytes = type_support->m_typeSize;
+            }
+            else if (counting_published_bytes.load(std::memory_order_relaxed))
+            {
+                bytes = type_support->getSerializedSizeProvider(data)();
+            }
+            const bool written = instance == HANDLE_NIL
+                                     ? data_writer->write(data)
+                                     : data_writer->write(data, instance) == ReturnCode_t::RETCODE_OK;
+            if (written)
+            {
+                counters.count_published(bytes);
+                return true;
+            }
+
+            counters.count_write_failure();
+            return false;
+        }
+
+        template <typename data_pub_sub_type, typename on_has_subscriber_changed_function_type>
+        void publisher_handle<data_pub_sub_type, on_has_subscriber_changed_function_type>::discard_loan(
+            data_type *sample, const bool middleware_owned)
+        {
+            if (middleware_owned)
+            {
+                void *loaned = sample;
+                data_writer->discard_loan(loaned);
+            }
+            else
+            {
+                reusable_sample_loaned = false;
+            }
         }
     } // namespace dds
 } // namespace provizio
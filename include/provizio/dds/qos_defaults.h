@@ -15,23 +15,41 @@
 #ifndef DDS_QOS_DEFAULTS
 #define DDS_QOS_DEFAULTS
 
+#include <chrono>
+#include <cstdint>
+
+#include <fastdds/dds/core/policy/QosPolicies.hpp>
+#include <fastdds/dds/publisher/qos/DataWriterQos.hpp>
+#include <fastdds/dds/subscriber/qos/DataReaderQos.hpp>
+#include <fastdds/dds/topic/TypeSupport.hpp>
 #include <fastdds/rtps/resources/ResourceManagement.h>
 #include <fastrtps/qos/QosPolicies.h>
 
 #include "provizio/dds/common.h"
 
+// Forward declarations of large data types with specialized qos_defaults, as generated by provizio_dds_idls
+namespace sensor_msgs
+{
+    namespace msg
+    {
+        class PointCloud2PubSubType;
+        class ImagePubSubType;
+        class CompressedImagePubSubType;
+    } // namespace msg
+} // namespace sensor_msgs
+
 namespace provizio
 {
     namespace dds
     {
         /**
-         * @brief Defines default QOS policies for a DDS data type. They can be overriden in template specializations
-         * for specific types.
+         * @brief Default QOS policies for DDS data types, to be used as a base of provizio::dds::qos_defaults and its
+         * specializations, so a specialization only has to override the policies it changes.
          *
-         * @tparam data_pub_sub_type DDS data pub/sub type, f.e. std_msgs::msg::StringPubSubType
+         * @see provizio::dds::qos_defaults
          * @see https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/core/policy/policy.html
          */
-        template <typename data_pub_sub_type> struct qos_defaults final
+        struct default_qos_policies
         {
             /**
              * @brief Defines whether to use reliable data writer DDS QOS policies. RELIABLE_RELIABILITY_QOS by default
@@ -57,7 +75,364 @@ namespace provizio
              * https://fast-dds.docs.eprosima.com/en/latest/fastdds/api_reference/rtps/resources/MemoryManagementPolicy.html
              */
             static constexpr auto memory_policy = eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
+
+            /**
+             * @brief Defines the data-sharing delivery policy for both data reader and data writer. AUTO by default in
+             * Fast-DDS, which enables data-sharing (zero-copy on the same host) when the type is bounded and disables
+             * it otherwise. ON requires a bounded type.
+             * @see https://fast-dds.docs.eprosima.com/en/latest/fastdds/transport/datasharing.html
+             */
+            static constexpr DataSharingKind data_sharing_kind = AUTO;
+
+            /**
+             * @brief Defines the history kind for both data reader and data writer. KEEP_LAST_HISTORY_QOS by default in
+             * Fast-DDS.
+             * @see
+             * https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/core/policy/standardQosPolicies.html#historyqospolicy
+             */
+            static constexpr HistoryQosPolicyKind history_kind = KEEP_LAST_HISTORY_QOS;
+
+            /**
+             * @brief Defines the history depth for both data reader and data writer, only used along with
+             * KEEP_LAST_HISTORY_QOS. 1 by default in Fast-DDS.
+             * @see
+             * https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/core/policy/standardQosPolicies.html#historyqospolicy
+             */
+            static constexpr std::int32_t history_depth = 1;
+
+            /**
+             * @brief Defines the maximum number of samples in the history of both data reader and data writer. 5000 by
+             * default in Fast-DDS.
+             * @see
+             * https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/core/policy/standardQosPolicies.html#resourcelimitsqospolicy
+             */
+            static constexpr std::int32_t max_samples = 5000;
+
+            /**
+             * @brief Defines the maximum number of instances in the history of both data reader and data writer. 10 by
+             * default in Fast-DDS. max_instances * max_samples_per_instance may not exceed max_samples.
+             * @see
+             * https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/core/policy/standardQosPolicies.html#resourcelimitsqospolicy
+             */
+            static constexpr std::int32_t max_instances = 10;
+
+            /**
+             * @brief Defines the maximum number of samples of a single instance in the history of both data reader and
+             * data writer. 400 by default in Fast-DDS. It may not be less than history_depth.
+             * @see
+             * https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/core/policy/standardQosPolicies.html#resourcelimitsqospolicy
+             */
+            static constexpr std::int32_t max_samples_per_instance = 400;
+
+            /**
+             * @brief Defines the number of samples to be allocated in the history of both data reader and data writer
+             * on creation. 100 by default in Fast-DDS.
+             * @see
+             * https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/core/policy/standardQosPolicies.html#resourcelimitsqospolicy
+             */
+            static constexpr std::int32_t allocated_samples = 100;
+
+            /**
+             * @brief Defines whether data writers publish synchronously (in the calling thread) or asynchronously.
+             * SYNCHRONOUS_PUBLISH_MODE by default in Fast-DDS.
+             * @see
+             * https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/core/policy/eprosimaExtensions.html#publishmodeqospolicy
+             */
+            static constexpr PublishModeQosPolicyKind publish_mode_kind = SYNCHRONOUS_PUBLISH_MODE;
+
+            /**
+             * @brief Defines whether the histories of both data reader and data writer are fully preallocated on
+             * creation, so that no allocations take place on publishing and receiving in a steady state: as many
+             * samples are allocated as the history can hold (history_depth for KEEP_LAST_HISTORY_QOS, max_samples for
+             * KEEP_ALL_HISTORY_QOS, which then must not be LENGTH_UNLIMITED), and for bounded types their payloads are
+             * preallocated at the max serialized size with PREALLOCATED_MEMORY_MODE. Payloads of unbounded types still
+             * grow on first use up to the size of the largest sample. false by default, to save memory.
+             * @see provizio::dds::publisher_handle::warm_up
+             * @see
+             * https://fast-dds.docs.eprosima.com/en/latest/fastdds/use_cases/realtime/allocations.html
+             */
+            static constexpr bool preallocate = false;
+
+            /**
+             * @brief Defines the max period between samples of an instance, in milliseconds, or 0 for none. Missing
+             * it is reported to provizio::dds::subscriber_health_callbacks::on_requested_deadline_missed and counted
+             * in the metrics of both data reader and data writer. Data readers only match data writers with the same
+             * or a shorter period. 0 (infinite) by default in Fast-DDS.
+             * @see
+             * https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/core/policy/standardQosPolicies.html#deadlineqospolicy
+             */
+            static constexpr std::int64_t deadline_period_milliseconds = 0;
+
+            /**
+             * @brief Defines how data writers assert they are alive. AUTOMATIC_LIVELINESS_QOS by default in Fast-DDS,
+             * which asserts it while the participant is running. With MANUAL_BY_PARTICIPANT_LIVELINESS_QOS and
+             * MANUAL_BY_TOPIC_LIVELINESS_QOS it's asserted by publishing or
+             * provizio::dds::publisher_handle::assert_liveliness.
+             * @see
+             * https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/core/policy/standardQosPolicies.html#livelinessqospolicy
+             */
+            static constexpr LivelinessQosPolicyKind liveliness_kind = AUTOMATIC_LIVELINESS_QOS;
+
+            /**
+             * @brief Defines the time after the last liveliness assertion of a data writer, in milliseconds, when it's
+             * considered not alive, or 0 for never. Data writers assert it at half of the period. Changes are reported
+             * to provizio::dds::subscriber_health_callbacks::on_liveliness_changed. 0 (infinite) by default in
+             * Fast-DDS.
+             * @see
+             * https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/core/policy/standardQosPolicies.html#livelinessqospolicy
+             */
+            static constexpr std::int64_t liveliness_lease_duration_milliseconds = 0;
+
+            /**
+             * @brief Defines the time after publishing, in milliseconds, when a sample expires and is removed from the
+             * histories of both data reader and data writer, so that stale samples are never delivered, or 0 for
+             * never. Requires synchronized clocks between hosts. 0 (infinite) by default in Fast-DDS.
+             * @see
+             * https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/core/policy/standardQosPolicies.html#lifespanqospolicy
+             */
+            static constexpr std::int64_t lifespan_milliseconds = 0;
         };
+
+        /**
+         * @brief QOS policies suited for large samples, f.e. point clouds or images, which are normally only relevant
+         * while fresh: only the latest sample is kept in the history and just a couple of samples are allocated, so
+         * that no memory is wasted on large buffers that are never used.
+         *
+         * @see provizio::dds::qos_defaults
+         */
+        struct large_data_qos_policies : default_qos_policies
+        {
+            static constexpr HistoryQosPolicyKind history_kind = KEEP_LAST_HISTORY_QOS;
+            static constexpr std::int32_t history_depth = 1;
+            static constexpr std::int32_t max_samples = 4;
+            static constexpr std::int32_t max_instances = 1;
+            static constexpr std::int32_t max_samples_per_instance = 4;
+            static constexpr std::int32_t allocated_samples = 2;
+        };
+
+        /**
+         * @brief Defines default QOS policies for a DDS data type. They can be overriden in template specializations
+         * for specific types, which are recommended to derive from provizio::dds::default_qos_policies (or
+         * provizio::dds::large_data_qos_policies) and override the necessary policies only. Policies missing in a
+         * specialization fall back to provizio::dds::default_qos_policies.
+         *
+         * @tparam data_pub_sub_type DDS data pub/sub type, f.e. std_msgs::msg::StringPubSubType
+         * @see provizio::dds::default_qos_policies
+         * @see https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/core/policy/policy.html
+         */
+        template <typename data_pub_sub_type> struct qos_defaults final : default_qos_policies
+        {
+        };
+
+        template <> struct qos_defaults<sensor_msgs::msg::PointCloud2PubSubType> final : large_data_qos_policies
+        {
+        };
+
+        template <> struct qos_defaults<sensor_msgs::msg::ImagePubSubType> final : large_data_qos_policies
+        {
+        };
+
+        template <> struct qos_defaults<sensor_msgs::msg::CompressedImagePubSubType> final : large_data_qos_policies
+        {
+        };
+
+        namespace detail
+        {
+            template <typename...> struct make_void
+            {
+                using type = void;
+            };
+
+            template <typename... types> using void_t = typename make_void<types...>::type;
+
+// Defines qos_policy_<name><defaults>::value as defaults::<name> if declared, or default_qos_policies::<name> otherwise
+#define DDS_QOS_POLICY_WITH_FALLBACK(name)                                                                             \
+    template <typename defaults, typename = void> struct qos_policy_##name                                             \
+    {                                                                                                                  \
+        static constexpr auto value = default_qos_policies::name;                                                      \
+    };                                                                                                                 \
+    template <typename defaults> struct qos_policy_##name<defaults, void_t<decltype(defaults::name)>>                  \
+    {                                                                                                                  \
+        static constexpr auto value = defaults::name;                                                                  \
+    }
+
+            DDS_QOS_POLICY_WITH_FALLBACK(datawriter_reliability_kind);
+            DDS_QOS_POLICY_WITH_FALLBACK(datareader_reliability_kind);
+            DDS_QOS_POLICY_WITH_FALLBACK(memory_policy);
+            DDS_QOS_POLICY_WITH_FALLBACK(data_sharing_kind);
+            DDS_QOS_POLICY_WITH_FALLBACK(history_kind);
+            DDS_QOS_POLICY_WITH_FALLBACK(history_depth);
+            DDS_QOS_POLICY_WITH_FALLBACK(max_samples);
+            DDS_QOS_POLICY_WITH_FALLBACK(max_instances);
+            DDS_QOS_POLICY_WITH_FALLBACK(max_samples_per_instance);
+            DDS_QOS_POLICY_WITH_FALLBACK(allocated_samples);
+            DDS_QOS_POLICY_WITH_FALLBACK(publish_mode_kind);
+            DDS_QOS_POLICY_WITH_FALLBACK(preallocate);
+            DDS_QOS_POLICY_WITH_FALLBACK(deadline_period_milliseconds);
+            DDS_QOS_POLICY_WITH_FALLBACK(liveliness_kind);
+            DDS_QOS_POLICY_WITH_FALLBACK(liveliness_lease_duration_milliseconds);
+            DDS_QOS_POLICY_WITH_FALLBACK(lifespan_milliseconds);
+
+#undef DDS_QOS_POLICY_WITH_FALLBACK
+
+            /**
+             * @brief All policies of qos_defaults of a DDS data type, including the ones its specialization doesn't
+             * declare (f.e. as it was written before they were introduced), which take the values of
+             * default_qos_policies
+             *
+             * @tparam data_pub_sub_type DDS data pub/sub type, f.e. std_msgs::msg::StringPubSubType
+             */
+            template <typename data_pub_sub_type> struct qos_policies_of
+            {
+                using defaults = qos_defaults<data_pub_sub_type>;
+
+                static constexpr ReliabilityQosPolicyKind datawriter_reliability_kind =
+                    qos_policy_datawriter_reliability_kind<defaults>::value;
+                static constexpr ReliabilityQosPolicyKind datareader_reliability_kind =
+                    qos_policy_datareader_reliability_kind<defaults>::value;
+                static constexpr auto memory_policy = qos_policy_memory_policy<defaults>::value;
+                static constexpr DataSharingKind data_sharing_kind = qos_policy_data_sharing_kind<defaults>::value;
+                static constexpr HistoryQosPolicyKind history_kind = qos_policy_history_kind<defaults>::value;
+                static constexpr std::int32_t history_depth = qos_policy_history_depth<defaults>::value;
+                static constexpr std::int32_t max_samples = qos_policy_max_samples<defaults>::value;
+                static constexpr std::int32_t max_instances = qos_policy_max_instances<defaults>::value;
+                static constexpr std::int32_t max_samples_per_instance =
+                    qos_policy_max_samples_per_instance<defaults>::value;
+                static constexpr std::int32_t allocated_samples = qos_policy_allocated_samples<defaults>::value;
+                static constexpr PublishModeQosPolicyKind publish_mode_kind =
+                    qos_policy_publish_mode_kind<defaults>::value;
+                static constexpr bool preallocate = qos_policy_preallocate<defaults>::value;
+                static constexpr std::int64_t deadline_period_milliseconds =
+                    qos_policy_deadline_period_milliseconds<defaults>::value;
+                static constexpr LivelinessQosPolicyKind liveliness_kind = qos_policy_liveliness_kind<defaults>::value;
+                static constexpr std::int64_t liveliness_lease_duration_milliseconds =
+                    qos_policy_liveliness_lease_duration_milliseconds<defaults>::value;
+                static constexpr std::int64_t lifespan_milliseconds = qos_policy_lifespan_milliseconds<defaults>::value;
+            };
+
+            /**
+             * @brief Applies a data sharing kind to a DataSharingQosPolicy, using default shared memory directory
+             */
+            inline void apply_data_sharing_kind(DataSharingQosPolicy &policy, const DataSharingKind kind)
+            {
+                switch (kind)
+                {
+                case ON:
+                    policy.on("");
+                    break;
+
+                case OFF:
+                    policy.off();
+                    break;
+
+                default:
+                    policy.automatic();
+                    break;
+                }
+            }
+
+            /**
+             * @brief Converts a period of qos_defaults in milliseconds to a Duration_t, 0 meaning infinite
+             */
+            inline Duration_t to_duration_or_infinite(const std::int64_t milliseconds)
+            {
+                return milliseconds > 0 ? to_duration(std::chrono::milliseconds(milliseconds))
+                                        : eprosima::fastrtps::c_TimeInfinite;
+            }
+
+            /**
+             * @brief Converts a liveliness lease duration of qos_defaults in milliseconds to the period of automatic
+             * liveliness assertions: half of the lease, as it must be shorter, or infinite for an infinite lease.
+             * Computed in microseconds, so that a lease of a millisecond doesn't end up with a 0 (i.e. infinite)
+             * period.
+             */
+            inline Duration_t liveliness_announcement_period(const std::int64_t lease_duration_milliseconds)
+            {
+                return lease_duration_milliseconds > 0
+                           ? to_duration(std::chrono::microseconds(lease_duration_milliseconds * 1000 / 2))
+                           : eprosima::fastrtps::c_TimeInfinite;
+            }
+
+            /**
+             * @brief Applies the policies of qos_defaults, shared by data readers and data writers
+             */
+            template <typename data_pub_sub_type, typename endpoint_qos_type>
+            void apply_common_qos_defaults(endpoint_qos_type &qos)
+            {
+                using defaults = qos_policies_of<data_pub_sub_type>;
+
+                qos.endpoint().history_memory_policy = defaults::memory_policy;
+                apply_data_sharing_kind(qos.data_sharing(), defaults::data_sharing_kind);
+                qos.history().kind = defaults::history_kind;
+                qos.history().depth = defaults::history_depth;
+                qos.resource_limits().max_samples = defaults::max_samples;
+                qos.resource_limits().max_instances = defaults::max_instances;
+                qos.resource_limits().max_samples_per_instance = defaults::max_samples_per_instance;
+                qos.resource_limits().allocated_samples = defaults::allocated_samples;
+                qos.deadline().period = to_duration_or_infinite(defaults::deadline_period_milliseconds);
+                qos.liveliness().kind = defaults::liveliness_kind;
+                qos.liveliness().lease_duration =
+                    to_duration_or_infinite(defaults::liveliness_lease_duration_milliseconds);
+                qos.lifespan().duration = to_duration_or_infinite(defaults::lifespan_milliseconds);
+            }
+
+            /**
+             * @brief Applies the preallocation policy of qos_defaults, shared by data readers and data writers
+             */
+            template <typename data_pub_sub_type, typename endpoint_qos_type>
+            void apply_preallocation(endpoint_qos_type &qos, const dds::TypeSupport &type_support)
+            {
+                using defaults = qos_policies_of<data_pub_sub_type>;
+
+                // LENGTH_UNLIMITED (or any non-positive value) of max_samples leaves nothing to preallocate
+                constexpr bool unlimited_samples = defaults::max_samples <= 0;
+                static_assert(!defaults::preallocate || defaults::history_kind == KEEP_LAST_HISTORY_QOS ||
+                                  !unlimited_samples,
+                              "preallocate with KEEP_ALL_HISTORY_QOS requires a limited max_samples");
+
+                if (!defaults::preallocate)
+                {
+                    return;
+                }
+
+                // The whole history is allocated at once, rather than growing up to max_samples on demand
+                const std::int32_t history_size =
+                    defaults::history_kind == KEEP_LAST_HISTORY_QOS &&
+                            (unlimited_samples || defaults::history_depth < defaults::max_samples)
+                        ? defaults::history_depth
+                        : defaults::max_samples;
+                qos.resource_limits().allocated_samples = history_size;
+                if (type_support->is_bounded())
+                {
+                    // Payloads of max_serialized_size are allocated along with the samples and never reallocated
+                    qos.endpoint().history_memory_policy = eprosima::fastrtps::rtps::PREALLOCATED_MEMORY_MODE;
+                }
+            }
+
+            /**
+             * @brief Applies qos_defaults to a DataWriterQos, except for the reliability kind
+             */
+            template <typename data_pub_sub_type>
+            void apply_qos_defaults(DataWriterQos &qos, const dds::TypeSupport &type_support)
+            {
+                apply_common_qos_defaults<data_pub_sub_type>(qos);
+                apply_preallocation<data_pub_sub_type>(qos, type_support);
+                qos.publish_mode().kind = qos_policies_of<data_pub_sub_type>::publish_mode_kind;
+
+                qos.liveliness().announcement_period = liveliness_announcement_period(
+                    qos_policies_of<data_pub_sub_type>::liveliness_lease_duration_milliseconds);
+            }
+
+            /**
+             * @brief Applies qos_defaults to a DataReaderQos, except for the reliability kind
+             */
+            template <typename data_pub_sub_type>
+            void apply_qos_defaults(DataReaderQos &qos, const dds::TypeSupport &type_support)
+            {
+                apply_common_qos_defaults<data_pub_sub_type>(qos);
+                apply_preallocation<data_pub_sub_type>(qos, type_support);
+            }
+        } // namespace detail
     } // namespace dds
 } // namespace provizio
 
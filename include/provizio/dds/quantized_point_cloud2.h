@@ -0,0 +1,172 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DDS_QUANTIZED_POINT_CLOUD2
+#define DDS_QUANTIZED_POINT_CLOUD2
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sensor_msgs/msg/PointCloud2PubSubTypes.h>
+
+#include "provizio/dds/point_cloud2.h"
+#include "provizio/dds/publisher.h"
+#include "provizio/dds/subscriber.h"
+
+namespace provizio
+{
+    namespace dds
+    {
+        /**
+         * @brief Suffix of the topics of quantized point clouds, see provizio::dds::quantized_topic_name
+         */
+        constexpr const char *quantized_topic_suffix = "/quantized";
+
+        /**
+         * @brief Returns the name of the topic to publish quantized point clouds of a topic on. Quantized clouds are
+         * kept off the topic of the plain ones, as consumers unaware of the quantization (f.e. ROS 2 nodes over
+         * ros_interop) would misread their int16 fields, so subscribing to this topic is what requests them.
+         *
+         * @param topic_name The topic of the plain point clouds
+         * @return The topic of the quantized point clouds
+         * @see provizio::dds::quantize_point_cloud
+         */
+        inline std::string quantized_topic_name(const std::string &topic_name)
+        {
+            return topic_name + quantized_topic_suffix;
+        }
+
+        /**
+         * @brief Publishes point clouds in the encodings their subscribers negotiated by their choice of topic: as they
+         * are (with float fields) on the plain topic, and quantized on provizio::dds::quantized_topic_name of it. Each
+         * encoding is only produced while it has matched subscribers, so quantizing costs nothing with no quantized
+         * subscribers. Normally created using provizio::dds::make_quantized_point_cloud2_publisher.
+         */
+        class quantized_point_cloud2_publisher final
+        {
+          public:
+            using publisher_type = publisher_handle<sensor_msgs::msg::PointCloud2PubSubType>;
+
+            quantized_point_cloud2_publisher(const std::shared_ptr<DomainParticipant> &domain_participant,
+                                             const std::string &topic_name,
+                                             std::vector<point_field_quantization> quantization)
+                : quantization(std::move(quantization)),
+                  // Constructed directly, as make_publisher returns nullptr if a DataWriter can't be created
+                  plain(std::make_shared<publisher_type>(domain_participant, topic_name)),
+                  quantized(std::make_shared<publisher_type>(domain_participant, quantized_topic_name(topic_name)))
+            {
+            }
+
+            /**
+             * @brief Publishes a point cloud as it is to plain subscribers and quantized to quantized subscribers,
+             * whichever are matched. Thread-safe.
+             *
+             * @param cloud The point cloud, in the host byte order
+             * @return true if published in all the encodings with matched subscribers, false if any of them failed,
+             * including failing to quantize the cloud
+             */
+            bool publish(sensor_msgs::msg::PointCloud2 &cloud)
+            {
+                const auto any = [](const InstanceHandle_t &) { return true; };
+                bool success = true;
+                if (plain->any_matched_subscription(any))
+                {
+                    success = plain->publish(cloud);
+                }
+                if (quantized->any_matched_subscription(any))
+                {
+                    // The quantized cloud is reused, so its data isn't reallocated for every cloud
+                    std::lock_guard<std::mutex> lock{mutex};
+                    success = quantize_point_cloud(cloud, quantized_cloud, quantization) &&
+                              quantized->publish(quantized_cloud) && success;
+                }
+                return success;
+            }
+
+            /**
+             * @return The publisher of the plain topic
+             */
+            publisher_type &plain_publisher() noexcept
+            {
+                return *plain;
+            }
+
+            /**
+             * @return The publisher of the quantized topic
+             */
+            publisher_type &quantized_publisher() noexcept
+            {
+                return *quantized;
+            }
+
+          private:
+            const std::vector<point_field_quantization> quantization;
+            std::shared_ptr<publisher_type> plain;
+            std::shared_ptr<publisher_type> quantized;
+            std::mutex mutex;
+            sensor_msgs::msg::PointCloud2 quantized_cloud;
+        };
+
+        /**
+         * @brief Creates a new quantized_point_cloud2_publisher as a shared_ptr
+         *
+         * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+         * @param topic_name The topic of the plain point clouds. Quantized ones are published on
+         * provizio::dds::quantized_topic_name of it.
+         * @param quantization The fields to quantize, radar_point_cloud_quantization by default
+         * @return std::shared_ptr to the created quantized_point_cloud2_publisher
+         * @see provizio::dds::make_quantized_point_cloud2_subscriber
+         */
+        inline std::shared_ptr<quantized_point_cloud2_publisher> make_quantized_point_cloud2_publisher(
+            const std::shared_ptr<DomainParticipant> &domain_participant, const std::string &topic_name,
+            std::vector<point_field_quantization> quantization = radar_point_cloud_quantization())
+        {
+            return std::make_shared<quantized_point_cloud2_publisher>(domain_participant, topic_name,
+                                                                      std::move(quantization));
+        }
+
+        /**
+         * @brief Creates a subscriber of the quantized point clouds of a topic, as published by a
+         * quantized_point_cloud2_publisher, and restores them with provizio::dds::dequantize_point_cloud
+         *
+         * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+         * @param topic_name The topic of the plain point clouds, i.e. not the quantized topic name
+         * @param on_data_function Function / function object to be invoked with each restored point cloud, takes a
+         * const sensor_msgs::msg::PointCloud2 &, which is only valid during the invocation
+         * @return std::shared_ptr to the created subscriber_handle of the quantized topic, or nullptr if its DDS
+         * DataReader can't be created
+         */
+        template <typename on_data_function_type>
+        std::shared_ptr<subscriber_handle<sensor_msgs::msg::PointCloud2PubSubType>>
+        make_quantized_point_cloud2_subscriber(const std::shared_ptr<DomainParticipant> &domain_participant,
+                                               const std::string &topic_name, on_data_function_type on_data_function)
+        {
+            // Reused, so the data of restored clouds isn't reallocated for every cloud
+            auto dequantized = std::make_shared<sensor_msgs::msg::PointCloud2>();
+            return make_subscriber<sensor_msgs::msg::PointCloud2PubSubType>(
+                domain_participant, quantized_topic_name(topic_name),
+                [dequantized, on_data_function](const sensor_msgs::msg::PointCloud2 &quantized) mutable {
+                    if (dequantize_point_cloud(quantized, *dequantized))
+                    {
+                        on_data_function(static_cast<const sensor_msgs::msg::PointCloud2 &>(*dequantized));
+                    }
+                });
+        }
+    } // namespace dds
+} // namespace provizio
+
+#endif // DDS_QUANTIZED_POINT_CLOUD2
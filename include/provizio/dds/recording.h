@@ -0,0 +1,354 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DDS_RECORDING
+#define DDS_RECORDING
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <fastdds/dds/domain/DomainParticipant.hpp>
+#include <fastdds/dds/topic/TypeSupport.hpp>
+
+#include "provizio/dds/common.h"
+#include "provizio/dds/qos_defaults.h"
+#include "provizio/dds/serialized_pub_sub_type.h"
+
+namespace provizio
+{
+    namespace dds
+    {
+        /**
+         * @brief Options of a provizio::dds::recorder
+         */
+        struct recording_options final
+        {
+            /**
+             * @brief Default size of a single segment file of a recording, 256 MiB
+             */
+            static constexpr std::size_t default_segment_size = 256U * 1024U * 1024U;
+
+            /**
+             * @brief Path of the recording without an extension. Samples are recorded to segment files named
+             * <path>_0000.pvzrec, <path>_0001.pvzrec etc.
+             */
+            std::string path;
+
+            /**
+             * @brief Size of a segment file, which is memory-mapped as a whole. A new segment is started when a sample
+             * doesn't fit the current one. Closed segments are truncated to their actually recorded size.
+             */
+            std::size_t segment_size = default_segment_size;
+        };
+
+        /**
+         * @brief A snapshot of the counters of a provizio::dds::recorder
+         */
+        struct recorder_statistics final
+        {
+            /**
+             * @brief Number of samples recorded
+             */
+            std::uint64_t recorded_samples = 0;
+
+            /**
+             * @brief Number of bytes of serialized samples recorded, excluding the record headers
+             */
+            std::uint64_t recorded_bytes = 0;
+
+            /**
+             * @brief Number of samples that couldn't be recorded, f.e. being larger than a segment or due to I/O errors
+             */
+            std::uint64_t dropped_samples = 0;
+
+            /**
+             * @brief Number of segment files started
+             */
+            std::uint64_t segments = 0;
+        };
+
+        /**
+         * @brief Records samples of DDS topics in their serialized form, as received, with their reception and source
+         * timestamps. Samples are appended to memory-mapped segment files with no deserialization, so types of the
+         * recorded topics only need to be known by their names. Each segment keeps an index of its samples by
+         * reception time for fast seeking on replay.
+         *
+         * Recording is only supported in POSIX systems.
+         *
+         * @see provizio::dds::recording_reader
+         * @see provizio::dds::replayer
+         */
+        class recorder final
+        {
+          public:
+            /**
+             * @brief Constructs a new recorder object and creates the first segment of the recording
+             *
+             * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant.
+             * It must not register the recorded types in their deserialized form, i.e. it can't be shared with
+             * regular subscribers or publishers of the recorded topics.
+             * @param options Options of the recording
+             * @see provizio::dds::recorder::is_open
+             */
+            recorder(std::shared_ptr<DomainParticipant> domain_participant, recording_options options);
+            recorder(const recorder &) = delete;
+            recorder &operator=(const recorder &) = delete;
+            ~recorder();
+
+            /**
+             * @return true if the recording has been created successfully and not closed yet
+             */
+            bool is_open() const;
+
+            /**
+             * @brief Starts recording a topic
+             *
+             * @param topic_name A DDS Topic Name
+             * @param type_name DDS type name of the topic, f.e. "std_msgs::msg::dds_::String_"
+             * @param reliability_kind Reliability of the DDS DataReader. A reliable recorder doesn't match best effort
+             * publishers.
+             * @return true if started successfully, false if the recording is not open, the topic can't be described
+             * in a segment or its DDS DataReader can't be created
+             * @note Once samples are recorded, adding a topic starts a new segment
+             */
+            bool add_topic(const std::string &topic_name, const std::string &type_name,
+                           ReliabilityQosPolicyKind reliability_kind = BEST_EFFORT_RELIABILITY_QOS);
+
+            /**
+             * @brief Starts recording a topic of a DDS data type known at compile time
+             *
+             * @tparam data_pub_sub_type DDS data pub/sub type, f.e. std_msgs::msg::StringPubSubType
+             * @param topic_name A DDS Topic Name
+             * @param reliability_kind Reliability of the DDS DataReader, as defined in qos_defaults by default
+             * @return true if started successfully, false if the recording is not open, the topic can't be described
+             * in a segment or its DDS DataReader can't be created
+             * @note Once samples are recorded, adding a topic starts a new segment
+             */
+            template <typename data_pub_sub_type>
+            bool add_topic(const std::string &topic_name,
+                           ReliabilityQosPolicyKind reliability_kind =
+                               qos_defaults<data_pub_sub_type>::datareader_reliability_kind)
+            {
+                auto type = new serialized_pub_sub_type_of<data_pub_sub_type>();
+                const std::string type_name = type->getName();
+                return add_topic(topic_name, type_name, dds::TypeSupport(type), reliability_kind);
+            }
+
+            /**
+             * @brief Stops recording and closes the current segment, writing its index. Also performed on destruction.
+             */
+            void close();
+
+            /**
+             * @return A snapshot of the counters
+             */
+            recorder_statistics statistics() const;
+
+          private:
+            struct segment_writer;
+            struct channel;
+
+            bool add_topic(const std::string &topic_name, const std::string &type_name, dds::TypeSupport type_support,
+                           ReliabilityQosPolicyKind reliability_kind);
+            void record(std::uint16_t channel_id, std::int64_t reception_time_ns, std::int64_t source_time_ns,
+                        const unsigned char *data, std::size_t size);
+            bool start_segment();
+
+            std::shared_ptr<DomainParticipant> domain_participant;
+            recording_options options;
+            mutable std::mutex mutex;
+            std::unique_ptr<segment_writer> writer;
+            std::vector<std::unique_ptr<channel>> channels;
+            std::uint64_t next_segment_number = 0;
+            std::atomic<std::uint64_t> recorded_samples{0};
+            std::atomic<std::uint64_t> recorded_bytes{0};
+            std::atomic<std::uint64_t> dropped_samples{0};
+        };
+
+        /**
+         * @brief A topic recorded by a provizio::dds::recorder
+         */
+        struct recorded_channel final
+        {
+            std::string topic_name;
+            std::string type_name;
+        };
+
+        /**
+         * @brief A sample read by a provizio::dds::recording_reader
+         */
+        struct recorded_sample final
+        {
+            /**
+             * @brief The topic the sample has been recorded from, valid as long as the recording_reader
+             */
+            const recorded_channel *channel = nullptr;
+
+            /**
+             * @brief Reception and source timestamps of the sample, in nanoseconds since the epoch (of the system
+             * clock)
+             */
+            std::int64_t reception_time_ns = 0;
+            std::int64_t source_time_ns = 0;
+
+            /**
+             * @brief The serialized sample in the memory-mapped segment, see provizio::dds::serialized_sample. Only
+             * valid until the next call of next or seek of the recording_reader.
+             */
+            const unsigned char *data = nullptr;
+            std::size_t size = 0;
+        };
+
+        /**
+         * @brief Reads the samples of a recording made by a provizio::dds::recorder, in the order of their reception,
+         * with no copying, by memory-mapping its segments one by one. Recordings that haven't been closed properly
+         * (f.e. due to a crash) are read up to the last complete sample, though without the index for seeking.
+         */
+        class recording_reader final
+        {
+          public:
+            /**
+             * @brief Constructs a new recording_reader object and opens the first segment of the recording
+             *
+             * @param path Path of the recording without an extension, as in provizio::dds::recording_options::path
+             * @see provizio::dds::recording_reader::is_open
+             */
+            explicit recording_reader(std::string path);
+            recording_reader(const recording_reader &) = delete;
+            recording_reader &operator=(const recording_reader &) = delete;
+            ~recording_reader();
+
+            /**
+             * @return true if the recording has been opened successfully
+             */
+            bool is_open() const noexcept;
+
+            /**
+             * @brief Reads the next sample
+             *
+             * @param sample Receives the sample
+             * @return true if a sample has been read, false at the end of the recording
+             */
+            bool next(recorded_sample &sample);
+
+            /**
+             * @brief Positions the reader at the first sample received at or after the specified time, using the
+             * indices of the segments when available
+             *
+             * @param reception_time_ns Time in nanoseconds since the epoch
+             * @return true if there is such a sample, false otherwise
+             */
+            bool seek(std::int64_t reception_time_ns);
+
+          private:
+            struct segment;
+
+            bool open_segment(std::uint64_t segment_number);
+            std::uint16_t read_record(std::size_t &offset, recorded_sample &sample);
+
+            std::string path;
+            std::unique_ptr<segment> current;
+            std::uint64_t segment_number = 0;
+            std::size_t offset = 0;
+            std::vector<std::unique_ptr<recorded_channel>> channels;
+        };
+
+        /**
+         * @brief Options of a provizio::dds::replayer
+         */
+        struct replay_options final
+        {
+            /**
+             * @brief Replay speed relative to the original timing, f.e. 2.0 to replay twice as fast. 0 or less to
+             * replay as fast as possible.
+             */
+            double speed = 1.0;
+
+            /**
+             * @brief Max time to wait for a subscriber of a topic before publishing its first sample, which is
+             * otherwise likely to be missed by subscribers still being discovered. The timeline is shifted by the time
+             * spent waiting.
+             */
+            std::chrono::milliseconds match_timeout{0};
+
+            /**
+             * @brief Reliability of the DDS DataWriters, reliable ones match both reliable and best effort subscribers
+             */
+            ReliabilityQosPolicyKind reliability_kind = RELIABLE_RELIABILITY_QOS;
+
+            /**
+             * @brief Max time to wait, on finishing the replay, for the reliable subscribers to acknowledge the last
+             * samples
+             */
+            std::chrono::milliseconds acknowledgment_timeout{1000};
+        };
+
+        /**
+         * @brief Publishes the samples of a recording made by a provizio::dds::recorder to their original topics, with
+         * their original timing, faster or slower, or as fast as possible. Samples are published right from the
+         * memory-mapped segments, with no deserialization or copying.
+         */
+        class replayer final
+        {
+          public:
+            /**
+             * @brief Constructs a new replayer object
+             *
+             * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant.
+             * It must not register the replayed types in their deserialized form, i.e. it can't be shared with
+             * regular subscribers or publishers of the replayed topics.
+             * @param path Path of the recording without an extension, as in provizio::dds::recording_options::path
+             * @param options Options of the replay
+             */
+            replayer(std::shared_ptr<DomainParticipant> domain_participant, std::string path,
+                     replay_options options = {});
+            replayer(const replayer &) = delete;
+            replayer &operator=(const replayer &) = delete;
+            ~replayer();
+
+            /**
+             * @brief Replays the recording, blocking until it's over or stopped
+             *
+             * @return Number of samples published
+             */
+            std::uint64_t run();
+
+            /**
+             * @brief Stops the replay, can be invoked from any thread
+             */
+            void stop();
+
+          private:
+            struct channel_publisher;
+
+            bool wait_until(std::chrono::steady_clock::time_point time);
+
+            std::shared_ptr<DomainParticipant> domain_participant;
+            std::string path;
+            replay_options options;
+            std::mutex mutex;
+            std::condition_variable stopped_condition;
+            bool stopped = false;
+        };
+    } // namespace dds
+} // namespace provizio
+
+#endif // DDS_RECORDING
@@ -0,0 +1,188 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DDS_RELAY
+#define DDS_RELAY
+
+#include <memory>
+#include <string>
+
+#include "provizio/dds/common.h"
+#include "provizio/dds/metrics.h"
+#include "provizio/dds/publisher.h"
+#include "provizio/dds/serialized_pub_sub_type.h"
+#include "provizio/dds/subscriber.h"
+
+namespace provizio
+{
+    namespace dds
+    {
+        /**
+         * @brief Options of a provizio::dds::relay
+         */
+        struct relay_options final
+        {
+            /**
+             * @brief Name of the topic to publish the samples to, or empty to publish them to the same topic as they
+             * are received from (which requires different DDS domains or transports, to avoid loops)
+             */
+            std::string destination_topic_name;
+
+            /**
+             * @brief Reliability of the DDS DataReader, best effort ones match both reliable and best effort
+             * publishers
+             */
+            ReliabilityQosPolicyKind source_reliability_kind = BEST_EFFORT_RELIABILITY_QOS;
+
+            /**
+             * @brief Reliability of the DDS DataWriter, reliable ones match both reliable and best effort subscribers
+             */
+            ReliabilityQosPolicyKind destination_reliability_kind = RELIABLE_RELIABILITY_QOS;
+
+            /**
+             * @brief Defines whether to publish synchronously (in the Fast-DDS thread receiving the sample) or
+             * asynchronously
+             */
+            publish_mode_options publish_mode;
+        };
+
+        /**
+         * @brief A snapshot of the counters of a provizio::dds::relay
+         */
+        struct relay_metrics final
+        {
+            /**
+             * @brief Counters of the receiving side, incl. the received bytes
+             */
+            subscriber_metrics received;
+
+            /**
+             * @brief Counters of the publishing side
+             */
+            publisher_metrics forwarded;
+        };
+
+        /**
+         * @brief Forwards the samples of a topic from one DDS Domain Participant to another (f.e. of a different
+         * domain or transport), or to another topic, in their serialized form, with no deserialization or
+         * serialization. Normally created with provizio::dds::make_relay.
+         *
+         * @tparam data_pub_sub_type provizio::dds::serialized_pub_sub_type_of the data pub/sub type, or
+         * provizio::dds::serialized_pub_sub_type for a data type only known by its name
+         * @see provizio::dds::make_relay
+         */
+        template <typename data_pub_sub_type> class relay final
+        {
+          public:
+            /**
+             * @brief Constructs a new relay object
+             *
+             * @param source_participant A DDS Domain Participant to receive the samples with. It can't be shared with
+             * regular subscribers or publishers of the same data type.
+             * @param destination_participant A DDS Domain Participant to publish the samples with, can be the same as
+             * source_participant to relay to another topic
+             * @param topic_name A DDS Topic Name to receive the samples from
+             * @param type_support DDS Type Support holding a data_pub_sub_type
+             * @param options Options of the relay
+             */
+            relay(std::shared_ptr<DomainParticipant> source_participant,
+                  std::shared_ptr<DomainParticipant> destination_participant, const std::string &topic_name,
+                  const dds::TypeSupport &type_support, const relay_options &options = {})
+                : publisher(std::move(destination_participant),
+                            options.destination_topic_name.empty() ? topic_name : options.destination_topic_name,
+                            type_support, options.destination_reliability_kind, options.publish_mode),
+                  subscriber(std::move(source_participant), topic_name, type_support, content_filter{},
+                             std::make_shared<on_data_function_data_listener<serialized_sample, forwarder>>(
+                                 forwarder{&publisher, {}}),
+                             options.source_reliability_kind)
+            {
+            }
+
+            /**
+             * @return A snapshot of the counters of the receiving and publishing sides
+             */
+            relay_metrics metrics() const
+            {
+                return relay_metrics{subscriber.metrics(), publisher.metrics()};
+            }
+
+          private:
+            // Invoked by the Fast-DDS thread receiving the samples
+            struct forwarder
+            {
+                publisher_handle<data_pub_sub_type> *destination;
+                serialized_sample forwarded;
+
+                void operator()(const serialized_sample &sample)
+                {
+                    forwarded.refer(sample.data(), sample.size());
+                    destination->publish(forwarded);
+                }
+            };
+
+            // The subscriber is destroyed before the publisher it forwards to
+            publisher_handle<data_pub_sub_type> publisher;
+            subscriber_handle<data_pub_sub_type> subscriber;
+        };
+
+        /**
+         * @brief Creates a new relay object as a shared_ptr, that forwards the samples of a topic of a DDS data type
+         * known at compile time
+         *
+         * @tparam data_pub_sub_type DDS data pub/sub type of the topic, f.e. sensor_msgs::msg::PointCloud2PubSubType
+         * @param source_participant A DDS Domain Participant to receive the samples with. It can't be shared with
+         * regular subscribers or publishers of the same data type.
+         * @param destination_participant A DDS Domain Participant to publish the samples with
+         * @param topic_name A DDS Topic Name to receive the samples from
+         * @param options Options of the relay
+         * @return std::shared_ptr to the created relay
+         * @see provizio::dds::relay
+         */
+        template <typename data_pub_sub_type>
+        std::shared_ptr<relay<serialized_pub_sub_type_of<data_pub_sub_type>>> make_relay(
+            std::shared_ptr<DomainParticipant> source_participant,
+            std::shared_ptr<DomainParticipant> destination_participant, const std::string &topic_name,
+            const relay_options &options = {})
+        {
+            return std::make_shared<relay<serialized_pub_sub_type_of<data_pub_sub_type>>>(
+                std::move(source_participant), std::move(destination_participant), topic_name,
+                dds::TypeSupport(new serialized_pub_sub_type_of<data_pub_sub_type>()), options);
+        }
+
+        /**
+         * @brief Creates a new relay object as a shared_ptr, that forwards the samples of a topic of a DDS data type
+         * only known by its name at run time
+         *
+         * @param source_participant A DDS Domain Participant to receive the samples with. It can't be shared with
+         * regular subscribers or publishers of the same data type.
+         * @param destination_participant A DDS Domain Participant to publish the samples with
+         * @param topic_name A DDS Topic Name to receive the samples from
+         * @param type_name DDS type name of the topic, f.e. "std_msgs::msg::dds_::String_"
+         * @param options Options of the relay
+         * @return std::shared_ptr to the created relay
+         * @see provizio::dds::relay
+         */
+        inline std::shared_ptr<relay<serialized_pub_sub_type>> make_relay(
+            std::shared_ptr<DomainParticipant> source_participant,
+            std::shared_ptr<DomainParticipant> destination_participant, const std::string &topic_name,
+            const std::string &type_name, const relay_options &options = {})
+        {
+            return std::make_shared<relay<serialized_pub_sub_type>>(
+                std::move(source_participant), std::move(destination_participant), topic_name,
+                dds::TypeSupport(new serialized_pub_sub_type(type_name)), options);
+        }
+    } // namespace dds
+} // namespace provizio
+
+#endif // DDS_RELAY
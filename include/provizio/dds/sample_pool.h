@@ -0,0 +1,170 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DDS_SAMPLE_POOL
+#define DDS_SAMPLE_POOL
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace provizio
+{
+    namespace dds
+    {
+        /**
+         * @brief A fixed size lock-free pool of preallocated DDS data samples, which are reused instead of being
+         * constructed anew for every received sample. As the samples are reused, their dynamic members (f.e. data
+         * vector of sensor_msgs::msg::PointCloud2) keep their capacity, so no allocations take place in a steady state.
+         *
+         * A sample is acquired as a lease. While leased, and as long as any copies of its shared_ptr are kept outside
+         * of the pool, it's not acquired again. Keeping a copy of the shared_ptr is the way to retain a sample without
+         * copying it. When all samples are busy, a new one is allocated that doesn't belong to the pool.
+         *
+         * @tparam data_type DDS data type, f.e. std_msgs::msg::String
+         */
+        template <typename data_type> class sample_pool final
+        {
+          public:
+            /**
+             * @brief Default number of samples in a pool
+             */
+            static constexpr std::size_t default_size = 4;
+
+          private:
+            struct slot
+            {
+                std::shared_ptr<data_type> sample;
+                std::atomic<bool> leased{false};
+            };
+
+          public:
+            /**
+             * @brief Exclusive access to an acquired sample, released on destruction
+             */
+            class lease final
+            {
+              public:
+                lease(const lease &) = delete;
+                lease(lease &&other) noexcept : owner(other.owner), sample(std::move(other.sample))
+                {
+                    other.owner = nullptr;
+                }
+
+                ~lease()
+                {
+                    if (owner != nullptr)
+                    {
+                        owner->leased.store(false, std::memory_order_release);
+                    }
+                }
+
+                lease &operator=(const lease &) = delete;
+                lease &operator=(lease &&) = delete;
+
+                /**
+                 * @return The sample as a shared_ptr. Copying it retains the sample beyond the lease.
+                 */
+                const std::shared_ptr<data_type> &get() const noexcept
+                {
+                    return sample;
+                }
+
+                data_type &operator*() const noexcept
+                {
+                    return *sample;
+                }
+
+                data_type *operator->() const noexcept
+                {
+                    return sample.get();
+                }
+
+              private:
+                lease(slot *owner, std::shared_ptr<data_type> sample) : owner(owner), sample(std::move(sample))
+                {
+                }
+
+                slot *owner;
+                std::shared_ptr<data_type> sample;
+
+                friend class sample_pool;
+            };
+
+          public:
+            /**
+             * @brief Constructs a new sample_pool object, preallocating all its samples
+             *
+             * @param size Number of samples in the pool, at least 1
+             */
+            explicit sample_pool(std::size_t size = default_size)
+                : pool_size(size > 0 ? size : 1), slots(new slot[pool_size])
+            {
+                for (std::size_t i = 0; i < pool_size; ++i)
+                {
+                    slots[i].sample = std::make_shared<data_type>();
+                }
+            }
+
+            sample_pool(const sample_pool &) = delete;
+            sample_pool &operator=(const sample_pool &) = delete;
+
+            /**
+             * @brief Acquires a sample that is not leased or retained elsewhere. Wait-free while any pool samples
+             * are available, otherwise allocates a new one.
+             *
+             * @return The lease of the acquired sample. The sample keeps the contents it had on its previous use.
+             */
+            lease acquire()
+            {
+                const std::size_t start = next.fetch_add(1, std::memory_order_relaxed);
+                for (std::size_t i = 0; i < pool_size; ++i)
+                {
+                    slot &candidate = slots[(start + i) % pool_size];
+                    if (candidate.leased.exchange(true, std::memory_order_acquire))
+                    {
+                        continue;
+                    }
+
+                    if (candidate.sample.use_count() == 1)
+                    {
+                        // Make sure all accesses by former external owners happen before reusing the sample
+                        std::atomic_thread_fence(std::memory_order_acquire);
+                        return {&candidate, candidate.sample};
+                    }
+
+                    // Still retained outside of the pool
+                    candidate.leased.store(false, std::memory_order_release);
+                }
+
+                return {nullptr, std::make_shared<data_type>()};
+            }
+
+            /**
+             * @return Number of samples in the pool
+             */
+            std::size_t size() const noexcept
+            {
+                return pool_size;
+            }
+
+          private:
+            const std::size_t pool_size;
+            std::unique_ptr<slot[]> slots;
+            std::atomic<std::size_t> next{0};
+        };
+    } // namespace dds
+} // namespace provizio
+
+#endif // DDS_SAMPLE_POOL
@@ -0,0 +1,162 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DDS_SERIALIZED_PUB_SUB_TYPE
+#define DDS_SERIALIZED_PUB_SUB_TYPE
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <fastdds/dds/topic/TopicDataType.hpp>
+#include <fastdds/rtps/common/SerializedPayload.h>
+
+#include "provizio/dds/common.h"
+#include "provizio/dds/qos_defaults.h"
+
+namespace provizio
+{
+    namespace dds
+    {
+        /**
+         * @brief A sample of a DDS data type in its serialized form, i.e. the bytes of a SerializedPayload_t including
+         * the encapsulation (CDR representation) header, as passed by provizio::dds::serialized_pub_sub_type without
+         * touching CDR.
+         *
+         * The bytes are either owned by the sample (as when received), or refer to an external buffer the caller
+         * keeps alive (f.e. a memory-mapped recording), which saves a copy on publishing.
+         */
+        class serialized_sample final
+        {
+          public:
+            /**
+             * @return The serialized bytes, including the encapsulation header
+             */
+            const unsigned char *data() const noexcept
+            {
+                return external_data != nullptr ? external_data : owned.data();
+            }
+
+            /**
+             * @return Number of the serialized bytes
+             */
+            std::size_t size() const noexcept
+            {
+                return external_data != nullptr ? external_size : owned.size();
+            }
+
+            /**
+             * @brief Copies the serialized bytes into the sample. The owned buffer keeps its capacity, so no
+             * allocations take place in a steady state.
+             */
+            void assign(const unsigned char *bytes, const std::size_t count)
+            {
+                external_data = nullptr;
+                external_size = 0;
+                owned.assign(bytes, bytes + count);
+            }
+
+            /**
+             * @brief Makes the sample refer to external serialized bytes without copying them. They must be kept
+             * alive and unchanged while the sample refers to them.
+             */
+            void refer(const unsigned char *bytes, const std::size_t count) noexcept
+            {
+                external_data = bytes;
+                external_size = count;
+            }
+
+          private:
+            std::vector<unsigned char> owned;
+            const unsigned char *external_data = nullptr;
+            std::size_t external_size = 0;
+        };
+
+        /**
+         * @brief A DDS pub/sub type that passes samples of another DDS data type (identified by its type name) in
+         * their serialized form, without serializing or deserializing them. Topics of the original type can be
+         * published or subscribed with it, f.e. to record or relay samples regardless of their types. As samples are
+         * not deserialized, keys can't be computed, so instances of keyed types are not distinguished.
+         *
+         * @see provizio::dds::serialized_sample
+         * @see provizio::dds::serialized_pub_sub_type_of
+         */
+        class serialized_pub_sub_type : public eprosima::fastdds::dds::TopicDataType
+        {
+          public:
+            using type = serialized_sample;
+
+            /**
+             * @brief Default size, in bytes, of the serialized sample buffers to be allocated by Fast-DDS, which grow
+             * as necessary
+             */
+            static constexpr std::uint32_t default_initial_serialized_size = 1024;
+
+          public:
+            /**
+             * @brief Constructs a serialized_pub_sub_type with no type name, only to be used as a base
+             */
+            serialized_pub_sub_type();
+
+            /**
+             * @brief Constructs a new serialized_pub_sub_type object
+             *
+             * @param type_name DDS type name of the original data type, f.e. "std_msgs::msg::dds_::String_"
+             * @param initial_serialized_size Size, in bytes, of the serialized sample buffers to be allocated by
+             * Fast-DDS, which grow as necessary
+             */
+            explicit serialized_pub_sub_type(const std::string &type_name,
+                                             std::uint32_t initial_serialized_size = default_initial_serialized_size);
+
+            bool serialize(void *data, eprosima::fastrtps::rtps::SerializedPayload_t *payload) override;
+            bool deserialize(eprosima::fastrtps::rtps::SerializedPayload_t *payload, void *data) override;
+            std::function<std::uint32_t()> getSerializedSizeProvider(void *data) override;
+            void *createData() override;
+            void deleteData(void *data) override;
+            bool getKey(void *data, eprosima::fastrtps::rtps::InstanceHandle_t *handle, bool force_md5) override;
+        };
+
+        /**
+         * @brief A serialized_pub_sub_type for a DDS data type known at compile time
+         *
+         * @tparam data_pub_sub_type DDS data pub/sub type, f.e. std_msgs::msg::StringPubSubType
+         */
+        template <typename data_pub_sub_type> class serialized_pub_sub_type_of final : public serialized_pub_sub_type
+        {
+          public:
+            serialized_pub_sub_type_of()
+            {
+                data_pub_sub_type original;
+                setName(original.getName());
+                m_typeSize = original.m_typeSize;
+            }
+        };
+
+        /**
+         * @brief Serialized samples of a DDS data type are published and received with the QOS defaults of the data
+         * type itself
+         *
+         * @tparam data_pub_sub_type DDS data pub/sub type, f.e. sensor_msgs::msg::PointCloud2PubSubType
+         */
+        template <typename data_pub_sub_type>
+        struct qos_defaults<serialized_pub_sub_type_of<data_pub_sub_type>> final
+            : detail::qos_policies_of<data_pub_sub_type>
+        {
+        };
+    } // namespace dds
+} // namespace provizio
+
+#endif // DDS_SERIALIZED_PUB_SUB_TYPE
@@ -15,21 +15,216 @@
 #ifndef DDS_SUBSCRIBER
 #define DDS_SUBSCRIBER
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <memory>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+#include <fastdds/dds/core/LoanableSequence.hpp>
+#include <fastdds/dds/core/condition/StatusCondition.hpp>
+#include <fastdds/dds/core/condition/WaitSet.hpp>
 #include <fastdds/dds/subscriber/DataReader.hpp>
+#include <fastdds/dds/subscriber/SampleInfo.hpp>
 #include <fastdds/dds/subscriber/Subscriber.hpp>
+#include <fastdds/dds/topic/ContentFilteredTopic.hpp>
 #include <fastdds/dds/topic/TypeSupport.hpp>
 
 #include "provizio/dds/common.h"
+#include "provizio/dds/dispatcher.h"
 #include "provizio/dds/domain_participant.h"
+#include "provizio/dds/entity_registry.h"
+#include "provizio/dds/inplace_function.h"
+#include "provizio/dds/introspection.h"
+#include "provizio/dds/metrics.h"
 #include "provizio/dds/qos_defaults.h"
+#include "provizio/dds/sample_pool.h"
+#include "provizio/dds/serialized_pub_sub_type.h"
+#include "provizio/dds/triple_buffer.h"
 
 namespace provizio
 {
     namespace dds
     {
+        /**
+         * @brief A subscriber function taking a const reference to the data, stored with no heap allocations. Unlike
+         * lambdas, which make each subscriber instantiate a listener type of its own, all the subscribers of a data
+         * type created with a data_callback share one.
+         *
+         * @tparam data_type DDS data type, f.e. std_msgs::msg::String
+         * @tparam capacity Max size of the stored function object
+         * @see provizio::dds::make_subscriber
+         */
+        template <typename data_type, std::size_t capacity = default_inplace_function_capacity>
+        using data_callback = inplace_function<void(const data_type &), capacity>;
+
+        /**
+         * @brief A subscriber function taking a std::shared_ptr to the const data, to retain samples without copying
+         * them, stored with no heap allocations
+         *
+         * @tparam data_type DDS data type, f.e. std_msgs::msg::String
+         * @tparam capacity Max size of the stored function object
+         * @see provizio::dds::data_callback
+         */
+        template <typename data_type, std::size_t capacity = default_inplace_function_capacity>
+        using shared_data_callback = inplace_function<void(std::shared_ptr<const data_type>), capacity>;
+
+        /**
+         * @brief An on_has_publisher_changed function of a subscriber, stored with no heap allocations
+         *
+         * @tparam capacity Max size of the stored function object
+         */
+        template <std::size_t capacity = default_inplace_function_capacity>
+        using has_publisher_changed_callback = inplace_function<void(bool), capacity>;
+
+        template <typename data_pub_sub_type> class subscriber_handle;
+
+        /**
+         * @brief A DDS DataReaderListener that keeps the counters reported by
+         * provizio::dds::subscriber_handle::metrics. All listeners created by provizio::dds::make_subscriber derive
+         * from it, and so should custom listeners to have their metrics reported.
+         *
+         * It counts lost and rejected samples and missed deadlines. Listeners are expected to count received samples,
+         * their bytes (see received_bytes) and durations of subscriber function invocations with the counters.
+         *
+         * @see provizio::dds::subscriber_metrics
+         */
+        class counting_data_reader_listener : public DataReaderListener
+        {
+          public:
+            void on_sample_lost(DataReader *reader, const SampleLostStatus &status) override
+            {
+                (void)reader;
+                counters.count_samples_lost(status.total_count_change);
+            }
+
+            void on_sample_rejected(DataReader *reader, const SampleRejectedStatus &status) override
+            {
+                (void)reader;
+                counters.count_samples_rejected(status.total_count_change);
+            }
+
+            void on_requested_deadline_missed(DataReader *reader, const RequestedDeadlineMissedStatus &status) override
+            {
+                (void)reader;
+                counters.count_deadlines_missed(status.total_count_change);
+            }
+
+            /**
+             * @return A snapshot of the counters
+             */
+            subscriber_metrics metrics() const noexcept
+            {
+                return counters.snapshot();
+            }
+
+            /**
+             * @brief Enables or disables counting the received bytes of a data type that is not plain, which takes
+             * computing the serialized size of every received sample. Received bytes of plain data types and of raw
+             * subscribers are always counted. Disabled by default.
+             *
+             * @param enabled true to count the received bytes, false otherwise
+             * @see provizio::dds::subscriber_metrics::received_bytes
+             */
+            void count_received_bytes(const bool enabled) noexcept
+            {
+                counting_received_bytes.store(enabled, std::memory_order_relaxed);
+            }
+
+          protected:
+            /**
+             * @return true if the received bytes of data types that are not plain are to be counted
+             */
+            bool measures_received_bytes() const noexcept
+            {
+                return counting_received_bytes.load(std::memory_order_relaxed);
+            }
+
+            /**
+             * @return The serialized size of a received sample: fixed for plain data types, measured for others if
+             * measures_received_bytes, 0 otherwise
+             */
+            template <typename data_type> std::size_t received_bytes(const data_type &sample) const
+            {
+                if (plain_type_size != 0)
+                {
+                    return plain_type_size;
+                }
+                return measures_received_bytes() && !type_support.empty()
+                           ? type_support->getSerializedSizeProvider(const_cast<data_type *>(&sample))()
+                           : 0;
+            }
+
+            std::size_t received_bytes(const serialized_sample &sample) const noexcept
+            {
+                return sample.size();
+            }
+
+            detail::subscriber_counters counters;
+
+          private:
+            template <typename data_pub_sub_type> friend class subscriber_handle;
+
+            // Set before creating the DataReader, so the type isn't looked up for every received sample
+            void set_type_support(const TypeSupport &type)
+            {
+                type_support = type;
+                plain_type_size = !type.empty() && type->is_plain() ? type->m_typeSize : 0;
+            }
+
+            std::atomic<bool> counting_received_bytes{false};
+            TypeSupport type_support;
+            std::uint32_t plain_type_size = 0;
+        };
+
+        /**
+         * @brief A DDS DataReaderListener of a subscriber that is polled for data on the caller's thread rather than
+         * notified of it in a Fast-DDS listener thread, see provizio::dds::make_polling_subscriber. Such subscribers
+         * don't listen to data available notifications, so they trigger the DataReader StatusCondition instead.
+         *
+         * @see provizio::dds::subscriber_handle::poll
+         * @see provizio::dds::subscriber_handle::take_into
+         */
+        class polling_data_reader_listener final : public counting_data_reader_listener
+        {
+          public:
+            /**
+             * @brief Counts a sample taken by polling, along with its bytes
+             */
+            template <typename data_type> void count_taken(const SampleInfo &info, const data_type &sample)
+            {
+                counters.count_received(info.source_timestamp);
+                counters.count_received_bytes(received_bytes(sample));
+            }
+        };
+
+        /**
+         * @brief A content filter of a DDS ContentFilteredTopic, so that a subscriber only receives the samples it's
+         * interested in. Filtering is performed by the publishers where possible (f.e. in the same process, via the
+         * data-sharing transport or for reliable readers), so that filtered out samples are neither sent nor
+         * deserialized.
+         *
+         * @see provizio::dds::make_subscriber
+         * @see https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/topic/contentFilteredTopic/contentFilteredTopic.html
+         */
+        struct content_filter final
+        {
+            /**
+             * @brief A DDS-SQL filter expression, f.e. "sensor_id = %0", or empty for no filtering
+             */
+            std::string expression;
+
+            /**
+             * @brief Values of the parameters of the expression (%0, %1, etc), strings must be single-quoted
+             */
+            std::vector<std::string> parameters;
+        };
+
         /**
          * @brief Encapsulates DDS Subscriber and DataReader functionality in a single entity with automatic life cycle
          * management. Normally created with provizio::dds::make_subscriber.
@@ -62,15 +257,157 @@ namespace provizio
                               std::shared_ptr<DataReaderListener> data_listener,
                               ReliabilityQosPolicyKind reliability_kind =
                                   qos_defaults<data_pub_sub_type>::datareader_reliability_kind);
+
+            /**
+             * @brief Constructs a new subscriber_handle object, which only receives samples passing a content filter.
+             *
+             * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+             * @param topic_name A DDS Topic Name
+             * @param filter The content filter, or an empty one for no filtering
+             * @param data_listener A DDS DataReaderListener as a shared_ptr
+             * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS
+             * DataReader, which makes receiving data slower but more reliable
+             * @see provizio::dds::content_filter
+             * @see provizio::dds::make_subscriber
+             */
+            subscriber_handle(std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+                              const content_filter &filter, std::shared_ptr<DataReaderListener> data_listener,
+                              ReliabilityQosPolicyKind reliability_kind =
+                                  qos_defaults<data_pub_sub_type>::datareader_reliability_kind);
+
+            /**
+             * @brief Constructs a new subscriber_handle object with a DDS Type Support of its own rather than a
+             * default constructed data_pub_sub_type, f.e. a provizio::dds::serialized_pub_sub_type of a type name only
+             * known at run time.
+             *
+             * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+             * @param topic_name A DDS Topic Name
+             * @param type_support DDS Type Support holding a data_pub_sub_type
+             * @param filter The content filter, or an empty one for no filtering
+             * @param data_listener A DDS DataReaderListener as a shared_ptr
+             * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS
+             * DataReader, which makes receiving data slower but more reliable
+             * @see provizio::dds::serialized_pub_sub_type
+             */
+            subscriber_handle(std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+                              dds::TypeSupport type_support, const content_filter &filter,
+                              std::shared_ptr<DataReaderListener> data_listener,
+                              ReliabilityQosPolicyKind reliability_kind =
+                                  qos_defaults<data_pub_sub_type>::datareader_reliability_kind);
             ~subscriber_handle();
 
+            /**
+             * @brief Looks up the handle of an instance of a keyed DDS data type
+             *
+             * @param key_holder A sample with the key members of the instance filled in
+             * @return The instance handle, or HANDLE_NIL if the data type is not keyed or the instance is not known
+             * yet
+             */
+            InstanceHandle_t lookup_instance(const data_type &key_holder) const;
+
+            /**
+             * @brief Takes the next sample of an instance of a keyed DDS data type, leaving the samples of other
+             * instances in the DataReader. Meant for subscribers which data listener doesn't take samples itself,
+             * f.e. a plain provizio::dds::counting_data_reader_listener.
+             *
+             * @param sample The sample to take the data to
+             * @param instance Instance handle, as returned by lookup_instance or SampleInfo::instance_handle
+             * @param info Optionally receives the sample info
+             * @return true if a sample with valid data was taken, false otherwise
+             */
+            bool take_instance(data_type &sample, const InstanceHandle_t &instance, SampleInfo *info = nullptr);
+
+            /**
+             * @brief Reads the counters of the subscriber: received, lost and rejected samples, missed deadlines,
+             * end-to-end latency and durations of the subscriber function invocations. The counters are lock-free, so
+             * they can be read at any time from any thread.
+             *
+             * @return A snapshot of the counters, all zeros if the data listener doesn't derive from
+             * provizio::dds::counting_data_reader_listener
+             */
+            subscriber_metrics metrics() const;
+
+            /**
+             * @brief Enables or disables counting the received bytes of a data type that is not plain, see
+             * provizio::dds::counting_data_reader_listener::count_received_bytes. Has no effect if the data listener
+             * doesn't derive from provizio::dds::counting_data_reader_listener.
+             *
+             * @param enabled true to count the received bytes, false otherwise
+             * @see provizio::dds::subscriber_metrics::received_bytes
+             */
+            void count_received_bytes(bool enabled);
+
+            /**
+             * @brief Blocks the calling thread until the DataReader has received data to take, or the timeout expires.
+             * Meant for subscribers polled on the caller's thread (f.e. a control loop), as created by
+             * provizio::dds::make_polling_subscriber, which avoids handing samples over from a Fast-DDS listener
+             * thread. Not to be invoked concurrently with itself or take_into.
+             *
+             * @param timeout Max time to wait, 0 to check for data without blocking
+             * @return true if there is data to take, false on timeout
+             * @see provizio::dds::wait_set to wait for several subscribers at once
+             */
+            bool poll(std::chrono::nanoseconds timeout);
+
+            /**
+             * @brief Takes the next received sample on the calling thread, if any, with no blocking
+             *
+             * @param sample The sample to take the data to. When reused, its dynamic members keep their capacity, so
+             * no allocations take place in a steady state.
+             * @param info Optionally receives the sample info
+             * @return true if a sample with valid data was taken, false if there is none
+             */
+            bool take_into(data_type &sample, SampleInfo *info = nullptr);
+
+            /**
+             * @return The StatusCondition of the DataReader, triggered when it has received data to take, f.e. to
+             * be attached to a WaitSet, or nullptr if the DataReader couldn't be created
+             */
+            StatusCondition *data_available_condition();
+
+            /**
+             * @return Instance handle of the DDS DataReader, as reported to publishers on matching, or HANDLE_NIL if
+             * the DataReader couldn't be created
+             */
+            InstanceHandle_t instance_handle() const;
+
           private:
             std::shared_ptr<DomainParticipant> domain_participant;
             dds::TypeSupport type_support;
             std::shared_ptr<DataReaderListener> data_listener;
-            Topic *topic = nullptr;
-            Subscriber *subscriber = nullptr;
+            counting_data_reader_listener *counting_listener = nullptr;
+            polling_data_reader_listener *polling_listener = nullptr;
+            std::shared_ptr<Topic> topic;
+            ContentFilteredTopic *filtered_topic = nullptr;
+            std::shared_ptr<Subscriber> subscriber;
             DataReader *data_reader = nullptr;
+            std::uint64_t introspection_id = 0;
+            std::unique_ptr<WaitSet> wait_set; // Created on the first poll
+            ConditionSeq active_conditions;
+        };
+
+        /**
+         * @brief Functions to be invoked on changes of the health of the publishers of a subscriber, as defined by the
+         * deadline and liveliness policies of qos_defaults, so that stalled publishers (f.e. radars) are detected by
+         * the middleware rather than by timers of the subscriber. They are invoked in the Fast-DDS listener thread and
+         * stored with no heap allocations. Either can be left empty.
+         *
+         * @see provizio::dds::default_qos_policies::deadline_period_milliseconds
+         * @see provizio::dds::default_qos_policies::liveliness_lease_duration_milliseconds
+         */
+        struct subscriber_health_callbacks final
+        {
+            /**
+             * @brief Invoked when no sample of an instance is received within the deadline period, with the total
+             * number of missed deadlines and the instance handle
+             */
+            inplace_function<void(const RequestedDeadlineMissedStatus &)> on_requested_deadline_missed;
+
+            /**
+             * @brief Invoked when a matched publisher becomes alive or not alive, with the numbers of alive and not
+             * alive publishers
+             */
+            inplace_function<void(const LivelinessChangedStatus &)> on_liveliness_changed;
         };
 
         /**
@@ -80,14 +417,19 @@ namespace provizio
          *
          * @tparam data_pub_sub_type DDS data pub/sub type, f.e. std_msgs::msg::StringPubSubType
          * @tparam on_data_function_type Type of a function / function object to be invoked on receiving data, takes a
-         * single argument as a const reference to the data type, f.e. const std_msgs::msg::String&
+         * single argument as a const reference to the data type, f.e. const std_msgs::msg::String&. Alternatively it
+         * can take a std::shared_ptr to the const data type, f.e. std::shared_ptr<const std_msgs::msg::String>, and
+         * keep it to retain the sample after returning without copying it. When wrapped with
+         * provizio::dds::dispatched, the function is invoked by a dispatcher worker thread rather than in the Fast-DDS
+         * listener thread.
          * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
          * @param topic_name A DDS Topic Name
          * @param data_listener A DDS DataReaderListener as a shared_ptr
          * @param on_data_function Function / function object to be invoked on receiving data
          * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS DataReader,
          * which makes receiving data slower but more reliable
-         * @return std::shared_ptr to the created subscriber_handle
+         * @return std::shared_ptr to the created subscriber_handle, or nullptr if its DDS DataReader can't be
+         * created, f.e. as the topic exists with another type
          * @see provizio::dds::subscriber_handle
          * @see https://en.cppreference.com/w/cpp/memory/shared_ptr
          */
@@ -105,7 +447,11 @@ namespace provizio
          *
          * @tparam data_pub_sub_type DDS data pub/sub type, f.e. std_msgs::msg::StringPubSubType
          * @tparam on_data_function_type Type of a function / function object to be invoked on receiving data, takes a
-         * single argument as a const reference to the data type, f.e. const std_msgs::msg::String&
+         * single argument as a const reference to the data type, f.e. const std_msgs::msg::String&. Alternatively it
+         * can take a std::shared_ptr to the const data type, f.e. std::shared_ptr<const std_msgs::msg::String>, and
+         * keep it to retain the sample after returning without copying it. When wrapped with
+         * provizio::dds::dispatched, the function is invoked by a dispatcher worker thread rather than in the Fast-DDS
+         * listener thread.
          * @tparam on_has_publisher_changed_function_type Type of a function / function object to be invoked on matching
          * first / umatching last publisher, takes a single bool argument: true when the first publisher is matched,
          * false when the last publisher is unmatched
@@ -116,7 +462,8 @@ namespace provizio
          * @param on_has_publisher_changed_function The on_has_publisher_changed function
          * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS DataReader,
          * which makes receiving data slower but more reliable
-         * @return std::shared_ptr to the created subscriber_handle
+         * @return std::shared_ptr to the created subscriber_handle, or nullptr if its DDS DataReader can't be
+         * created, f.e. as the topic exists with another type
          * @see provizio::dds::subscriber_handle
          * @see https://en.cppreference.com/w/cpp/memory/shared_ptr
          */
@@ -128,111 +475,1067 @@ namespace provizio
             on_has_publisher_changed_function_type on_has_publisher_changed_function,
             ReliabilityQosPolicyKind reliability_kind = qos_defaults<data_pub_sub_type>::datareader_reliability_kind);
 
-        template <typename data_pub_sub_type>
-        subscriber_handle<data_pub_sub_type>::subscriber_handle(std::shared_ptr<DomainParticipant> domain_participant,
-                                                                const std::string &topic_name,
-                                                                std::shared_ptr<DataReaderListener> data_listener,
-                                                                const ReliabilityQosPolicyKind reliability_kind)
-            : domain_participant(std::move(domain_participant)), type_support(new data_pub_sub_type()),
-              data_listener(std::move(data_listener))
-        {
-            const auto &topic_qos = TOPIC_QOS_DEFAULT;
-            const auto &subscriber_qos = SUBSCRIBER_QOS_DEFAULT;
-            auto datareader_qos = DATAREADER_QOS_DEFAULT;
-            datareader_qos.reliability().kind = reliability_kind;
-            datareader_qos.endpoint().history_memory_policy = qos_defaults<data_pub_sub_type>::memory_policy;
-
-            type_support.register_type(this->domain_participant.get());
-            topic = this->domain_participant->create_topic(topic_name, type_support->getName(), topic_qos);
-            subscriber = this->domain_participant->create_subscriber(subscriber_qos);
-            data_reader = subscriber->create_datareader(topic, datareader_qos, this->data_listener.get());
-        }
-
-        template <typename data_pub_sub_type> subscriber_handle<data_pub_sub_type>::~subscriber_handle()
-        {
-            if (data_reader != nullptr)
-            {
-                subscriber->delete_datareader(data_reader);
-            }
-
-            if (subscriber != nullptr)
-            {
-                domain_participant->delete_subscriber(subscriber);
-            }
-
-            if (topic != nullptr)
-            {
-                domain_participant->delete_topic(topic);
-            }
-        }
-
-        template <typename data_type, typename on_data_function_type>
-        class on_data_function_data_listener : public DataReaderListener
-        {
-          public:
-            on_data_function_data_listener(on_data_function_type &&on_data_function)
-                : on_data_function(std::move(on_data_function))
-            {
-            }
-
-            void on_data_available(DataReader *reader) override
-            {
-                SampleInfo info;
-                data_type data;
-                if (reader->take_next_sample(&data, &info) == ReturnCode_t::RETCODE_OK && info.valid_data)
-                {
-                    on_data_function(data);
-                }
-            }
-
-          private:
-            on_data_function_type on_data_function;
-        };
-
+        /**
+         * @brief Creates a new subscriber_handle object as a shared_ptr with a function / function object to be invoked
+         * on receiving data and functions to be invoked on missed deadlines and liveliness changes of its publishers.
+         * The subscriber_handle is automatically deleted correctly on destroying its last shared_ptr.
+         *
+         * @tparam data_pub_sub_type DDS data pub/sub type, f.e. std_msgs::msg::StringPubSubType
+         * @tparam on_data_function_type Type of a function / function object to be invoked on receiving data, as in
+         * the make_subscriber without health callbacks
+         * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+         * @param topic_name A DDS Topic Name
+         * @param on_data_function Function / function object to be invoked on receiving data
+         * @param health_callbacks Functions to be invoked on missed deadlines and liveliness changes
+         * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS DataReader,
+         * which makes receiving data slower but more reliable
+         * @return std::shared_ptr to the created subscriber_handle, or nullptr if its DDS DataReader can't be
+         * created, f.e. as the topic exists with another type
+         * @see provizio::dds::subscriber_health_callbacks
+         * @see provizio::dds::subscriber_handle
+         */
         template <typename data_pub_sub_type, typename on_data_function_type>
         std::shared_ptr<subscriber_handle<data_pub_sub_type>> make_subscriber(
             std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
-            on_data_function_type on_data_function, const ReliabilityQosPolicyKind reliability_kind)
-        {
-            return std::make_shared<subscriber_handle<data_pub_sub_type>>(
-                std::move(domain_participant), topic_name,
-                std::make_shared<
-                    on_data_function_data_listener<typename data_pub_sub_type::type, on_data_function_type>>(
-                    std::move(on_data_function)),
-                reliability_kind);
-        }
-
-        template <typename data_type, typename on_data_function_type, typename on_has_publisher_changed_function_type>
-        class functional_data_listener : public on_data_function_data_listener<data_type, on_data_function_type>
-        {
-          public:
-            functional_data_listener(on_data_function_type &&on_data_function,
-                                     on_has_publisher_changed_function_type &&on_has_publisher_changed_function)
-                : on_data_function_data_listener<data_type, on_data_function_type>(std::move(on_data_function)),
-                  on_has_publisher_changed_function(std::move(on_has_publisher_changed_function))
-            {
-            }
-
-            void on_subscription_matched(DataReader *reader, const SubscriptionMatchedStatus &info) override
+            on_data_function_type on_data_function, subscriber_health_callbacks health_callbacks,
+            ReliabilityQosPolicyKind reliability_kind = qos_defaults<data_pub_sub_type>::datareader_reliability_kind);
 
-            {
-                (void)reader;
-                if (info.current_count > 0 && info.current_count_change == info.current_count)
-                {
-                    // Just matched the first publisher
-                    on_has_publisher_changed_function(true);
-                }
-                else if (info.current_count == 0 && info.current_count_change < 0)
-                {
-                    // Just unmatched the last publisher
-                    on_has_publisher_changed_function(false);
-                }
-            }
+        /**
+         * @brief Creates a new subscriber_handle object as a shared_ptr with a function / function object to be invoked
+         * on receiving data passing a content filter. Filtered out samples are dropped by the publishers where
+         * possible, so they are not deserialized. The subscriber_handle is automatically deleted correctly on
+         * destroying its last shared_ptr. Usually the function type is auto-detected from the provided argument value.
+         *
+         * @tparam data_pub_sub_type DDS data pub/sub type, f.e. std_msgs::msg::StringPubSubType
+         * @tparam on_data_function_type Type of a function / function object to be invoked on receiving data, as in
+         * the unfiltered make_subscriber
+         * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+         * @param topic_name A DDS Topic Name
+         * @param filter The content filter, f.e. {"data = %0", {"'provizio'"}}
+         * @param on_data_function Function / function object to be invoked on receiving data
+         * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS DataReader,
+         * which makes receiving data slower but more reliable
+         * @return std::shared_ptr to the created subscriber_handle, or nullptr if its DDS DataReader can't be
+         * created, f.e. as the topic exists with another type
+         * @see provizio::dds::content_filter
+         * @see provizio::dds::subscriber_handle
+         */
+        template <typename data_pub_sub_type, typename on_data_function_type>
+        std::shared_ptr<subscriber_handle<data_pub_sub_type>> make_subscriber(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            const content_filter &filter, on_data_function_type on_data_function,
+            ReliabilityQosPolicyKind reliability_kind = qos_defaults<data_pub_sub_type>::datareader_reliability_kind);
+
+        /**
+         * @brief Creates a new subscriber_handle object as a shared_ptr with a function / function object to be invoked
+         * on receiving data passing a content filter and another function / function object to be invoked on matching
+         * first / umatching last publisher. The subscriber_handle is automatically deleted correctly on destroying its
+         * last shared_ptr. Usually the function types are auto-detected from the provided argument values.
+         *
+         * @tparam data_pub_sub_type DDS data pub/sub type, f.e. std_msgs::msg::StringPubSubType
+         * @tparam on_data_function_type Type of a function / function object to be invoked on receiving data, as in
+         * the unfiltered make_subscriber
+         * @tparam on_has_publisher_changed_function_type Type of a function / function object to be invoked on matching
+         * first / umatching last publisher, takes a single bool argument
+         * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+         * @param topic_name A DDS Topic Name
+         * @param filter The content filter, f.e. {"data = %0", {"'provizio'"}}
+         * @param on_data_function Function / function object to be invoked on receiving data
+         * @param on_has_publisher_changed_function The on_has_publisher_changed function
+         * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS DataReader,
+         * which makes receiving data slower but more reliable
+         * @return std::shared_ptr to the created subscriber_handle, or nullptr if its DDS DataReader can't be
+         * created, f.e. as the topic exists with another type
+         * @see provizio::dds::content_filter
+         * @see provizio::dds::subscriber_handle
+         */
+        template <typename data_pub_sub_type, typename on_data_function_type,
+                  typename on_has_publisher_changed_function_type>
+        std::shared_ptr<subscriber_handle<data_pub_sub_type>> make_subscriber(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            const content_filter &filter, on_data_function_type on_data_function,
+            on_has_publisher_changed_function_type on_has_publisher_changed_function,
+            ReliabilityQosPolicyKind reliability_kind = qos_defaults<data_pub_sub_type>::datareader_reliability_kind);
+
+        /**
+         * @brief Creates a new subscriber_handle object as a shared_ptr with a function / function object to be invoked
+         * on receiving samples of a keyed DDS data type along with their instance handles, f.e. to keep a state per
+         * radar sharing the topic with others. The subscriber_handle is automatically deleted correctly on destroying
+         * its last shared_ptr. Usually the function type is auto-detected from the provided argument value.
+         *
+         * @tparam data_pub_sub_type DDS data pub/sub type, f.e. std_msgs::msg::StringPubSubType
+         * @tparam on_instance_data_function_type Type of a function / function object to be invoked on receiving data,
+         * takes two arguments: a const reference to the instance handle and a const reference to the data type
+         * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+         * @param topic_name A DDS Topic Name
+         * @param filter The content filter, or an empty one for no filtering
+         * @param on_instance_data_function Function / function object to be invoked on receiving data
+         * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS DataReader,
+         * which makes receiving data slower but more reliable
+         * @return std::shared_ptr to the created subscriber_handle, or nullptr if its DDS DataReader can't be
+         * created, f.e. as the topic exists with another type
+         * @see provizio::dds::subscriber_handle
+         * @see https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/topic/instances.html
+         */
+        template <typename data_pub_sub_type, typename on_instance_data_function_type>
+        std::shared_ptr<subscriber_handle<data_pub_sub_type>> make_instance_subscriber(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            const content_filter &filter, on_instance_data_function_type on_instance_data_function,
+            ReliabilityQosPolicyKind reliability_kind = qos_defaults<data_pub_sub_type>::datareader_reliability_kind);
+
+        /**
+         * @brief Creates a new subscriber_handle object as a shared_ptr with a function / function object to be invoked
+         * on receiving samples of a keyed DDS data type along with their instance handles, and another one to be
+         * invoked on an instance being disposed or left with no publishers, which carries no sample. The
+         * subscriber_handle is automatically deleted correctly on destroying its last shared_ptr. Usually the function
+         * types are auto-detected from the provided argument values.
+         *
+         * @tparam data_pub_sub_type DDS data pub/sub type, f.e. std_msgs::msg::StringPubSubType
+         * @tparam on_instance_data_function_type Type of a function / function object to be invoked on receiving data,
+         * takes two arguments: a const reference to the instance handle and a const reference to the data type
+         * @tparam on_instance_state_function_type Type of a function / function object to be invoked on an instance
+         * becoming not alive, takes two arguments: a const reference to the instance handle and its InstanceStateKind,
+         * i.e. NOT_ALIVE_DISPOSED_INSTANCE_STATE or NOT_ALIVE_NO_WRITERS_INSTANCE_STATE
+         * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+         * @param topic_name A DDS Topic Name
+         * @param filter The content filter, or an empty one for no filtering
+         * @param on_instance_data_function Function / function object to be invoked on receiving data
+         * @param on_instance_state_function Function / function object to be invoked on an instance becoming not alive
+         * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS DataReader,
+         * which makes receiving data slower but more reliable
+         * @return std::shared_ptr to the created subscriber_handle, or nullptr if its DDS DataReader can't be
+         * created, f.e. as the topic exists with another type
+         * @note Unregistering an instance also disposes it, unless the publisher's writer_data_lifecycle QoS disables
+         * autodispose_unregistered_instances
+         * @see provizio::dds::subscriber_handle
+         * @see https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/topic/instances.html
+         */
+        template <typename data_pub_sub_type, typename on_instance_data_function_type,
+                  typename on_instance_state_function_type>
+        std::shared_ptr<subscriber_handle<data_pub_sub_type>> make_instance_subscriber(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            const content_filter &filter, on_instance_data_function_type on_instance_data_function,
+            on_instance_state_function_type on_instance_state_function,
+            ReliabilityQosPolicyKind reliability_kind = qos_defaults<data_pub_sub_type>::datareader_reliability_kind);
+
+        /**
+         * @brief Creates a new subscriber_handle object as a shared_ptr with a function / function object to be invoked
+         * on receiving samples in their serialized form, with no deserialization, f.e. to relay, record or measure
+         * them. They can be published as they are with a provizio::dds::make_raw_publisher. The received bytes are
+         * counted by provizio::dds::subscriber_handle::metrics. Content filters are not supported, as there is no
+         * type information to evaluate them.
+         *
+         * @tparam data_pub_sub_type DDS data pub/sub type of the topic, f.e. sensor_msgs::msg::PointCloud2PubSubType
+         * @tparam on_data_function_type Type of a function / function object to be invoked on receiving data, takes a
+         * single argument as a const reference to provizio::dds::serialized_sample (or a std::shared_ptr to the const
+         * serialized_sample), optionally wrapped with provizio::dds::dispatched, as in make_subscriber
+         * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant. It
+         * can't be shared with regular subscribers or publishers of the same data type.
+         * @param topic_name A DDS Topic Name
+         * @param on_data_function Function / function object to be invoked on receiving data
+         * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS DataReader,
+         * which makes receiving data slower but more reliable
+         * @return std::shared_ptr to the created subscriber_handle, or nullptr if its DDS DataReader can't be
+         * created, f.e. as the topic exists with another type
+         * @see provizio::dds::serialized_pub_sub_type_of
+         */
+        template <typename data_pub_sub_type, typename on_data_function_type>
+        std::shared_ptr<subscriber_handle<serialized_pub_sub_type_of<data_pub_sub_type>>> make_raw_subscriber(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            on_data_function_type on_data_function,
+            ReliabilityQosPolicyKind reliability_kind = qos_defaults<data_pub_sub_type>::datareader_reliability_kind);
+
+        /**
+         * @brief Creates a new subscriber_handle object as a shared_ptr with a function / function object to be invoked
+         * on receiving samples in their serialized form, for a DDS data type only known by its name at run time
+         *
+         * @tparam on_data_function_type Type of a function / function object to be invoked on receiving data, as in
+         * the make_raw_subscriber of a data type known at compile time
+         * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant. It
+         * can't be shared with regular subscribers or publishers of the same data type.
+         * @param topic_name A DDS Topic Name
+         * @param type_name DDS type name of the topic, f.e. "std_msgs::msg::dds_::String_"
+         * @param on_data_function Function / function object to be invoked on receiving data
+         * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS DataReader,
+         * which makes receiving data slower but more reliable
+         * @return std::shared_ptr to the created subscriber_handle, or nullptr if its DDS DataReader can't be
+         * created, f.e. as the topic exists with another type
+         * @see provizio::dds::serialized_pub_sub_type
+         */
+        template <typename on_data_function_type>
+        std::shared_ptr<subscriber_handle<serialized_pub_sub_type>> make_raw_subscriber(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            const std::string &type_name, on_data_function_type on_data_function,
+            ReliabilityQosPolicyKind reliability_kind =
+                qos_defaults<serialized_pub_sub_type>::datareader_reliability_kind);
+
+        /**
+         * @brief Creates a new subscriber_handle object as a shared_ptr, that is polled for data on the caller's thread
+         * with subscriber_handle::poll and subscriber_handle::take_into (or a provizio::dds::wait_set), rather than
+         * invoking a function in a Fast-DDS listener thread. Suits deterministic control loops, as samples are taken
+         * inline with no thread handoff.
+         *
+         * @tparam data_pub_sub_type DDS data pub/sub type, f.e. std_msgs::msg::StringPubSubType
+         * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+         * @param topic_name A DDS Topic Name
+         * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS DataReader,
+         * which makes receiving data slower but more reliable
+         * @param filter The content filter, or an empty one for no filtering
+         * @return std::shared_ptr to the created subscriber_handle, or nullptr if its DDS DataReader can't be
+         * created, f.e. as the topic exists with another type
+         * @see provizio::dds::polling_data_reader_listener
+         */
+        template <typename data_pub_sub_type>
+        std::shared_ptr<subscriber_handle<data_pub_sub_type>> make_polling_subscriber(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            ReliabilityQosPolicyKind reliability_kind = qos_defaults<data_pub_sub_type>::datareader_reliability_kind,
+            const content_filter &filter = {});
+
+        template <typename data_type> class latest_value_data_listener;
+
+        /**
+         * @brief A subscriber that keeps the newest received sample only ("mailbox" mode), for consumers that poll it,
+         * f.e. from a control loop. The sample is passed from the Fast-DDS listener thread via a wait-free triple
+         * buffer, so polling never blocks or contends with receiving. Normally created with
+         * provizio::dds::make_latest_value_subscriber.
+         *
+         * try_get_latest and get_latest_view are to be invoked by a single polling thread at a time, while
+         * latest_sequence and metrics can be read by any thread.
+         *
+         * @tparam data_pub_sub_type DDS data pub/sub type, f.e. std_msgs::msg::StringPubSubType
+         * @see provizio::dds::make_latest_value_subscriber
+         * @see provizio::dds::triple_buffer
+         */
+        template <typename data_pub_sub_type> class latest_value_subscriber final
+        {
+          public:
+            using data_type = typename data_pub_sub_type::type;
+
+          public:
+            /**
+             * @brief Constructs a new latest_value_subscriber object.
+             *
+             * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+             * @param topic_name A DDS Topic Name
+             * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS
+             * DataReader, which makes receiving data slower but more reliable
+             * @param filter The content filter, or an empty one for no filtering
+             */
+            latest_value_subscriber(std::shared_ptr<DomainParticipant> domain_participant,
+                                    const std::string &topic_name,
+                                    ReliabilityQosPolicyKind reliability_kind =
+                                        qos_defaults<data_pub_sub_type>::datareader_reliability_kind,
+                                    const content_filter &filter = {});
+
+            /**
+             * @brief Copies the newest received sample. Wait-free.
+             *
+             * @param sample The sample to copy the data to
+             * @param sequence Optionally receives the sequence number of the sample, which grows with every received
+             * sample, so that updates can be detected
+             * @return true if a sample has been received, false if none has been received yet
+             */
+            bool try_get_latest(data_type &sample, std::uint64_t *sequence = nullptr);
+
+            /**
+             * @brief Provides the newest received sample without copying it. Wait-free.
+             *
+             * @param sequence Optionally receives the sequence number of the sample, 0 if none has been received yet
+             * @return Pointer to the sample, valid until the next try_get_latest or get_latest_view invocation, or
+             * nullptr if none has been received yet
+             */
+            const data_type *get_latest_view(std::uint64_t *sequence = nullptr);
+
+            /**
+             * @return Sequence number of the newest received sample, 0 if none has been received yet. Can be read by
+             * any thread to detect updates cheaply.
+             */
+            std::uint64_t latest_sequence() const noexcept;
+
+            /**
+             * @return The instance handle of the DDS DataReader, or HANDLE_NIL if it couldn't be created
+             */
+            InstanceHandle_t instance_handle() const
+            {
+                return handle.instance_handle();
+            }
+
+            /**
+             * @brief Reads the counters of the subscriber
+             *
+             * @return A snapshot of the counters
+             */
+            subscriber_metrics metrics() const;
+
+          private:
+            std::shared_ptr<latest_value_data_listener<data_type>> listener;
+            subscriber_handle<data_pub_sub_type> handle;
+        };
+
+        /**
+         * @brief Creates a new latest_value_subscriber object as a shared_ptr, which keeps the newest received sample
+         * to be polled wait-free. The latest_value_subscriber is automatically deleted correctly on destroying its
+         * last shared_ptr.
+         *
+         * @tparam data_pub_sub_type DDS data pub/sub type, f.e. std_msgs::msg::StringPubSubType
+         * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+         * @param topic_name A DDS Topic Name
+         * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS DataReader,
+         * which makes receiving data slower but more reliable
+         * @param filter The content filter, or an empty one for no filtering
+         * @return std::shared_ptr to the created latest_value_subscriber, nullptr if its DDS DataReader couldn't be
+         * created
+         * @see provizio::dds::latest_value_subscriber
+         */
+        template <typename data_pub_sub_type>
+        std::shared_ptr<latest_value_subscriber<data_pub_sub_type>> make_latest_value_subscriber(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            ReliabilityQosPolicyKind reliability_kind = qos_defaults<data_pub_sub_type>::datareader_reliability_kind,
+            const content_filter &filter = {})
+        {
+            return detail::created_or_null(std::make_shared<latest_value_subscriber<data_pub_sub_type>>(
+                std::move(domain_participant), topic_name, reliability_kind, filter));
+        }
+
+        /**
+         * @brief A span-like view of a batch of samples taken from a DDS DataReader at once, as passed to a
+         * function / function object provided to provizio::dds::make_batch_subscriber. The samples are loaned by
+         * Fast-DDS and only valid during the function invocation.
+         *
+         * Iterating (begin / end) visits valid samples only, while size, sample, info and operator[] address all the
+         * taken samples, including the ones without valid data (f.e. instance state notifications).
+         *
+         * @tparam data_type DDS data type, f.e. std_msgs::msg::String
+         * @see provizio::dds::make_batch_subscriber
+         */
+        template <typename data_type> class sample_batch final
+        {
+          public:
+            using size_type = LoanableCollection::size_type;
+
+            /**
+             * @brief Forward iterator over the valid samples of a sample_batch
+             */
+            class const_iterator final
+            {
+              public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = data_type;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const data_type *;
+                using reference = const data_type &;
+
+              public:
+                const_iterator(const sample_batch &batch, const size_type index) : batch(&batch), index(index)
+                {
+                    skip_invalid();
+                }
+
+                reference operator*() const
+                {
+                    return batch->sample(index);
+                }
+
+                pointer operator->() const
+                {
+                    return &batch->sample(index);
+                }
+
+                const_iterator &operator++()
+                {
+                    ++index;
+                    skip_invalid();
+                    return *this;
+                }
+
+                const_iterator operator++(int)
+                {
+                    const_iterator result = *this;
+                    ++(*this);
+                    return result;
+                }
+
+                bool operator==(const const_iterator &other) const
+                {
+                    return index == other.index;
+                }
+
+                bool operator!=(const const_iterator &other) const
+                {
+                    return index != other.index;
+                }
+
+              private:
+                void skip_invalid()
+                {
+                    while (index < batch->size() && !batch->info(index).valid_data)
+                    {
+                        ++index;
+                    }
+                }
+
+                const sample_batch *batch;
+                size_type index;
+            };
+
+          public:
+            sample_batch(const LoanableSequence<data_type> &samples, const SampleInfoSeq &infos)
+                : samples(samples), infos(infos)
+            {
+            }
+
+            /**
+             * @return Number of samples taken, including the ones without valid data
+             */
+            size_type size() const
+            {
+                return samples.length();
+            }
+
+            /**
+             * @return true if no samples were taken
+             */
+            bool empty() const
+            {
+                return size() == 0;
+            }
+
+            /**
+             * @param index Sample index, in the range [0, size())
+             * @return The sample data, only meaningful if info(index).valid_data is true
+             */
+            const data_type &sample(const size_type index) const
+            {
+                return samples[index];
+            }
+
+            /**
+             * @param index Sample index, in the range [0, size())
+             * @return The sample info
+             * @see https://fast-dds.docs.eprosima.com/en/latest/fastdds/dds_layer/subscriber/sampleInfo/sampleInfo.html
+             */
+            const SampleInfo &info(const size_type index) const
+            {
+                return infos[index];
+            }
+
+            const data_type &operator[](const size_type index) const
+            {
+                return sample(index);
+            }
+
+            const_iterator begin() const
+            {
+                return {*this, 0};
+            }
+
+            const_iterator end() const
+            {
+                return {*this, size()};
+            }
+
+          private:
+            const LoanableSequence<data_type> &samples;
+            const SampleInfoSeq &infos;
+        };
+
+        /**
+         * @brief Creates a new subscriber_handle object as a shared_ptr with a function / function object to be invoked
+         * on receiving data as batches of samples. All the samples available in the DDS DataReader are taken at once
+         * as loans, which takes a single listener dispatch for a burst of samples and avoids copying them. The
+         * subscriber_handle is automatically deleted correctly on destroying its last shared_ptr. Usually the function
+         * type is auto-detected from the provided argument value.
+         *
+         * @tparam data_pub_sub_type DDS data pub/sub type, f.e. std_msgs::msg::StringPubSubType
+         * @tparam on_batch_function_type Type of a function / function object to be invoked on receiving data, takes a
+         * single argument as a const reference to provizio::dds::sample_batch of the data type, f.e. const
+         * provizio::dds::sample_batch<std_msgs::msg::String>&
+         * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+         * @param topic_name A DDS Topic Name
+         * @param on_batch_function Function / function object to be invoked on receiving a batch of data. Loaned
+         * samples are returned right after it returns, so they must not be referenced afterwards.
+         * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS DataReader,
+         * which makes receiving data slower but more reliable
+         * @param max_samples Maximum number of samples per batch, LENGTH_UNLIMITED by default
+         * @return std::shared_ptr to the created subscriber_handle, or nullptr if its DDS DataReader can't be
+         * created, f.e. as the topic exists with another type
+         * @see provizio::dds::subscriber_handle
+         * @see provizio::dds::sample_batch
+         * @see https://en.cppreference.com/w/cpp/memory/shared_ptr
+         */
+        template <typename data_pub_sub_type, typename on_batch_function_type>
+        std::shared_ptr<subscriber_handle<data_pub_sub_type>> make_batch_subscriber(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            on_batch_function_type on_batch_function,
+            ReliabilityQosPolicyKind reliability_kind = qos_defaults<data_pub_sub_type>::datareader_reliability_kind,
+            std::int32_t max_samples = LENGTH_UNLIMITED);
+
+        /**
+         * @brief Creates a new subscriber_handle object as a shared_ptr with a function / function object to be invoked
+         * on receiving data as batches of samples and another function / function object to be invoked on matching
+         * first / umatching last publisher. The subscriber_handle is automatically deleted correctly on destroying its
+         * last shared_ptr. Usually the function types are auto-detected from the provided argument values.
+         *
+         * @tparam data_pub_sub_type DDS data pub/sub type, f.e. std_msgs::msg::StringPubSubType
+         * @tparam on_batch_function_type Type of a function / function object to be invoked on receiving data, takes a
+         * single argument as a const reference to provizio::dds::sample_batch of the data type, f.e. const
+         * provizio::dds::sample_batch<std_msgs::msg::String>&
+         * @tparam on_has_publisher_changed_function_type Type of a function / function object to be invoked on matching
+         * first / umatching last publisher, takes a single bool argument: true when the first publisher is matched,
+         * false when the last publisher is unmatched
+         * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+         * @param topic_name A DDS Topic Name
+         * @param on_batch_function Function / function object to be invoked on receiving a batch of data. Loaned
+         * samples are returned right after it returns, so they must not be referenced afterwards.
+         * @param on_has_publisher_changed_function The on_has_publisher_changed function
+         * @param reliability_kind Defines whether RELIABLE_RELIABILITY_QOS should be enabled for the DDS DataReader,
+         * which makes receiving data slower but more reliable
+         * @param max_samples Maximum number of samples per batch, LENGTH_UNLIMITED by default
+         * @return std::shared_ptr to the created subscriber_handle, or nullptr if its DDS DataReader can't be
+         * created, f.e. as the topic exists with another type
+         * @see provizio::dds::subscriber_handle
+         * @see provizio::dds::sample_batch
+         * @see https://en.cppreference.com/w/cpp/memory/shared_ptr
+         */
+        template <typename data_pub_sub_type, typename on_batch_function_type,
+                  typename on_has_publisher_changed_function_type>
+        std::shared_ptr<subscriber_handle<data_pub_sub_type>> make_batch_subscriber(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            on_batch_function_type on_batch_function,
+            on_has_publisher_changed_function_type on_has_publisher_changed_function,
+            ReliabilityQosPolicyKind reliability_kind = qos_defaults<data_pub_sub_type>::datareader_reliability_kind,
+            std::int32_t max_samples = LENGTH_UNLIMITED);
+
+        namespace detail
+        {
+            /**
+             * @return A name for a new ContentFilteredTopic, unique in the process, as DDS requires
+             */
+            inline std::string unique_filtered_topic_name(const std::string &topic_name)
+            {
+                static std::atomic<std::uint64_t> counter{0};
+                return topic_name + "_filtered_" + std::to_string(counter.fetch_add(1, std::memory_order_relaxed));
+            }
+        } // namespace detail
+
+        template <typename data_pub_sub_type>
+        subscriber_handle<data_pub_sub_type>::subscriber_handle(std::shared_ptr<DomainParticipant> domain_participant,
+                                                                const std::string &topic_name,
+                                                                std::shared_ptr<DataReaderListener> data_listener,
+                                                                const ReliabilityQosPolicyKind reliability_kind)
+            : subscriber_handle(std::move(domain_participant), topic_name, content_filter{}, std::move(data_listener),
+                                reliability_kind)
+        {
+        }
+
+        template <typename data_pub_sub_type>
+        subscriber_handle<data_pub_sub_type>::subscriber_handle(std::shared_ptr<DomainParticipant> domain_participant,
+                                                                const std::string &topic_name,
+                                                                const content_filter &filter,
+                                                                std::shared_ptr<DataReaderListener> data_listener,
+                                                                const ReliabilityQosPolicyKind reliability_kind)
+            : subscriber_handle(std::move(domain_participant), topic_name, dds::TypeSupport(new data_pub_sub_type()),
+                                filter, std::move(data_listener), reliability_kind)
+        {
+        }
+
+        template <typename data_pub_sub_type>
+        subscriber_handle<data_pub_sub_type>::subscriber_handle(std::shared_ptr<DomainParticipant> domain_participant,
+                                                                const std::string &topic_name,
+                                                                dds::TypeSupport type_support,
+                                                                const content_filter &filter,
+                                                                std::shared_ptr<DataReaderListener> data_listener,
+                                                                const ReliabilityQosPolicyKind reliability_kind)
+            : domain_participant(std::move(domain_participant)), type_support(std::move(type_support)),
+              data_listener(std::move(data_listener)),
+              counting_listener(dynamic_cast<counting_data_reader_listener *>(this->data_listener.get())),
+              polling_listener(dynamic_cast<polling_data_reader_listener *>(this->data_listener.get()))
+        {
+            auto datareader_qos = DATAREADER_QOS_DEFAULT;
+            datareader_qos.reliability().kind = reliability_kind;
+            detail::apply_qos_defaults<data_pub_sub_type>(datareader_qos, this->type_support);
+            datareader_qos.endpoint().user_defined_id =
+                static_endpoint_user_id(this->domain_participant, topic_name, static_endpoint_kind::reader);
+
+            topic = acquire_topic(this->domain_participant, topic_name, this->type_support);
+            subscriber = acquire_subscriber(this->domain_participant);
+            if (!topic || !subscriber)
+            {
+                return;
+            }
+
+            TopicDescription *topic_description = topic.get();
+            if (!filter.expression.empty())
+            {
+                filtered_topic = this->domain_participant->create_contentfilteredtopic(
+                    detail::unique_filtered_topic_name(topic_name), topic.get(), filter.expression, filter.parameters);
+                if (filtered_topic == nullptr)
+                {
+                    // Invalid filter expression or parameters
+                    return;
+                }
+                topic_description = filtered_topic;
+            }
+
+            if (counting_listener != nullptr)
+            {
+                counting_listener->set_type_support(this->type_support);
+            }
+
+            // Polled subscribers are not notified of data available, so it triggers the StatusCondition instead
+            const StatusMask listener_mask =
+                polling_listener != nullptr ? StatusMask::all() >> StatusMask::data_available() : StatusMask::all();
+            data_reader = subscriber->create_datareader(topic_description, datareader_qos, this->data_listener.get(),
+                                                        listener_mask);
+            if (data_reader != nullptr)
+            {
+                data_reader->get_statuscondition().set_enabled_statuses(StatusMask::data_available());
+                introspection_id = detail::register_introspected(this->domain_participant, data_reader,
+                                                                 [this]() { return metrics(); });
+            }
+        }
+
+        template <typename data_pub_sub_type> subscriber_handle<data_pub_sub_type>::~subscriber_handle()
+        {
+            detail::unregister_introspected(introspection_id);
+            if (data_reader != nullptr)
+            {
+                if (wait_set)
+                {
+                    wait_set->detach_condition(data_reader->get_statuscondition());
+                }
+                subscriber->delete_datareader(data_reader);
+            }
+
+            // Deleted before the topic it's based on
+            if (filtered_topic != nullptr)
+            {
+                domain_participant->delete_contentfilteredtopic(filtered_topic);
+            }
+        }
+
+        template <typename data_pub_sub_type>
+        InstanceHandle_t subscriber_handle<data_pub_sub_type>::lookup_instance(const data_type &key_holder) const
+        {
+            return data_reader != nullptr ? data_reader->lookup_instance(&key_holder) : HANDLE_NIL;
+        }
+
+        template <typename data_pub_sub_type>
+        bool subscriber_handle<data_pub_sub_type>::take_instance(data_type &sample, const InstanceHandle_t &instance,
+                                                                 SampleInfo *info)
+        {
+            if (data_reader == nullptr || instance == HANDLE_NIL)
+            {
+                return false;
+            }
+
+            LoanableSequence<data_type> samples;
+            SampleInfoSeq infos;
+            if (data_reader->take_instance(samples, infos, 1, instance) != ReturnCode_t::RETCODE_OK)
+            {
+                return false;
+            }
+
+            const bool valid = samples.length() > 0 && infos[0].valid_data;
+            if (valid)
+            {
+                sample = samples[0];
+                if (info != nullptr)
+                {
+                    *info = infos[0];
+                }
+            }
+            data_reader->return_loan(samples, infos);
+            return valid;
+        }
+
+        template <typename data_pub_sub_type> subscriber_metrics subscriber_handle<data_pub_sub_type>::metrics() const
+        {
+            return counting_listener != nullptr ? counting_listener->metrics() : subscriber_metrics{};
+        }
+
+        template <typename data_pub_sub_type>
+        void subscriber_handle<data_pub_sub_type>::count_received_bytes(const bool enabled)
+        {
+            if (counting_listener != nullptr)
+            {
+                counting_listener->count_received_bytes(enabled);
+            }
+        }
+
+        template <typename data_pub_sub_type>
+        bool subscriber_handle<data_pub_sub_type>::poll(const std::chrono::nanoseconds timeout)
+        {
+            if (data_reader == nullptr)
+            {
+                return false;
+            }
+
+            if (data_reader->get_unread_count() > 0 || timeout <= std::chrono::nanoseconds::zero())
+            {
+                return data_reader->get_unread_count() > 0;
+            }
+
+            if (!wait_set)
+            {
+                wait_set = std::make_unique<WaitSet>();
+                wait_set->attach_condition(data_reader->get_statuscondition());
+            }
+
+            // The sequence keeps its capacity, so waiting doesn't allocate in a steady state
+            active_conditions.clear();
+            return wait_set->wait(active_conditions, detail::to_duration(timeout)) == ReturnCode_t::RETCODE_OK &&
+                   data_reader->get_unread_count() > 0;
+        }
+
+        template <typename data_pub_sub_type>
+        bool subscriber_handle<data_pub_sub_type>::take_into(data_type &sample, SampleInfo *info)
+        {
+            if (data_reader == nullptr)
+            {
+                return false;
+            }
+
+            SampleInfo local_info;
+            SampleInfo &sample_info = info != nullptr ? *info : local_info;
+            while (data_reader->take_next_sample(&sample, &sample_info) == ReturnCode_t::RETCODE_OK)
+            {
+                if (sample_info.valid_data)
+                {
+                    if (polling_listener != nullptr)
+                    {
+                        polling_listener->count_taken(sample_info, sample);
+                    }
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        template <typename data_pub_sub_type>
+        StatusCondition *subscriber_handle<data_pub_sub_type>::data_available_condition()
+        {
+            return data_reader != nullptr ? &data_reader->get_statuscondition() : nullptr;
+        }
+
+        template <typename data_pub_sub_type>
+        InstanceHandle_t subscriber_handle<data_pub_sub_type>::instance_handle() const
+        {
+            return data_reader != nullptr ? data_reader->get_instance_handle() : HANDLE_NIL;
+        }
+
+        namespace detail
+        {
+            template <typename function_type, typename argument_type, typename = void>
+            struct is_invocable_with : std::false_type
+            {
+            };
+
+            template <typename function_type, typename argument_type>
+            struct is_invocable_with<function_type, argument_type,
+                                     decltype(void(std::declval<function_type &>()(std::declval<argument_type>())))>
+                : std::true_type
+            {
+            };
+
+            // Checking for const data_type & first, so generic functions are never instantiated with a shared_ptr
+            template <typename function_type, typename data_type,
+                      bool = is_invocable_with<function_type, const data_type &>::value>
+            struct takes_shared_sample : std::false_type
+            {
+            };
+
+            template <typename function_type, typename data_type>
+            struct takes_shared_sample<function_type, data_type, false>
+                : is_invocable_with<function_type, std::shared_ptr<const data_type>>
+            {
+            };
+        } // namespace detail
+
+        template <typename data_type, typename on_data_function_type>
+        class on_data_function_data_listener : public counting_data_reader_listener
+        {
+          public:
+            on_data_function_data_listener(on_data_function_type &&on_data_function,
+                                           const std::size_t sample_pool_size = sample_pool<data_type>::default_size)
+                : on_data_function(std::move(on_data_function)), samples(sample_pool_size)
+            {
+            }
+
+            void on_data_available(DataReader *reader) override
+            {
+                SampleInfo info;
+                const auto sample = samples.acquire();
+                if (reader->take_next_sample(sample.get().get(), &info) == ReturnCode_t::RETCODE_OK &&
+                    info.valid_data)
+                {
+                    counters.count_received(info.source_timestamp);
+                    counters.count_received_bytes(received_bytes(*sample.get()));
+                    detail::scoped_callback_timer timer{counters};
+                    invoke(sample.get(), detail::takes_shared_sample<on_data_function_type, data_type>{});
+                }
+            }
+
+          private:
+            void invoke(const std::shared_ptr<data_type> &sample, std::false_type /*takes_shared_sample*/)
+            {
+                on_data_function(static_cast<const data_type &>(*sample));
+            }
+
+            void invoke(const std::shared_ptr<data_type> &sample, std::true_type /*takes_shared_sample*/)
+            {
+                on_data_function(std::shared_ptr<const data_type>{sample});
+            }
+
+            on_data_function_type on_data_function;
+            sample_pool<data_type> samples;
+        };
+
+        namespace detail
+        {
+            template <typename data_type, typename on_data_function_type>
+            class dispatch_queue final : public dispatch_queue_base
+            {
+              public:
+                dispatch_queue(on_data_function_type &&on_data_function, std::string name, const std::size_t capacity,
+                               subscriber_counters &counters)
+                    : dispatch_queue_base(std::move(name)), on_data_function(std::move(on_data_function)),
+                      queue(capacity), counters(counters)
+                {
+                }
+
+                bool push(std::shared_ptr<data_type> &&sample)
+                {
+                    if (!queue.try_push(queued_sample{std::move(sample), std::chrono::steady_clock::now()}))
+                    {
+                        count_dropped();
+                        return false;
+                    }
+
+                    count_enqueued(queue.size());
+                    return true;
+                }
+
+                std::size_t drain(const std::size_t max_count) override
+                {
+                    std::size_t count = 0;
+                    queued_sample next;
+                    while (count < max_count && queue.try_pop(next))
+                    {
+                        const auto started = std::chrono::steady_clock::now();
+                        invoke(next.sample, takes_shared_sample<on_data_function_type, data_type>{});
+                        const auto finished = std::chrono::steady_clock::now();
+                        counters.count_callback(
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(finished - started));
+
+                        // Returns the sample to its pool, unless retained by the function
+                        next.sample.reset();
+                        count_dispatched(std::chrono::duration_cast<std::chrono::nanoseconds>(started - next.enqueued),
+                                         std::chrono::duration_cast<std::chrono::nanoseconds>(finished - started));
+                        ++count;
+                    }
+                    return count;
+                }
+
+                std::size_t size() const noexcept override
+                {
+                    return queue.size();
+                }
+
+              private:
+                struct queued_sample
+                {
+                    std::shared_ptr<data_type> sample;
+                    std::chrono::steady_clock::time_point enqueued;
+                };
+
+                void invoke(const std::shared_ptr<data_type> &sample, std::false_type /*takes_shared_sample*/)
+                {
+                    on_data_function(static_cast<const data_type &>(*sample));
+                }
+
+                void invoke(const std::shared_ptr<data_type> &sample, std::true_type /*takes_shared_sample*/)
+                {
+                    on_data_function(std::shared_ptr<const data_type>{sample});
+                }
+
+                on_data_function_type on_data_function;
+                bounded_queue<queued_sample> queue;
+                subscriber_counters &counters;
+            };
+        } // namespace detail
+
+        /**
+         * @brief Pushes received samples to a queue served by a dispatcher worker thread, instead of invoking the
+         * function in the Fast-DDS listener thread
+         */
+        template <typename data_type, typename on_data_function_type>
+        class on_data_function_data_listener<data_type, dispatched_function<on_data_function_type>>
+            : public counting_data_reader_listener
+        {
+          public:
+            on_data_function_data_listener(dispatched_function<on_data_function_type> &&on_data_function,
+                                           const std::size_t sample_pool_size = 0)
+                : executor(std::move(on_data_function.executor)),
+                  queue(std::make_shared<detail::dispatch_queue<data_type, on_data_function_type>>(
+                      std::move(on_data_function.function), std::move(on_data_function.name),
+                      executor->queue_capacity(), counters)),
+                  // Enough samples for a full queue and the one being taken, unless specified explicitly
+                  samples(sample_pool_size > 0 ? sample_pool_size : executor->queue_capacity() + 1)
+            {
+                executor->add(queue);
+            }
+
+            ~on_data_function_data_listener() override
+            {
+                executor->remove(queue.get());
+            }
+
+            on_data_function_data_listener(const on_data_function_data_listener &) = delete;
+            on_data_function_data_listener &operator=(const on_data_function_data_listener &) = delete;
+
+            void on_data_available(DataReader *reader) override
+            {
+                SampleInfo info;
+                std::shared_ptr<data_type> sample;
+                {
+                    // The sample stays out of the pool while retained by the queue
+                    const auto lease = samples.acquire();
+                    if (reader->take_next_sample(lease.get().get(), &info) != ReturnCode_t::RETCODE_OK ||
+                        !info.valid_data)
+                    {
+                        return;
+                    }
+                    sample = lease.get();
+                }
+
+                counters.count_received(info.source_timestamp);
+                counters.count_received_bytes(received_bytes(*sample));
+                if (queue->push(std::move(sample)))
+                {
+                    executor->notify(queue.get());
+                }
+            }
+
+          private:
+            std::shared_ptr<dispatcher> executor;
+            std::shared_ptr<detail::dispatch_queue<data_type, on_data_function_type>> queue;
+            sample_pool<data_type> samples;
+        };
+
+        template <typename data_pub_sub_type, typename on_data_function_type>
+        std::shared_ptr<subscriber_handle<data_pub_sub_type>> make_subscriber(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            on_data_function_type on_data_function, const ReliabilityQosPolicyKind reliability_kind)
+        {
+            return detail::created_or_null(std::make_shared<subscriber_handle<data_pub_sub_type>>(
+                std::move(domain_participant), topic_name,
+                std::make_shared<
+                    on_data_function_data_listener<typename data_pub_sub_type::type, on_data_function_type>>(
+                    std::move(on_data_function)),
+                reliability_kind));
+        }
+
+        template <typename base_listener_type, typename on_has_publisher_changed_function_type>
+        class on_has_publisher_changed_data_listener : public base_listener_type
+        {
+          public:
+            template <typename on_data_function_type, typename... extra_arg_types>
+            on_has_publisher_changed_data_listener(
+                on_data_function_type &&on_data_function,
+                on_has_publisher_changed_function_type &&on_has_publisher_changed_function,
+                extra_arg_types &&...extra_args)
+                : base_listener_type(std::forward<on_data_function_type>(on_data_function),
+                                     std::forward<extra_arg_types>(extra_args)...),
+                  on_has_publisher_changed_function(std::move(on_has_publisher_changed_function))
+            {
+            }
+
+            void on_subscription_matched(DataReader *reader, const SubscriptionMatchedStatus &info) override
+
+            {
+                (void)reader;
+                if (info.current_count > 0 && info.current_count_change == info.current_count)
+                {
+                    // Just matched the first publisher
+                    on_has_publisher_changed_function(true);
+                }
+                else if (info.current_count == 0 && info.current_count_change < 0)
+                {
+                    // Just unmatched the last publisher
+                    on_has_publisher_changed_function(false);
+                }
+            }
 
           private:
             on_has_publisher_changed_function_type on_has_publisher_changed_function;
         };
 
+        template <typename base_listener_type> class health_data_listener : public base_listener_type
+        {
+          public:
+            template <typename on_data_function_type, typename... extra_arg_types>
+            health_data_listener(on_data_function_type &&on_data_function,
+                                 subscriber_health_callbacks &&health_callbacks, extra_arg_types &&...extra_args)
+                : base_listener_type(std::forward<on_data_function_type>(on_data_function),
+                                     std::forward<extra_arg_types>(extra_args)...),
+                  health_callbacks(std::move(health_callbacks))
+            {
+            }
+
+            void on_requested_deadline_missed(DataReader *reader, const RequestedDeadlineMissedStatus &status) override
+            {
+                base_listener_type::on_requested_deadline_missed(reader, status);
+                if (health_callbacks.on_requested_deadline_missed)
+                {
+                    health_callbacks.on_requested_deadline_missed(status);
+                }
+            }
+
+            void on_liveliness_changed(DataReader *reader, const LivelinessChangedStatus &status) override
+            {
+                base_listener_type::on_liveliness_changed(reader, status);
+                if (health_callbacks.on_liveliness_changed)
+                {
+                    health_callbacks.on_liveliness_changed(status);
+                }
+            }
+
+          private:
+            subscriber_health_callbacks health_callbacks;
+        };
+
+        template <typename data_pub_sub_type, typename on_data_function_type>
+        std::shared_ptr<subscriber_handle<data_pub_sub_type>> make_subscriber(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            on_data_function_type on_data_function, subscriber_health_callbacks health_callbacks,
+            const ReliabilityQosPolicyKind reliability_kind)
+        {
+            return detail::created_or_null(std::make_shared<subscriber_handle<data_pub_sub_type>>(
+                std::move(domain_participant), topic_name,
+                std::make_shared<health_data_listener<
+                    on_data_function_data_listener<typename data_pub_sub_type::type, on_data_function_type>>>(
+                    std::move(on_data_function), std::move(health_callbacks)),
+                reliability_kind));
+        }
+
+        template <typename data_type, typename on_data_function_type, typename on_has_publisher_changed_function_type>
+        class functional_data_listener
+            : public on_has_publisher_changed_data_listener<
+                  on_data_function_data_listener<data_type, on_data_function_type>,
+                  on_has_publisher_changed_function_type>
+        {
+          public:
+            functional_data_listener(on_data_function_type &&on_data_function,
+                                     on_has_publisher_changed_function_type &&on_has_publisher_changed_function)
+                : on_has_publisher_changed_data_listener<
+                      on_data_function_data_listener<data_type, on_data_function_type>,
+                      on_has_publisher_changed_function_type>(std::move(on_data_function),
+                                                              std::move(on_has_publisher_changed_function))
+            {
+            }
+        };
+
         template <typename data_pub_sub_type, typename on_data_function_type,
                   typename on_has_publisher_changed_function_type>
         std::shared_ptr<subscriber_handle<data_pub_sub_type>> make_subscriber(
@@ -241,12 +1544,322 @@ namespace provizio
             on_has_publisher_changed_function_type on_has_publisher_changed_function,
             const ReliabilityQosPolicyKind reliability_kind)
         {
-            return std::make_shared<subscriber_handle<data_pub_sub_type>>(
+            return detail::created_or_null(std::make_shared<subscriber_handle<data_pub_sub_type>>(
                 std::move(domain_participant), topic_name,
                 std::make_shared<functional_data_listener<typename data_pub_sub_type::type, on_data_function_type,
                                                           on_has_publisher_changed_function_type>>(
                     std::move(on_data_function), std::move(on_has_publisher_changed_function)),
-                reliability_kind);
+                reliability_kind));
+        }
+
+        template <typename data_pub_sub_type, typename on_data_function_type>
+        std::shared_ptr<subscriber_handle<data_pub_sub_type>> make_subscriber(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            const content_filter &filter, on_data_function_type on_data_function,
+            const ReliabilityQosPolicyKind reliability_kind)
+        {
+            return detail::created_or_null(std::make_shared<subscriber_handle<data_pub_sub_type>>(
+                std::move(domain_participant), topic_name, filter,
+                std::make_shared<
+                    on_data_function_data_listener<typename data_pub_sub_type::type, on_data_function_type>>(
+                    std::move(on_data_function)),
+                reliability_kind));
+        }
+
+        template <typename data_pub_sub_type, typename on_data_function_type,
+                  typename on_has_publisher_changed_function_type>
+        std::shared_ptr<subscriber_handle<data_pub_sub_type>> make_subscriber(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            const content_filter &filter, on_data_function_type on_data_function,
+            on_has_publisher_changed_function_type on_has_publisher_changed_function,
+            const ReliabilityQosPolicyKind reliability_kind)
+        {
+            return detail::created_or_null(std::make_shared<subscriber_handle<data_pub_sub_type>>(
+                std::move(domain_participant), topic_name, filter,
+                std::make_shared<functional_data_listener<typename data_pub_sub_type::type, on_data_function_type,
+                                                          on_has_publisher_changed_function_type>>(
+                    std::move(on_data_function), std::move(on_has_publisher_changed_function)),
+                reliability_kind));
+        }
+
+        namespace detail
+        {
+            struct ignore_instance_state
+            {
+                void operator()(const InstanceHandle_t & /*instance*/, InstanceStateKind /*state*/) const
+                {
+                }
+            };
+        } // namespace detail
+
+        template <typename data_type, typename on_instance_data_function_type,
+                  typename on_instance_state_function_type = detail::ignore_instance_state>
+        class on_instance_data_function_data_listener : public counting_data_reader_listener
+        {
+          public:
+            on_instance_data_function_data_listener(
+                on_instance_data_function_type &&on_instance_data_function,
+                on_instance_state_function_type &&on_instance_state_function = on_instance_state_function_type{})
+                : on_instance_data_function(std::move(on_instance_data_function)),
+                  on_instance_state_function(std::move(on_instance_state_function))
+            {
+            }
+
+            void on_data_available(DataReader *reader) override
+            {
+                SampleInfo info;
+                while (reader->take_next_sample(&sample, &info) == ReturnCode_t::RETCODE_OK)
+                {
+                    if (info.valid_data)
+                    {
+                        counters.count_received(info.source_timestamp);
+                        counters.count_received_bytes(received_bytes(sample));
+                        detail::scoped_callback_timer timer{counters};
+                        on_instance_data_function(static_cast<const InstanceHandle_t &>(info.instance_handle),
+                                                  static_cast<const data_type &>(sample));
+                    }
+                    else if (info.instance_state != ALIVE_INSTANCE_STATE)
+                    {
+                        // Disposal or unregistration of the instance, with no data
+                        on_instance_state_function(static_cast<const InstanceHandle_t &>(info.instance_handle),
+                                                   static_cast<InstanceStateKind>(info.instance_state));
+                    }
+                }
+            }
+
+          private:
+            on_instance_data_function_type on_instance_data_function;
+            on_instance_state_function_type on_instance_state_function;
+
+            // Reused by every take, so its dynamic members keep their capacity
+            data_type sample;
+        };
+
+        template <typename data_pub_sub_type, typename on_instance_data_function_type>
+        std::shared_ptr<subscriber_handle<data_pub_sub_type>> make_instance_subscriber(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            const content_filter &filter, on_instance_data_function_type on_instance_data_function,
+            const ReliabilityQosPolicyKind reliability_kind)
+        {
+            return detail::created_or_null(std::make_shared<subscriber_handle<data_pub_sub_type>>(
+                std::move(domain_participant), topic_name, filter,
+                std::make_shared<on_instance_data_function_data_listener<typename data_pub_sub_type::type,
+                                                                         on_instance_data_function_type>>(
+                    std::move(on_instance_data_function)),
+                reliability_kind));
+        }
+
+        template <typename data_pub_sub_type, typename on_instance_data_function_type,
+                  typename on_instance_state_function_type>
+        std::shared_ptr<subscriber_handle<data_pub_sub_type>> make_instance_subscriber(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            const content_filter &filter, on_instance_data_function_type on_instance_data_function,
+            on_instance_state_function_type on_instance_state_function, const ReliabilityQosPolicyKind reliability_kind)
+        {
+            return detail::created_or_null(std::make_shared<subscriber_handle<data_pub_sub_type>>(
+                std::move(domain_participant), topic_name, filter,
+                std::make_shared<on_instance_data_function_data_listener<
+                    typename data_pub_sub_type::type, on_instance_data_function_type, on_instance_state_function_type>>(
+                    std::move(on_instance_data_function), std::move(on_instance_state_function)),
+                reliability_kind));
+        }
+
+        template <typename data_pub_sub_type, typename on_data_function_type>
+        std::shared_ptr<subscriber_handle<serialized_pub_sub_type_of<data_pub_sub_type>>> make_raw_subscriber(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            on_data_function_type on_data_function, const ReliabilityQosPolicyKind reliability_kind)
+        {
+            return make_subscriber<serialized_pub_sub_type_of<data_pub_sub_type>>(
+                std::move(domain_participant), topic_name, std::move(on_data_function), reliability_kind);
+        }
+
+        template <typename on_data_function_type>
+        std::shared_ptr<subscriber_handle<serialized_pub_sub_type>> make_raw_subscriber(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            const std::string &type_name, on_data_function_type on_data_function,
+            const ReliabilityQosPolicyKind reliability_kind)
+        {
+            return detail::created_or_null(std::make_shared<subscriber_handle<serialized_pub_sub_type>>(
+                std::move(domain_participant), topic_name, dds::TypeSupport(new serialized_pub_sub_type(type_name)),
+                content_filter{},
+                std::make_shared<on_data_function_data_listener<serialized_sample, on_data_function_type>>(
+                    std::move(on_data_function)),
+                reliability_kind));
+        }
+
+        template <typename data_pub_sub_type>
+        std::shared_ptr<subscriber_handle<data_pub_sub_type>> make_polling_subscriber(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            const ReliabilityQosPolicyKind reliability_kind, const content_filter &filter)
+        {
+            return detail::created_or_null(std::make_shared<subscriber_handle<data_pub_sub_type>>(
+                std::move(domain_participant), topic_name, filter, std::make_shared<polling_data_reader_listener>(),
+                reliability_kind));
+        }
+
+        template <typename data_type, typename on_batch_function_type>
+        class on_batch_function_data_listener : public counting_data_reader_listener
+        {
+          public:
+            on_batch_function_data_listener(on_batch_function_type &&on_batch_function,
+                                            const std::int32_t max_samples = LENGTH_UNLIMITED)
+                : on_batch_function(std::move(on_batch_function)), max_samples(max_samples)
+            {
+            }
+
+            void on_data_available(DataReader *reader) override
+            {
+                LoanableSequence<data_type> samples;
+                SampleInfoSeq infos;
+                while (reader->take(samples, infos, max_samples) == ReturnCode_t::RETCODE_OK)
+                {
+                    const sample_batch<data_type> batch{samples, infos};
+                    for (typename sample_batch<data_type>::size_type i = 0; i < batch.size(); ++i)
+                    {
+                        if (batch.info(i).valid_data)
+                        {
+                            counters.count_received(batch.info(i).source_timestamp);
+                            counters.count_received_bytes(received_bytes(batch.sample(i)));
+                        }
+                    }
+
+                    {
+                        detail::scoped_callback_timer timer{counters};
+                        on_batch_function(batch);
+                    }
+                    reader->return_loan(samples, infos);
+                }
+            }
+
+          private:
+            on_batch_function_type on_batch_function;
+            std::int32_t max_samples;
+        };
+
+        template <typename data_pub_sub_type, typename on_batch_function_type>
+        std::shared_ptr<subscriber_handle<data_pub_sub_type>> make_batch_subscriber(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            on_batch_function_type on_batch_function, const ReliabilityQosPolicyKind reliability_kind,
+            const std::int32_t max_samples)
+        {
+            return detail::created_or_null(std::make_shared<subscriber_handle<data_pub_sub_type>>(
+                std::move(domain_participant), topic_name,
+                std::make_shared<
+                    on_batch_function_data_listener<typename data_pub_sub_type::type, on_batch_function_type>>(
+                    std::move(on_batch_function), max_samples),
+                reliability_kind));
+        }
+
+        template <typename data_type, typename on_batch_function_type, typename on_has_publisher_changed_function_type>
+        class functional_batch_data_listener
+            : public on_has_publisher_changed_data_listener<
+                  on_batch_function_data_listener<data_type, on_batch_function_type>,
+                  on_has_publisher_changed_function_type>
+        {
+          public:
+            functional_batch_data_listener(on_batch_function_type &&on_batch_function,
+                                           on_has_publisher_changed_function_type &&on_has_publisher_changed_function,
+                                           const std::int32_t max_samples = LENGTH_UNLIMITED)
+                : on_has_publisher_changed_data_listener<
+                      on_batch_function_data_listener<data_type, on_batch_function_type>,
+                      on_has_publisher_changed_function_type>(std::move(on_batch_function),
+                                                              std::move(on_has_publisher_changed_function), max_samples)
+            {
+            }
+        };
+
+        template <typename data_pub_sub_type, typename on_batch_function_type,
+                  typename on_has_publisher_changed_function_type>
+        std::shared_ptr<subscriber_handle<data_pub_sub_type>> make_batch_subscriber(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            on_batch_function_type on_batch_function,
+            on_has_publisher_changed_function_type on_has_publisher_changed_function,
+            const ReliabilityQosPolicyKind reliability_kind, const std::int32_t max_samples)
+        {
+            return detail::created_or_null(std::make_shared<subscriber_handle<data_pub_sub_type>>(
+                std::move(domain_participant), topic_name,
+                std::make_shared<functional_batch_data_listener<typename data_pub_sub_type::type,
+                                                                on_batch_function_type,
+                                                                on_has_publisher_changed_function_type>>(
+                    std::move(on_batch_function), std::move(on_has_publisher_changed_function), max_samples),
+                reliability_kind));
+        }
+
+        template <typename data_type> class latest_value_data_listener : public counting_data_reader_listener
+        {
+          public:
+            void on_data_available(DataReader *reader) override
+            {
+                SampleInfo info;
+                while (reader->take_next_sample(&values.back(), &info) == ReturnCode_t::RETCODE_OK)
+                {
+                    if (info.valid_data)
+                    {
+                        counters.count_received(info.source_timestamp);
+                        counters.count_received_bytes(received_bytes(values.back()));
+                        values.publish();
+                    }
+                }
+            }
+
+            /**
+             * @return The triple buffer, which producer side is only to be accessed by on_data_available
+             */
+            triple_buffer<data_type> &latest_values() noexcept
+            {
+                return values;
+            }
+
+          private:
+            triple_buffer<data_type> values;
+        };
+
+        template <typename data_pub_sub_type>
+        latest_value_subscriber<data_pub_sub_type>::latest_value_subscriber(
+            std::shared_ptr<DomainParticipant> domain_participant, const std::string &topic_name,
+            const ReliabilityQosPolicyKind reliability_kind, const content_filter &filter)
+            : listener(std::make_shared<latest_value_data_listener<data_type>>()),
+              handle(std::move(domain_participant), topic_name, filter, listener, reliability_kind)
+        {
+        }
+
+        template <typename data_pub_sub_type>
+        bool latest_value_subscriber<data_pub_sub_type>::try_get_latest(data_type &sample, std::uint64_t *sequence)
+        {
+            const data_type *latest = get_latest_view(sequence);
+            if (latest == nullptr)
+            {
+                return false;
+            }
+
+            sample = *latest;
+            return true;
+        }
+
+        template <typename data_pub_sub_type>
+        const typename latest_value_subscriber<data_pub_sub_type>::data_type *latest_value_subscriber<
+            data_pub_sub_type>::get_latest_view(std::uint64_t *sequence)
+        {
+            auto &values = listener->latest_values();
+            values.update();
+            const std::uint64_t front_sequence = values.front_sequence();
+            if (sequence != nullptr)
+            {
+                *sequence = front_sequence;
+            }
+            return front_sequence > 0 ? &values.front() : nullptr;
+        }
+
+        template <typename data_pub_sub_type>
+        std::uint64_t latest_value_subscriber<data_pub_sub_type>::latest_sequence() const noexcept
+        {
+            return listener->latest_values().sequence();
+        }
+
+        template <typename data_pub_sub_type>
+        subscriber_metrics latest_value_subscriber<data_pub_sub_type>::metrics() const
+        {
+            return handle.metrics();
         }
     } // namespace dds
 } // namespace provizio
@@ -0,0 +1,499 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DDS_SYNCHRONIZED_SUBSCRIBER
+#define DDS_SYNCHRONIZED_SUBSCRIBER
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "provizio/dds/common.h"
+#include "provizio/dds/dispatcher.h"
+#include "provizio/dds/subscriber.h"
+
+namespace provizio
+{
+    namespace dds
+    {
+        /**
+         * @brief Defines how samples of the topics of a provizio::dds::synchronized_subscriber are matched
+         */
+        enum class synchronization_policy
+        {
+            /**
+             * @brief Only samples with exactly the same timestamp are matched
+             */
+            exact,
+
+            /**
+             * @brief Samples with timestamps within synchronization_options::tolerance of each other are matched. The
+             * first such set is emitted, with no waiting for a closer one.
+             */
+            approximate
+        };
+
+        /**
+         * @brief Options of a provizio::dds::synchronized_subscriber
+         */
+        struct synchronization_options
+        {
+            synchronization_policy policy = synchronization_policy::approximate;
+
+            /**
+             * @brief Max difference of the timestamps of matched samples in the approximate policy
+             */
+            std::chrono::nanoseconds tolerance = std::chrono::milliseconds(10);
+
+            /**
+             * @brief Number of samples kept per topic while waiting for matching samples of other topics. When full,
+             * the oldest sample is dropped.
+             */
+            std::size_t queue_size = 4;
+
+            /**
+             * @brief Reliability of the DDS DataReaders, best effort ones match both reliable and best effort
+             * publishers
+             */
+            ReliabilityQosPolicyKind reliability_kind = BEST_EFFORT_RELIABILITY_QOS;
+
+            /**
+             * @brief Options of the dispatcher the samples are matched in, which only has a single worker thread
+             */
+            dispatcher_options dispatch;
+        };
+
+        /**
+         * @brief A snapshot of the counters of a provizio::dds::synchronized_subscriber
+         */
+        struct synchronization_statistics
+        {
+            /**
+             * @brief Number of emitted sets of matched samples
+             */
+            std::uint64_t emitted = 0;
+
+            /**
+             * @brief Number of received samples dropped without being matched
+             */
+            std::uint64_t dropped = 0;
+        };
+
+        /**
+         * @brief Provides the timestamp samples are synchronized by, which is header().stamp() by default (f.e. for
+         * sensor_msgs::msg::PointCloud2). Can be specialized for data types with no header.
+         *
+         * @tparam data_type DDS data type, f.e. sensor_msgs::msg::PointCloud2
+         */
+        template <typename data_type> struct sample_timestamp
+        {
+            /**
+             * @return Timestamp of the sample in nanoseconds
+             */
+            static std::int64_t nanoseconds(const data_type &sample) noexcept
+            {
+                return static_cast<std::int64_t>(sample.header().stamp().sec()) * 1000000000 +
+                       static_cast<std::int64_t>(sample.header().stamp().nanosec());
+            }
+        };
+
+        namespace detail
+        {
+            constexpr std::size_t no_sample = static_cast<std::size_t>(-1);
+
+            /**
+             * @brief Samples of a single topic of a synchronized_subscriber waiting to be matched, oldest first. Its
+             * capacity is reserved in advance, so it doesn't allocate in a steady state.
+             */
+            template <typename data_type> class synchronization_queue final
+            {
+              public:
+                explicit synchronization_queue(const std::size_t capacity) : capacity(capacity > 0 ? capacity : 1)
+                {
+                    entries.reserve(this->capacity);
+                }
+
+                /**
+                 * @return true if the oldest sample was dropped to make space
+                 */
+                bool push(std::shared_ptr<const data_type> &&sample, const std::int64_t stamp)
+                {
+                    const bool full = entries.size() == capacity;
+                    if (full)
+                    {
+                        entries.erase(entries.begin());
+                    }
+                    entries.push_back(entry{std::move(sample), stamp});
+                    return full;
+                }
+
+                /**
+                 * @return Index of the sample with the timestamp closest to stamp, or no_sample if empty
+                 */
+                std::size_t closest(const std::int64_t stamp) const noexcept
+                {
+                    std::size_t result = no_sample;
+                    std::int64_t min_distance = 0;
+                    for (std::size_t i = 0; i < entries.size(); ++i)
+                    {
+                        const std::int64_t distance =
+                            entries[i].stamp > stamp ? entries[i].stamp - stamp : stamp - entries[i].stamp;
+                        if (result == no_sample || distance < min_distance)
+                        {
+                            result = i;
+                            min_distance = distance;
+                        }
+                    }
+                    return result;
+                }
+
+                std::int64_t stamp(const std::size_t index) const noexcept
+                {
+                    return entries[index].stamp;
+                }
+
+                const std::shared_ptr<const data_type> &sample(const std::size_t index) const noexcept
+                {
+                    return entries[index].sample;
+                }
+
+                /**
+                 * @brief Removes all samples not newer than stamp, as they can't be matched anymore
+                 *
+                 * @return Number of removed samples
+                 */
+                std::size_t erase_up_to(const std::int64_t stamp)
+                {
+                    std::size_t kept = 0;
+                    for (auto &next : entries)
+                    {
+                        if (next.stamp > stamp)
+                        {
+                            entries[kept++] = std::move(next);
+                        }
+                    }
+                    const std::size_t removed = entries.size() - kept;
+                    entries.resize(kept);
+                    return removed;
+                }
+
+              private:
+                struct entry
+                {
+                    std::shared_ptr<const data_type> sample;
+                    std::int64_t stamp;
+                };
+
+                const std::size_t capacity;
+                std::vector<entry> entries;
+            };
+
+            /**
+             * @brief Matches the samples of the topics of a synchronized_subscriber. Only accessed by the single
+             * worker thread of its dispatcher, so it needs no locking.
+             */
+            template <typename... data_types> class synchronizer final
+            {
+              public:
+                using on_synchronized_function_type = std::function<void(std::shared_ptr<const data_types>...)>;
+
+                synchronizer(on_synchronized_function_type on_synchronized_function,
+                             const synchronization_options &options)
+                    : on_synchronized_function(std::move(on_synchronized_function)), policy(options.policy),
+                      tolerance(options.tolerance.count()),
+                      queues(synchronization_queue<data_types>(options.queue_size)...)
+                {
+                }
+
+                template <std::size_t index>
+                void on_sample(
+                    std::shared_ptr<const typename std::tuple_element<index, std::tuple<data_types...>>::type> sample)
+                {
+                    using data_type = typename std::tuple_element<index, std::tuple<data_types...>>::type;
+
+                    const std::int64_t stamp = sample_timestamp<data_type>::nanoseconds(*sample);
+                    if (std::get<index>(queues).push(std::move(sample), stamp))
+                    {
+                        dropped.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    try_emit(stamp, std::index_sequence_for<data_types...>{});
+                }
+
+                synchronization_statistics statistics() const noexcept
+                {
+                    synchronization_statistics result;
+                    result.emitted = emitted.load(std::memory_order_relaxed);
+                    result.dropped = dropped.load(std::memory_order_relaxed);
+                    return result;
+                }
+
+              private:
+                static constexpr std::size_t topics = sizeof...(data_types);
+
+                template <std::size_t... indices>
+                void try_emit(const std::int64_t stamp, std::index_sequence<indices...> /*indices*/)
+                {
+                    // The samples closest to the newly received one
+                    const std::array<std::size_t, topics> chosen{{std::get<indices>(queues).closest(stamp)...}};
+                    for (const std::size_t index : chosen)
+                    {
+                        if (index == no_sample)
+                        {
+                            return;
+                        }
+                    }
+
+                    const std::array<std::int64_t, topics> stamps{
+                        {std::get<indices>(queues).stamp(chosen[indices])...}};
+                    std::int64_t oldest = stamps[0];
+                    std::int64_t newest = stamps[0];
+                    for (const std::int64_t next : stamps)
+                    {
+                        oldest = next < oldest ? next : oldest;
+                        newest = next > newest ? next : newest;
+                    }
+                    if (newest - oldest > (policy == synchronization_policy::exact ? 0 : tolerance))
+                    {
+                        return;
+                    }
+
+                    on_synchronized_function(std::get<indices>(queues).sample(chosen[indices])...);
+                    emitted.fetch_add(1, std::memory_order_relaxed);
+
+                    // Samples older than the matched ones can't be matched anymore
+                    std::size_t removed = 0;
+                    (void)std::initializer_list<int>{
+                        (removed += std::get<indices>(queues).erase_up_to(stamps[indices]), 0)...};
+                    dropped.fetch_add(removed - topics, std::memory_order_relaxed);
+                }
+
+                on_synchronized_function_type on_synchronized_function;
+                const synchronization_policy policy;
+                const std::int64_t tolerance;
+                std::tuple<synchronization_queue<data_types>...> queues;
+                std::atomic<std::uint64_t> emitted{0};
+                std::atomic<std::uint64_t> dropped{0};
+            };
+
+            /**
+             * @brief Forwards the samples of a single topic to a synchronizer, in its dispatcher worker thread
+             */
+            template <std::size_t index, typename data_type, typename synchronizer_type> struct synchronized_forwarder
+            {
+                std::shared_ptr<synchronizer_type> target;
+
+                void operator()(std::shared_ptr<const data_type> sample)
+                {
+                    target->template on_sample<index>(std::move(sample));
+                }
+            };
+
+            template <typename function_type, typename = void, typename... argument_types>
+            struct is_invocable_with_all : std::false_type
+            {
+            };
+
+            template <typename function_type, typename... argument_types>
+            struct is_invocable_with_all<
+                function_type,
+                decltype(void(std::declval<function_type &>()(std::declval<argument_types>()...))),
+                argument_types...> : std::true_type
+            {
+            };
+
+            // Checking for const data_type & first, as in takes_shared_sample
+            template <typename function_type, typename... data_types>
+            using takes_shared_samples = std::integral_constant<
+                bool, !is_invocable_with_all<function_type, void, const data_types &...>::value &&
+                          is_invocable_with_all<function_type, void, std::shared_ptr<const data_types>...>::value>;
+
+            template <typename on_synchronized_function_type, typename... data_types>
+            std::function<void(std::shared_ptr<const data_types>...)> make_synchronized_function(
+                on_synchronized_function_type on_synchronized_function, std::true_type /*takes_shared_samples*/)
+            {
+                return on_synchronized_function;
+            }
+
+            template <typename on_synchronized_function_type, typename... data_types>
+            std::function<void(std::shared_ptr<const data_types>...)> make_synchronized_function(
+                on_synchronized_function_type on_synchronized_function, std::false_type /*takes_shared_samples*/)
+            {
+                return [on_synchronized_function](std::shared_ptr<const data_types>... samples) mutable {
+                    on_synchronized_function(static_cast<const data_types &>(*samples)...);
+                };
+            }
+        } // namespace detail
+
+        /**
+         * @brief Subscribes to several topics (f.e. point clouds of multiple radars to fuse) and invokes a function
+         * with sets of their samples matched by timestamps. Samples are neither copied nor locked: they are received
+         * into pooled samples, kept in small per-topic queues while waiting to be matched, and matched in the single
+         * worker thread of a dispatcher of its own. Normally created with provizio::dds::make_synchronized_subscriber.
+         *
+         * @tparam data_pub_sub_types DDS data pub/sub types of the topics, f.e. sensor_msgs::msg::PointCloud2PubSubType
+         * @see provizio::dds::make_synchronized_subscriber
+         * @see provizio::dds::sample_timestamp
+         */
+        template <typename... data_pub_sub_types> class synchronized_subscriber final
+        {
+          public:
+            using synchronizer_type = detail::synchronizer<typename data_pub_sub_types::type...>;
+            static constexpr std::size_t topics = sizeof...(data_pub_sub_types);
+
+            /**
+             * @brief Constructs a new synchronized_subscriber object
+             *
+             * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+             * @param topic_names DDS Topic Names, in the order of data_pub_sub_types
+             * @param on_synchronized_function Function to be invoked with matched samples, in the order of the topics
+             * @param options Matching policy, queue size, reliability and dispatcher options
+             */
+            synchronized_subscriber(const std::shared_ptr<DomainParticipant> &domain_participant,
+                                    const std::array<std::string, topics> &topic_names,
+                                    typename synchronizer_type::on_synchronized_function_type on_synchronized_function,
+                                    const synchronization_options &options = {})
+                : executor(make_single_thread_dispatcher(options.dispatch)),
+                  synchronizer(std::make_shared<synchronizer_type>(std::move(on_synchronized_function), options)),
+                  subscribers(make_subscribers(domain_participant, topic_names, options,
+                                               std::index_sequence_for<data_pub_sub_types...>{}))
+            {
+            }
+
+            /**
+             * @return A snapshot of the counters of emitted and dropped samples
+             */
+            synchronization_statistics statistics() const noexcept
+            {
+                return synchronizer->statistics();
+            }
+
+            /**
+             * @return Dispatch statistics of the topics, f.e. to check whether matching keeps up
+             */
+            std::vector<dispatch_statistics> dispatcher_statistics() const
+            {
+                return executor->statistics();
+            }
+
+            /**
+             * @tparam index Index of the topic
+             * @return The subscriber of the topic, f.e. to read its metrics
+             */
+            template <std::size_t index>
+            const std::shared_ptr<
+                subscriber_handle<typename std::tuple_element<index, std::tuple<data_pub_sub_types...>>::type>> &
+            subscriber() const noexcept
+            {
+                return std::get<index>(subscribers);
+            }
+
+            /**
+             * @return true if the DDS DataReaders of all the topics were created
+             */
+            bool created() const
+            {
+                return created(std::index_sequence_for<data_pub_sub_types...>{});
+            }
+
+          private:
+            template <std::size_t... indices> bool created(std::index_sequence<indices...> /*indices*/) const
+            {
+                bool all_created = true;
+                (void)std::initializer_list<int>{
+                    (all_created = std::get<indices>(subscribers)->instance_handle() != HANDLE_NIL && all_created,
+                     0)...};
+                return all_created;
+            }
+
+            static std::shared_ptr<dispatcher> make_single_thread_dispatcher(dispatcher_options options)
+            {
+                options.worker_threads = 1;
+                return make_dispatcher(options);
+            }
+
+            template <std::size_t... indices>
+            std::tuple<std::shared_ptr<subscriber_handle<data_pub_sub_types>>...> make_subscribers(
+                const std::shared_ptr<DomainParticipant> &domain_participant,
+                const std::array<std::string, topics> &topic_names, const synchronization_options &options,
+                std::index_sequence<indices...> /*indices*/)
+            {
+                // Samples are retained by the dispatcher queue and then by the synchronization queue
+                const std::size_t sample_pool_size = executor->queue_capacity() + options.queue_size + 1;
+                return std::tuple<std::shared_ptr<subscriber_handle<data_pub_sub_types>>...>{
+                    std::make_shared<subscriber_handle<data_pub_sub_types>>(
+                        domain_participant, topic_names[indices],
+                        std::make_shared<on_data_function_data_listener<
+                            typename data_pub_sub_types::type,
+                            dispatched_function<detail::synchronized_forwarder<
+                                indices, typename data_pub_sub_types::type, synchronizer_type>>>>(
+                            dispatched(executor,
+                                       detail::synchronized_forwarder<indices, typename data_pub_sub_types::type,
+                                                                      synchronizer_type>{synchronizer},
+                                       topic_names[indices]),
+                            sample_pool_size),
+                        options.reliability_kind)...};
+            }
+
+            // Destroyed in the reverse order: the subscribers stop dispatching before the dispatcher stops
+            std::shared_ptr<dispatcher> executor;
+            std::shared_ptr<synchronizer_type> synchronizer;
+            std::tuple<std::shared_ptr<subscriber_handle<data_pub_sub_types>>...> subscribers;
+        };
+
+        /**
+         * @brief Creates a new synchronized_subscriber object as a shared_ptr, that invokes a function with samples of
+         * several topics matched by their timestamps (header().stamp() by default)
+         *
+         * @tparam data_pub_sub_types DDS data pub/sub types of the topics, f.e. sensor_msgs::msg::PointCloud2PubSubType
+         * @tparam on_synchronized_function_type Type of a function / function object to be invoked with the matched
+         * samples, takes an argument per topic in the order of the topics: either a const reference to the data type or
+         * a std::shared_ptr to the const data type, to retain the sample after returning without copying it
+         * @param domain_participant A DDS Domain Participant, as created by provizio::dds::make_domain_participant
+         * @param topic_names DDS Topic Names, in the order of data_pub_sub_types
+         * @param on_synchronized_function Function / function object to be invoked with the matched samples
+         * @param options Matching policy, queue size, reliability and dispatcher options
+         * @return std::shared_ptr to the created synchronized_subscriber, nullptr if the DDS DataReader of any topic
+         * couldn't be created
+         * @see provizio::dds::synchronized_subscriber
+         */
+        template <typename... data_pub_sub_types, typename on_synchronized_function_type>
+        std::shared_ptr<synchronized_subscriber<data_pub_sub_types...>> make_synchronized_subscriber(
+            const std::shared_ptr<DomainParticipant> &domain_participant,
+            const std::array<std::string, sizeof...(data_pub_sub_types)> &topic_names,
+            on_synchronized_function_type on_synchronized_function, const synchronization_options &options = {})
+        {
+            using takes_shared_samples =
+                detail::takes_shared_samples<on_synchronized_function_type, typename data_pub_sub_types::type...>;
+            auto subscriber = std::make_shared<synchronized_subscriber<data_pub_sub_types...>>(
+                domain_participant, topic_names,
+                detail::make_synchronized_function<on_synchronized_function_type,
+                                                   typename data_pub_sub_types::type...>(
+                    std::move(on_synchronized_function), takes_shared_samples{}),
+                options);
+            return subscriber->created() ? std::move(subscriber) : nullptr;
+        }
+    } // namespace dds
+} // namespace provizio
+
+#endif // DDS_SYNCHRONIZED_SUBSCRIBER
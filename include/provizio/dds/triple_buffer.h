@@ -0,0 +1,129 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DDS_TRIPLE_BUFFER
+#define DDS_TRIPLE_BUFFER
+
+#include <atomic>
+#include <cstdint>
+
+namespace provizio
+{
+    namespace dds
+    {
+        /**
+         * @brief A wait-free single producer / single consumer triple buffer, which passes the newest value from the
+         * producer to the consumer. The producer writes into its own back buffer and publishes it, the consumer reads
+         * its own front buffer, and the buffers are exchanged via a single atomic middle index, so neither side ever
+         * blocks or waits for the other. Values the consumer doesn't pick up in time are overwritten by newer ones.
+         *
+         * As the buffers are reused, their dynamic members (f.e. data vector of sensor_msgs::msg::PointCloud2) keep
+         * their capacity, so no allocations take place in a steady state.
+         *
+         * @tparam value_type Type of the values, default constructible
+         */
+        template <typename value_type> class triple_buffer final
+        {
+          public:
+            triple_buffer() = default;
+            triple_buffer(const triple_buffer &) = delete;
+            triple_buffer &operator=(const triple_buffer &) = delete;
+
+            /**
+             * @brief Producer only: the back buffer to write the next value to. It keeps the contents of an older
+             * value.
+             */
+            value_type &back() noexcept
+            {
+                return buffers[back_index].value;
+            }
+
+            /**
+             * @brief Producer only: publishes the back buffer as the newest value, and takes another buffer as the
+             * back one
+             *
+             * @return Sequence number of the published value, starting with 1
+             */
+            std::uint64_t publish() noexcept
+            {
+                const std::uint64_t sequence = published_sequence.load(std::memory_order_relaxed) + 1;
+                buffers[back_index].sequence = sequence;
+                back_index = middle.exchange(back_index | dirty_flag, std::memory_order_acq_rel) & index_mask;
+                published_sequence.store(sequence, std::memory_order_release);
+                return sequence;
+            }
+
+            /**
+             * @brief Consumer only: picks up the newest published value, if any
+             *
+             * @return true if a value newer than the current front one has been picked up
+             */
+            bool update() noexcept
+            {
+                if ((middle.load(std::memory_order_relaxed) & dirty_flag) == 0)
+                {
+                    return false;
+                }
+
+                front_index = middle.exchange(front_index, std::memory_order_acq_rel) & index_mask;
+                return true;
+            }
+
+            /**
+             * @brief Consumer only: the front buffer, i.e. the newest value picked up by update
+             */
+            const value_type &front() const noexcept
+            {
+                return buffers[front_index].value;
+            }
+
+            /**
+             * @brief Consumer only: sequence number of the front value, 0 if no value has been picked up yet
+             */
+            std::uint64_t front_sequence() const noexcept
+            {
+                return buffers[front_index].sequence;
+            }
+
+            /**
+             * @brief Sequence number of the newest published value, 0 if none. Can be read by any thread, f.e. to
+             * detect updates without picking them up.
+             */
+            std::uint64_t sequence() const noexcept
+            {
+                return published_sequence.load(std::memory_order_acquire);
+            }
+
+          private:
+            static constexpr std::uint8_t index_mask = 0x3;
+            static constexpr std::uint8_t dirty_flag = 0x4;
+
+            struct buffer
+            {
+                value_type value{};
+                std::uint64_t sequence = 0;
+            };
+
+            buffer buffers[3];
+
+            // Kept apart, so the producer, the consumer and the shared index don't falsely share cache lines
+            alignas(64) std::uint8_t back_index = 0;
+            alignas(64) std::atomic<std::uint8_t> middle{1};
+            std::atomic<std::uint64_t> published_sequence{0};
+            alignas(64) std::uint8_t front_index = 2;
+        };
+    } // namespace dds
+} // namespace provizio
+
+#endif // DDS_TRIPLE_BUFFER
@@ -0,0 +1,137 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DDS_WAIT_SET
+#define DDS_WAIT_SET
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <fastdds/dds/core/condition/WaitSet.hpp>
+
+#include "provizio/dds/common.h"
+#include "provizio/dds/subscriber.h"
+
+namespace provizio
+{
+    namespace dds
+    {
+        /**
+         * @brief Waits on the caller's thread for any of several subscribers to receive data, using a single DDS
+         * WaitSet, f.e. to serve all inputs of a control loop in one thread as created by
+         * provizio::dds::make_polling_subscriber. Not thread-safe, attach the subscribers before waiting.
+         *
+         * @see provizio::dds::subscriber_handle::poll to wait for a single subscriber
+         */
+        class wait_set final
+        {
+          public:
+            wait_set() = default;
+            wait_set(const wait_set &) = delete;
+            wait_set &operator=(const wait_set &) = delete;
+
+            ~wait_set()
+            {
+                for (auto *condition : conditions)
+                {
+                    dds_wait_set.detach_condition(*condition);
+                }
+            }
+
+            /**
+             * @brief Attaches a subscriber to wait for, keeping it alive while attached
+             *
+             * @param subscriber The subscriber, as created by provizio::dds::make_polling_subscriber
+             * @return Index of the subscriber to pass to ready, or wait_set::npos if its DataReader couldn't be
+             * created
+             */
+            template <typename data_pub_sub_type>
+            std::size_t attach(std::shared_ptr<subscriber_handle<data_pub_sub_type>> subscriber)
+            {
+                auto *condition = subscriber != nullptr ? subscriber->data_available_condition() : nullptr;
+                if (condition == nullptr || dds_wait_set.attach_condition(*condition) != ReturnCode_t::RETCODE_OK)
+                {
+                    return npos;
+                }
+
+                conditions.push_back(condition);
+                subscribers.push_back(std::move(subscriber));
+                ready_flags.push_back(false);
+                active_conditions.reserve(static_cast<ConditionSeq::size_type>(conditions.size()));
+                return conditions.size() - 1;
+            }
+
+            /**
+             * @brief Blocks the calling thread until any of the attached subscribers has received data to take, or
+             * the timeout expires, and updates which of them are ready
+             *
+             * @param timeout Max time to wait
+             * @return Number of subscribers ready to take data from, 0 on timeout
+             */
+            std::size_t wait(const std::chrono::nanoseconds timeout)
+            {
+                std::fill(ready_flags.begin(), ready_flags.end(), false);
+                active_conditions.clear();
+                if (conditions.empty() ||
+                    dds_wait_set.wait(active_conditions, detail::to_duration(timeout)) != ReturnCode_t::RETCODE_OK)
+                {
+                    return 0;
+                }
+
+                std::size_t ready_count = 0;
+                for (auto *active_condition : active_conditions)
+                {
+                    const auto found = std::find(conditions.begin(), conditions.end(), active_condition);
+                    if (found != conditions.end())
+                    {
+                        ready_flags[static_cast<std::size_t>(found - conditions.begin())] = true;
+                        ++ready_count;
+                    }
+                }
+                return ready_count;
+            }
+
+            /**
+             * @param index Index of the subscriber, as returned by attach
+             * @return true if the subscriber was ready to take data from on the last wait
+             */
+            bool ready(const std::size_t index) const
+            {
+                return index < ready_flags.size() && ready_flags[index];
+            }
+
+            /**
+             * @return Number of the attached subscribers
+             */
+            std::size_t size() const
+            {
+                return conditions.size();
+            }
+
+            static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+          private:
+            WaitSet dds_wait_set;
+            std::vector<Condition *> conditions;
+            std::vector<std::shared_ptr<void>> subscribers; // Keep the DataReaders (and their conditions) alive
+            std::vector<bool> ready_flags;
+            ConditionSeq active_conditions;
+        };
+    } // namespace dds
+} // namespace provizio
+
+#endif // DDS_WAIT_SET
@@ -50,12 +50,11 @@
 
 # Serialization of provizio_dds.PointCloud2 messages.
 
-import array
 from collections import namedtuple
 import sys
-from typing import Iterable, List, NamedTuple, Optional, Sequence
+from typing import Iterable, List, Mapping, NamedTuple, Optional, Sequence, Union
 import numpy as np
-from numpy.lib.recfunctions import structured_to_unstructured, unstructured_to_structured
+from numpy.lib.recfunctions import structured_to_unstructured
 from provizio_dds_python_types import *
 
 
@@ -82,13 +81,27 @@ _DATATYPES_SIZES[FLOAT64] = 8
 
 DUMMY_FIELD_PREFIX = 'unnamed_field'
 
+# Suffix of the topics of quantized point clouds, see quantized_topic_name
+QUANTIZED_TOPIC_SUFFIX = '/quantized'
+
+# Default scales of quantize_cloud for radar point clouds: 2 centimeters (up to +/- 655 meters) and centimeters per
+# second (up to +/- 327 meters per second)
+RADAR_POINT_CLOUD_QUANTIZATION = {
+    'x': 0.02,
+    'y': 0.02,
+    'z': 0.02,
+    'radar_relative_radial_velocity': 0.01,
+    'ground_relative_radial_velocity': 0.01
+}
+
 
 def read_points(
         cloud: PointCloud2,
         field_names: Optional[List[str]] = None,
         skip_nans: bool = False,
         uvs: Optional[Iterable] = None,
-        reshape_organized_cloud: bool = False) -> np.ndarray:
+        reshape_organized_cloud: bool = False,
+        copy: bool = True) -> np.ndarray:
     """
     Read points from a provizio_dds.PointCloud2 message.
 
@@ -100,16 +113,22 @@ def read_points(
     :param uvs: If specified, then only return the points at the given
         coordinates. (Type: Iterable, Default: None)
     :param reshape_organized_cloud: Returns the array as an 2D organized point cloud if set.
-    :return: Structured NumPy array containing all points.
+    :param copy: If False, then unless filtered the array is a view of the data of the cloud, with no
+                 copying: modifying it modifies the cloud. Such a view must not outlive the data it was
+                 read from: create_cloud(cloud=...) and QueuedSubscriber.take_batch detach it, keeping
+                 the previous data, but other ways of replacing the data, f.e. cloud.data(...), don't.
+                 (Type: Bool, Default: True)
+    :return: Structured NumPy array containing all points
     """
     assert isinstance(cloud, PointCloud2), \
         'Cloud is not a provizio_dds.PointCloud2'
 
-    # Cast bytes to numpy array
+    # Wrap the data of the cloud in a numpy array, with no copying. The array keeps the cloud alive.
     points = np.ndarray(
         shape=(cloud.width() * cloud.height(), ),
         dtype=dtype_from_fields(cloud.fields(), point_step=cloud.point_step()),
-        buffer=bytearray(cloud.data()))
+        buffer=point_cloud2_data_view(cloud))
+    is_view = True
 
     # Keep only the requested fields
     if field_names is not None:
@@ -118,9 +137,10 @@ def read_points(
         # Mask fields
         points = points[list(field_names)]
 
-    # Swap array if byte order does not match
+    # Swap array if byte order does not match, into a copy so that the cloud is left intact
     if bool(sys.byteorder != 'little') != bool(cloud.is_bigendian()):
-        points = points.byteswap(inplace=True)
+        points = points.byteswap(inplace=False)
+        is_view = False
 
     # Check if we want to drop points with nan values
     if skip_nans and not cloud.is_dense():
@@ -132,6 +152,7 @@ def read_points(
                 not_nan_mask, ~np.isnan(points[field_name]))
         # Select these points
         points = points[not_nan_mask]
+        is_view = False
 
     # Select points indexed by the uvs field
     if uvs is not None:
@@ -140,11 +161,16 @@ def read_points(
             uvs = np.fromiter(uvs, int)
         # Index requested points
         points = points[uvs]
+        is_view = False
 
     # Cast into 2d array if cloud is 'organized'
     if reshape_organized_cloud and cloud.height() > 1:
         points = points.reshape(cloud.width(), cloud.height())
 
+    # Unless a view is requested, don't let the array depend on the data of the cloud staying in place
+    if copy and is_view:
+        points = points.copy()
+
     return points
 
 
@@ -153,7 +179,8 @@ def read_points_numpy(
         field_names: Optional[List[str]] = None,
         skip_nans: bool = False,
         uvs: Optional[Iterable] = None,
-        reshape_organized_cloud: bool = False) -> np.ndarray:
+        reshape_organized_cloud: bool = False,
+        copy: bool = True) -> np.ndarray:
     """
     Read equally typed fields from provizio_dds.PointCloud2 message as a unstructured numpy array.
 
@@ -170,12 +197,14 @@ def read_points_numpy(
     :param uvs: If specified, then only return the points at the given
         coordinates. (Type: Iterable, Default: None)
     :param reshape_organized_cloud: Returns the array as an 2D organized point cloud if set.
+    :param copy: If False, the array may be a view of the data of the cloud, as described in read_points.
+                 (Type: Bool, Default: True)
     :return: Numpy array containing all points.
     """
     assert all(cloud.fields()[0].datatype() == field.datatype() for field in cloud.fields()[1:]), \
         'All fields need to have the same datatype. Use `read_points()` otherwise.'
     structured_numpy_array = read_points(
-        cloud, field_names, skip_nans, uvs, reshape_organized_cloud)
+        cloud, field_names, skip_nans, uvs, reshape_organized_cloud, copy)
     return structured_to_unstructured(structured_numpy_array)
 
 
@@ -208,8 +237,9 @@ def read_points_list(
 
     Point = namedtuple('Point', field_names)
 
+    # The points are converted right away, so there is no need to copy them first
     return [Point._make(p) for p in read_points(cloud, field_names,
-                                                skip_nans, uvs)]
+                                                skip_nans, uvs, copy=False)]
 
 
 def dtype_from_fields(fields: Sequence, point_step: Optional[int] = None) -> np.dtype:
@@ -264,109 +294,207 @@ def dtype_from_fields(fields: Sequence, point_step: Optional[int] = None) -> np.
 def create_cloud(
         header: Header,
         fields: Sequence,
-        points: Iterable,
-        is_dense: bool = True) -> PointCloud2:
+        points: Union[Iterable, np.ndarray, Mapping],
+        is_dense: bool = True,
+        cloud: Optional[PointCloud2] = None) -> PointCloud2:
     """
     Create a provizio_dds.PointCloud2 message.
 
+    NumPy arrays and dicts of NumPy columns are written straight into the data of the cloud, field by field, with no
+    Python-level iteration over the points.
+
     :param header: The point cloud header. (Type: provizio_dds.Header)
     :param fields: The point cloud fields. (Type: Sequence of provizio_dds.PointField)
-    :param points: The point cloud points. List of iterables, i.e. one iterable
-                   for each point, with the elements of each iterable being the
-                   values of the fields for that point (in the same order as
-                   the fields parameter)
+    :param points: The point cloud points, one of:
+                   - a structured NumPy array with fields named as the fields parameter,
+                   - an unstructured NumPy array, with the last dimension being the values of the fields for each
+                     point (in the same order as the fields parameter),
+                   - a dict of field names to NumPy arrays of the values of that field for all points (SoA),
+                   - a list of iterables, i.e. one iterable for each point, with the elements of each iterable being
+                     the values of the fields for that point (in the same order as the fields parameter), which is
+                     slow for large clouds
     :param is_dense: True if there are no invalid points
+    :param cloud: A cloud to fill instead of creating a new one, f.e. the one published for the previous frame, so that
+                  its data buffer is reused unless views returned by read_points(copy=False) for it are still
+                  alive, in which case they keep the previous data. (Type: provizio_dds.PointCloud2, Default: None)
     :return: The point cloud as provizio_dds.PointCloud2
     """
-    # Check if input is numpy array
-    if isinstance(points, np.ndarray):
-        # Check if this is an unstructured array
-        if points.dtype.names is None:
-            assert all(fields[0].datatype == field.datatype for field in fields[1:]), \
-                'All fields need to have the same datatype. Pass a structured NumPy array \
-                    with multiple dtypes otherwise.'
-            # Convert unstructured to structured array
-            points = unstructured_to_structured(
-                points,
-                dtype=dtype_from_fields(fields))
-        else:
-            assert points.dtype == dtype_from_fields(fields), \
-                'PointFields and structured NumPy array dtype do not match for all fields! \
-                    Check their field order, names and types.'
+    return _fill_cloud(header, fields, dtype_from_fields(fields), points, is_dense, cloud)
+
+
+def make_radar_point_cloud(
+        header: Header,
+        points: Union[Iterable, np.ndarray, Mapping],
+        is_dense: bool = True,
+        cloud: Optional[PointCloud2] = None) -> PointCloud2:
+    """
+    Create a provizio_dds.PointCloud2 message with
+    (x, y, z, radar_relative_radial_velocity, signal_to_noise_ratio, ground_relative_radial_velocity) fields.
+
+    :param header: The point cloud header. (Type: provizio_dds.Header)
+    :param points: The point cloud points, in any of the forms accepted by create_cloud.
+                   (Type: Iterable, NumPy array or dict of NumPy arrays)
+    :param is_dense: True if there are no invalid points
+    :param cloud: A cloud to fill instead of creating a new one, f.e. the one published for the previous frame, so that
+                  its data buffer is reused. (Type: provizio_dds.PointCloud2, Default: None)
+    :return: The point cloud as provizio_dds.PointCloud2.
+    """
+    return _fill_cloud(header, _RADAR_POINT_FIELDS, _RADAR_POINT_DTYPE, points, is_dense, cloud)
+
+
+def quantize_cloud(cloud: PointCloud2, scales: Optional[dict] = None) -> PointCloud2:
+    """
+    Quantize floating point fields of a provizio_dds.PointCloud2 message into int16 values with per-field scales,
+    f.e. to reduce the bandwidth of publishing radar point clouds. The scales are marked in the fields of the result,
+    which consumers unaware of the quantization misread, so it's to be published on a topic of its own, as
+    quantized_topic_name, with plain consumers kept on the float fields. NaN values are preserved, other values beyond
+    +/- 32767 units saturate.
+
+    :param cloud: The point cloud to quantize, in the host byte order. (Type: provizio_dds.PointCloud2)
+    :param scales: Field names to the real values of a single quantized unit.
+                   (Type: dict, Default: RADAR_POINT_CLOUD_QUANTIZATION)
+    :return: The quantized point cloud as provizio_dds.PointCloud2
+    :raises ValueError: If the cloud can't be quantized
+    """
+    quantized = PointCloud2()
+    # Not in an assert, which python -O strips along with the quantization
+    if not point_cloud2_quantize(cloud, quantized, RADAR_POINT_CLOUD_QUANTIZATION if scales is None else scales):
+        raise ValueError(
+            'Failed to quantize the cloud, check the fields to quantize are float32 or float64 and scales are positive')
+    return quantized
+
+
+def dequantize_cloud(cloud: PointCloud2) -> PointCloud2:
+    """
+    Restore a provizio_dds.PointCloud2 message quantized by quantize_cloud, with the quantized fields as float32.
+    Clouds with no quantized fields are copied as they are.
+
+    :param cloud: The quantized point cloud, in the host byte order. (Type: provizio_dds.PointCloud2)
+    :return: The restored point cloud as provizio_dds.PointCloud2
+    :raises ValueError: If the cloud can't be dequantized
+    """
+    dequantized = PointCloud2()
+    if not point_cloud2_dequantize(cloud, dequantized):
+        raise ValueError('Failed to dequantize the cloud')
+    return dequantized
+
+
+def quantized_topic_name(topic_name: str) -> str:
+    """
+    Name of the topic to publish quantized clouds of a topic on, as provizio::dds::quantized_topic_name in C++.
+
+    :param topic_name: The topic of the plain point clouds. (Type: str)
+    :return: The topic of the quantized point clouds
+    """
+    return topic_name + QUANTIZED_TOPIC_SUFFIX
+
+
+def make_header(timestamp_sec: int, timestamp_nanosec: int, frame_id: str) -> Header:
+    """
+    Create a provizio_dds.Header
+
+    :param timestamp_sec: Seconds component of timestamp. (Type: int)
+    :param timestamp_nanosec: Nanoseconds component of timestamp, valid in the range [0, 10e9). (Type: int)
+    :param frame_id: Frame this data is associated with
+    """
+    header = Header()
+    header.stamp().sec(timestamp_sec)
+    header.stamp().nanosec(timestamp_nanosec)
+    header.frame_id(frame_id)
+    return header
+
+
+def _points_shape(points: Union[np.ndarray, Mapping], dtype: np.dtype) -> tuple:
+    # Shape of the cloud as (width, ) or (width, height) for points already held in NumPy arrays
+    if isinstance(points, Mapping):
+        assert all(name in points for name in dtype.names), \
+            'Columns are missing for some of the PointFields! Got: ' + str(list(points.keys()))
+        shape = np.shape(points[dtype.names[0]])
+        assert all(np.shape(points[name]) == shape for name in dtype.names), \
+            'All columns need to have the same shape.'
+        return shape
+    if points.dtype.names is None:
+        assert points.ndim >= 1 and points.shape[-1] == len(dtype.names), \
+            'The last dimension of an unstructured NumPy array needs to match the number of fields.'
+        return points.shape[:-1]
+    return points.shape
+
+
+def _write_points(target: np.ndarray, points: Union[np.ndarray, Mapping]):
+    # Writes the points into a structured array wrapping the data of a cloud, a whole field at a time
+    if isinstance(points, np.ndarray) and points.dtype == target.dtype:
+        target[...] = points
+    elif isinstance(points, np.ndarray) and points.dtype.names is None:
+        for i, name in enumerate(target.dtype.names):
+            target[name] = points[..., i]
     else:
+        assert isinstance(points, Mapping) or set(points.dtype.names) == set(target.dtype.names), \
+            'PointFields and structured NumPy array dtype do not match for all fields! \
+                Check their names.'
+        for name in target.dtype.names:
+            target[name] = points[name]
+
+
+def _fill_cloud(
+        header: Header,
+        fields: Sequence,
+        dtype: np.dtype,
+        points: Union[Iterable, np.ndarray, Mapping],
+        is_dense: bool,
+        cloud: Optional[PointCloud2]) -> PointCloud2:
+    if not isinstance(points, (np.ndarray, Mapping)):
         # Cast python objects to structured NumPy array (slow)
         points = np.array(
             # Points need to be tuples in the structured array
             list(map(tuple, points)),
-            dtype=dtype_from_fields(fields))
+            dtype=dtype)
+    shape = _points_shape(points, dtype)
 
     # Handle organized clouds
-    assert len(points.shape) <= 2, \
+    assert len(shape) <= 2, \
         'Too many dimensions for organized cloud! \
             Points can only be organized in max. two dimensional space'
-    height = 1
-    width = points.shape[0]
+    width = shape[0] if len(shape) > 0 else 1
     # Check if input points are an organized cloud (2D array of points)
-    if len(points.shape) == 2:
-        height = points.shape[1]
-
-    # Convert numpy points to array.array
-    memory_view = memoryview(points)
-    casted = memory_view.cast('B')
-    array_array = array.array('B')
-    array_array.frombytes(casted)
+    height = shape[1] if len(shape) == 2 else 1
 
     # Put everything together
-    cloud = PointCloud2()
+    if cloud is None:
+        cloud = PointCloud2()
     cloud.header(header)
     cloud.height(height)
     cloud.width(width)
     cloud.is_dense(is_dense)
     cloud.is_bigendian(sys.byteorder != 'little')
     cloud.fields(fields)
-    cloud.point_step(points.dtype.itemsize)
-    cloud.row_step(points.dtype.itemsize * width)
-    cloud.data(array_array)
+    cloud.point_step(dtype.itemsize)
+    cloud.row_step(dtype.itemsize * width)
+
+    # Write the points straight into the data of the cloud, which keeps its capacity when the cloud is reused
+    size = dtype.itemsize * width * height
+    point_cloud2_resize_data(cloud, size)
+    if size > 0:
+        _write_points(
+            np.ndarray(shape=(width, height) if len(shape) == 2 else (width, ), dtype=dtype,
+                       buffer=point_cloud2_data_view(cloud)),
+            points)
 
     return cloud
 
 
-def make_radar_point_cloud(header: Header, points: Iterable, is_dense: bool = True) -> PointCloud2:
-    """
-    Create a provizio_dds.PointCloud2 message with
-    (x, y, z, radar_relative_radial_velocity, signal_to_noise_ratio, ground_relative_radial_velocity) fields.
-
-    :param header: The point cloud header. (Type: provizio_dds.Header)
-    :param points: The point cloud points. (Type: Iterable)
-    :param is_dense: True if there are no invalid points
-    :return: The point cloud as provizio_dds.PointCloud2.
-    """
-    fields = [None] * 6
-    for i in range(6):
+def _make_radar_point_fields() -> List:
+    names = ['x', 'y', 'z', 'radar_relative_radial_velocity', 'signal_to_noise_ratio',
+             'ground_relative_radial_velocity']
+    fields = [None] * len(names)
+    for i, name in enumerate(names):
         fields[i] = PointField()
+        fields[i].name(name)
         fields[i].offset(i * 4)
         fields[i].count(1)
         fields[i].datatype(FLOAT32)
-    fields[0].name("x")
-    fields[1].name("y")
-    fields[2].name("z")
-    fields[3].name("radar_relative_radial_velocity")
-    fields[4].name("signal_to_noise_ratio")
-    fields[5].name("ground_relative_radial_velocity")
-
-    return create_cloud(header, fields, points, is_dense)
+    return fields
 
 
-def make_header(timestamp_sec: int, timestamp_nanosec: int, frame_id: str) -> Header:
-    """
-    Create a provizio_dds.Header
-
-    :param timestamp_sec: Seconds component of timestamp. (Type: int)
-    :param timestamp_nanosec: Nanoseconds component of timestamp, valid in the range [0, 10e9). (Type: int)
-    :param frame_id: Frame this data is associated with
-    """
-    header = Header()
-    header.stamp().sec(timestamp_sec)
-    header.stamp().nanosec(timestamp_nanosec)
-    header.frame_id(frame_id)
-    return header
+# Fields of make_radar_point_cloud, created once rather than per cloud
+_RADAR_POINT_FIELDS = _make_radar_point_fields()
+_RADAR_POINT_DTYPE = dtype_from_fields(_RADAR_POINT_FIELDS)
@@ -0,0 +1,303 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Exposes the data of a sensor_msgs::msg::PointCloud2 through the Python buffer protocol, so point_cloud2.py can wrap
+// it in NumPy arrays with no per-byte conversions. Included in provizio_dds_python_types after the generated types.
+
+%{
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "provizio/dds/point_cloud2.h"
+
+namespace provizio
+{
+    namespace dds
+    {
+        namespace python
+        {
+            // Data of a PointCloud2 detached from it while exported, so the exports never point to freed memory
+            struct exported_data
+            {
+                std::vector<std::uint8_t> detached;
+            };
+
+            // Clouds with alive exports. The mutex is taken with or without the GIL, and never the other way around.
+            struct export_registry
+            {
+                std::mutex mutex;
+                std::map<const sensor_msgs::msg::PointCloud2 *, std::weak_ptr<exported_data>> clouds;
+            };
+
+            // A function-local static, so it outlives any exports of the clouds of the module
+            export_registry &exports()
+            {
+                static export_registry instance;
+                return instance;
+            }
+
+            std::shared_ptr<exported_data> *acquire_exported_data(const sensor_msgs::msg::PointCloud2 &cloud)
+            {
+                std::lock_guard<std::mutex> lock{exports().mutex};
+                auto &registered = exports().clouds[&cloud];
+                std::shared_ptr<exported_data> result = registered.lock();
+                if (!result)
+                {
+                    result = std::make_shared<exported_data>();
+                    registered = result;
+                }
+                return new std::shared_ptr<exported_data>(std::move(result));
+            }
+
+            void release_exported_data(const sensor_msgs::msg::PointCloud2 *cloud, std::shared_ptr<exported_data> *data)
+            {
+                std::lock_guard<std::mutex> lock{exports().mutex};
+                delete data;
+                const auto found = exports().clouds.find(cloud);
+                if (found != exports().clouds.end() && found->second.expired())
+                {
+                    exports().clouds.erase(found);
+                }
+            }
+
+            /**
+             * @brief Moves the data of a PointCloud2 to its alive exports, if there are any, leaving the cloud with no
+             * data. To be called before resizing or deserializing into the cloud, so the exports keep the previous
+             * data rather than pointing to freed memory. Thread-safe, doesn't require the GIL.
+             *
+             * @return true if the data has been detached
+             */
+            bool detach_exported_data(sensor_msgs::msg::PointCloud2 &cloud)
+            {
+                std::lock_guard<std::mutex> lock{exports().mutex};
+                const auto found = exports().clouds.find(&cloud);
+                if (found == exports().clouds.end())
+                {
+                    return false;
+                }
+
+                const std::shared_ptr<exported_data> data = found->second.lock();
+                exports().clouds.erase(found);
+                if (!data)
+                {
+                    return false;
+                }
+                data->detached.swap(cloud.data());
+                return true;
+            }
+
+            // Exports a raw memory buffer, keeping the Python object that owns it alive
+            struct data_buffer
+            {
+                PyObject_HEAD
+                PyObject *owner;
+                const sensor_msgs::msg::PointCloud2 *cloud;
+                std::shared_ptr<exported_data> *exported;
+                void *data;
+                Py_ssize_t size;
+            };
+
+            int data_buffer_get_buffer(PyObject *self, Py_buffer *view, int flags)
+            {
+                auto buffer = reinterpret_cast<data_buffer *>(self);
+                return PyBuffer_FillInfo(view, self, buffer->data, buffer->size, 0, flags);
+            }
+
+            void data_buffer_dealloc(PyObject *self)
+            {
+                auto buffer = reinterpret_cast<data_buffer *>(self);
+                release_exported_data(buffer->cloud, buffer->exported);
+                Py_XDECREF(buffer->owner);
+                Py_TYPE(self)->tp_free(self);
+            }
+
+            PyTypeObject *data_buffer_type()
+            {
+                static PyBufferProcs buffer_procs;
+                static PyTypeObject type = {PyVarObject_HEAD_INIT(nullptr, 0)};
+                static bool ready = false;
+                if (!ready)
+                {
+                    buffer_procs.bf_getbuffer = data_buffer_get_buffer;
+                    type.tp_name = "provizio_dds_python_types.data_buffer";
+                    type.tp_basicsize = sizeof(data_buffer);
+                    type.tp_flags = Py_TPFLAGS_DEFAULT;
+                    type.tp_dealloc = data_buffer_dealloc;
+                    type.tp_as_buffer = &buffer_procs;
+                    if (PyType_Ready(&type) != 0)
+                    {
+                        return nullptr;
+                    }
+                    ready = true;
+                }
+                return &type;
+            }
+
+            // Returns nullptr with no Python error set if cloud_object isn't a PointCloud2
+            sensor_msgs::msg::PointCloud2 *find_point_cloud2(PyObject *cloud_object)
+            {
+                static swig_type_info *const point_cloud2_type = SWIG_TypeQuery("sensor_msgs::msg::PointCloud2 *");
+
+                void *cloud = nullptr;
+                if (point_cloud2_type == nullptr ||
+                    !SWIG_IsOK(SWIG_ConvertPtr(cloud_object, &cloud, point_cloud2_type, 0)))
+                {
+                    return nullptr;
+                }
+                return static_cast<sensor_msgs::msg::PointCloud2 *>(cloud);
+            }
+
+            sensor_msgs::msg::PointCloud2 *as_point_cloud2(PyObject *cloud_object)
+            {
+                sensor_msgs::msg::PointCloud2 *cloud = find_point_cloud2(cloud_object);
+                if (cloud == nullptr)
+                {
+                    PyErr_SetString(PyExc_TypeError, "Not a provizio_dds.PointCloud2");
+                }
+                return cloud;
+            }
+        } // namespace python
+    } // namespace dds
+} // namespace provizio
+%}
+
+%inline %{
+/**
+ * @brief Returns a writable memoryview of the data of a PointCloud2, with no copying. The memoryview keeps the cloud
+ * alive. When the data is resized with point_cloud2_resize_data or taken into by a sample_queue, alive memoryviews
+ * keep the previous data instead, detached from the cloud.
+ */
+PyObject *point_cloud2_data_view(PyObject *cloud_object)
+{
+    using namespace provizio::dds::python;
+
+    sensor_msgs::msg::PointCloud2 *cloud = as_point_cloud2(cloud_object);
+    PyTypeObject *type = data_buffer_type();
+    if (cloud == nullptr || type == nullptr)
+    {
+        return nullptr;
+    }
+
+    auto buffer = PyObject_New(data_buffer, type);
+    if (buffer == nullptr)
+    {
+        return nullptr;
+    }
+    Py_INCREF(cloud_object);
+    buffer->owner = cloud_object;
+    buffer->cloud = cloud;
+    buffer->exported = acquire_exported_data(*cloud);
+    buffer->data = cloud->data().data();
+    buffer->size = static_cast<Py_ssize_t>(cloud->data().size());
+
+    PyObject *view = PyMemoryView_FromObject(reinterpret_cast<PyObject *>(buffer));
+    Py_DECREF(buffer);
+    return view;
+}
+
+/**
+ * @brief Resizes the data of a PointCloud2 without initializing it from Python, to be filled through
+ * point_cloud2_data_view. If memoryviews of the data are alive, they keep it and the cloud gets new zeroed data, so
+ * its buffer is only reused once they are released.
+ */
+PyObject *point_cloud2_resize_data(PyObject *cloud_object, const size_t size)
+{
+    sensor_msgs::msg::PointCloud2 *cloud = provizio::dds::python::as_point_cloud2(cloud_object);
+    if (cloud == nullptr)
+    {
+        return nullptr;
+    }
+
+    provizio::dds::python::detach_exported_data(*cloud);
+    cloud->data().resize(size);
+    Py_RETURN_NONE;
+}
+
+/**
+ * @brief Detaches the data of a PointCloud2 from its alive memoryviews, leaving the cloud with no data, f.e. before
+ * assigning new data to it from Python
+ *
+ * @return True if there were alive memoryviews
+ */
+PyObject *point_cloud2_detach_data(PyObject *cloud_object)
+{
+    sensor_msgs::msg::PointCloud2 *cloud = provizio::dds::python::as_point_cloud2(cloud_object);
+    if (cloud == nullptr)
+    {
+        return nullptr;
+    }
+
+    return PyBool_FromLong(provizio::dds::python::detach_exported_data(*cloud) ? 1 : 0);
+}
+
+/**
+ * @brief Quantizes floating point fields of a PointCloud2 into int16 values, as provizio::dds::quantize_point_cloud.
+ * scales is a dict of field names to the real values of a single quantized unit.
+ */
+PyObject *point_cloud2_quantize(PyObject *source_object, PyObject *quantized_object, PyObject *scales)
+{
+    using namespace provizio::dds::python;
+
+    sensor_msgs::msg::PointCloud2 *source = as_point_cloud2(source_object);
+    sensor_msgs::msg::PointCloud2 *quantized = as_point_cloud2(quantized_object);
+    if (source == nullptr || quantized == nullptr)
+    {
+        return nullptr;
+    }
+    if (!PyDict_Check(scales))
+    {
+        PyErr_SetString(PyExc_TypeError, "Scales are expected to be a dict of field names to scales");
+        return nullptr;
+    }
+
+    std::vector<provizio::dds::point_field_quantization> quantization;
+    PyObject *name = nullptr;
+    PyObject *scale = nullptr;
+    Py_ssize_t position = 0;
+    while (PyDict_Next(scales, &position, &name, &scale))
+    {
+        const char *name_string = PyUnicode_AsUTF8(name);
+        const double scale_value = PyFloat_AsDouble(scale);
+        if (name_string == nullptr || PyErr_Occurred() != nullptr)
+        {
+            return nullptr;
+        }
+        quantization.push_back({name_string, static_cast<float>(scale_value)});
+    }
+
+    detach_exported_data(*quantized);
+    return PyBool_FromLong(provizio::dds::quantize_point_cloud(*source, *quantized, quantization) ? 1 : 0);
+}
+
+/**
+ * @brief Restores a PointCloud2 quantized by point_cloud2_quantize, as provizio::dds::dequantize_point_cloud
+ */
+PyObject *point_cloud2_dequantize(PyObject *quantized_object, PyObject *dequantized_object)
+{
+    using namespace provizio::dds::python;
+
+    sensor_msgs::msg::PointCloud2 *quantized = as_point_cloud2(quantized_object);
+    sensor_msgs::msg::PointCloud2 *dequantized = as_point_cloud2(dequantized_object);
+    if (quantized == nullptr || dequantized == nullptr)
+    {
+        return nullptr;
+    }
+
+    detach_exported_data(*dequantized);
+    return PyBool_FromLong(provizio::dds::dequantize_point_cloud(*quantized, *dequantized) ? 1 : 0);
+}
+%}
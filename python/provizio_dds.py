@@ -17,7 +17,10 @@ Python library for DDS communication in Provizio customer facing APIs and
 internal Provizio software components. Built using eProsima Fast-DDS DDS    
 implementation (Apache License 2.0).
 """
+import asyncio
+import concurrent.futures
 import os
+import weakref
 from typing import Any, Callable, Optional, TypeVar
 
 # until https://bugs.python.org/issue46276 is fixed we can apply this workaround
@@ -248,7 +251,10 @@ class Subscriber(_TopicHandle):
         :param reliability_kind: Optional, a DDS data reader reliability kind to be used: either BEST_EFFORT_RELIABILITY_QOS or RELIABLE_RELIABILITY_QOS; if not specified, QosDefaults for pub_sub_type will be used
         """
         super().__init__(domain_participant, topic_name, pub_sub_type)
+        self._create_reader(pub_sub_type, Subscriber._ReaderListener(
+            data_type, on_data_function, on_has_publisher_changed_function), reliability_kind)
 
+    def _create_reader(self, pub_sub_type, listener, reliability_kind):
         qos_defaults = QosDefaults(pub_sub_type)
 
         if (reliability_kind is None):
@@ -261,8 +267,7 @@ class Subscriber(_TopicHandle):
             self._subscriber_qos)
 
         # Create DataReader
-        self._listener = Subscriber._ReaderListener(
-            data_type, on_data_function, on_has_publisher_changed_function)
+        self._listener = listener
         self._reader_qos = DataReaderQos()
         self._subscriber.get_default_datareader_qos(self._reader_qos)
         self._reader_qos.reliability().kind = reliability_kind
@@ -281,3 +286,212 @@ class Subscriber(_TopicHandle):
         except:
             pass
         super().__del__()
+
+
+class QueuedSubscriber(Subscriber):
+    """Provides subscription functionality for a DDS data type and topic name specified when constructing, with
+    samples queued by a native listener without taking the GIL, so that a single take_batch serves many samples.
+    Data objects are preallocated and reused."""
+
+    DEFAULT_QUEUE_SIZE = 64
+    """Default number of data objects to queue samples into"""
+
+    def __init__(
+            self,
+            domain_participant: object,
+            topic_name: str,
+            pub_sub_type: TypeVar("pub_sub_type", bound=TopicDataType),
+            data_type: TypeVar("data_type"),
+            queue_size: int = DEFAULT_QUEUE_SIZE,
+            on_has_publisher_changed_function: Optional[Callable[[
+                bool], Any]] = None,
+            reliability_kind: Optional[Any] = None):
+        """Constructs a DDS Subscriber with a queue of received samples
+
+        :param domain_participant: A DDS Domain Participant wrapper object, as created by provizio_dds.make_domain_participant
+        :param str topic_name: A string DDS Topic name
+        :param pub_sub_type: The DDS PubSub Type to be received, f.e. provizio_dds.StringPubSubType
+        :param data_type: The DDS Data Type to be received, f.e. provizio_dds.String
+        :param queue_size: Number of data objects to queue samples into, which limits the size of a batch. When all of them are busy, samples are left in the DataReader history, which only keeps the latest ones according to its HistoryQosPolicy
+        :param on_has_publisher_changed_function: Optional, a function to be invoked on matching first / umatching last publisher, takes a single bool argument: True when the first publisher is matched, False when the last publisher is unmatched; Note: called from a background Thread
+        :param reliability_kind: Optional, a DDS data reader reliability kind to be used: either BEST_EFFORT_RELIABILITY_QOS or RELIABLE_RELIABILITY_QOS; if not specified, QosDefaults for pub_sub_type will be used
+        """
+        _TopicHandle.__init__(
+            self, domain_participant, topic_name, pub_sub_type)
+
+        self._queue_size = max(queue_size, 1)
+        self._queue = sample_queue([data_type() for _ in range(
+            self._queue_size)], on_has_publisher_changed_function)
+        self._create_reader(
+            pub_sub_type, self._queue.data_reader_listener(), reliability_kind)
+        self._queue.set_data_reader(self._reader)
+        self._loop = None
+        self._wakeup = None
+
+    def __del__(self):
+        try:
+            self.close()
+        except:
+            pass
+        super().__del__()
+
+    def close(self):
+        """Stops waking up the event loop used by take_batch_async and wait_for_publisher, f.e. before closing it. A
+        later asynchronous wait starts waking up its own event loop again."""
+        if self._loop is not None and not self._loop.is_closed():
+            self._loop.remove_reader(self._queue.wakeup_fd())
+        self._loop = None
+
+    def take_batch(self, max_count: Optional[int] = None, timeout: Optional[float] = None) -> list:
+        """Takes a batch of received samples, waiting for at least one with the GIL released
+
+        :param max_count: Optional, max number of samples to take, the queue size by default
+        :param timeout: Optional, max time to wait for a sample in seconds: 0 not to wait, None to wait indefinitely
+        :return: A list of data objects, f.e. of provizio_dds.String, in the order of reception; empty on timeout. The data objects are reused, so they are only valid until the next take_batch; copy them to keep them longer
+        """
+        return self._queue.take_batch(self._queue_size if max_count is None else max_count, -1.0 if timeout is None else timeout)
+
+    async def take_batch_async(self, max_count: Optional[int] = None) -> list:
+        """Takes a batch of received samples, waiting for at least one without blocking the event loop, which is woken
+        up through a file descriptor rather than by a thread. Only to be used with a single event loop at a time.
+
+        :param max_count: Optional, max number of samples to take, the queue size by default
+        :return: A list of data objects, as in take_batch, only valid until the next take_batch or take_batch_async
+        """
+        while True:
+            wakeup = self._wakeup_event()
+            batch = self.take_batch(max_count, 0)
+            if batch:
+                return batch
+            await wakeup.wait()
+
+    async def wait_for_publisher(self, matched: bool = True):
+        """Waits for a publisher to be matched (or all publishers to be unmatched) without blocking the event loop
+
+        :param matched: True to wait for any publisher to be matched, False to wait for all of them to be unmatched
+        """
+        while True:
+            # The wakeup fd is created before checking, so a match in between is signalled rather than missed
+            wakeup = self._wakeup_event()
+            if (self._queue.publisher_count() > 0) == matched:
+                return
+            await wakeup.wait()
+
+    def __aiter__(self):
+        """Iterates asynchronously over batches of received samples, as returned by take_batch_async"""
+        return self
+
+    async def __anext__(self) -> list:
+        return await self.take_batch_async()
+
+    def _wakeup_event(self):
+        # An event per wakeup, rather than clearing a single one, so concurrent waiters never miss a wakeup
+        loop = asyncio.get_running_loop()
+        if self._loop is not loop:
+            if self._loop is not None and not self._loop.is_closed():
+                self._loop.remove_reader(self._queue.wakeup_fd())
+            self._loop = loop
+            self._wakeup = asyncio.Event()
+            # A weak reference, so the event loop doesn't keep the subscriber alive
+            self._loop.add_reader(self._queue.wakeup_fd(), QueuedSubscriber._on_wakeup_of, weakref.ref(self))
+        return self._wakeup
+
+    @staticmethod
+    def _on_wakeup_of(subscriber_ref):
+        subscriber = subscriber_ref()
+        if subscriber is not None:
+            subscriber._on_wakeup()
+
+    def _on_wakeup(self):
+        self._queue.acknowledge_wakeup()
+        wakeup, self._wakeup = self._wakeup, asyncio.Event()
+        wakeup.set()
+
+
+class AsyncSubscriber(QueuedSubscriber):
+    """A QueuedSubscriber to be iterated asynchronously over individual received samples:
+    async for sample in subscriber"""
+
+    def __aiter__(self):
+        """Iterates asynchronously over received samples. A sample is only valid until the next iteration."""
+        return self._samples()
+
+    async def _samples(self):
+        while True:
+            for sample in await self.take_batch_async():
+                yield sample
+
+
+class AsyncPublisher(Publisher):
+    """A Publisher with asyncio integration: awaitable publishing and subscribers matching. To be constructed and used
+    in a single event loop."""
+
+    def __init__(
+            self,
+            domain_participant: object,
+            topic_name: str,
+            pub_sub_type: TypeVar("pub_sub_type", bound=TopicDataType),
+            reliability_kind: Optional[Any] = None):
+        """Constructs a DDS Publisher for the running event loop, i.e. in a coroutine or callback of it
+
+        :param domain_participant: A DDS Domain Participant wrapper object, as created by provizio_dds.make_domain_participant
+        :param str topic_name: A string DDS Topic name
+        :param pub_sub_type: The DDS PubSub Type to be published, f.e. provizio_dds.StringPubSubType
+        :param reliability_kind: Optional, a DDS data writer reliability kind to be used: either BEST_EFFORT_RELIABILITY_QOS or RELIABLE_RELIABILITY_QOS; if not specified, QosDefaults for pub_sub_type will be used
+        """
+        if (reliability_kind is None):
+            reliability_kind = QosDefaults(
+                pub_sub_type).datawriter_reliability_kind
+        self._loop = asyncio.get_running_loop()
+        self._executor = None
+        self._reliable = reliability_kind == RELIABLE_RELIABILITY_QOS
+        self._has_subscriber = False
+        self._matched = asyncio.Event()
+
+        super().__init__(domain_participant, topic_name, pub_sub_type,
+                         self._on_has_subscriber_changed, reliability_kind)
+
+    def __del__(self):
+        try:
+            if self._executor is not None:
+                self._executor.shutdown(wait=False)
+        except:
+            pass
+        super().__del__()
+
+    async def publish_async(self, data: object):
+        """Publishes DDS data without blocking the event loop. Reliable writes, which may block until the history has
+        room, are made one by one in a thread of the publisher; best effort writes never block so they are made right
+        away.
+
+        :param data: actual data (not Pub Sub Type), f.e. provizio_dds.String
+        :return: True if published successfully, and False otherwise
+        """
+        if not self._reliable:
+            return self.publish(data)
+        if self._executor is None:
+            # A single thread, so reliable writes are made in the order of publish_async calls
+            self._executor = concurrent.futures.ThreadPoolExecutor(max_workers=1)
+        return await self._loop.run_in_executor(self._executor, self.publish, data)
+
+    async def wait_for_subscriber(self, matched: bool = True):
+        """Waits for a subscriber to be matched (or all subscribers to be unmatched) without blocking the event loop
+
+        :param matched: True to wait for any subscriber to be matched, False to wait for all of them to be unmatched
+        """
+        while self._has_subscriber != matched:
+            await self._matched.wait()
+
+    def _on_has_subscriber_changed(self, _, has_subscriber):
+        # Invoked in a Fast-DDS thread
+        try:
+            self._loop.call_soon_threadsafe(
+                self._set_has_subscriber, has_subscriber)
+        except RuntimeError:
+            # The event loop is closed
+            pass
+
+    def _set_has_subscriber(self, has_subscriber):
+        self._has_subscriber = has_subscriber
+        matched, self._matched = self._matched, asyncio.Event()
+        matched.set()
@@ -0,0 +1,443 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A native DataReaderListener which takes samples into a bounded queue of reused data objects without the GIL, so
+// Python drains many samples per GIL acquisition rather than being called back for each of them. Used by
+// provizio_dds.QueuedSubscriber. Included in provizio_dds_python_types after the generated types.
+
+%{
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include <fastdds/dds/subscriber/DataReader.hpp>
+#include <fastdds/dds/subscriber/DataReaderListener.hpp>
+#include <fastdds/dds/subscriber/SampleInfo.hpp>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace provizio
+{
+    namespace dds
+    {
+        namespace python
+        {
+            class queued_reader_listener final : public eprosima::fastdds::dds::DataReaderListener
+            {
+              public:
+                // Takes ownership of the references to the samples and the function. point_clouds are the samples
+                // which are PointCloud2, nullptr for the rest.
+                queued_reader_listener(std::vector<PyObject *> sample_objects, std::vector<void *> samples,
+                                       std::vector<sensor_msgs::msg::PointCloud2 *> point_clouds,
+                                       PyObject *on_has_publisher_changed)
+                    : sample_objects(std::move(sample_objects)), samples(std::move(samples)),
+                      point_clouds(std::move(point_clouds)), on_has_publisher_changed(on_has_publisher_changed)
+                {
+                    for (std::size_t i = 0; i < this->samples.size(); ++i)
+                    {
+                        free_slots.push_back(i);
+                    }
+                }
+
+                // Invoked with the GIL held
+                ~queued_reader_listener() override
+                {
+                    for (PyObject *sample_object : sample_objects)
+                    {
+                        Py_DECREF(sample_object);
+                    }
+                    Py_XDECREF(on_has_publisher_changed);
+
+#if !defined(_WIN32)
+                    if (wakeup_fds[0] >= 0)
+                    {
+                        close(wakeup_fds[0]);
+                        close(wakeup_fds[1]);
+                    }
+#endif
+                }
+
+                queued_reader_listener(const queued_reader_listener &) = delete;
+                queued_reader_listener &operator=(const queued_reader_listener &) = delete;
+
+                void on_data_available(eprosima::fastdds::dds::DataReader *data_reader) override
+                {
+                    {
+                        std::lock_guard<std::mutex> lock{mutex};
+                        reader = data_reader;
+                        take_available();
+                        if (ready_slots.empty())
+                        {
+                            return;
+                        }
+                    }
+                    condition.notify_all();
+                    signal_wakeup();
+                }
+
+                void on_subscription_matched(eprosima::fastdds::dds::DataReader *,
+                                             const eprosima::fastdds::dds::SubscriptionMatchedStatus &info) override
+                {
+                    publishers.store(info.current_count, std::memory_order_release);
+                    signal_wakeup();
+
+                    if (on_has_publisher_changed == nullptr)
+                    {
+                        return;
+                    }
+
+                    bool has_publisher = false;
+                    if (info.current_count > 0 && info.current_count_change == info.current_count)
+                    {
+                        // Just matched the first publisher
+                        has_publisher = true;
+                    }
+                    else if (!(info.current_count == 0 && info.current_count_change < 0))
+                    {
+                        // Neither the first matched nor the last unmatched
+                        return;
+                    }
+
+                    const PyGILState_STATE gil_state = PyGILState_Ensure();
+                    PyObject *result = PyObject_CallFunctionObjArgs(on_has_publisher_changed,
+                                                                    has_publisher ? Py_True : Py_False, nullptr);
+                    if (result == nullptr)
+                    {
+                        PyErr_Print();
+                    }
+                    Py_XDECREF(result);
+                    PyGILState_Release(gil_state);
+                }
+
+                // Invoked with the GIL released. Samples of the previous batch are reused from now on.
+                std::vector<std::size_t> take_batch(const std::size_t max_count, const double timeout)
+                {
+                    std::unique_lock<std::mutex> lock{mutex};
+                    free_slots.insert(free_slots.end(), lent_slots.begin(), lent_slots.end());
+                    lent_slots.clear();
+                    take_available();
+
+                    if (ready_slots.empty() && timeout != 0)
+                    {
+                        const auto has_samples = [this]() { return !ready_slots.empty(); };
+                        if (timeout < 0)
+                        {
+                            condition.wait(lock, has_samples);
+                        }
+                        else
+                        {
+                            condition.wait_for(lock, std::chrono::duration<double>{timeout}, has_samples);
+                        }
+                    }
+
+                    while (!ready_slots.empty() && lent_slots.size() < max_count)
+                    {
+                        lent_slots.push_back(ready_slots.front());
+                        ready_slots.pop_front();
+                    }
+                    return lent_slots;
+                }
+
+                PyObject *sample_object(const std::size_t slot) const
+                {
+                    return sample_objects[slot];
+                }
+
+                // Invoked with the GIL held
+                int wakeup_fd()
+                {
+#if !defined(_WIN32)
+                    std::lock_guard<std::mutex> lock{mutex};
+                    if (wakeup_fds[0] < 0)
+                    {
+                        int fds[2];
+                        if (pipe(fds) != 0)
+                        {
+                            return -1;
+                        }
+                        for (const int fd : fds)
+                        {
+                            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+                            fcntl(fd, F_SETFD, FD_CLOEXEC);
+                        }
+                        wakeup_fds[1] = fds[1];
+                        wakeup_fds[0] = fds[0];
+                    }
+                    return wakeup_fds[0];
+#else
+                    return -1;
+#endif
+                }
+
+                // Invoked with the GIL held, before taking the samples the wakeup signalled. The pipe is drained
+                // before clearing the flag, so a byte written by a concurrent signal_wakeup is never drained while the
+                // flag stays set. A signal suppressed in between is for samples or matches the caller checks next.
+                void acknowledge_wakeup()
+                {
+#if !defined(_WIN32)
+                    char buffer[64];
+                    while (wakeup_fds[0] >= 0 && read(wakeup_fds[0], buffer, sizeof(buffer)) > 0)
+                    {
+                    }
+#endif
+                    signalled.store(false, std::memory_order_seq_cst);
+                }
+
+                int publisher_count() const noexcept
+                {
+                    return publishers.load(std::memory_order_acquire);
+                }
+
+                void set_reader(eprosima::fastdds::dds::DataReader *data_reader)
+                {
+                    std::lock_guard<std::mutex> lock{mutex};
+                    reader = data_reader;
+                }
+
+              private:
+                // Makes the wakeup fd readable, unless it's already signalled and not yet acknowledged
+                void signal_wakeup()
+                {
+#if !defined(_WIN32)
+                    const int fd = wakeup_fds[1];
+                    if (fd >= 0 && !signalled.exchange(true, std::memory_order_seq_cst))
+                    {
+                        const char byte = 0;
+                        while (write(fd, &byte, 1) < 0 && errno == EINTR)
+                        {
+                        }
+                    }
+#endif
+                }
+
+                // Takes samples available in the reader while there are free slots. The rest are left in the history
+                // of the DataReader, which drops the oldest ones according to its HistoryQosPolicy.
+                void take_available()
+                {
+                    if (reader == nullptr)
+                    {
+                        return;
+                    }
+
+                    while (!free_slots.empty())
+                    {
+                        const std::size_t slot = free_slots.back();
+                        if (point_clouds[slot] != nullptr)
+                        {
+                            // NumPy arrays of the previous batch keep the previous data rather than dangling
+                            detach_exported_data(*point_clouds[slot]);
+                        }
+
+                        eprosima::fastdds::dds::SampleInfo info;
+                        if (reader->take_next_sample(samples[slot], &info) != ReturnCode_t::RETCODE_OK)
+                        {
+                            return;
+                        }
+
+                        if (info.valid_data)
+                        {
+                            free_slots.pop_back();
+                            ready_slots.push_back(slot);
+                        }
+                    }
+                }
+
+                using ReturnCode_t = eprosima::fastrtps::types::ReturnCode_t;
+
+                const std::vector<PyObject *> sample_objects;
+                const std::vector<void *> samples;
+                const std::vector<sensor_msgs::msg::PointCloud2 *> point_clouds;
+                PyObject *const on_has_publisher_changed;
+
+                std::mutex mutex;
+                std::condition_variable condition;
+                eprosima::fastdds::dds::DataReader *reader = nullptr;
+                std::vector<std::size_t> free_slots;
+                std::deque<std::size_t> ready_slots;
+                std::vector<std::size_t> lent_slots;
+
+                std::atomic<int> publishers{0};
+                std::atomic<bool> signalled{false};
+                std::atomic<int> wakeup_fds[2] = {{-1}, {-1}};
+            };
+        } // namespace python
+    } // namespace dds
+} // namespace provizio
+%}
+
+%include <std_except.i>
+%catches(std::invalid_argument) sample_queue::sample_queue;
+
+%inline %{
+/**
+ * @brief A bounded queue of received samples, filled by a native DataReaderListener without the GIL
+ */
+class sample_queue
+{
+  public:
+    /**
+     * @brief Constructs a new sample_queue object
+     *
+     * @param samples A list of data objects (f.e. provizio_dds.String) to take samples into, which are reused. Its
+     * length is the capacity of the queue, plus the size of a batch.
+     * @param on_has_publisher_changed A function taking a bool on matching first / unmatching last publisher, or None
+     */
+    sample_queue(PyObject *samples, PyObject *on_has_publisher_changed)
+    {
+        PyObject *sequence = PySequence_Fast(samples, "samples must be a sequence");
+        if (sequence == nullptr)
+        {
+            PyErr_Clear();
+            throw std::invalid_argument("samples must be a sequence");
+        }
+
+        std::vector<PyObject *> sample_objects;
+        std::vector<void *> sample_pointers;
+        std::vector<sensor_msgs::msg::PointCloud2 *> point_clouds;
+        const Py_ssize_t size = PySequence_Fast_GET_SIZE(sequence);
+        for (Py_ssize_t i = 0; i < size; ++i)
+        {
+            PyObject *sample_object = PySequence_Fast_GET_ITEM(sequence, i);
+            void *sample = nullptr;
+            if (!SWIG_IsOK(SWIG_ConvertPtr(sample_object, &sample, nullptr, 0)) || sample == nullptr)
+            {
+                for (PyObject *converted : sample_objects)
+                {
+                    Py_DECREF(converted);
+                }
+                Py_DECREF(sequence);
+                throw std::invalid_argument("samples must be DDS data objects");
+            }
+            Py_INCREF(sample_object);
+            sample_objects.push_back(sample_object);
+            sample_pointers.push_back(sample);
+            point_clouds.push_back(provizio::dds::python::find_point_cloud2(sample_object));
+        }
+        Py_DECREF(sequence);
+
+        if (on_has_publisher_changed == Py_None)
+        {
+            on_has_publisher_changed = nullptr;
+        }
+        Py_XINCREF(on_has_publisher_changed);
+        listener.reset(new provizio::dds::python::queued_reader_listener(
+            std::move(sample_objects), std::move(sample_pointers), std::move(point_clouds), on_has_publisher_changed));
+    }
+
+    /**
+     * @return The native listener, as an eprosima::fastdds::dds::DataReaderListener to pass to create_datareader.
+     * The sample_queue must outlive the DataReader.
+     */
+    PyObject *data_reader_listener()
+    {
+        static swig_type_info *const listener_type =
+            SWIG_TypeQuery("eprosima::fastdds::dds::DataReaderListener *");
+        if (listener_type == nullptr)
+        {
+            PyErr_SetString(PyExc_RuntimeError, "fastdds module is not loaded");
+            return nullptr;
+        }
+        return SWIG_NewPointerObj(static_cast<eprosima::fastdds::dds::DataReaderListener *>(listener.get()),
+                                  listener_type, 0);
+    }
+
+    /**
+     * @brief Sets the DataReader to take samples from, so samples received before it's first notified are taken too
+     */
+    PyObject *set_data_reader(PyObject *reader_object)
+    {
+        static swig_type_info *const reader_type = SWIG_TypeQuery("eprosima::fastdds::dds::DataReader *");
+        void *reader = nullptr;
+        if (reader_type == nullptr || !SWIG_IsOK(SWIG_ConvertPtr(reader_object, &reader, reader_type, 0)))
+        {
+            PyErr_SetString(PyExc_TypeError, "Not a fastdds.DataReader");
+            return nullptr;
+        }
+        listener->set_reader(static_cast<eprosima::fastdds::dds::DataReader *>(reader));
+        Py_RETURN_NONE;
+    }
+
+    /**
+     * @return A file descriptor which becomes readable when samples are received or publishers are matched or
+     * unmatched, f.e. for asyncio loop.add_reader. Call acknowledge_wakeup before taking the samples.
+     */
+    PyObject *wakeup_fd()
+    {
+        const int fd = listener->wakeup_fd();
+        if (fd < 0)
+        {
+            PyErr_SetString(PyExc_OSError, "Failed to create a wakeup file descriptor");
+            return nullptr;
+        }
+        return PyLong_FromLong(fd);
+    }
+
+    /**
+     * @brief Resets the wakeup file descriptor, so it becomes readable again on the next event
+     */
+    void acknowledge_wakeup()
+    {
+        listener->acknowledge_wakeup();
+    }
+
+    /**
+     * @return Number of currently matched publishers
+     */
+    int publisher_count() const
+    {
+        return listener->publisher_count();
+    }
+
+    /**
+     * @brief Takes a batch of received samples, waiting for at least one with the GIL released. The returned data
+     * objects are reused and only valid until the next take_batch.
+     *
+     * @param max_count Maximum number of samples
+     * @param timeout Maximum time to wait, in seconds: 0 not to wait, negative to wait indefinitely
+     * @return A list of data objects, empty on timeout
+     */
+    PyObject *take_batch(const size_t max_count, const double timeout)
+    {
+        std::vector<std::size_t> slots;
+        Py_BEGIN_ALLOW_THREADS
+        slots = listener->take_batch(max_count, timeout);
+        Py_END_ALLOW_THREADS
+
+        PyObject *batch = PyList_New(static_cast<Py_ssize_t>(slots.size()));
+        if (batch == nullptr)
+        {
+            return nullptr;
+        }
+        for (std::size_t i = 0; i < slots.size(); ++i)
+        {
+            PyObject *sample_object = listener->sample_object(slots[i]);
+            Py_INCREF(sample_object);
+            PyList_SET_ITEM(batch, static_cast<Py_ssize_t>(i), sample_object);
+        }
+        return batch;
+    }
+
+  private:
+    std::unique_ptr<provizio::dds::python::queued_reader_listener> listener;
+};
+%}
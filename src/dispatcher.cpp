@@ -0,0 +1,300 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "provizio/dds/dispatcher.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace provizio
+{
+    namespace dds
+    {
+        namespace
+        {
+            // Max samples of a single queue to be dispatched before going on to the next queue of the same worker
+            constexpr std::size_t max_batch_size = 16;
+
+            template <typename value_type> void update_max(std::atomic<value_type> &max, const value_type value)
+            {
+                value_type current = max.load(std::memory_order_relaxed);
+                while (current < value && !max.compare_exchange_weak(current, value, std::memory_order_relaxed))
+                {
+                }
+            }
+
+            void set_cpu_affinity(std::thread &thread, const int cpu)
+            {
+#if defined(__linux__)
+                cpu_set_t cpu_set;
+                CPU_ZERO(&cpu_set);
+                CPU_SET(cpu, &cpu_set);
+                pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set), &cpu_set);
+#else
+                (void)thread;
+                (void)cpu;
+#endif
+            }
+        } // namespace
+
+        namespace detail
+        {
+            dispatch_queue_base::dispatch_queue_base(std::string name) : name(std::move(name))
+            {
+            }
+
+            dispatch_statistics dispatch_queue_base::statistics() const
+            {
+                dispatch_statistics result;
+                result.name = name;
+                result.dispatched = dispatched.load(std::memory_order_relaxed);
+                result.dropped = dropped.load(std::memory_order_relaxed);
+                result.queue_depth = size();
+                result.max_queue_depth = max_queue_depth.load(std::memory_order_relaxed);
+                result.total_wait_time = std::chrono::nanoseconds{total_wait_time_ns.load(std::memory_order_relaxed)};
+                result.max_wait_time = std::chrono::nanoseconds{max_wait_time_ns.load(std::memory_order_relaxed)};
+                result.total_callback_time =
+                    std::chrono::nanoseconds{total_callback_time_ns.load(std::memory_order_relaxed)};
+                result.max_callback_time =
+                    std::chrono::nanoseconds{max_callback_time_ns.load(std::memory_order_relaxed)};
+                return result;
+            }
+
+            void dispatch_queue_base::count_enqueued(const std::size_t depth) noexcept
+            {
+                update_max(max_queue_depth, depth);
+            }
+
+            void dispatch_queue_base::count_dropped() noexcept
+            {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void dispatch_queue_base::count_dispatched(const std::chrono::nanoseconds wait_time,
+                                                       const std::chrono::nanoseconds callback_time) noexcept
+            {
+                const auto wait_time_ns = static_cast<std::int64_t>(wait_time.count());
+                const auto callback_time_ns = static_cast<std::int64_t>(callback_time.count());
+
+                dispatched.fetch_add(1, std::memory_order_relaxed);
+                total_wait_time_ns.fetch_add(wait_time_ns, std::memory_order_relaxed);
+                update_max(max_wait_time_ns, wait_time_ns);
+                total_callback_time_ns.fetch_add(callback_time_ns, std::memory_order_relaxed);
+                update_max(max_callback_time_ns, callback_time_ns);
+            }
+        } // namespace detail
+
+        struct dispatcher::worker
+        {
+            // Guards the queues of the worker, held while dispatching
+            std::mutex queues_mutex;
+            std::vector<std::shared_ptr<detail::dispatch_queue_base>> queues;
+
+            // Queues added but not yet picked up by the worker, so adding never waits for a dispatching round
+            std::mutex added_mutex;
+            std::vector<std::shared_ptr<detail::dispatch_queue_base>> added;
+
+            // Only held briefly for waking up, so producers are never blocked by a slow subscriber function
+            std::mutex wake_mutex;
+            std::condition_variable wake_condition;
+            std::atomic<bool> notified{false};
+            bool stopping = false;
+
+            std::thread thread;
+
+            void notify()
+            {
+                if (!notified.exchange(true, std::memory_order_acq_rel))
+                {
+                    std::lock_guard<std::mutex> lock{wake_mutex};
+                    wake_condition.notify_one();
+                }
+            }
+
+            void run()
+            {
+                for (;;)
+                {
+                    notified.store(false, std::memory_order_seq_cst);
+
+                    bool dispatched_any = false;
+                    {
+                        std::lock_guard<std::mutex> lock{queues_mutex};
+                        {
+                            std::lock_guard<std::mutex> added_lock{added_mutex};
+                            queues.insert(queues.end(), added.begin(), added.end());
+                            added.clear();
+                        }
+
+                        for (const auto &queue : queues)
+                        {
+                            if (!queue->detached.load(std::memory_order_acquire))
+                            {
+                                dispatched_any = queue->drain(max_batch_size) > 0 || dispatched_any;
+                            }
+                        }
+
+                        // Queues removed from the worker thread itself, f.e. by destroying a subscriber in its function
+                        queues.erase(std::remove_if(queues.begin(), queues.end(),
+                                                    [](const std::shared_ptr<detail::dispatch_queue_base> &queue) {
+                                                        return queue->detached.load(std::memory_order_acquire);
+                                                    }),
+                                     queues.end());
+                    }
+
+                    std::unique_lock<std::mutex> lock{wake_mutex};
+                    if (!dispatched_any)
+                    {
+                        wake_condition.wait(lock, [this]() {
+                            return stopping || notified.load(std::memory_order_acquire);
+                        });
+                    }
+
+                    if (stopping)
+                    {
+                        return;
+                    }
+                }
+            }
+        };
+
+        dispatcher::dispatcher(const dispatcher_options &options) : capacity(options.queue_capacity)
+        {
+            const std::size_t worker_threads = std::max<std::size_t>(options.worker_threads, 1);
+            workers.reserve(worker_threads);
+            for (std::size_t i = 0; i < worker_threads; ++i)
+            {
+                workers.emplace_back(new worker());
+                auto &new_worker = *workers.back();
+                new_worker.thread = std::thread{[&new_worker]() { new_worker.run(); }};
+                if (!options.cpu_affinity.empty())
+                {
+                    set_cpu_affinity(new_worker.thread, options.cpu_affinity[i % options.cpu_affinity.size()]);
+                }
+            }
+        }
+
+        dispatcher::~dispatcher()
+        {
+            for (auto &stopped_worker : workers)
+            {
+                {
+                    std::lock_guard<std::mutex> lock{stopped_worker->wake_mutex};
+                    stopped_worker->stopping = true;
+                }
+                stopped_worker->wake_condition.notify_one();
+
+                if (stopped_worker->thread.get_id() == std::this_thread::get_id())
+                {
+                    // The last reference to the dispatcher is released in its own worker thread, which can't be joined.
+                    // The worker is left to finish on its own, so it's intentionally leaked.
+                    stopped_worker->thread.detach();
+                    stopped_worker.release();
+                }
+                else
+                {
+                    stopped_worker->thread.join();
+                }
+            }
+        }
+
+        std::size_t dispatcher::queue_capacity() const noexcept
+        {
+            return capacity;
+        }
+
+        std::vector<dispatch_statistics> dispatcher::statistics() const
+        {
+            std::lock_guard<std::mutex> lock{queues_mutex};
+            std::vector<dispatch_statistics> result;
+            result.reserve(queues.size());
+            for (const auto &queue : queues)
+            {
+                result.push_back(queue->statistics());
+            }
+            return result;
+        }
+
+        void dispatcher::add(std::shared_ptr<detail::dispatch_queue_base> queue)
+        {
+            if (!queue)
+            {
+                return;
+            }
+
+            worker *target = nullptr;
+            {
+                std::lock_guard<std::mutex> lock{queues_mutex};
+                queue->worker_index = next_worker++ % workers.size();
+                queues.push_back(queue);
+                target = workers[queue->worker_index].get();
+            }
+
+            {
+                std::lock_guard<std::mutex> added_lock{target->added_mutex};
+                target->added.push_back(std::move(queue));
+            }
+            target->notify();
+        }
+
+        void dispatcher::remove(const detail::dispatch_queue_base *queue)
+        {
+            std::shared_ptr<detail::dispatch_queue_base> removed;
+            {
+                std::lock_guard<std::mutex> lock{queues_mutex};
+                const auto found = std::find_if(queues.begin(), queues.end(),
+                                                [queue](const std::shared_ptr<detail::dispatch_queue_base> &candidate) {
+                                                    return candidate.get() == queue;
+                                                });
+                if (found == queues.end())
+                {
+                    return;
+                }
+
+                removed = std::move(*found);
+                queues.erase(found);
+            }
+
+            // From now on the worker skips the queue, and erases it after the current dispatching round
+            removed->detached.store(true, std::memory_order_release);
+
+            auto &owner = *workers[removed->worker_index];
+            if (owner.thread.get_id() != std::this_thread::get_id())
+            {
+                // Waits for the worker to finish a dispatching round that might be using the queue
+                std::lock_guard<std::mutex> worker_lock{owner.queues_mutex};
+                owner.queues.erase(std::remove(owner.queues.begin(), owner.queues.end(), removed), owner.queues.end());
+
+                std::lock_guard<std::mutex> added_lock{owner.added_mutex};
+                owner.added.erase(std::remove(owner.added.begin(), owner.added.end(), removed), owner.added.end());
+            }
+        }
+
+        void dispatcher::notify(const detail::dispatch_queue_base *queue)
+        {
+            workers[queue->worker_index]->notify();
+        }
+
+        std::shared_ptr<dispatcher> make_dispatcher(const dispatcher_options &options)
+        {
+            return std::make_shared<dispatcher>(options);
+        }
+    } // namespace dds
+} // namespace provizio
@@ -14,7 +14,27 @@
 
 #include "provizio/dds/domain_participant.h"
 
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include <fastdds/dds/domain/DomainParticipantFactory.hpp>
+#include <fastdds/dds/domain/qos/DomainParticipantQos.hpp>
+#include <fastdds/rtps/attributes/ServerAttributes.h>
+#include <fastdds/rtps/transport/TCPv4TransportDescriptor.h>
+#include <fastdds/rtps/transport/UDPv4TransportDescriptor.h>
+#include <fastdds/rtps/transport/shared_mem/SharedMemTransportDescriptor.h>
+#include <fastrtps/utils/IPLocator.h>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 namespace provizio
 {
@@ -26,6 +46,294 @@ namespace provizio
             {
                 DomainParticipantFactory::get_instance()->delete_participant(participant);
             }
+
+            // Async writer thread settings of the participants created with them
+            struct thread_settings_registry
+            {
+                std::mutex mutex;
+                std::map<const DomainParticipant *, thread_settings> async_writer;
+            };
+
+            // A function-local static, so it outlives any static handles constructed after its first use
+            thread_settings_registry &thread_registry()
+            {
+                static thread_settings_registry instance;
+                return instance;
+            }
+
+            // Serializes changes of the process wide default thread attributes, recursive to allow nested scopes
+            std::recursive_mutex &default_thread_attributes_mutex()
+            {
+                static std::recursive_mutex instance;
+                return instance;
+            }
+
+#if defined(__linux__)
+            int to_policy(const thread_scheduling scheduling)
+            {
+                switch (scheduling)
+                {
+                case thread_scheduling::fifo:
+                    return SCHED_FIFO;
+
+                case thread_scheduling::round_robin:
+                    return SCHED_RR;
+
+                default:
+                    return SCHED_OTHER;
+                }
+            }
+#endif
+
+            // Fast-DDS refers to the names of flow controllers rather than copies them, so they are owned by the
+            // deleter of the participant
+            using flow_controller_names = std::shared_ptr<const std::vector<std::string>>;
+
+            std::shared_ptr<eprosima::fastdds::rtps::TransportDescriptorInterface> make_shm_transport(
+                const transport_options &options)
+            {
+                auto shm_transport = std::make_shared<eprosima::fastdds::rtps::SharedMemTransportDescriptor>();
+                shm_transport->segment_size(options.shm_segment_size);
+                return shm_transport;
+            }
+
+            DomainParticipantQos make_participant_qos(const transport_profile profile, const transport_options &options,
+                                                      flow_controller_names &names)
+            {
+                DomainParticipantQos participant_qos = PARTICIPANT_QOS_DEFAULT;
+                auto &transport = participant_qos.transport();
+                switch (profile)
+                {
+                case transport_profile::builtin:
+                    break;
+
+                case transport_profile::shm_only:
+                    transport.use_builtin_transports = false;
+                    transport.user_transports.push_back(make_shm_transport(options));
+                    break;
+
+                case transport_profile::udp_only:
+                    transport.use_builtin_transports = false;
+                    transport.user_transports.push_back(
+                        std::make_shared<eprosima::fastdds::rtps::UDPv4TransportDescriptor>());
+                    break;
+
+                case transport_profile::shm_and_udp:
+                    transport.use_builtin_transports = false;
+                    transport.user_transports.push_back(make_shm_transport(options));
+                    transport.user_transports.push_back(
+                        std::make_shared<eprosima::fastdds::rtps::UDPv4TransportDescriptor>());
+                    break;
+
+                case transport_profile::large_data_tcp: {
+                    transport.use_builtin_transports = false;
+                    transport.user_transports.push_back(make_shm_transport(options));
+
+                    auto tcp_transport = std::make_shared<eprosima::fastdds::rtps::TCPv4TransportDescriptor>();
+                    tcp_transport->add_listener_port(options.tcp_listening_port);
+                    transport.user_transports.push_back(tcp_transport);
+
+                    // UDP is still required for multicast discovery of participants
+                    transport.user_transports.push_back(
+                        std::make_shared<eprosima::fastdds::rtps::UDPv4TransportDescriptor>());
+                    break;
+                }
+                }
+
+                // Filled in before the descriptors refer to them, so they are never reallocated
+                auto owned_names = std::make_shared<std::vector<std::string>>();
+                owned_names->reserve(options.flow_controllers.size());
+                for (const auto &flow_controller : options.flow_controllers)
+                {
+                    owned_names->push_back(flow_controller.name);
+                }
+                for (std::size_t i = 0; i < options.flow_controllers.size(); ++i)
+                {
+                    const auto &flow_controller = options.flow_controllers[i];
+                    auto descriptor = std::make_shared<eprosima::fastdds::rtps::FlowControllerDescriptor>();
+                    descriptor->name = (*owned_names)[i].c_str();
+                    descriptor->max_bytes_per_period = flow_controller.max_bytes_per_period;
+                    descriptor->period_ms = flow_controller.period_ms;
+                    descriptor->scheduler = flow_controller.scheduler;
+                    participant_qos.flow_controllers().push_back(descriptor);
+                }
+                names = std::move(owned_names);
+
+                return participant_qos;
+            }
+
+            Duration_t milliseconds_to_duration(const std::uint32_t milliseconds)
+            {
+                return {static_cast<std::int32_t>(milliseconds / 1000), (milliseconds % 1000) * 1000000};
+            }
+
+            std::string static_endpoint_property_name(const std::string &topic_name, const static_endpoint_kind kind)
+            {
+                return (kind == static_endpoint_kind::writer ? "provizio.static_edp.writer."
+                                                             : "provizio.static_edp.reader.") +
+                       topic_name;
+            }
+
+            // Discovery Servers are reached over the network transport of the profile: TCP in large_data_tcp and UDP
+            // otherwise. Shared memory only participants have no network transport to reach them with.
+            bool make_server_locator(const discovery_server_options &server, const transport_profile profile,
+                                     eprosima::fastrtps::rtps::Locator_t &locator)
+            {
+                using eprosima::fastrtps::rtps::IPLocator;
+
+                switch (profile)
+                {
+                case transport_profile::shm_only:
+                    return false;
+
+                case transport_profile::large_data_tcp:
+                    locator.kind = LOCATOR_KIND_TCPv4;
+                    return IPLocator::setIPv4(locator, server.address) &&
+                           IPLocator::setPhysicalPort(locator, server.port) &&
+                           IPLocator::setLogicalPort(locator, server.port);
+
+                default:
+                    locator.kind = LOCATOR_KIND_UDPv4;
+                    locator.port = server.port;
+                    return IPLocator::setIPv4(locator, server.address);
+                }
+            }
+
+            // A TCP Discovery Server accepts connections on its port, rather than the automatically assigned one
+            void listen_to_server_port(DomainParticipantQos &participant_qos, const std::uint16_t port)
+            {
+                for (const auto &transport : participant_qos.transport().user_transports)
+                {
+                    auto tcp_transport =
+                        std::dynamic_pointer_cast<eprosima::fastdds::rtps::TCPv4TransportDescriptor>(transport);
+                    if (tcp_transport)
+                    {
+                        auto &ports = tcp_transport->listening_ports;
+                        ports.erase(std::remove(ports.begin(), ports.end(), 0), ports.end());
+                        if (std::find(ports.begin(), ports.end(), port) == ports.end())
+                        {
+                            tcp_transport->add_listener_port(port);
+                        }
+                    }
+                }
+            }
+
+            // Fast-DDS 2.8 doesn't reliably assign an available port to a TCP listener on port 0, so it's not accepted
+            bool has_tcp_listening_ports(const DomainParticipantQos &participant_qos)
+            {
+                for (const auto &transport : participant_qos.transport().user_transports)
+                {
+                    const auto tcp_transport =
+                        std::dynamic_pointer_cast<eprosima::fastdds::rtps::TCPv4TransportDescriptor>(transport);
+                    if (tcp_transport && (tcp_transport->listening_ports.empty() ||
+                                          std::find(tcp_transport->listening_ports.begin(),
+                                                    tcp_transport->listening_ports.end(),
+                                                    0) != tcp_transport->listening_ports.end()))
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            bool apply_discovery_options(DomainParticipantQos &participant_qos, const transport_profile profile,
+                                         const discovery_options &discovery)
+            {
+                auto &discovery_config = participant_qos.wire_protocol().builtin.discovery_config;
+                discovery_config.leaseDuration = milliseconds_to_duration(discovery.lease_duration_ms);
+                discovery_config.leaseDuration_announcementperiod =
+                    milliseconds_to_duration(discovery.announcement_period_ms);
+                discovery_config.initial_announcements.count = discovery.initial_announcements_count;
+                discovery_config.initial_announcements.period =
+                    milliseconds_to_duration(discovery.initial_announcements_period_ms);
+                if (!discovery.participant_name.empty())
+                {
+                    participant_qos.name(discovery.participant_name);
+                }
+
+                switch (discovery.mode)
+                {
+                case discovery_mode::simple:
+                    break;
+
+                case discovery_mode::discovery_server_client:
+                    if (discovery.servers.empty())
+                    {
+                        return false;
+                    }
+
+                    discovery_config.discoveryProtocol = eprosima::fastrtps::rtps::DiscoveryProtocol_t::CLIENT;
+                    discovery_config.discoveryServer_client_syncperiod =
+                        milliseconds_to_duration(discovery.client_sync_period_ms);
+                    for (const auto &server : discovery.servers)
+                    {
+                        eprosima::fastrtps::rtps::RemoteServerAttributes server_attributes;
+                        eprosima::fastrtps::rtps::Locator_t locator;
+                        if (!server_attributes.ReadguidPrefix(server.guid_prefix.c_str()) ||
+                            !make_server_locator(server, profile, locator))
+                        {
+                            return false;
+                        }
+                        server_attributes.metatrafficUnicastLocatorList.push_back(locator);
+                        discovery_config.m_DiscoveryServers.push_back(server_attributes);
+                    }
+                    break;
+
+                case discovery_mode::discovery_server: {
+                    if (discovery.servers.size() != 1)
+                    {
+                        return false;
+                    }
+
+                    const auto &server = discovery.servers.front();
+                    eprosima::fastrtps::rtps::Locator_t locator;
+                    std::istringstream guid_prefix{server.guid_prefix};
+                    guid_prefix >> participant_qos.wire_protocol().prefix;
+                    if (guid_prefix.fail() || !make_server_locator(server, profile, locator))
+                    {
+                        return false;
+                    }
+                    if (profile == transport_profile::large_data_tcp)
+                    {
+                        listen_to_server_port(participant_qos, server.port);
+                    }
+                    discovery_config.discoveryProtocol = eprosima::fastrtps::rtps::DiscoveryProtocol_t::SERVER;
+                    participant_qos.wire_protocol().builtin.metatrafficUnicastLocatorList.push_back(locator);
+                    break;
+                }
+
+                case discovery_mode::static_edp:
+                    if (discovery.static_edp_xml.empty() || discovery.participant_name.empty())
+                    {
+                        return false;
+                    }
+
+                    discovery_config.use_SIMPLE_EndpointDiscoveryProtocol = false;
+                    discovery_config.use_STATIC_EndpointDiscoveryProtocol = true;
+                    // Copied by Fast-DDS
+                    discovery_config.static_edp_xml_config(
+                        ((discovery.static_edp_xml.front() == '<' ? "data://" : "file://") + discovery.static_edp_xml)
+                            .c_str());
+
+                    // Stored in the participant, so publisher and subscriber handles can look them up
+                    for (const auto &endpoint : discovery.static_endpoints)
+                    {
+                        participant_qos.properties().properties().emplace_back(
+                            static_endpoint_property_name(endpoint.topic_name, endpoint.kind),
+                            std::to_string(endpoint.user_id));
+                    }
+                    break;
+                }
+
+                return true;
+            }
+
+            bool is_inherited(const thread_settings &settings)
+            {
+                return settings.cpu_affinity.empty() && settings.scheduling == thread_scheduling::inherit &&
+                       settings.stack_size == 0;
+            }
         } // namespace
 
         std::shared_ptr<DomainParticipant> make_domain_participant(DomainId_t domain_id)
@@ -34,5 +342,226 @@ namespace provizio
                                                                                       PARTICIPANT_QOS_DEFAULT, nullptr),
                     delete_participant};
         }
+
+        std::shared_ptr<DomainParticipant> make_domain_participant(DomainId_t domain_id,
+                                                                   const transport_profile profile,
+                                                                   const transport_options &options)
+        {
+            flow_controller_names names;
+            const DomainParticipantQos participant_qos = make_participant_qos(profile, options, names);
+            if (!has_tcp_listening_ports(participant_qos))
+            {
+                return nullptr;
+            }
+
+            return {dds::DomainParticipantFactory::get_instance()->create_participant(domain_id, participant_qos,
+                                                                                      nullptr),
+                    [names](DomainParticipant *deleted) { delete_participant(deleted); }};
+        }
+
+        std::shared_ptr<DomainParticipant> make_domain_participant(DomainId_t domain_id,
+                                                                   const transport_profile profile,
+                                                                   const transport_options &options,
+                                                                   const discovery_options &discovery)
+        {
+            return make_domain_participant(domain_id, profile, options, discovery, participant_thread_options{});
+        }
+
+        std::shared_ptr<DomainParticipant> make_domain_participant(DomainId_t domain_id,
+                                                                   const transport_profile profile,
+                                                                   const transport_options &options,
+                                                                   const discovery_options &discovery,
+                                                                   const participant_thread_options &threads)
+        {
+            flow_controller_names names;
+            DomainParticipantQos participant_qos = make_participant_qos(profile, options, names);
+            if (!apply_discovery_options(participant_qos, profile, discovery) ||
+                !has_tcp_listening_ports(participant_qos))
+            {
+                return nullptr;
+            }
+
+            DomainParticipant *participant = nullptr;
+            {
+                // The internal threads are started on creating the participant, inheriting the settings
+                const scoped_thread_settings settings{threads.internal};
+                participant = dds::DomainParticipantFactory::get_instance()->create_participant(
+                    domain_id, participant_qos, nullptr);
+            }
+            if (participant == nullptr)
+            {
+                return nullptr;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock{thread_registry().mutex};
+                thread_registry().async_writer[participant] = threads.async_writer;
+            }
+            return {participant, [names](DomainParticipant *deleted) {
+                        {
+                            std::lock_guard<std::mutex> lock{thread_registry().mutex};
+                            thread_registry().async_writer.erase(deleted);
+                        }
+                        delete_participant(deleted);
+                    }};
+        }
+
+        struct scoped_thread_settings::saved_settings
+        {
+#if defined(__linux__)
+            bool affinity_saved = false;
+            cpu_set_t affinity;
+            bool scheduling_saved = false;
+            int policy = SCHED_OTHER;
+            sched_param parameters{};
+#if defined(__GLIBC__)
+            std::unique_lock<std::recursive_mutex> stack_size_lock;
+            bool stack_size_saved = false;
+            std::size_t stack_size = 0;
+#endif
+#endif
+        };
+
+        scoped_thread_settings::scoped_thread_settings(const thread_settings &settings)
+        {
+            if (is_inherited(settings))
+            {
+                // Nothing to apply or restore, f.e. for the synchronous publishers
+                return;
+            }
+
+#if defined(__linux__)
+            saved = std::make_unique<saved_settings>();
+            const pthread_t self = pthread_self();
+            if (!settings.cpu_affinity.empty())
+            {
+                cpu_set_t cpu_set;
+                CPU_ZERO(&cpu_set);
+                for (const int cpu : settings.cpu_affinity)
+                {
+                    CPU_SET(cpu, &cpu_set);
+                }
+                saved->affinity_saved = pthread_getaffinity_np(self, sizeof(saved->affinity), &saved->affinity) == 0;
+                all_applied = saved->affinity_saved && pthread_setaffinity_np(self, sizeof(cpu_set), &cpu_set) == 0;
+            }
+
+            if (settings.scheduling != thread_scheduling::inherit)
+            {
+                saved->scheduling_saved = pthread_getschedparam(self, &saved->policy, &saved->parameters) == 0;
+                sched_param parameters{};
+                parameters.sched_priority = settings.scheduling == thread_scheduling::other ? 0 : settings.priority;
+                all_applied = saved->scheduling_saved &&
+                              pthread_setschedparam(self, to_policy(settings.scheduling), &parameters) == 0 &&
+                              all_applied;
+            }
+
+            if (settings.stack_size > 0)
+            {
+#if defined(__GLIBC__)
+                // Fast-DDS starts its threads with the default attributes, which are process wide, so they are only
+                // changed by one scope at a time
+                saved->stack_size_lock = std::unique_lock<std::recursive_mutex>{default_thread_attributes_mutex()};
+                pthread_attr_t attributes;
+                if (pthread_getattr_default_np(&attributes) == 0)
+                {
+                    saved->stack_size_saved = pthread_attr_getstacksize(&attributes, &saved->stack_size) == 0;
+                    all_applied = saved->stack_size_saved &&
+                                  pthread_attr_setstacksize(&attributes, settings.stack_size) == 0 &&
+                                  pthread_setattr_default_np(&attributes) == 0 && all_applied;
+                    pthread_attr_destroy(&attributes);
+                }
+                else
+                {
+                    all_applied = false;
+                }
+#else
+                all_applied = false;
+#endif
+            }
+#else
+            all_applied = false;
+#endif
+        }
+
+        scoped_thread_settings::~scoped_thread_settings()
+        {
+#if defined(__linux__)
+            if (!saved)
+            {
+                return;
+            }
+
+            const pthread_t self = pthread_self();
+            if (saved->affinity_saved)
+            {
+                pthread_setaffinity_np(self, sizeof(saved->affinity), &saved->affinity);
+            }
+            if (saved->scheduling_saved)
+            {
+                pthread_setschedparam(self, saved->policy, &saved->parameters);
+            }
+#if defined(__GLIBC__)
+            pthread_attr_t attributes;
+            if (saved->stack_size_saved && pthread_getattr_default_np(&attributes) == 0)
+            {
+                pthread_attr_setstacksize(&attributes, saved->stack_size);
+                pthread_setattr_default_np(&attributes);
+                pthread_attr_destroy(&attributes);
+            }
+            if (saved->stack_size_lock.owns_lock())
+            {
+                saved->stack_size_lock.unlock();
+            }
+#endif
+#endif
+        }
+
+        thread_settings async_writer_thread_settings(const std::shared_ptr<DomainParticipant> &domain_participant)
+        {
+            std::lock_guard<std::mutex> lock{thread_registry().mutex};
+            const auto found = thread_registry().async_writer.find(domain_participant.get());
+            return found != thread_registry().async_writer.end() ? found->second : thread_settings{};
+        }
+
+        std::shared_ptr<DomainParticipant> get_domain_participant(DomainId_t domain_id, const transport_profile profile)
+        {
+            // Function-local statics, so they outlive any static handles constructed after the first use
+            static std::mutex mutex;
+            static std::map<std::pair<DomainId_t, transport_profile>, std::weak_ptr<DomainParticipant>> participants;
+
+            std::lock_guard<std::mutex> lock{mutex};
+            auto &cached = participants[std::make_pair(domain_id, profile)];
+            auto participant = cached.lock();
+            if (!participant)
+            {
+                // Created under the mutex, so concurrent callers never end up with different participants
+                participant = profile == transport_profile::builtin ? make_domain_participant(domain_id)
+                                                                    : make_domain_participant(domain_id, profile);
+                if (participant)
+                {
+                    cached = participant;
+                }
+            }
+            return participant;
+        }
+
+        std::int16_t static_endpoint_user_id(const std::shared_ptr<DomainParticipant> &domain_participant,
+                                             const std::string &topic_name, const static_endpoint_kind kind)
+        {
+            if (!domain_participant)
+            {
+                return -1;
+            }
+
+            const std::string name = static_endpoint_property_name(topic_name, kind);
+            for (const auto &property : domain_participant->get_qos().properties().properties())
+            {
+                if (property.name() == name)
+                {
+                    return static_cast<std::int16_t>(std::stoi(property.value()));
+                }
+            }
+            return -1;
+        }
     } // namespace dds
 } // namespace provizio
@@ -0,0 +1,200 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "provizio/dds/entity_registry.h"
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+
+#include "provizio/dds/serialized_pub_sub_type.h"
+
+namespace provizio
+{
+    namespace dds
+    {
+        namespace
+        {
+            template <typename entity_type> struct shared_entity
+            {
+                entity_type *entity = nullptr;
+                std::size_t references = 0;
+            };
+
+            struct participant_entities
+            {
+                shared_entity<Publisher> publisher;
+                shared_entity<Subscriber> subscriber;
+                std::map<std::string, shared_entity<Topic>> topics;
+
+                bool empty() const
+                {
+                    return publisher.references == 0 && subscriber.references == 0 && topics.empty();
+                }
+            };
+
+            // Reference counting is performed under the mutex (rather than relying on weak_ptr expiration), so an
+            // entity is never re-created before its predecessor is deleted, which Fast-DDS doesn't allow for topics
+            struct entity_registry
+            {
+                std::mutex mutex;
+                std::map<const DomainParticipant *, participant_entities> participants;
+            };
+
+            // A function-local static, so it outlives any static handles constructed after its first use
+            entity_registry &registry()
+            {
+                static entity_registry instance;
+                return instance;
+            }
+
+            void release_if_empty(const DomainParticipant *domain_participant)
+            {
+                auto &participants = registry().participants;
+                const auto found = participants.find(domain_participant);
+                if (found != participants.end() && found->second.empty())
+                {
+                    participants.erase(found);
+                }
+            }
+
+            void delete_entity(DomainParticipant &domain_participant, Publisher *publisher)
+            {
+                domain_participant.delete_publisher(publisher);
+            }
+
+            void delete_entity(DomainParticipant &domain_participant, Subscriber *subscriber)
+            {
+                domain_participant.delete_subscriber(subscriber);
+            }
+
+            Publisher *create_entity(DomainParticipant &domain_participant, Publisher * /*tag*/)
+            {
+                return domain_participant.create_publisher(PUBLISHER_QOS_DEFAULT);
+            }
+
+            Subscriber *create_entity(DomainParticipant &domain_participant, Subscriber * /*tag*/)
+            {
+                return domain_participant.create_subscriber(SUBSCRIBER_QOS_DEFAULT);
+            }
+
+            template <typename entity_type>
+            std::shared_ptr<entity_type> acquire(std::shared_ptr<DomainParticipant> domain_participant,
+                                                 shared_entity<entity_type> participant_entities::*member)
+            {
+                if (!domain_participant)
+                {
+                    return nullptr;
+                }
+
+                std::lock_guard<std::mutex> lock{registry().mutex};
+                auto &shared = registry().participants[domain_participant.get()].*member;
+                if (shared.references == 0)
+                {
+                    shared.entity = create_entity(*domain_participant, static_cast<entity_type *>(nullptr));
+                    if (shared.entity == nullptr)
+                    {
+                        release_if_empty(domain_participant.get());
+                        return nullptr;
+                    }
+                }
+                ++shared.references;
+
+                return {shared.entity, [domain_participant, member](entity_type *entity) {
+                            std::lock_guard<std::mutex> release_lock{registry().mutex};
+                            auto &released = registry().participants[domain_participant.get()].*member;
+                            if (--released.references == 0)
+                            {
+                                delete_entity(*domain_participant, entity);
+                                released.entity = nullptr;
+                            }
+                            release_if_empty(domain_participant.get());
+                        }};
+            }
+
+            bool is_serialized(const TypeSupport &type_support)
+            {
+                return dynamic_cast<const serialized_pub_sub_type *>(type_support.get()) != nullptr;
+            }
+        } // namespace
+
+        std::shared_ptr<Topic> acquire_topic(std::shared_ptr<DomainParticipant> domain_participant,
+                                             const std::string &topic_name, const TypeSupport &type_support)
+        {
+            if (!domain_participant)
+            {
+                return nullptr;
+            }
+
+            std::lock_guard<std::mutex> lock{registry().mutex};
+            const TypeSupport registered_type = domain_participant->find_type(type_support->getName());
+            if (!registered_type.empty() && is_serialized(registered_type) != is_serialized(type_support))
+            {
+                // Samples of the registered type and serialized samples of the same type can't share a participant,
+                // as its data readers and writers (de)serialize with the registered type
+                return nullptr;
+            }
+
+            auto &topics = registry().participants[domain_participant.get()].topics;
+            auto found = topics.find(topic_name);
+            if (found != topics.end())
+            {
+                if (found->second.entity->get_type_name() != type_support->getName())
+                {
+                    // Same topic name, but a different type
+                    return nullptr;
+                }
+            }
+            else
+            {
+                if (registered_type.empty())
+                {
+                    type_support.register_type(domain_participant.get());
+                }
+
+                Topic *topic =
+                    domain_participant->create_topic(topic_name, type_support->getName(), TOPIC_QOS_DEFAULT);
+                if (topic == nullptr)
+                {
+                    release_if_empty(domain_participant.get());
+                    return nullptr;
+                }
+                found = topics.emplace(topic_name, shared_entity<Topic>{topic, 0}).first;
+            }
+            ++found->second.references;
+
+            return {found->second.entity, [domain_participant, topic_name](Topic *topic) {
+                        std::lock_guard<std::mutex> release_lock{registry().mutex};
+                        auto &participant_topics = registry().participants[domain_participant.get()].topics;
+                        const auto released = participant_topics.find(topic_name);
+                        if (released != participant_topics.end() && --released->second.references == 0)
+                        {
+                            domain_participant->delete_topic(topic);
+                            participant_topics.erase(released);
+                        }
+                        release_if_empty(domain_participant.get());
+                    }};
+        }
+
+        std::shared_ptr<Publisher> acquire_publisher(std::shared_ptr<DomainParticipant> domain_participant)
+        {
+            return acquire(std::move(domain_participant), &participant_entities::publisher);
+        }
+
+        std::shared_ptr<Subscriber> acquire_subscriber(std::shared_ptr<DomainParticipant> domain_participant)
+        {
+            return acquire(std::move(domain_participant), &participant_entities::subscriber);
+        }
+    } // namespace dds
+} // namespace provizio
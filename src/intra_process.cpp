@@ -0,0 +1,82 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "provizio/dds/intra_process.h"
+
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace provizio
+{
+    namespace dds
+    {
+        namespace detail
+        {
+            namespace
+            {
+                struct registered_channel
+                {
+                    std::string type_name;
+                    std::weak_ptr<void> channel;
+                };
+
+                struct channel_registry
+                {
+                    std::mutex mutex;
+                    std::map<std::pair<const DomainParticipant *, std::string>, registered_channel> channels;
+                };
+
+                // A function-local static, so it outlives any static handles constructed after its first use
+                channel_registry &registry()
+                {
+                    static channel_registry instance;
+                    return instance;
+                }
+            } // namespace
+
+            std::shared_ptr<void> acquire_intra_process_channel(
+                const std::shared_ptr<DomainParticipant> &domain_participant, const std::string &topic_name,
+                const std::string &type_name, std::shared_ptr<void> (*make_channel)())
+            {
+                if (!domain_participant)
+                {
+                    return nullptr;
+                }
+
+                std::lock_guard<std::mutex> lock{registry().mutex};
+                auto &channels = registry().channels;
+
+                // Expired channels are erased on acquiring, as there are only a few of them
+                for (auto next = channels.begin(); next != channels.end();)
+                {
+                    next = next->second.channel.expired() ? channels.erase(next) : std::next(next);
+                }
+
+                const auto key = std::make_pair(domain_participant.get(), topic_name);
+                const auto found = channels.find(key);
+                if (found != channels.end())
+                {
+                    // Same topic name, but a different type
+                    return found->second.type_name == type_name ? found->second.channel.lock() : nullptr;
+                }
+
+                auto channel = make_channel();
+                channels.emplace(key, registered_channel{type_name, channel});
+                return channel;
+            }
+        } // namespace detail
+    } // namespace dds
+} // namespace provizio
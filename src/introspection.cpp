@@ -0,0 +1,419 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "provizio/dds/introspection.h"
+
+#include <chrono>
+#include <cstdio>
+#include <locale>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <utility>
+
+#include <fastdds/dds/domain/qos/DomainParticipantQos.hpp>
+#include <fastdds/dds/topic/ContentFilteredTopic.hpp>
+#include <fastdds/dds/topic/Topic.hpp>
+#include <fastdds/rtps/transport/TCPv4TransportDescriptor.h>
+#include <fastdds/rtps/transport/UDPv4TransportDescriptor.h>
+#include <fastdds/rtps/transport/shared_mem/SharedMemTransportDescriptor.h>
+
+namespace provizio
+{
+    namespace dds
+    {
+        namespace
+        {
+            struct introspected_entity
+            {
+                const DomainParticipant *domain_participant = nullptr;
+                DataWriter *data_writer = nullptr;
+                DataReader *data_reader = nullptr;
+                std::function<publisher_metrics()> publisher_metrics_function;
+                std::function<subscriber_metrics()> subscriber_metrics_function;
+
+                // Rates of provizio::dds::introspect are averaged since then
+                std::chrono::steady_clock::time_point created = std::chrono::steady_clock::now();
+            };
+
+            // Entities are listed under the mutex, so an unregistered DataWriter or DataReader is never accessed
+            struct introspection_registry
+            {
+                std::mutex mutex;
+                std::uint64_t last_id = 0;
+                std::map<std::uint64_t, introspected_entity> entities;
+            };
+
+            // A function-local static, so it outlives any static handles constructed after its first use
+            introspection_registry &registry()
+            {
+                static introspection_registry instance;
+                return instance;
+            }
+
+            std::uint64_t register_entity(introspected_entity &&entity)
+            {
+                std::lock_guard<std::mutex> lock{registry().mutex};
+                const std::uint64_t id = ++registry().last_id;
+                registry().entities.emplace(id, std::move(entity));
+                return id;
+            }
+
+            std::string participant_transports(const DomainParticipant &domain_participant)
+            {
+                const auto &transport = domain_participant.get_qos().transport();
+
+                // Fast-DDS builtin transports are UDPv4 and shared memory
+                std::string result = transport.use_builtin_transports ? "shm+udpv4" : "";
+                for (const auto &descriptor : transport.user_transports)
+                {
+                    const auto *const descriptor_pointer = descriptor.get();
+                    const char *name = "other";
+                    if (dynamic_cast<const eprosima::fastdds::rtps::SharedMemTransportDescriptor *>(
+                            descriptor_pointer) != nullptr)
+                    {
+                        name = "shm";
+                    }
+                    else if (dynamic_cast<const eprosima::fastdds::rtps::UDPv4TransportDescriptor *>(
+                                 descriptor_pointer) != nullptr)
+                    {
+                        name = "udpv4";
+                    }
+                    else if (dynamic_cast<const eprosima::fastdds::rtps::TCPv4TransportDescriptor *>(
+                                 descriptor_pointer) != nullptr)
+                    {
+                        name = "tcpv4";
+                    }
+
+                    if (!result.empty())
+                    {
+                        result += '+';
+                    }
+                    result += name;
+                }
+                return result;
+            }
+
+            template <typename qos_type>
+            void report_qos(const qos_type &qos, const TypeSupport &type_support, const std::string &transports,
+                            entity_report &report)
+            {
+                report.transport = qos.data_sharing().kind() != OFF ? "data_sharing+" + transports : transports;
+                const std::int32_t allocated_samples = qos.resource_limits().allocated_samples;
+                report.history_samples = allocated_samples > 0 ? static_cast<std::uint64_t>(allocated_samples) : 0;
+                report.max_sample_bytes = !type_support.empty() ? type_support->m_typeSize : 0;
+                report.history_bytes = report.history_samples * report.max_sample_bytes;
+            }
+
+            double rate(const std::uint64_t count, const std::chrono::steady_clock::duration duration)
+            {
+                const double seconds = std::chrono::duration<double>(duration).count();
+                return seconds > 0.0 ? static_cast<double>(count) / seconds : 0.0;
+            }
+
+            entity_report report_entity(const std::uint64_t id, const introspected_entity &entity,
+                                        const std::string &transports, const std::chrono::steady_clock::time_point now)
+            {
+                entity_report report;
+                report.id = id;
+                if (entity.data_writer != nullptr)
+                {
+                    report.kind = entity_kind::publisher;
+                    const Topic *topic = entity.data_writer->get_topic();
+                    if (topic != nullptr)
+                    {
+                        report.topic_name = topic->get_name();
+                        report.type_name = topic->get_type_name();
+                    }
+
+                    PublicationMatchedStatus matched_status{};
+                    entity.data_writer->get_publication_matched_status(matched_status);
+                    report.matched = matched_status.current_count;
+                    report_qos(entity.data_writer->get_qos(), entity.data_writer->get_type(), transports, report);
+
+                    const publisher_metrics metrics = entity.publisher_metrics_function();
+                    report.samples = metrics.published;
+                    report.bytes = metrics.published_bytes;
+                }
+                else
+                {
+                    report.kind = entity_kind::subscriber;
+                    const TopicDescription *topic_description = entity.data_reader->get_topicdescription();
+                    const auto *filtered_topic = dynamic_cast<const ContentFilteredTopic *>(topic_description);
+                    if (filtered_topic != nullptr && filtered_topic->get_related_topic() != nullptr)
+                    {
+                        // Filtered topics are named uniquely per subscriber, so the topic they're based on is reported
+                        topic_description = filtered_topic->get_related_topic();
+                    }
+                    if (topic_description != nullptr)
+                    {
+                        report.topic_name = topic_description->get_name();
+                        report.type_name = topic_description->get_type_name();
+                    }
+
+                    SubscriptionMatchedStatus matched_status{};
+                    entity.data_reader->get_subscription_matched_status(matched_status);
+                    report.matched = matched_status.current_count;
+                    report_qos(entity.data_reader->get_qos(), entity.data_reader->type(), transports, report);
+
+                    const subscriber_metrics metrics = entity.subscriber_metrics_function();
+                    report.samples = metrics.received;
+                    report.bytes = metrics.received_bytes;
+                }
+
+                report.samples_per_second = rate(report.samples, now - entity.created);
+                report.bytes_per_second = rate(report.bytes, now - entity.created);
+                return report;
+            }
+
+            const char *to_string(const entity_kind kind)
+            {
+                return kind == entity_kind::publisher ? "publisher" : "subscriber";
+            }
+
+            void write_json_string(std::ostream &stream, const std::string &value)
+            {
+                stream << '"';
+                for (const char character : value)
+                {
+                    switch (character)
+                    {
+                    case '"':
+                        stream << "\\\"";
+                        break;
+
+                    case '\\':
+                        stream << "\\\\";
+                        break;
+
+                    case '\n':
+                        stream << "\\n";
+                        break;
+
+                    default:
+                        if (static_cast<unsigned char>(character) < 0x20)
+                        {
+                            char escaped[8];
+                            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(character));
+                            stream << escaped;
+                        }
+                        else
+                        {
+                            stream << character;
+                        }
+                        break;
+                    }
+                }
+                stream << '"';
+            }
+
+            void write_prometheus_label(std::ostream &stream, const char *name, const std::string &value)
+            {
+                stream << name << "=\"";
+                for (const char character : value)
+                {
+                    switch (character)
+                    {
+                    case '"':
+                        stream << "\\\"";
+                        break;
+
+                    case '\\':
+                        stream << "\\\\";
+                        break;
+
+                    case '\n':
+                        stream << "\\n";
+                        break;
+
+                    default:
+                        stream << character;
+                        break;
+                    }
+                }
+                stream << '"';
+            }
+
+            template <typename value_type>
+            void write_prometheus_metric(std::ostream &stream, const participant_report &report, const char *name,
+                                         const char *type, const char *help,
+                                         value_type (*value)(const entity_report &))
+            {
+                stream << "# HELP " << name << ' ' << help << '\n' << "# TYPE " << name << ' ' << type << '\n';
+                for (const auto &entity : report.entities)
+                {
+                    stream << name << '{';
+                    write_prometheus_label(stream, "id", std::to_string(entity.id));
+                    stream << ',';
+                    write_prometheus_label(stream, "kind", to_string(entity.kind));
+                    stream << ',';
+                    write_prometheus_label(stream, "topic", entity.topic_name);
+                    stream << ',';
+                    write_prometheus_label(stream, "type", entity.type_name);
+                    stream << ',';
+                    write_prometheus_label(stream, "transport", entity.transport);
+                    stream << "} " << value(entity) << '\n';
+                }
+            }
+        } // namespace
+
+        participant_report introspect(const std::shared_ptr<DomainParticipant> &domain_participant)
+        {
+            participant_report report;
+            if (!domain_participant)
+            {
+                return report;
+            }
+
+            const std::string transports = participant_transports(*domain_participant);
+            const auto now = std::chrono::steady_clock::now();
+            std::lock_guard<std::mutex> lock{registry().mutex};
+            for (const auto &entity : registry().entities)
+            {
+                if (entity.second.domain_participant == domain_participant.get())
+                {
+                    report.entities.push_back(report_entity(entity.first, entity.second, transports, now));
+                }
+            }
+            return report;
+        }
+
+        introspector::introspector(std::shared_ptr<DomainParticipant> domain_participant)
+            : domain_participant(std::move(domain_participant))
+        {
+        }
+
+        participant_report introspector::introspect()
+        {
+            participant_report report = dds::introspect(domain_participant);
+            const auto now = std::chrono::steady_clock::now();
+
+            // Measurements of the handles no longer listed are dropped
+            std::lock_guard<std::mutex> lock{mutex};
+            std::map<std::uint64_t, measurement> new_measurements;
+            for (auto &entity : report.entities)
+            {
+                const auto previous = measurements.find(entity.id);
+                if (previous != measurements.end())
+                {
+                    entity.samples_per_second =
+                        rate(entity.samples - previous->second.samples, now - previous->second.measured);
+                    entity.bytes_per_second =
+                        rate(entity.bytes - previous->second.bytes, now - previous->second.measured);
+                }
+                new_measurements.emplace(entity.id, measurement{now, entity.samples, entity.bytes});
+            }
+            measurements = std::move(new_measurements);
+            return report;
+        }
+
+        std::string to_json(const participant_report &report)
+        {
+            std::ostringstream stream;
+            stream.imbue(std::locale::classic());
+            stream << "{\"entities\":[";
+            for (std::size_t i = 0; i < report.entities.size(); ++i)
+            {
+                const auto &entity = report.entities[i];
+                stream << (i > 0 ? "," : "") << "{\"id\":" << entity.id << ",\"kind\":";
+                write_json_string(stream, to_string(entity.kind));
+                stream << ",\"topic_name\":";
+                write_json_string(stream, entity.topic_name);
+                stream << ",\"type_name\":";
+                write_json_string(stream, entity.type_name);
+                stream << ",\"matched\":" << entity.matched << ",\"transport\":";
+                write_json_string(stream, entity.transport);
+                stream << ",\"history_samples\":" << entity.history_samples
+                       << ",\"max_sample_bytes\":" << entity.max_sample_bytes
+                       << ",\"history_bytes\":" << entity.history_bytes << ",\"samples\":" << entity.samples
+                       << ",\"bytes\":" << entity.bytes << ",\"samples_per_second\":" << entity.samples_per_second
+                       << ",\"bytes_per_second\":" << entity.bytes_per_second << '}';
+            }
+            stream << "]}";
+            return stream.str();
+        }
+
+        std::string to_prometheus(const participant_report &report)
+        {
+            std::ostringstream stream;
+            stream.imbue(std::locale::classic());
+            write_prometheus_metric<std::int32_t>(
+                stream, report, "provizio_dds_matched", "gauge",
+                "Number of matched subscriptions of a publisher or publications of a subscriber",
+                [](const entity_report &entity) { return entity.matched; });
+            write_prometheus_metric<std::uint64_t>(
+                stream, report, "provizio_dds_history_bytes", "gauge", "Estimated size of the history pool in bytes",
+                [](const entity_report &entity) { return entity.history_bytes; });
+            write_prometheus_metric<std::uint64_t>(
+                stream, report, "provizio_dds_samples_total", "counter", "Number of samples published or received",
+                [](const entity_report &entity) { return entity.samples; });
+            write_prometheus_metric<std::uint64_t>(
+                stream, report, "provizio_dds_bytes_total", "counter",
+                "Serialized size of the samples published or received in bytes",
+                [](const entity_report &entity) { return entity.bytes; });
+            write_prometheus_metric<double>(
+                stream, report, "provizio_dds_samples_per_second", "gauge",
+                "Rate of samples since the handle creation or the previous report",
+                [](const entity_report &entity) { return entity.samples_per_second; });
+            write_prometheus_metric<double>(stream, report, "provizio_dds_bytes_per_second", "gauge",
+                                            "Rate of bytes since the handle creation or the previous report",
+                                            [](const entity_report &entity) { return entity.bytes_per_second; });
+            return stream.str();
+        }
+
+        namespace detail
+        {
+            std::uint64_t register_introspected(const std::shared_ptr<DomainParticipant> &domain_participant,
+                                                DataWriter *data_writer, std::function<publisher_metrics()> metrics)
+            {
+                if (!domain_participant || data_writer == nullptr)
+                {
+                    return 0;
+                }
+
+                introspected_entity entity;
+                entity.domain_participant = domain_participant.get();
+                entity.data_writer = data_writer;
+                entity.publisher_metrics_function = std::move(metrics);
+                return register_entity(std::move(entity));
+            }
+
+            std::uint64_t register_introspected(const std::shared_ptr<DomainParticipant> &domain_participant,
+                                                DataReader *data_reader, std::function<subscriber_metrics()> metrics)
+            {
+                if (!domain_participant || data_reader == nullptr)
+                {
+                    return 0;
+                }
+
+                introspected_entity entity;
+                entity.domain_participant = domain_participant.get();
+                entity.data_reader = data_reader;
+                entity.subscriber_metrics_function = std::move(metrics);
+                return register_entity(std::move(entity));
+            }
+
+            void unregister_introspected(const std::uint64_t id)
+            {
+                if (id == 0)
+                {
+                    return;
+                }
+
+                std::lock_guard<std::mutex> lock{registry().mutex};
+                registry().entities.erase(id);
+            }
+        } // namespace detail
+    } // namespace dds
+} // namespace provizio
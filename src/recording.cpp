@@ -0,0 +1,795 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "provizio/dds/recording.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <map>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "provizio/dds/publisher.h"
+#include "provizio/dds/subscriber.h"
+
+namespace provizio
+{
+    namespace dds
+    {
+        namespace
+        {
+            // A segment file is a header followed by 8-byte aligned records: channel records (describing a recorded
+            // topic, emitted at the start of every segment, before any sample records) and sample records. Closed
+            // segments are followed by an index of their sample records.
+            constexpr char segment_magic[8] = {'P', 'V', 'Z', 'R', 'E', 'C', '0', '1'};
+            constexpr std::uint32_t segment_format_version = 1;
+            constexpr std::size_t record_alignment = 8;
+
+            enum record_kind : std::uint16_t
+            {
+                no_record = 0,
+                channel_record = 1,
+                sample_record = 2
+            };
+
+            struct segment_header
+            {
+                char magic[sizeof(segment_magic)];
+                std::uint32_t version;
+                std::uint32_t header_size;
+                std::uint64_t end_offset; // 0 while still recording
+                std::uint64_t index_offset;
+                std::uint64_t index_count;
+                std::uint64_t reserved[3];
+            };
+            static_assert(sizeof(segment_header) == 64, "Unexpected segment header layout");
+
+            struct record_header
+            {
+                std::uint32_t size; // Of the payload following the header
+                std::uint16_t kind;
+                std::uint16_t channel;
+                std::int64_t reception_time_ns;
+                std::int64_t source_time_ns;
+            };
+            static_assert(sizeof(record_header) == 24, "Unexpected record header layout");
+
+            struct index_entry
+            {
+                std::int64_t reception_time_ns;
+                std::uint64_t offset;
+            };
+            static_assert(sizeof(index_entry) == 16, "Unexpected index entry layout");
+
+            constexpr std::size_t estimated_record_size = 1024;
+
+            std::size_t aligned(const std::size_t size)
+            {
+                return (size + record_alignment - 1) & ~(record_alignment - 1);
+            }
+
+            std::string segment_path(const std::string &path, const std::uint64_t segment_number)
+            {
+                char suffix[32];
+                std::snprintf(suffix, sizeof(suffix), "_%04llu.pvzrec",
+                              static_cast<unsigned long long>(segment_number));
+                return path + suffix;
+            }
+
+            std::int64_t system_time_ns()
+            {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::system_clock::now().time_since_epoch())
+                    .count();
+            }
+
+            // Sets a flag on matching the first / unmatching the last subscriber of a replayed topic
+            struct match_flag
+            {
+                std::atomic<bool> *matched;
+
+                template <typename publisher_handle_type>
+                void operator()(publisher_handle_type &, const bool has_subscriber)
+                {
+                    matched->store(has_subscriber, std::memory_order_release);
+                }
+            };
+        } // namespace
+
+        struct recorder::segment_writer
+        {
+            segment_writer() = default;
+            segment_writer(const segment_writer &) = delete;
+            segment_writer &operator=(const segment_writer &) = delete;
+
+            ~segment_writer()
+            {
+                close();
+            }
+
+            bool open(const std::string &file_path, const std::size_t size)
+            {
+#if defined(_WIN32)
+                (void)file_path;
+                (void)size;
+                return false;
+#else
+                if (size < sizeof(segment_header))
+                {
+                    return false;
+                }
+
+                file = ::open(file_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+                if (file < 0)
+                {
+                    return false;
+                }
+
+#if defined(__linux__)
+                // Allocates the disk space upfront, so running out of it fails here rather than with a SIGBUS on
+                // writing to the mapping
+                const bool resized = posix_fallocate(file, 0, static_cast<off_t>(size)) == 0;
+#else
+                const bool resized = ftruncate(file, static_cast<off_t>(size)) == 0;
+#endif
+                void *mapped = resized ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0) : MAP_FAILED;
+                if (mapped == MAP_FAILED)
+                {
+                    ::close(file);
+                    file = -1;
+                    return false;
+                }
+                memory = static_cast<unsigned char *>(mapped);
+                capacity = size;
+
+                // Enough for a segment of samples of 1 KiB on average, so indexing them rarely reallocates
+                index.reserve(size / estimated_record_size);
+
+                std::memset(&header, 0, sizeof(header));
+                std::memcpy(header.magic, segment_magic, sizeof(segment_magic));
+                header.version = segment_format_version;
+                header.header_size = sizeof(segment_header);
+                std::memcpy(memory, &header, sizeof(header));
+                end = sizeof(segment_header);
+                return true;
+#endif
+            }
+
+            bool append(const record_kind kind, const std::uint16_t channel_id, const std::int64_t reception_time_ns,
+                        const std::int64_t source_time_ns, const unsigned char *data, const std::size_t size)
+            {
+                const std::size_t record_size = aligned(sizeof(record_header) + size);
+                if (memory == nullptr || size > std::numeric_limits<std::uint32_t>::max() ||
+                    record_size > capacity - end)
+                {
+                    return false;
+                }
+
+                const record_header record{static_cast<std::uint32_t>(size), kind, channel_id, reception_time_ns,
+                                           source_time_ns};
+                std::memcpy(memory + end, &record, sizeof(record));
+                std::memcpy(memory + end + sizeof(record), data, size);
+                if (kind == sample_record)
+                {
+                    // Kept sorted for binary search, even if samples of different topics arrive slightly out of order
+                    const std::int64_t indexed_time =
+                        index.empty() ? reception_time_ns : std::max(reception_time_ns, index.back().reception_time_ns);
+                    index.push_back(index_entry{indexed_time, end});
+                }
+                end += record_size;
+                return true;
+            }
+
+            bool has_samples() const noexcept
+            {
+                return !index.empty();
+            }
+
+            void close()
+            {
+#if !defined(_WIN32)
+                if (memory == nullptr)
+                {
+                    return;
+                }
+
+                munmap(memory, capacity);
+                memory = nullptr;
+
+                // Leaves end_offset at 0 if anything fails, so the segment is read as one that wasn't closed properly
+                const std::size_t index_size = index.size() * sizeof(index_entry);
+                if (ftruncate(file, static_cast<off_t>(end)) == 0 &&
+                    (index_size == 0 ||
+                     pwrite(file, index.data(), index_size, static_cast<off_t>(end)) ==
+                         static_cast<ssize_t>(index_size)))
+                {
+                    header.end_offset = end;
+                    header.index_offset = end;
+                    header.index_count = index.size();
+                    (void)pwrite(file, &header, sizeof(header), 0);
+                }
+                ::close(file);
+                file = -1;
+#endif
+            }
+
+            int file = -1;
+            unsigned char *memory = nullptr;
+            std::size_t capacity = 0;
+            std::size_t end = 0;
+            segment_header header{};
+            std::vector<index_entry> index;
+        };
+
+        struct recorder::channel
+        {
+            class listener final : public counting_data_reader_listener
+            {
+              public:
+                listener(recorder &owner, const std::uint16_t channel_id) : owner(owner), channel_id(channel_id)
+                {
+                }
+
+                void on_data_available(DataReader *reader) override
+                {
+                    SampleInfo info;
+                    while (reader->take_next_sample(&sample, &info) == ReturnCode_t::RETCODE_OK)
+                    {
+                        if (info.valid_data)
+                        {
+                            counters.count_received(info.source_timestamp);
+                            counters.count_received_bytes(sample.size());
+                            const std::int64_t reception_time_ns = info.reception_timestamp.to_ns();
+                            owner.record(channel_id, reception_time_ns != 0 ? reception_time_ns : system_time_ns(),
+                                         info.source_timestamp.to_ns(), sample.data(), sample.size());
+                        }
+                    }
+                }
+
+              private:
+                recorder &owner;
+                std::uint16_t channel_id;
+                serialized_sample sample; // Reused, so no allocations take place in a steady state
+            };
+
+            std::string topic_name;
+            std::string type_name;
+            std::shared_ptr<listener> data_listener;
+            std::unique_ptr<subscriber_handle<serialized_pub_sub_type>> handle;
+
+            // topic_name and type_name, both 0-terminated
+            std::string record_payload() const
+            {
+                std::string payload = topic_name;
+                payload.push_back('\0');
+                payload += type_name;
+                payload.push_back('\0');
+                return payload;
+            }
+        };
+
+        recorder::recorder(std::shared_ptr<DomainParticipant> domain_participant, recording_options options)
+            : domain_participant(std::move(domain_participant)), options(std::move(options))
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            start_segment();
+        }
+
+        recorder::~recorder()
+        {
+            close();
+        }
+
+        bool recorder::is_open() const
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            return writer != nullptr;
+        }
+
+        bool recorder::add_topic(const std::string &topic_name, const std::string &type_name,
+                                 const ReliabilityQosPolicyKind reliability_kind)
+        {
+            return add_topic(topic_name, type_name, dds::TypeSupport(new serialized_pub_sub_type(type_name)),
+                             reliability_kind);
+        }
+
+        bool recorder::add_topic(const std::string &topic_name, const std::string &type_name,
+                                 dds::TypeSupport type_support, const ReliabilityQosPolicyKind reliability_kind)
+        {
+            channel *added = nullptr;
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                if (!writer || channels.size() > std::numeric_limits<std::uint16_t>::max())
+                {
+                    return false;
+                }
+
+                const auto channel_id = static_cast<std::uint16_t>(channels.size());
+                std::unique_ptr<channel> new_channel{new channel()};
+                new_channel->topic_name = topic_name;
+                new_channel->type_name = type_name;
+                new_channel->data_listener = std::make_shared<channel::listener>(*this, channel_id);
+
+                const std::string payload = new_channel->record_payload();
+                added = new_channel.get();
+                channels.push_back(std::move(new_channel));
+
+                // Channel records precede the samples of a segment, so seeking doesn't have to scan for them. Once the
+                // segment has samples, a new one describes all the channels, the added one included.
+                if (writer->has_samples() ? !start_segment()
+                                          : !writer->append(channel_record, channel_id, system_time_ns(), 0,
+                                                            reinterpret_cast<const unsigned char *>(payload.data()),
+                                                            payload.size()))
+                {
+                    channels.pop_back();
+                    return false;
+                }
+            }
+
+            // Not under the mutex, as samples may be recorded as soon as the DataReader is created
+            added->handle = std::make_unique<subscriber_handle<serialized_pub_sub_type>>(
+                domain_participant, topic_name, std::move(type_support), content_filter{}, added->data_listener,
+                reliability_kind);
+            if (added->handle->instance_handle() == HANDLE_NIL)
+            {
+                // No DataReader, f.e. as the type is registered in its deserialized form. The channel id is reused by
+                // the next added topic, unless another one has been added meanwhile, which keeps it with no samples.
+                std::lock_guard<std::mutex> lock{mutex};
+                if (!channels.empty() && channels.back().get() == added)
+                {
+                    channels.pop_back();
+                }
+                return false;
+            }
+            return true;
+        }
+
+        void recorder::close()
+        {
+            std::vector<std::unique_ptr<channel>> closed_channels;
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                closed_channels.swap(channels);
+            }
+
+            // Deletes the DataReaders first, so no more samples are recorded
+            closed_channels.clear();
+
+            std::lock_guard<std::mutex> lock{mutex};
+            writer.reset();
+        }
+
+        recorder_statistics recorder::statistics() const
+        {
+            recorder_statistics statistics;
+            statistics.recorded_samples = recorded_samples.load(std::memory_order_relaxed);
+            statistics.recorded_bytes = recorded_bytes.load(std::memory_order_relaxed);
+            statistics.dropped_samples = dropped_samples.load(std::memory_order_relaxed);
+
+            std::lock_guard<std::mutex> lock{mutex};
+            statistics.segments = next_segment_number;
+            return statistics;
+        }
+
+        void recorder::record(const std::uint16_t channel_id, const std::int64_t reception_time_ns,
+                              const std::int64_t source_time_ns, const unsigned char *data, const std::size_t size)
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            if (!writer)
+            {
+                // Closed
+                return;
+            }
+
+            // A sample that doesn't fit an empty segment can't be recorded at all
+            if (!writer->append(sample_record, channel_id, reception_time_ns, source_time_ns, data, size) &&
+                (!writer->has_samples() || !start_segment() ||
+                 !writer->append(sample_record, channel_id, reception_time_ns, source_time_ns, data, size)))
+            {
+                dropped_samples.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            recorded_samples.fetch_add(1, std::memory_order_relaxed);
+            recorded_bytes.fetch_add(size, std::memory_order_relaxed);
+        }
+
+        bool recorder::start_segment()
+        {
+            // The index of the closed segment is reused, so segments of a similar number of samples don't reallocate it
+            std::vector<index_entry> index;
+            if (writer)
+            {
+                writer->close();
+                index = std::move(writer->index);
+                index.clear();
+            }
+            writer.reset();
+
+            std::unique_ptr<segment_writer> new_writer{new segment_writer()};
+            new_writer->index = std::move(index);
+            if (!new_writer->open(segment_path(options.path, next_segment_number), options.segment_size))
+            {
+                return false;
+            }
+            ++next_segment_number;
+
+            // Every segment describes all the channels, so it can be read on its own
+            for (std::size_t i = 0; i < channels.size(); ++i)
+            {
+                const std::string payload = channels[i]->record_payload();
+                if (!new_writer->append(channel_record, static_cast<std::uint16_t>(i), system_time_ns(), 0,
+                                        reinterpret_cast<const unsigned char *>(payload.data()), payload.size()))
+                {
+                    return false;
+                }
+            }
+
+            writer = std::move(new_writer);
+            return true;
+        }
+
+        struct recording_reader::segment
+        {
+            segment() = default;
+            segment(const segment &) = delete;
+            segment &operator=(const segment &) = delete;
+
+            ~segment()
+            {
+#if !defined(_WIN32)
+                if (memory != nullptr)
+                {
+                    munmap(const_cast<unsigned char *>(memory), size);
+                }
+                if (file >= 0)
+                {
+                    ::close(file);
+                }
+#endif
+            }
+
+            bool open(const std::string &file_path)
+            {
+#if defined(_WIN32)
+                (void)file_path;
+                return false;
+#else
+                file = ::open(file_path.c_str(), O_RDONLY);
+                struct stat file_stat;
+                if (file < 0 || fstat(file, &file_stat) != 0 ||
+                    static_cast<std::size_t>(file_stat.st_size) < sizeof(segment_header))
+                {
+                    return false;
+                }
+
+                size = static_cast<std::size_t>(file_stat.st_size);
+                void *mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0);
+                if (mapped == MAP_FAILED)
+                {
+                    return false;
+                }
+                memory = static_cast<const unsigned char *>(mapped);
+
+                std::memcpy(&header, memory, sizeof(header));
+                if (std::memcmp(header.magic, segment_magic, sizeof(segment_magic)) != 0 ||
+                    header.version != segment_format_version || header.header_size < sizeof(segment_header) ||
+                    header.header_size > size)
+                {
+                    return false;
+                }
+
+                if (header.end_offset != 0 && header.end_offset <= size && header.index_offset >= header.end_offset &&
+                    header.index_count <= (size - header.index_offset) / sizeof(index_entry))
+                {
+                    end = header.end_offset;
+                    index_count = header.index_count;
+                }
+                else
+                {
+                    // Not closed properly, read up to the last complete record
+                    end = size;
+                    index_count = 0;
+                }
+                return true;
+#endif
+            }
+
+            index_entry index(const std::size_t i) const
+            {
+                index_entry entry;
+                std::memcpy(&entry, memory + header.index_offset + i * sizeof(index_entry), sizeof(entry));
+                return entry;
+            }
+
+            int file = -1;
+            const unsigned char *memory = nullptr;
+            std::size_t size = 0;
+            std::size_t end = 0;
+            std::size_t index_count = 0;
+            segment_header header{};
+        };
+
+        recording_reader::recording_reader(std::string path) : path(std::move(path))
+        {
+            open_segment(0);
+        }
+
+        recording_reader::~recording_reader() = default;
+
+        bool recording_reader::is_open() const noexcept
+        {
+            return current != nullptr;
+        }
+
+        bool recording_reader::next(recorded_sample &sample)
+        {
+            while (current)
+            {
+                const std::uint16_t kind = read_record(offset, sample);
+                if (kind == sample_record && sample.channel != nullptr)
+                {
+                    return true;
+                }
+
+                if (kind == no_record && !open_segment(segment_number + 1))
+                {
+                    return false;
+                }
+            }
+            return false;
+        }
+
+        bool recording_reader::seek(const std::int64_t reception_time_ns)
+        {
+            recorded_sample sample;
+            for (std::uint64_t number = 0; open_segment(number); ++number)
+            {
+                const std::size_t count = current->index_count;
+                if (count > 0)
+                {
+                    if (current->index(count - 1).reception_time_ns < reception_time_ns)
+                    {
+                        continue;
+                    }
+
+                    // Binary search for the first entry at or after the time
+                    std::size_t first = 0;
+                    std::size_t last = count - 1;
+                    while (first < last)
+                    {
+                        const std::size_t middle = first + (last - first) / 2;
+                        if (current->index(middle).reception_time_ns < reception_time_ns)
+                        {
+                            first = middle + 1;
+                        }
+                        else
+                        {
+                            last = middle;
+                        }
+                    }
+                    const std::size_t found = current->index(first).offset;
+
+                    // Only the channel records at the start of the segment are to be read before jumping to the sample
+                    while (offset < found && read_record(offset, sample) == channel_record)
+                    {
+                    }
+                    offset = found;
+                    return true;
+                }
+
+                // No index, scan the records
+                std::size_t record_offset = offset;
+                std::uint16_t kind = no_record;
+                while ((kind = read_record(offset, sample)) != no_record)
+                {
+                    if (kind == sample_record && sample.reception_time_ns >= reception_time_ns)
+                    {
+                        offset = record_offset;
+                        return true;
+                    }
+                    record_offset = offset;
+                }
+            }
+
+            if (current)
+            {
+                offset = current->end;
+            }
+            return false;
+        }
+
+        bool recording_reader::open_segment(const std::uint64_t number)
+        {
+            std::unique_ptr<segment> opened{new segment()};
+            if (!opened->open(segment_path(path, number)))
+            {
+                return false;
+            }
+
+            current = std::move(opened);
+            segment_number = number;
+            offset = current->header.header_size;
+            return true;
+        }
+
+        std::uint16_t recording_reader::read_record(std::size_t &record_offset, recorded_sample &sample)
+        {
+            if (record_offset > current->end || current->end - record_offset < sizeof(record_header))
+            {
+                return no_record;
+            }
+
+            record_header header;
+            std::memcpy(&header, current->memory + record_offset, sizeof(header));
+            const std::size_t payload_offset = record_offset + sizeof(header);
+            if (header.kind == no_record || header.size > current->end - payload_offset)
+            {
+                // The end of a segment that hasn't been closed properly
+                return no_record;
+            }
+
+            const unsigned char *payload = current->memory + payload_offset;
+            record_offset = std::min(aligned(payload_offset + header.size), current->end);
+
+            if (header.kind == channel_record)
+            {
+                const char *names = reinterpret_cast<const char *>(payload);
+                const std::size_t topic_name_size = strnlen(names, header.size);
+                if (topic_name_size < header.size)
+                {
+                    if (channels.size() <= header.channel)
+                    {
+                        channels.resize(header.channel + 1U);
+                    }
+                    if (!channels[header.channel])
+                    {
+                        channels[header.channel].reset(new recorded_channel());
+                    }
+
+                    const char *type_name = names + topic_name_size + 1;
+                    channels[header.channel]->topic_name.assign(names, topic_name_size);
+                    channels[header.channel]->type_name.assign(
+                        type_name, strnlen(type_name, header.size - topic_name_size - 1));
+                }
+            }
+            else if (header.kind == sample_record)
+            {
+                sample.channel = header.channel < channels.size() ? channels[header.channel].get() : nullptr;
+                sample.reception_time_ns = header.reception_time_ns;
+                sample.source_time_ns = header.source_time_ns;
+                sample.data = payload;
+                sample.size = header.size;
+            }
+            return header.kind;
+        }
+
+        struct replayer::channel_publisher
+        {
+            std::atomic<bool> matched{false};
+            std::unique_ptr<publisher_handle<serialized_pub_sub_type, match_flag>> handle;
+        };
+
+        replayer::replayer(std::shared_ptr<DomainParticipant> domain_participant, std::string path,
+                           replay_options options)
+            : domain_participant(std::move(domain_participant)), path(std::move(path)), options(options)
+        {
+        }
+
+        replayer::~replayer()
+        {
+            stop();
+        }
+
+        std::uint64_t replayer::run()
+        {
+            recording_reader reader{path};
+            std::map<const recorded_channel *, std::unique_ptr<channel_publisher>> publishers;
+            serialized_sample serialized;
+            recorded_sample sample;
+            std::uint64_t published = 0;
+            bool started = false;
+            std::int64_t first_time_ns = 0;
+            std::chrono::steady_clock::time_point start_time;
+
+            while (reader.next(sample))
+            {
+                auto &publisher = publishers[sample.channel];
+                if (!publisher)
+                {
+                    const auto wait_start = std::chrono::steady_clock::now();
+                    publisher.reset(new channel_publisher());
+                    publisher->handle = std::make_unique<publisher_handle<serialized_pub_sub_type, match_flag>>(
+                        domain_participant, sample.channel->topic_name,
+                        dds::TypeSupport(new serialized_pub_sub_type(sample.channel->type_name)),
+                        match_flag{&publisher->matched}, options.reliability_kind);
+
+                    const auto deadline = wait_start + options.match_timeout;
+                    while (!publisher->matched.load(std::memory_order_acquire) &&
+                           std::chrono::steady_clock::now() < deadline)
+                    {
+                        if (!wait_until(std::min(deadline, std::chrono::steady_clock::now() +
+                                                               std::chrono::milliseconds(1))))
+                        {
+                            break;
+                        }
+                    }
+
+                    // The waiting is not a part of the timeline
+                    start_time += std::chrono::steady_clock::now() - wait_start;
+                }
+
+                if (!started)
+                {
+                    started = true;
+                    first_time_ns = sample.reception_time_ns;
+                    start_time = std::chrono::steady_clock::now();
+                }
+                else if (options.speed > 0.0)
+                {
+                    const auto offset = std::chrono::nanoseconds(
+                        static_cast<std::int64_t>(static_cast<double>(sample.reception_time_ns - first_time_ns) /
+                                                  options.speed));
+                    if (!wait_until(start_time + offset))
+                    {
+                        break;
+                    }
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock{mutex};
+                    if (stopped)
+                    {
+                        break;
+                    }
+                }
+
+                // Published right from the memory-mapped segment
+                serialized.refer(sample.data, sample.size);
+                if (publisher->handle->publish(serialized))
+                {
+                    ++published;
+                }
+            }
+
+            for (auto &publisher : publishers)
+            {
+                publisher.second->handle->wait_for_acknowledgments(options.acknowledgment_timeout);
+            }
+            return published;
+        }
+
+        void replayer::stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                stopped = true;
+            }
+            stopped_condition.notify_all();
+        }
+
+        bool replayer::wait_until(const std::chrono::steady_clock::time_point time)
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            return !stopped_condition.wait_until(lock, time, [this]() { return stopped; });
+        }
+    } // namespace dds
+} // namespace provizio
@@ -0,0 +1,94 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "provizio/dds/serialized_pub_sub_type.h"
+
+#include <cstring>
+
+namespace provizio
+{
+    namespace dds
+    {
+        namespace
+        {
+            // Size of the encapsulation (CDR representation identifier + options) at the start of every payload
+            constexpr std::size_t encapsulation_size = 4;
+        } // namespace
+
+        serialized_pub_sub_type::serialized_pub_sub_type()
+        {
+            m_typeSize = default_initial_serialized_size;
+            m_isGetKeyDefined = false;
+
+            // There's no type information to announce, the original type is announced by its own publishers
+            auto_fill_type_object(false);
+            auto_fill_type_information(false);
+        }
+
+        serialized_pub_sub_type::serialized_pub_sub_type(const std::string &type_name,
+                                                         const std::uint32_t initial_serialized_size)
+            : serialized_pub_sub_type()
+        {
+            setName(type_name.c_str());
+            m_typeSize = initial_serialized_size;
+        }
+
+        bool serialized_pub_sub_type::serialize(void *data, eprosima::fastrtps::rtps::SerializedPayload_t *payload)
+        {
+            const auto &sample = *static_cast<const serialized_sample *>(data);
+            const std::size_t size = sample.size();
+            if (size < encapsulation_size || size > payload->max_size)
+            {
+                return false;
+            }
+
+            std::memcpy(payload->data, sample.data(), size);
+            payload->length = static_cast<std::uint32_t>(size);
+            payload->encapsulation = static_cast<std::uint16_t>((sample.data()[0] << 8) | sample.data()[1]);
+            return true;
+        }
+
+        bool serialized_pub_sub_type::deserialize(eprosima::fastrtps::rtps::SerializedPayload_t *payload, void *data)
+        {
+            static_cast<serialized_sample *>(data)->assign(payload->data, payload->length);
+            return true;
+        }
+
+        std::function<std::uint32_t()> serialized_pub_sub_type::getSerializedSizeProvider(void *data)
+        {
+            return [data]() {
+                return static_cast<std::uint32_t>(static_cast<const serialized_sample *>(data)->size());
+            };
+        }
+
+        void *serialized_pub_sub_type::createData()
+        {
+            return new serialized_sample();
+        }
+
+        void serialized_pub_sub_type::deleteData(void *data)
+        {
+            delete static_cast<serialized_sample *>(data);
+        }
+
+        bool serialized_pub_sub_type::getKey(void *data, eprosima::fastrtps::rtps::InstanceHandle_t *handle,
+                                             bool force_md5)
+        {
+            (void)data;
+            (void)handle;
+            (void)force_md5;
+            return false;
+        }
+    } // namespace dds
+} // namespace provizio
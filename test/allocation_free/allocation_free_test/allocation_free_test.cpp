@@ -0,0 +1,146 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+#include "provizio/dds/allocation_guard.h"
+#include "provizio/dds/publisher.h"
+#include "provizio/dds/subscriber.h"
+#include "provizio/dds/test/check.h"
+
+#include <std_msgs/msg/StringPubSubTypes.h>
+
+PROVIZIO_DDS_ALLOCATION_HOOK();
+
+namespace provizio
+{
+    namespace dds
+    {
+        template <> struct qos_defaults<std_msgs::msg::StringPubSubType> final : default_qos_policies
+        {
+            static constexpr bool preallocate = true;
+        };
+    } // namespace dds
+} // namespace provizio
+
+namespace
+{
+    const provizio::dds::test::checker check{"allocation_free_test"};
+} // namespace
+
+int main()
+{
+    const std::string topic_name{"provizio_dds_test_allocation_free_topic"};
+    // Short enough for the small string optimization, so that neither copying nor deserializing it allocates
+    const std::string value{"provizio"};
+    const std::chrono::seconds wait_time{3};
+    constexpr int warm_up_samples = 10;
+    constexpr int steady_state_samples = 100;
+
+    std::atomic<int> received{0};
+    std::atomic<bool> steady_state{false};
+    std::atomic<std::uint64_t> subscriber_allocations{0};
+    auto subscriber = provizio::dds::make_subscriber<std_msgs::msg::StringPubSubType>(
+        provizio::dds::make_domain_participant(), topic_name, [&](const std_msgs::msg::String &message) {
+            // Allocations of each thread delivering samples are counted between its steady state invocations
+            thread_local std::uint64_t previous_allocations = 0;
+            thread_local bool counting = false;
+            const std::uint64_t allocations = provizio::dds::allocation_guard::thread_allocations();
+            if (steady_state)
+            {
+                subscriber_allocations += counting ? allocations - previous_allocations : 0;
+                counting = true;
+            }
+            previous_allocations = allocations;
+            received += message.data().size() == value.size() ? 1 : 0;
+        });
+
+    auto publisher = provizio::dds::make_publisher<std_msgs::msg::StringPubSubType>(
+        provizio::dds::make_domain_participant(), topic_name);
+    std_msgs::msg::String message;
+    message.data(value);
+
+    bool success = check(provizio::dds::allocation_guard::hook_installed(), "allocation hook installed");
+    success = check(publisher->warm_up(message), "warmed up") && success;
+
+    // Wait for the subscriber and let the publication paths settle
+    const auto deadline = std::chrono::steady_clock::now() + wait_time;
+    while (received < warm_up_samples && std::chrono::steady_clock::now() < deadline)
+    {
+        publisher->publish(message);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    success = check(received >= warm_up_samples, "warm-up samples received") && success;
+
+    // Intra-process delivery takes the samples in the publishing thread, so the guard counts both sides then
+    const int received_before_steady_state = received;
+    steady_state = true;
+    std::uint64_t allocations = 0;
+    {
+        provizio::dds::allocation_guard guard;
+        for (int i = 0; i < steady_state_samples; ++i)
+        {
+            // Both loaned and copied samples are published
+            if (i % 2 == 0)
+            {
+                auto loaned = publisher->loan();
+                if (loaned)
+                {
+                    loaned->data(value);
+                    publisher->publish_loaned(std::move(loaned));
+                }
+            }
+            else
+            {
+                publisher->publish(message);
+            }
+        }
+        allocations = guard.allocations();
+    }
+
+    const auto steady_state_deadline = std::chrono::steady_clock::now() + wait_time;
+    while (received - received_before_steady_state < steady_state_samples &&
+           std::chrono::steady_clock::now() < steady_state_deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    steady_state = false;
+
+    if (!check(allocations == 0, "no publisher allocations in a steady state"))
+    {
+        std::cerr << "allocation_free_test: " << allocations << " allocations made by the publisher" << std::endl;
+        success = false;
+    }
+    if (!check(subscriber_allocations == 0, "no subscriber allocations in a steady state"))
+    {
+        std::cerr << "allocation_free_test: " << subscriber_allocations << " allocations made by the subscriber"
+                  << std::endl;
+        success = false;
+    }
+    success = check(publisher->metrics().write_failures == 0, "all samples published") && success;
+    success =
+        check(received - received_before_steady_state >= steady_state_samples, "steady state samples received") &&
+        success;
+
+    if (!success)
+    {
+        return 1;
+    }
+
+    std::cout << "allocation_free_test: Success" << std::endl;
+
+    return 0;
+}
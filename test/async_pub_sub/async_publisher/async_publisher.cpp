@@ -0,0 +1,77 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "provizio/dds/publisher.h"
+#include "provizio/dds/test/check.h"
+
+#include <std_msgs/msg/StringPubSubTypes.h>
+
+namespace
+{
+    const provizio::dds::test::checker check{"async_publisher"};
+} // namespace
+
+int main()
+{
+    const std::string topic_name{"provizio_dds_test_async_pub_sub_topic"};
+    const std::string value{"provizio_dds_test"};
+    const std::chrono::milliseconds wait_time{50};
+    const int publish_times = 60;
+
+    provizio::dds::transport_options options;
+    provizio::dds::flow_controller_options flow_controller;
+    flow_controller.name = "provizio_dds_test_flow_controller";
+    flow_controller.max_bytes_per_period = 64 * 1024;
+    flow_controller.period_ms = 10;
+    options.flow_controllers.push_back(flow_controller);
+    auto participant = provizio::dds::make_domain_participant(0, provizio::dds::transport_profile::builtin, options);
+
+    // The participant must not refer to the options once created
+    options = {};
+    flow_controller = {};
+
+    auto publisher = provizio::dds::make_publisher<std_msgs::msg::StringPubSubType>(
+        participant, topic_name,
+        provizio::dds::qos_defaults<std_msgs::msg::StringPubSubType>::datawriter_reliability_kind,
+        provizio::dds::publish_mode_options::asynchronous("provizio_dds_test_flow_controller"));
+    bool success = check(publisher != nullptr, "asynchronous publisher");
+
+    std_msgs::msg::String message;
+    message.data(value);
+    int published = 0;
+    int queued = 0;
+    for (int i = 0; publisher != nullptr && i < publish_times; ++i)
+    {
+        const auto status = publisher->publish_with_status(message);
+        published += status == provizio::dds::publish_status::published ? 1 : 0;
+        queued += status == provizio::dds::publish_status::queued ? 1 : 0;
+        std::this_thread::sleep_for(wait_time);
+    }
+    success = check(published == 0, "no synchronous publishing") && success;
+    success = check(queued > 0, "queued") && success;
+
+    if (!success)
+    {
+        return 1;
+    }
+
+    std::cout << "async_publisher: Successfully queued " << queued << " times" << std::endl;
+
+    return 0;
+}
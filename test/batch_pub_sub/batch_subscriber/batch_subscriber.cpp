@@ -0,0 +1,63 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+
+#include "provizio/dds/subscriber.h"
+
+#include <std_msgs/msg/StringPubSubTypes.h>
+
+int main()
+{
+    // Shares the topic with simplest_publisher
+    const std::string topic_name{"provizio_dds_test_simplest_pub_sub_topic"};
+    const std::string expected_value{"provizio_dds_test"};
+    const std::chrono::seconds wait_time{3};
+
+    std::mutex mutex;
+    std::condition_variable condition_variable;
+    std::string string;
+    const auto subscriber = provizio::dds::make_batch_subscriber<std_msgs::msg::StringPubSubType>(
+        provizio::dds::make_domain_participant(), topic_name,
+        [&](const provizio::dds::sample_batch<std_msgs::msg::String> &batch) {
+            std::lock_guard<std::mutex> lock{mutex};
+            for (const auto &message : batch)
+            {
+                string = message.data();
+            }
+            condition_variable.notify_one();
+        });
+
+    std::unique_lock<std::mutex> lock{mutex};
+    condition_variable.wait_for(lock, wait_time, [&]() { return string == expected_value; });
+
+    if (string != expected_value)
+    {
+        std::cerr << "batch_subscriber: " << expected_value << " was expected but "
+                  << (string.empty() ? "nothing" : string) << " was received!" << std::endl;
+        return 1;
+    }
+
+    if (subscriber->metrics().received == 0)
+    {
+        std::cerr << "batch_subscriber: No received samples counted" << std::endl;
+        return 1;
+    }
+
+    std::cout << "batch_subscriber: Success" << std::endl;
+
+    return 0;
+}
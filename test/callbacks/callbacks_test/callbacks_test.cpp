@@ -0,0 +1,117 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "provizio/dds/inplace_function.h"
+#include "provizio/dds/publisher.h"
+#include "provizio/dds/subscriber.h"
+#include "provizio/dds/test/check.h"
+
+#include <std_msgs/msg/StringPubSubTypes.h>
+
+namespace
+{
+    const provizio::dds::test::checker check{"callbacks_test"};
+} // namespace
+
+int main()
+{
+    using provizio::dds::inplace_function;
+
+    // Copies, moves and destroys the stored function objects
+    bool success = true;
+    {
+        auto counter = std::make_shared<int>(0);
+        inplace_function<int(int)> function{[counter](const int increment) { return *counter += increment; }};
+        inplace_function<int(int)> copy{function};
+        success = check(function(1) == 1 && copy(2) == 3, "copies share the captures") && success;
+        success = check(counter.use_count() == 3, "captures copied") && success;
+
+        inplace_function<int(int)> moved{std::move(copy)};
+        copy = moved;
+        function = inplace_function<int(int)>{};
+        success = check(!function && moved && moved(3) == 6, "moved and reset") && success;
+        moved = inplace_function<int(int)>{};
+        copy = inplace_function<int(int)>{};
+        success = check(counter.use_count() == 1, "captures destroyed") && success;
+    }
+
+    // Subscribers and publishers with different callbacks share the same types
+    const std::string topic_name{"provizio_dds_test_callbacks_topic"};
+    const std::string value{"provizio_dds_test"};
+    const std::chrono::seconds wait_time{3};
+
+    std::atomic<int> received{0};
+    std::atomic<bool> has_publisher{false};
+    auto subscriber = provizio::dds::make_subscriber<std_msgs::msg::StringPubSubType>(
+        provizio::dds::make_domain_participant(), topic_name,
+        provizio::dds::data_callback<std_msgs::msg::String>{[&](const std_msgs::msg::String &message) {
+            if (message.data() == value)
+            {
+                ++received;
+            }
+        }},
+        provizio::dds::has_publisher_changed_callback<>{[&](const bool has) { has_publisher = has; }});
+
+    std::atomic<bool> has_subscriber{false};
+    const auto participant = provizio::dds::make_domain_participant();
+    auto publisher = provizio::dds::make_publisher<std_msgs::msg::StringPubSubType>(
+        participant, topic_name,
+        provizio::dds::has_subscriber_changed_callback<std_msgs::msg::StringPubSubType>{
+            [&](provizio::dds::data_publisher<std_msgs::msg::StringPubSubType> & /*publisher*/,
+                const bool has) { has_subscriber = has; }});
+    auto another_publisher = provizio::dds::make_publisher<std_msgs::msg::StringPubSubType>(
+        participant, topic_name,
+        provizio::dds::has_subscriber_changed_callback<std_msgs::msg::StringPubSubType>{
+            [](provizio::dds::data_publisher<std_msgs::msg::StringPubSubType> & /*publisher*/, bool /*has*/) {}});
+    success = check(std::is_same<decltype(publisher), decltype(another_publisher)>::value, "same publisher type") &&
+              success;
+
+    // Publishers of any on_has_subscriber_changed function type are published to with no virtual calls
+    auto plain_publisher =
+        provizio::dds::make_publisher<std_msgs::msg::StringPubSubType>(participant, topic_name);
+    const std::vector<provizio::dds::publisher_ref<std_msgs::msg::StringPubSubType>> publishers{*publisher,
+                                                                                               *plain_publisher};
+
+    std_msgs::msg::String message;
+    message.data(value);
+    const auto deadline = std::chrono::steady_clock::now() + wait_time;
+    while (received < 2 && std::chrono::steady_clock::now() < deadline)
+    {
+        for (const auto &next : publishers)
+        {
+            next.publish(message);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    success = check(received >= 2, "received") && success;
+    success = check(has_publisher, "has publisher") && success;
+    success = check(has_subscriber, "has subscriber") && success;
+
+    if (!success)
+    {
+        return 1;
+    }
+
+    std::cout << "callbacks_test: Success" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include "provizio/dds/subscriber.h"
+
+#include <std_msgs/msg/StringPubSubTypes.h>
+
+int main()
+{
+    // Shares the topic with simplest_publisher
+    const std::string topic_name{"provizio_dds_test_simplest_pub_sub_topic"};
+    const std::string expected_value{"provizio_dds_test"};
+    const std::chrono::seconds wait_time{3};
+
+    const auto dispatcher = provizio::dds::make_dispatcher();
+
+    std::mutex mutex;
+    std::condition_variable condition_variable;
+    std::string string;
+    std::thread::id callback_thread_id;
+    std::thread::id listener_thread_id;
+    const auto participant = provizio::dds::make_domain_participant();
+
+    // A plain subscriber in the same participant reveals which thread Fast-DDS invokes listeners in
+    const auto listener_subscriber = provizio::dds::make_subscriber<std_msgs::msg::StringPubSubType>(
+        participant, topic_name, [&](const std_msgs::msg::String &message) {
+            std::lock_guard<std::mutex> lock{mutex};
+            if (message.data() == expected_value)
+            {
+                listener_thread_id = std::this_thread::get_id();
+                condition_variable.notify_one();
+            }
+        });
+    const auto subscriber = provizio::dds::make_subscriber<std_msgs::msg::StringPubSubType>(
+        participant, topic_name,
+        provizio::dds::dispatched(
+            dispatcher,
+            [&](const std_msgs::msg::String &message) {
+                std::lock_guard<std::mutex> lock{mutex};
+                string = message.data();
+                callback_thread_id = std::this_thread::get_id();
+                condition_variable.notify_one();
+            },
+            topic_name));
+
+    std::unique_lock<std::mutex> lock{mutex};
+    condition_variable.wait_for(lock, wait_time, [&]() {
+        return string == expected_value && listener_thread_id != std::thread::id{};
+    });
+
+    if (string != expected_value)
+    {
+        std::cerr << "dispatched_subscriber: " << expected_value << " was expected but "
+                  << (string.empty() ? "nothing" : string) << " was received!" << std::endl;
+        return 1;
+    }
+
+    const auto statistics = dispatcher->statistics();
+    if (statistics.size() != 1 || statistics.front().name != topic_name || statistics.front().dispatched == 0)
+    {
+        std::cerr << "dispatched_subscriber: Unexpected dispatch statistics" << std::endl;
+        return 1;
+    }
+
+    if (callback_thread_id == std::this_thread::get_id())
+    {
+        std::cerr << "dispatched_subscriber: The function was invoked in the main thread" << std::endl;
+        return 1;
+    }
+
+    if (listener_thread_id == std::thread::id{} || callback_thread_id == listener_thread_id)
+    {
+        std::cerr << "dispatched_subscriber: The function was invoked in the listener thread" << std::endl;
+        return 1;
+    }
+
+    std::cout << "dispatched_subscriber: Success" << std::endl;
+
+    return 0;
+}
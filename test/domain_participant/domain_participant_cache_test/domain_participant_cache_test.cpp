@@ -0,0 +1,52 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+
+#include "provizio/dds/domain_participant.h"
+#include "provizio/dds/test/check.h"
+
+namespace
+{
+    const provizio::dds::test::checker check{"domain_participant_cache_test"};
+} // namespace
+
+int main()
+{
+    bool success = true;
+
+    auto participant = provizio::dds::get_domain_participant();
+    success = check(participant != nullptr, "participant created") && success;
+    success = check(provizio::dds::get_domain_participant(0) == participant, "same domain shared") && success;
+    success = check(provizio::dds::get_domain_participant(1) != participant, "other domain not shared") && success;
+    success = check(provizio::dds::get_domain_participant(0, provizio::dds::transport_profile::shm_only) !=
+                        participant,
+                    "other transport profile not shared") &&
+              success;
+
+    // Cached weakly, so the participant is deleted with its last shared_ptr and then re-created
+    const std::weak_ptr<provizio::dds::DomainParticipant> weak_participant = participant;
+    participant.reset();
+    success = check(weak_participant.expired(), "participant deleted") && success;
+    success = check(provizio::dds::get_domain_participant() != nullptr, "participant re-created") && success;
+
+    if (!success)
+    {
+        return 1;
+    }
+
+    std::cout << "domain_participant_cache_test: Success" << std::endl;
+
+    return 0;
+}
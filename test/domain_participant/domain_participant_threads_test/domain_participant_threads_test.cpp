@@ -0,0 +1,167 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "provizio/dds/domain_participant.h"
+#include "provizio/dds/publisher.h"
+#include "provizio/dds/test/check.h"
+
+#include <std_msgs/msg/StringPubSubTypes.h>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/types.h>
+#endif
+
+namespace
+{
+    const provizio::dds::test::checker check{"domain_participant_threads_test"};
+
+#if defined(__linux__)
+    int allowed_cpus()
+    {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        pthread_getaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+        return CPU_COUNT(&cpu_set);
+    }
+
+    // Ids of all threads of the process
+    std::vector<pid_t> thread_ids()
+    {
+        std::vector<pid_t> result;
+        DIR *tasks = opendir("/proc/self/task");
+        if (tasks == nullptr)
+        {
+            return result;
+        }
+        while (const dirent *task = readdir(tasks))
+        {
+            if (task->d_name[0] != '.')
+            {
+                result.push_back(static_cast<pid_t>(std::stoi(task->d_name)));
+            }
+        }
+        closedir(tasks);
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    // CPUs another thread of the process may run on, 0 if the thread is gone
+    int allowed_cpus(const pid_t thread_id)
+    {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        return sched_getaffinity(thread_id, sizeof(cpu_set), &cpu_set) == 0 ? CPU_COUNT(&cpu_set) : 0;
+    }
+#endif
+} // namespace
+
+int main()
+{
+    bool success = true;
+
+    provizio::dds::participant_thread_options threads;
+    threads.internal.cpu_affinity = {0};
+    threads.internal.stack_size = 1024 * 1024;
+    threads.async_writer.cpu_affinity = {0};
+
+#if defined(__linux__)
+    // Threads created while the settings are applied inherit them, and the previous settings are restored afterwards
+    const int cpus = allowed_cpus();
+    {
+        const provizio::dds::scoped_thread_settings settings{threads.internal};
+        success = check(settings.applied(), "settings applied") && success;
+
+        int thread_cpus = 0;
+        std::thread thread{[&thread_cpus]() { thread_cpus = allowed_cpus(); }};
+        thread.join();
+        success = check(thread_cpus == 1, "affinity inherited") && success;
+    }
+    success = check(allowed_cpus() == cpus, "affinity restored") && success;
+#endif
+
+#if defined(__linux__)
+    const std::vector<pid_t> threads_before = thread_ids();
+#endif
+    auto participant = provizio::dds::make_domain_participant(0, provizio::dds::transport_profile::builtin, {}, {},
+                                                              threads);
+    success = check(participant != nullptr, "participant created") && success;
+    success = check(provizio::dds::async_writer_thread_settings(participant).cpu_affinity == std::vector<int>{0},
+                    "async writer settings kept") &&
+              success;
+#if defined(__linux__)
+    success = check(allowed_cpus() == cpus, "affinity restored after creating the participant") && success;
+
+    // The threads Fast-DDS started along with the participant got the internal settings
+    const std::vector<pid_t> threads_after = thread_ids();
+    std::vector<pid_t> participant_threads;
+    std::set_difference(threads_after.begin(), threads_after.end(), threads_before.begin(), threads_before.end(),
+                        std::back_inserter(participant_threads));
+    success = check(!participant_threads.empty(), "participant threads started") && success;
+    success = check(std::all_of(participant_threads.begin(), participant_threads.end(),
+                                [](const pid_t thread_id) { return allowed_cpus(thread_id) <= 1; }),
+                    "affinity of participant threads") &&
+              success;
+#endif
+
+    // The thread sending the samples of asynchronous publishers is started along with the first of them
+#if defined(__linux__)
+    const std::vector<pid_t> threads_before_publisher = thread_ids();
+#endif
+    auto publisher = provizio::dds::make_publisher<std_msgs::msg::StringPubSubType>(
+        participant, "provizio_dds_test_threads_topic",
+        provizio::dds::qos_defaults<std_msgs::msg::StringPubSubType>::datawriter_reliability_kind,
+        provizio::dds::publish_mode_options::asynchronous());
+    success = check(publisher != nullptr, "asynchronous publisher created") && success;
+#if defined(__linux__)
+    success = check(allowed_cpus() == cpus, "affinity restored after creating the publisher") && success;
+
+    const std::vector<pid_t> threads_after_publisher = thread_ids();
+    std::vector<pid_t> publisher_threads;
+    std::set_difference(threads_after_publisher.begin(), threads_after_publisher.end(),
+                        threads_before_publisher.begin(), threads_before_publisher.end(),
+                        std::back_inserter(publisher_threads));
+    success = check(!publisher_threads.empty(), "async writer thread started") && success;
+    success = check(std::all_of(publisher_threads.begin(), publisher_threads.end(),
+                                [](const pid_t thread_id) { return allowed_cpus(thread_id) <= 1; }),
+                    "affinity of async writer thread") &&
+              success;
+#endif
+
+    // Looked up by the address of the deleted participant, which is not dereferenced
+    const decltype(participant) deleted{decltype(participant){}, participant.get()};
+    publisher.reset();
+    participant.reset();
+    success = check(provizio::dds::async_writer_thread_settings(deleted).cpu_affinity.empty(),
+                    "async writer settings released") &&
+              success;
+
+    if (!success)
+    {
+        return 1;
+    }
+
+    std::cout << "domain_participant_threads_test: Success" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,92 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+
+#include "provizio/dds/domain_participant.h"
+#include "provizio/dds/publisher.h"
+#include "provizio/dds/test/check.h"
+
+#include <std_msgs/msg/StringPubSubTypes.h>
+
+namespace
+{
+    const provizio::dds::test::checker check{"domain_participant_transport_test"};
+
+    const std::uint16_t tcp_listening_port = 17410;
+    const std::uint16_t tcp_server_port = 17411;
+} // namespace
+
+int main()
+{
+    using provizio::dds::make_domain_participant;
+    using provizio::dds::transport_profile;
+
+    bool success = true;
+
+    success = check(make_domain_participant(0, transport_profile::builtin) != nullptr, "builtin") && success;
+    success = check(make_domain_participant(0, transport_profile::shm_only) != nullptr, "shm_only") && success;
+    success = check(make_domain_participant(0, transport_profile::udp_only) != nullptr, "udp_only") && success;
+    success = check(make_domain_participant(0, transport_profile::shm_and_udp) != nullptr, "shm_and_udp") && success;
+
+    provizio::dds::transport_options options;
+    options.shm_segment_size = 1024 * 1024;
+    success = check(make_domain_participant(0, transport_profile::shm_only, options) != nullptr,
+                    "custom shared memory segment size") &&
+              success;
+
+    // Fast-DDS 2.8 doesn't reliably assign a TCP listening port automatically, so one is required
+    success = check(make_domain_participant(0, transport_profile::large_data_tcp) == nullptr,
+                    "large_data_tcp without a listening port rejected") &&
+              success;
+    success = check(provizio::dds::get_domain_participant(0, transport_profile::large_data_tcp) == nullptr,
+                    "shared large_data_tcp participant rejected") &&
+              success;
+    options.tcp_listening_port = tcp_listening_port;
+    success = check(make_domain_participant(0, transport_profile::large_data_tcp, options) != nullptr,
+                    "large_data_tcp with a listening port") &&
+              success;
+
+    // A hosted Discovery Server accepts connections on its own port instead
+    provizio::dds::discovery_options discovery;
+    discovery.mode = provizio::dds::discovery_mode::discovery_server;
+    discovery.servers.front().port = tcp_server_port;
+    success = check(make_domain_participant(0, transport_profile::large_data_tcp, {}, discovery) != nullptr,
+                    "large_data_tcp Discovery Server without a listening port") &&
+              success;
+
+    // Flow controllers are registered in the participant, so asynchronous publishers can refer to them by name
+    provizio::dds::flow_controller_options flow_controller;
+    flow_controller.name = "provizio_dds_test_transport_flow_controller";
+    flow_controller.max_bytes_per_period = 1024;
+    options = {};
+    options.flow_controllers.push_back(flow_controller);
+    auto participant = make_domain_participant(0, transport_profile::builtin, options);
+    success = check(participant != nullptr, "participant with a flow controller") && success;
+    success = check(provizio::dds::make_publisher<std_msgs::msg::StringPubSubType>(
+                        participant, "provizio_dds_test_transport_topic",
+                        provizio::dds::qos_defaults<std_msgs::msg::StringPubSubType>::datawriter_reliability_kind,
+                        provizio::dds::publish_mode_options::asynchronous(flow_controller.name)) != nullptr,
+                    "asynchronous publisher with the flow controller") &&
+              success;
+
+    if (!success)
+    {
+        return 1;
+    }
+
+    std::cout << "domain_participant_transport_test: Success" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,151 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+#include "provizio/dds/entity_registry.h"
+#include "provizio/dds/intra_process.h"
+#include "provizio/dds/publisher.h"
+#include "provizio/dds/serialized_pub_sub_type.h"
+#include "provizio/dds/subscriber.h"
+#include "provizio/dds/test/check.h"
+
+#include <std_msgs/msg/Int32PubSubTypes.h>
+#include <std_msgs/msg/StringPubSubTypes.h>
+
+namespace
+{
+    const provizio::dds::test::checker check{"entity_registry_test"};
+} // namespace
+
+int main()
+{
+    const std::string topic_name{"provizio_dds_test_entity_registry_topic"};
+    const std::chrono::seconds wait_time{3};
+
+    const auto participant = provizio::dds::make_domain_participant();
+    const auto other_participant = provizio::dds::make_domain_participant();
+    const provizio::dds::TypeSupport string_type{new std_msgs::msg::StringPubSubType()};
+    const provizio::dds::TypeSupport int32_type{new std_msgs::msg::Int32PubSubType()};
+
+    // Entities are shared per participant
+    auto topic = provizio::dds::acquire_topic(participant, topic_name, string_type);
+    auto same_topic = provizio::dds::acquire_topic(participant, topic_name, string_type);
+    bool success = check(topic != nullptr && topic == same_topic, "topic shared by name");
+    success = check(provizio::dds::acquire_topic(participant, topic_name, int32_type) == nullptr,
+                    "topic with a different type rejected") &&
+              success;
+    const provizio::dds::TypeSupport serialized_string_type{
+        new provizio::dds::serialized_pub_sub_type(string_type->getName())};
+    success = check(provizio::dds::acquire_topic(participant, topic_name + "_serialized", serialized_string_type) ==
+                        nullptr,
+                    "serialized form of a registered type rejected") &&
+              success;
+    success = check(provizio::dds::make_raw_publisher<std_msgs::msg::StringPubSubType>(
+                        participant, topic_name + "_serialized") == nullptr,
+                    "raw publisher of a registered type not created") &&
+              success;
+    success = check(provizio::dds::make_latest_value_subscriber<std_msgs::msg::Int32PubSubType>(
+                        participant, topic_name) == nullptr &&
+                        provizio::dds::make_intra_process_publisher<std_msgs::msg::Int32PubSubType>(
+                            participant, topic_name) == nullptr,
+                    "latest value and intra-process handles of a topic with another type not created") &&
+              success;
+    const auto other_topic = provizio::dds::acquire_topic(other_participant, topic_name, string_type);
+    success = check(other_topic != nullptr && other_topic != topic, "topics of other participants not shared") &&
+              success;
+
+    auto publisher = provizio::dds::acquire_publisher(participant);
+    const auto other_publisher = provizio::dds::acquire_publisher(other_participant);
+    success = check(publisher != nullptr && publisher == provizio::dds::acquire_publisher(participant),
+                    "publisher shared") &&
+              success;
+    success = check(other_publisher != nullptr && other_publisher != publisher, "publishers per participant") &&
+              success;
+    const auto subscriber = provizio::dds::acquire_subscriber(participant);
+    success = check(subscriber != nullptr && subscriber == provizio::dds::acquire_subscriber(participant),
+                    "subscriber shared") &&
+              success;
+    success = check(provizio::dds::acquire_topic(nullptr, topic_name, string_type) == nullptr &&
+                        provizio::dds::acquire_publisher(nullptr) == nullptr &&
+                        provizio::dds::acquire_subscriber(nullptr) == nullptr,
+                    "no participant") &&
+              success;
+
+    // Entities are deleted with their last reference, so they can be created again
+    topic.reset();
+    success = check(participant->lookup_topicdescription(topic_name) != nullptr, "topic kept while referenced") &&
+              success;
+    same_topic.reset();
+    success = check(participant->lookup_topicdescription(topic_name) == nullptr, "topic deleted when released") &&
+              success;
+    topic = provizio::dds::acquire_topic(participant, topic_name, int32_type);
+    success = check(topic != nullptr, "released topic name reused with another type") && success;
+    topic.reset();
+    publisher.reset();
+
+    // Handles of the same participant and topic share the entities, and can coexist
+    std::mutex mutex;
+    std::condition_variable condition_variable;
+    std::set<std::string> received;
+    const auto on_data = [&](const std_msgs::msg::String &message) {
+        std::lock_guard<std::mutex> lock{mutex};
+        received.insert(message.data());
+        condition_variable.notify_all();
+    };
+    const auto subscriber_handle =
+        provizio::dds::make_subscriber<std_msgs::msg::StringPubSubType>(participant, topic_name, on_data);
+    const auto other_subscriber_handle =
+        provizio::dds::make_subscriber<std_msgs::msg::StringPubSubType>(participant, topic_name, on_data);
+    const auto publisher_handle =
+        provizio::dds::make_publisher<std_msgs::msg::StringPubSubType>(participant, topic_name);
+    const auto other_publisher_handle =
+        provizio::dds::make_publisher<std_msgs::msg::StringPubSubType>(participant, topic_name);
+    success = check(subscriber_handle != nullptr && other_subscriber_handle != nullptr &&
+                        publisher_handle != nullptr && other_publisher_handle != nullptr,
+                    "handles sharing a topic created") &&
+              success;
+    if (publisher_handle != nullptr && other_publisher_handle != nullptr)
+    {
+        std_msgs::msg::String message;
+        const auto deadline = std::chrono::steady_clock::now() + wait_time;
+        std::unique_lock<std::mutex> lock{mutex};
+        while (received.size() < 2 && std::chrono::steady_clock::now() < deadline)
+        {
+            lock.unlock();
+            message.data("first");
+            publisher_handle->publish(message);
+            message.data("second");
+            other_publisher_handle->publish(message);
+            lock.lock();
+            condition_variable.wait_for(lock, std::chrono::milliseconds(50), [&]() { return received.size() == 2; });
+        }
+        success = check(received.size() == 2, "samples of both publishers received") && success;
+    }
+
+    if (!success)
+    {
+        return 1;
+    }
+
+    std::cout << "entity_registry_test: Success" << std::endl;
+
+    return 0;
+}
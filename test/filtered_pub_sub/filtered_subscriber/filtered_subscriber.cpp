@@ -0,0 +1,86 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include "provizio/dds/subscriber.h"
+
+#include <std_msgs/msg/StringPubSubTypes.h>
+
+int main()
+{
+    // Shares the topic with simplest_publisher
+    const std::string topic_name{"provizio_dds_test_simplest_pub_sub_topic"};
+    const std::string expected_value{"provizio_dds_test"};
+    const std::chrono::seconds wait_time{3};
+    // Long enough for simplest_publisher to publish several samples more
+    const std::chrono::milliseconds receive_window{1000};
+
+    const auto domain_participant = provizio::dds::make_domain_participant();
+
+    std::mutex mutex;
+    std::condition_variable condition_variable;
+    std::string string;
+    std::atomic<int> received{0};
+    const auto subscriber = provizio::dds::make_subscriber<std_msgs::msg::StringPubSubType>(
+        domain_participant, topic_name, provizio::dds::content_filter{"data = %0", {"'" + expected_value + "'"}},
+        [&](const std_msgs::msg::String &message) {
+            std::lock_guard<std::mutex> lock{mutex};
+            string = message.data();
+            ++received;
+            condition_variable.notify_one();
+        });
+
+    // Matches nothing simplest_publisher publishes
+    std::atomic<int> filtered_out_received{0};
+    const auto filtered_out_subscriber = provizio::dds::make_subscriber<std_msgs::msg::StringPubSubType>(
+        domain_participant, topic_name, provizio::dds::content_filter{"data <> %0", {"'" + expected_value + "'"}},
+        [&](const std_msgs::msg::String &) { ++filtered_out_received; });
+
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        condition_variable.wait_for(lock, wait_time, [&]() { return string == expected_value; });
+
+        if (string != expected_value)
+        {
+            std::cerr << "filtered_subscriber: " << expected_value << " was expected but "
+                      << (string.empty() ? "nothing" : string) << " was received!" << std::endl;
+            return 1;
+        }
+    }
+
+    // Samples going through the filtered out subscriber could be just late, so both keep receiving for a while
+    const int received_before_window = received;
+    std::this_thread::sleep_for(receive_window);
+    if (received == received_before_window)
+    {
+        std::cerr << "filtered_subscriber: Nothing received within the receive window" << std::endl;
+        return 1;
+    }
+
+    if (filtered_out_received > 0)
+    {
+        std::cerr << "filtered_subscriber: " << filtered_out_received << " samples were received despite the filter"
+                  << std::endl;
+        return 1;
+    }
+
+    std::cout << "filtered_subscriber: Success" << std::endl;
+
+    return 0;
+}
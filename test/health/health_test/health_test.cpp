@@ -0,0 +1,148 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+#include "provizio/dds/publisher.h"
+#include "provizio/dds/subscriber.h"
+#include "provizio/dds/test/check.h"
+
+#include <std_msgs/msg/Int32PubSubTypes.h>
+#include <std_msgs/msg/StringPubSubTypes.h>
+
+namespace provizio
+{
+    namespace dds
+    {
+        template <> struct qos_defaults<std_msgs::msg::StringPubSubType> final : default_qos_policies
+        {
+            static constexpr std::int64_t deadline_period_milliseconds = 100;
+            static constexpr std::int64_t liveliness_lease_duration_milliseconds = 500;
+            static constexpr std::int64_t lifespan_milliseconds = 1000;
+        };
+
+        template <> struct qos_defaults<std_msgs::msg::Int32PubSubType> final : default_qos_policies
+        {
+            static constexpr LivelinessQosPolicyKind liveliness_kind = MANUAL_BY_TOPIC_LIVELINESS_QOS;
+            static constexpr std::int64_t liveliness_lease_duration_milliseconds = 200;
+        };
+    } // namespace dds
+} // namespace provizio
+
+namespace
+{
+    const provizio::dds::test::checker check{"health_test"};
+} // namespace
+
+int main()
+{
+    const std::string topic_name{"provizio_dds_test_health_topic"};
+    const std::string value{"provizio_dds_test"};
+    const std::chrono::seconds wait_time{3};
+
+    std::atomic<int> received{0};
+    std::atomic<int> deadlines_missed{0};
+    std::atomic<int> alive_publishers{0};
+    std::atomic<bool> was_alive{false};
+    provizio::dds::subscriber_health_callbacks health_callbacks;
+    health_callbacks.on_requested_deadline_missed = [&](const eprosima::fastdds::dds::RequestedDeadlineMissedStatus
+                                                            &status) { deadlines_missed = status.total_count; };
+    health_callbacks.on_liveliness_changed = [&](const eprosima::fastdds::dds::LivelinessChangedStatus &status) {
+        alive_publishers = status.alive_count;
+        was_alive = was_alive || status.alive_count > 0;
+    };
+    auto subscriber = provizio::dds::make_subscriber<std_msgs::msg::StringPubSubType>(
+        provizio::dds::make_domain_participant(), topic_name,
+        [&](const std_msgs::msg::String &message) {
+            if (message.data() == value)
+            {
+                ++received;
+            }
+        },
+        std::move(health_callbacks));
+
+    auto publisher = provizio::dds::make_publisher<std_msgs::msg::StringPubSubType>(
+        provizio::dds::make_domain_participant(), topic_name);
+
+    // Publishing more often than the deadline period
+    std_msgs::msg::String message;
+    message.data(value);
+    auto deadline = std::chrono::steady_clock::now() + wait_time;
+    while ((received < 5 || !was_alive) && std::chrono::steady_clock::now() < deadline)
+    {
+        publisher->publish(message);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    bool success = check(received >= 5, "received");
+    success = check(was_alive, "publisher alive") && success;
+
+    // A stalled publisher misses deadlines, and a destroyed one is no longer alive
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    success = check(deadlines_missed > 0, "deadline missed") && success;
+    success = check(subscriber->metrics().deadlines_missed > 0, "missed deadline counted") && success;
+
+    publisher.reset();
+    deadline = std::chrono::steady_clock::now() + wait_time;
+    while (alive_publishers > 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    success = check(alive_publishers == 0, "publisher not alive") && success;
+
+    // Publishers of manual liveliness kinds only stay alive while asserting it
+    std::atomic<int> manually_alive_publishers{0};
+    provizio::dds::subscriber_health_callbacks manual_health_callbacks;
+    manual_health_callbacks.on_liveliness_changed =
+        [&](const eprosima::fastdds::dds::LivelinessChangedStatus &status) {
+            manually_alive_publishers = status.alive_count;
+        };
+    auto manual_subscriber = provizio::dds::make_subscriber<std_msgs::msg::Int32PubSubType>(
+        provizio::dds::make_domain_participant(), topic_name + "_manual", [](const std_msgs::msg::Int32 &) {},
+        std::move(manual_health_callbacks));
+    auto manual_publisher = provizio::dds::make_publisher<std_msgs::msg::Int32PubSubType>(
+        provizio::dds::make_domain_participant(), topic_name + "_manual");
+    bool asserted = true;
+    deadline = std::chrono::steady_clock::now() + wait_time;
+    while (manually_alive_publishers == 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        asserted = manual_publisher->assert_liveliness() && asserted;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    success = check(asserted && manually_alive_publishers > 0, "liveliness asserted manually") && success;
+
+    deadline = std::chrono::steady_clock::now() + wait_time;
+    while (manually_alive_publishers > 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    success = check(manually_alive_publishers == 0, "manual publisher not alive without assertions") && success;
+
+    // Automatic assertions of the shortest lease are still periodic
+    const auto shortest_period = provizio::dds::detail::liveliness_announcement_period(1);
+    success = check(shortest_period != eprosima::fastrtps::c_TimeInfinite &&
+                        shortest_period < provizio::dds::detail::to_duration(std::chrono::milliseconds(1)),
+                    "announcement period of a millisecond lease") &&
+              success;
+
+    if (!success)
+    {
+        return 1;
+    }
+
+    std::cout << "health_test: Success" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,64 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DDS_TEST_CHECK
+#define DDS_TEST_CHECK
+
+#include <iostream>
+
+namespace provizio
+{
+    namespace dds
+    {
+        namespace test
+        {
+            /**
+             * @brief Reports failed checks of a test program, as "<test name>: Failed: <description>"
+             */
+            class checker final
+            {
+              public:
+                /**
+                 * @brief Constructs a new checker object
+                 *
+                 * @param test_name Name of the test program, to prefix the failures with
+                 */
+                explicit checker(const char *test_name) : test_name(test_name)
+                {
+                }
+
+                /**
+                 * @brief Reports a failed check to std::cerr
+                 *
+                 * @param condition The checked condition
+                 * @param description Description of the check
+                 * @return condition, so that the results can be combined as success = check(...) && success
+                 */
+                bool operator()(const bool condition, const char *description) const
+                {
+                    if (!condition)
+                    {
+                        std::cerr << test_name << ": Failed: " << description << std::endl;
+                    }
+                    return condition;
+                }
+
+              private:
+                const char *test_name;
+            };
+        } // namespace test
+    } // namespace dds
+} // namespace provizio
+
+#endif // DDS_TEST_CHECK
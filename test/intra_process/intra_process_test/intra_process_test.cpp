@@ -0,0 +1,141 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include "provizio/dds/intra_process.h"
+#include "provizio/dds/subscriber.h"
+#include "provizio/dds/test/check.h"
+
+#include <std_msgs/msg/StringPubSubTypes.h>
+
+namespace
+{
+    const provizio::dds::test::checker check{"intra_process_test"};
+} // namespace
+
+int main()
+{
+    const std::string topic_name{"provizio_dds_test_intra_process_topic"};
+    const std::string value{"provizio_dds_test"};
+    const std::chrono::seconds wait_time{3};
+
+    const auto participant = provizio::dds::make_domain_participant();
+    std::mutex mutex;
+    std::shared_ptr<const std_msgs::msg::String> last_received;
+    std::size_t received_count = 0;
+    auto intra_process_subscriber = provizio::dds::make_intra_process_subscriber<std_msgs::msg::StringPubSubType>(
+        participant, topic_name, [&](std::shared_ptr<const std_msgs::msg::String> message) {
+            std::lock_guard<std::mutex> lock{mutex};
+            last_received = std::move(message);
+            ++received_count;
+        });
+    auto intra_process_publisher =
+        provizio::dds::make_intra_process_publisher<std_msgs::msg::StringPubSubType>(participant, topic_name);
+
+    auto message = std::make_shared<std_msgs::msg::String>();
+    message->data(value);
+
+    // Intra-process subscribers receive the very same sample, with no DDS publishing when there are no others
+    bool success = check(intra_process_publisher->publish(message), "published intra-process");
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        success = check(last_received == message, "received the same sample") && success;
+    }
+    success = check(intra_process_publisher->intra_process_deliveries() == 1, "delivery counted") && success;
+    success = check(intra_process_publisher->metrics().published == 0, "not published over DDS") && success;
+
+    // Subscriber functions may publish to their own topic, with the nested samples delivered once they return
+    std::size_t echoed_count = 0;
+    std::shared_ptr<provizio::dds::intra_process_publisher<std_msgs::msg::StringPubSubType>> echo_publisher;
+    auto echo_subscriber = provizio::dds::make_intra_process_subscriber<std_msgs::msg::StringPubSubType>(
+        participant, topic_name + "_echo", [&](std::shared_ptr<const std_msgs::msg::String> echo_message) {
+            if (++echoed_count < 3)
+            {
+                auto echo = std::make_shared<std_msgs::msg::String>(*echo_message);
+                echo_publisher->publish(echo);
+            }
+        });
+    echo_publisher =
+        provizio::dds::make_intra_process_publisher<std_msgs::msg::StringPubSubType>(participant, topic_name + "_echo");
+    success = check(echo_publisher->publish(message) && echoed_count == 3, "published from the subscriber function") &&
+              success;
+
+    // Subscriber functions publishing to each other's topics in different threads don't wait for each other
+    const int ping_pong_limit = 100;
+    std::atomic<int> ping_count{0};
+    std::atomic<int> pong_count{0};
+    std::shared_ptr<provizio::dds::intra_process_publisher<std_msgs::msg::StringPubSubType>> ping_publisher;
+    std::shared_ptr<provizio::dds::intra_process_publisher<std_msgs::msg::StringPubSubType>> pong_publisher;
+    auto ping_subscriber = provizio::dds::make_intra_process_subscriber<std_msgs::msg::StringPubSubType>(
+        participant, topic_name + "_ping", [&](std::shared_ptr<const std_msgs::msg::String> ping) {
+            if (++ping_count < ping_pong_limit)
+            {
+                pong_publisher->publish(std::make_shared<std_msgs::msg::String>(*ping));
+            }
+        });
+    auto pong_subscriber = provizio::dds::make_intra_process_subscriber<std_msgs::msg::StringPubSubType>(
+        participant, topic_name + "_pong", [&](std::shared_ptr<const std_msgs::msg::String> pong) {
+            if (++pong_count < ping_pong_limit)
+            {
+                ping_publisher->publish(std::make_shared<std_msgs::msg::String>(*pong));
+            }
+        });
+    ping_publisher =
+        provizio::dds::make_intra_process_publisher<std_msgs::msg::StringPubSubType>(participant, topic_name + "_ping");
+    pong_publisher =
+        provizio::dds::make_intra_process_publisher<std_msgs::msg::StringPubSubType>(participant, topic_name + "_pong");
+    std::thread ping_thread{[&]() { ping_publisher->publish(std::make_shared<std_msgs::msg::String>(*message)); }};
+    pong_publisher->publish(std::make_shared<std_msgs::msg::String>(*message));
+    ping_thread.join();
+    success = check(std::max(ping_count.load(), pong_count.load()) >= ping_pong_limit,
+                    "published to each other's topics concurrently") &&
+              success;
+
+    // Other subscribers receive the samples over DDS, while intra-process subscribers don't receive them twice
+    std::atomic<bool> remote_received{false};
+    auto remote_subscriber = provizio::dds::make_subscriber<std_msgs::msg::StringPubSubType>(
+        provizio::dds::make_domain_participant(), topic_name,
+        [&](const std_msgs::msg::String &remote_message) { remote_received = remote_message.data() == value; });
+
+    std::size_t published_count = 1;
+    const auto deadline = std::chrono::steady_clock::now() + wait_time;
+    while (!remote_received && std::chrono::steady_clock::now() < deadline)
+    {
+        intra_process_publisher->publish(message);
+        ++published_count;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    success = check(remote_received, "received over DDS") && success;
+    success = check(intra_process_publisher->has_remote_subscribers(), "remote subscriber matched") && success;
+    success = check(intra_process_publisher->metrics().published > 0, "published over DDS") && success;
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        success = check(received_count == published_count, "no duplicates received") && success;
+    }
+
+    if (!success)
+    {
+        return 1;
+    }
+
+    std::cout << "intra_process_test: Success" << std::endl;
+
+    return 0;
+}
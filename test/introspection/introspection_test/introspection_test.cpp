@@ -0,0 +1,126 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "provizio/dds/introspection.h"
+#include "provizio/dds/publisher.h"
+#include "provizio/dds/subscriber.h"
+#include "provizio/dds/test/check.h"
+
+#include <std_msgs/msg/StringPubSubTypes.h>
+
+namespace
+{
+    const provizio::dds::test::checker check{"introspection_test"};
+
+    bool contains(const std::string &text, const std::string &fragment)
+    {
+        return text.find(fragment) != std::string::npos;
+    }
+} // namespace
+
+int main()
+{
+    const std::string topic_name{"provizio_dds_test_introspection_topic"};
+    const std::chrono::seconds wait_time{3};
+
+    // Both handles share a participant, so that both are listed in its report
+    const auto participant = provizio::dds::make_domain_participant();
+    std::atomic<int> received{0};
+    auto subscriber = provizio::dds::make_subscriber<std_msgs::msg::StringPubSubType>(
+        participant, topic_name, [&](const std_msgs::msg::String &) { ++received; });
+    auto publisher = provizio::dds::make_publisher<std_msgs::msg::StringPubSubType>(participant, topic_name);
+
+    // Strings are not plain, so their bytes are counted on request
+    subscriber->count_received_bytes(true);
+    publisher->count_published_bytes(true);
+    provizio::dds::introspector introspector{participant};
+    std_msgs::msg::String message;
+    message.data("provizio_dds_test");
+
+    const auto deadline = std::chrono::steady_clock::now() + wait_time;
+    while (received == 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        publisher->publish(message);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    auto report = introspector.introspect();
+    bool success = check(received > 0, "sample received");
+    success = check(report.entities.size() == 2, "both handles listed") && success;
+    if (report.entities.size() == 2)
+    {
+        const auto &subscriber_report = report.entities[0];
+        const auto &publisher_report = report.entities[1];
+        success = check(subscriber_report.kind == provizio::dds::entity_kind::subscriber &&
+                            publisher_report.kind == provizio::dds::entity_kind::publisher,
+                        "listed in the order of creation") &&
+                  success;
+        success = check(subscriber_report.topic_name == topic_name && publisher_report.topic_name == topic_name,
+                        "topic names") &&
+                  success;
+        success = check(subscriber_report.type_name == "std_msgs::msg::dds_::String_", "type name") && success;
+        success = check(subscriber_report.matched == 1 && publisher_report.matched == 1, "matched") && success;
+        success = check(!publisher_report.transport.empty(), "transport reported") && success;
+        success = check(publisher_report.history_bytes ==
+                            publisher_report.history_samples * publisher_report.max_sample_bytes,
+                        "history bytes") &&
+                  success;
+        success =
+            check(publisher_report.samples > 0 && publisher_report.bytes > 0, "published samples counted") && success;
+        success =
+            check(subscriber_report.samples > 0 && subscriber_report.bytes > 0, "received samples counted") && success;
+        success = check(publisher_report.samples_per_second > 0.0 && subscriber_report.bytes_per_second > 0.0,
+                        "rates measured") &&
+                  success;
+    }
+
+    // An introspector measures rates since its own previous report, unaffected by other reports
+    provizio::dds::introspect(participant);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    const auto idle_report = introspector.introspect();
+    success = check(idle_report.entities.size() == 2 && idle_report.entities[1].samples_per_second == 0.0,
+                    "no publishing since the previous report") &&
+              success;
+    const auto average_report = provizio::dds::introspect(participant);
+    success = check(average_report.entities.size() == 2 && average_report.entities[1].samples_per_second > 0.0,
+                    "average rate since the handle creation") &&
+              success;
+
+    const std::string json = provizio::dds::to_json(report);
+    success = check(contains(json, "\"topic_name\":\"" + topic_name + "\""), "JSON report") && success;
+    const std::string prometheus = provizio::dds::to_prometheus(report);
+    success = check(contains(prometheus, "# TYPE provizio_dds_samples_total counter"), "Prometheus types") && success;
+    success = check(contains(prometheus, "kind=\"publisher\",topic=\"" + topic_name + "\""), "Prometheus labels") &&
+              success;
+
+    // Destroyed handles are no longer listed
+    publisher.reset();
+    report = provizio::dds::introspect(participant);
+    success = check(report.entities.size() == 1, "destroyed handle unlisted") && success;
+    success = check(provizio::dds::introspect(nullptr).entities.empty(), "no participant") && success;
+
+    if (!success)
+    {
+        return 1;
+    }
+
+    std::cout << "introspection_test: Success" << std::endl;
+
+    return 0;
+}
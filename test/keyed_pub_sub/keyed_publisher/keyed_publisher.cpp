@@ -0,0 +1,88 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "provizio/dds/publisher.h"
+#include "provizio/dds/test/check.h"
+
+#include <std_msgs/msg/StringPubSubTypes.h>
+
+#include "../keyed_sample.h"
+
+namespace
+{
+    const provizio::dds::test::checker check{"keyed_publisher"};
+} // namespace
+
+int main()
+{
+    using provizio::dds::test::keyed_sample;
+    using provizio::dds::test::keyed_samplePubSubType;
+
+    const std::string topic_name{"provizio_dds_test_keyed_pub_sub_topic"};
+    const std::chrono::milliseconds wait_time{50};
+    const int publish_times = 40;
+    // Long enough for keyed_subscriber to be notified of the disposed and unregistered instances
+    const std::chrono::milliseconds linger_time{1000};
+
+    keyed_sample first;
+    first.id = 1;
+    first.value = 10;
+    keyed_sample second;
+    second.id = 2;
+    second.value = 20;
+
+    auto publisher =
+        provizio::dds::make_publisher<keyed_samplePubSubType>(provizio::dds::make_domain_participant(), topic_name);
+    const auto first_instance = publisher->register_instance(first);
+    const auto second_instance = publisher->register_instance(second);
+    bool success = check(first_instance != eprosima::fastdds::dds::HANDLE_NIL &&
+                             second_instance != eprosima::fastdds::dds::HANDLE_NIL && first_instance != second_instance,
+                         "register_instance");
+
+    int successful_times = 0;
+    for (int i = 0; i < publish_times; ++i)
+    {
+        successful_times +=
+            publisher->publish(first, first_instance) && publisher->publish(second, second_instance) ? 1 : 0;
+        std::this_thread::sleep_for(wait_time);
+    }
+    success = check(successful_times > 0, "published by instance handle") && success;
+
+    success = check(publisher->dispose_instance(first, first_instance), "dispose_instance") && success;
+    success = check(publisher->unregister_instance(second, second_instance), "unregister_instance") && success;
+
+    // Unkeyed types have no instances to register
+    std_msgs::msg::String message;
+    auto unkeyed_publisher = provizio::dds::make_publisher<std_msgs::msg::StringPubSubType>(
+        provizio::dds::make_domain_participant(), "provizio_dds_test_keyed_pub_sub_unkeyed_topic");
+    success = check(unkeyed_publisher->register_instance(message) == eprosima::fastdds::dds::HANDLE_NIL,
+                    "no instances of unkeyed types") &&
+              success;
+
+    std::this_thread::sleep_for(linger_time);
+
+    if (!success)
+    {
+        return 1;
+    }
+
+    std::cout << "keyed_publisher: Successfully published " << successful_times << " times" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DDS_TEST_KEYED_SAMPLE
+#define DDS_TEST_KEYED_SAMPLE
+
+#include <cstdint>
+#include <functional>
+
+#include <fastdds/dds/topic/TopicDataType.hpp>
+#include <fastdds/rtps/common/SerializedPayload.h>
+
+#include "provizio/dds/qos_defaults.h"
+
+namespace provizio
+{
+    namespace dds
+    {
+        namespace test
+        {
+            // A keyed DDS data type, as the bundled IDL types have no keys, equivalent to the IDL:
+            // struct keyed_sample { @key uint32 id; int32 value; };
+            class keyed_sample
+            {
+              public:
+                std::uint32_t id = 0;
+                std::int32_t value = 0;
+            };
+
+            // Encapsulation header followed by both members in little-endian CDR
+            constexpr std::uint32_t keyed_sample_serialized_size = 4 + 4 + 4;
+
+            class keyed_samplePubSubType : public eprosima::fastdds::dds::TopicDataType
+            {
+              public:
+                using type = keyed_sample;
+
+                keyed_samplePubSubType()
+                {
+                    setName("provizio_dds_test::keyed_sample");
+                    m_typeSize = keyed_sample_serialized_size;
+                    m_isGetKeyDefined = true;
+                }
+
+                bool serialize(void *data, eprosima::fastrtps::rtps::SerializedPayload_t *payload) override
+                {
+                    if (payload->max_size < keyed_sample_serialized_size)
+                    {
+                        return false;
+                    }
+
+                    const auto &sample = *static_cast<const keyed_sample *>(data);
+                    payload->data[0] = 0;
+                    payload->data[1] = CDR_LE;
+                    payload->data[2] = 0;
+                    payload->data[3] = 0;
+                    write_little_endian(sample.id, payload->data + 4);
+                    write_little_endian(static_cast<std::uint32_t>(sample.value), payload->data + 8);
+                    payload->encapsulation = CDR_LE;
+                    payload->length = keyed_sample_serialized_size;
+                    return true;
+                }
+
+                bool deserialize(eprosima::fastrtps::rtps::SerializedPayload_t *payload, void *data) override
+                {
+                    if (payload->length < keyed_sample_serialized_size || payload->data[1] != CDR_LE)
+                    {
+                        return false;
+                    }
+
+                    auto &sample = *static_cast<keyed_sample *>(data);
+                    sample.id = read_little_endian(payload->data + 4);
+                    sample.value = static_cast<std::int32_t>(read_little_endian(payload->data + 8));
+                    return true;
+                }
+
+                std::function<std::uint32_t()> getSerializedSizeProvider(void * /*data*/) override
+                {
+                    return []() { return keyed_sample_serialized_size; };
+                }
+
+                void *createData() override
+                {
+                    return new keyed_sample();
+                }
+
+                void deleteData(void *data) override
+                {
+                    delete static_cast<keyed_sample *>(data);
+                }
+
+                bool getKey(void *data, eprosima::fastrtps::rtps::InstanceHandle_t *handle, bool /*force_md5*/) override
+                {
+                    // Keys of up to 16 bytes are the handle itself, serialized in big-endian CDR and padded with zeros
+                    const std::uint32_t id = static_cast<const keyed_sample *>(data)->id;
+                    for (std::size_t i = 0; i < 16; ++i)
+                    {
+                        handle->value[i] = i < 4 ? static_cast<std::uint8_t>(id >> (8 * (3 - i))) : 0;
+                    }
+                    return true;
+                }
+
+                bool is_bounded() const override
+                {
+                    return true;
+                }
+
+              private:
+                static void write_little_endian(const std::uint32_t value, std::uint8_t *destination)
+                {
+                    for (std::size_t i = 0; i < 4; ++i)
+                    {
+                        destination[i] = static_cast<std::uint8_t>(value >> (8 * i));
+                    }
+                }
+
+                static std::uint32_t read_little_endian(const std::uint8_t *source)
+                {
+                    std::uint32_t value = 0;
+                    for (std::size_t i = 0; i < 4; ++i)
+                    {
+                        value |= static_cast<std::uint32_t>(source[i]) << (8 * i);
+                    }
+                    return value;
+                }
+            };
+        } // namespace test
+
+        // Reliable, so the latest sample of each instance is kept in the history for take_instance
+        template <> struct qos_defaults<test::keyed_samplePubSubType> final : default_qos_policies
+        {
+            static constexpr ReliabilityQosPolicyKind datareader_reliability_kind = RELIABLE_RELIABILITY_QOS;
+        };
+    } // namespace dds
+} // namespace provizio
+
+#endif // DDS_TEST_KEYED_SAMPLE
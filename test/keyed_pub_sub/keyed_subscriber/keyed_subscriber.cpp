@@ -0,0 +1,160 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "provizio/dds/subscriber.h"
+#include "provizio/dds/test/check.h"
+
+#include "../keyed_sample.h"
+
+namespace
+{
+    const provizio::dds::test::checker check{"keyed_subscriber"};
+} // namespace
+
+int main()
+{
+    using provizio::dds::test::keyed_sample;
+    using provizio::dds::test::keyed_samplePubSubType;
+
+    const std::string topic_name{"provizio_dds_test_keyed_pub_sub_topic"};
+    const std::chrono::seconds wait_time{3};
+
+    keyed_sample first;
+    first.id = 1;
+    first.value = 10;
+    keyed_sample second;
+    second.id = 2;
+    second.value = 20;
+    keyed_sample unknown;
+    unknown.id = 3;
+
+    // Samples are delivered to the instance subscriber along with their instance handles
+    std::mutex mutex;
+    std::condition_variable condition_variable;
+    eprosima::fastdds::dds::InstanceHandle_t received_first_instance;
+    eprosima::fastdds::dds::InstanceHandle_t received_second_instance;
+    int received_first = 0;
+    int received_second = 0;
+    int received_invalid = 0;
+    std::map<eprosima::fastdds::dds::InstanceHandle_t, eprosima::fastdds::dds::InstanceStateKind> instance_states;
+    auto instance_subscriber = provizio::dds::make_instance_subscriber<keyed_samplePubSubType>(
+        provizio::dds::make_domain_participant(), topic_name, provizio::dds::content_filter{},
+        [&](const eprosima::fastdds::dds::InstanceHandle_t &instance, const keyed_sample &sample) {
+            std::lock_guard<std::mutex> lock{mutex};
+            if (sample.id == first.id && sample.value == first.value)
+            {
+                received_first_instance = instance;
+                ++received_first;
+            }
+            else if (sample.id == second.id && sample.value == second.value)
+            {
+                received_second_instance = instance;
+                ++received_second;
+            }
+            else
+            {
+                ++received_invalid;
+            }
+            condition_variable.notify_one();
+        },
+        [&](const eprosima::fastdds::dds::InstanceHandle_t &instance,
+            const eprosima::fastdds::dds::InstanceStateKind state) {
+            std::lock_guard<std::mutex> lock{mutex};
+            instance_states[instance] = state;
+            condition_variable.notify_one();
+        });
+
+    // Leaves the samples in the DataReader, to be taken per instance
+    auto polling_subscriber = std::make_shared<provizio::dds::subscriber_handle<keyed_samplePubSubType>>(
+        provizio::dds::make_domain_participant(), topic_name,
+        std::make_shared<provizio::dds::counting_data_reader_listener>());
+
+    const auto deadline = std::chrono::steady_clock::now() + wait_time;
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        condition_variable.wait_until(lock, deadline, [&]() { return received_first > 0 && received_second > 0; });
+    }
+    while ((polling_subscriber->lookup_instance(first) == eprosima::fastdds::dds::HANDLE_NIL ||
+            polling_subscriber->lookup_instance(second) == eprosima::fastdds::dds::HANDLE_NIL) &&
+           std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    // Instance handles are computed from the keys, so both readers agree on them
+    const auto first_instance = polling_subscriber->lookup_instance(first);
+    const auto second_instance = polling_subscriber->lookup_instance(second);
+    bool success = check(first_instance != eprosima::fastdds::dds::HANDLE_NIL &&
+                             second_instance != eprosima::fastdds::dds::HANDLE_NIL && first_instance != second_instance,
+                         "lookup_instance");
+    success = check(polling_subscriber->lookup_instance(unknown) == eprosima::fastdds::dds::HANDLE_NIL,
+                    "lookup_instance of an unknown instance") &&
+              success;
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        success = check(received_first > 0 && received_second > 0 && received_invalid == 0, "received per instance") &&
+                  success;
+        success = check(received_first_instance == first_instance && received_second_instance == second_instance,
+                        "instance handles of received samples") &&
+                  success;
+    }
+
+    // Instances are taken separately
+    keyed_sample taken;
+    success = check(polling_subscriber->take_instance(taken, second_instance) && taken.id == second.id &&
+                        taken.value == second.value,
+                    "take_instance") &&
+              success;
+    eprosima::fastdds::dds::SampleInfo info;
+    success = check(polling_subscriber->take_instance(taken, first_instance, &info) && taken.id == first.id &&
+                        info.instance_handle == first_instance,
+                    "take_instance of another instance") &&
+              success;
+    success =
+        check(!polling_subscriber->take_instance(taken, eprosima::fastdds::dds::HANDLE_NIL), "take no instance") &&
+        success;
+
+    // keyed_publisher disposes the first instance and unregisters the second one, which also disposes it by default
+    {
+        const auto states_deadline = std::chrono::steady_clock::now() + wait_time;
+        std::unique_lock<std::mutex> lock{mutex};
+        condition_variable.wait_until(lock, states_deadline, [&]() {
+            return instance_states.count(first_instance) != 0 && instance_states.count(second_instance) != 0;
+        });
+        success = check(instance_states.count(first_instance) != 0 &&
+                            instance_states[first_instance] ==
+                                eprosima::fastdds::dds::NOT_ALIVE_DISPOSED_INSTANCE_STATE,
+                        "disposed instance forwarded") &&
+                  success;
+        success = check(instance_states.count(second_instance) != 0, "unregistered instance forwarded") && success;
+    }
+
+    if (!success)
+    {
+        return 1;
+    }
+
+    std::cout << "keyed_subscriber: Success" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,72 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <thread>
+
+#include "provizio/dds/subscriber.h"
+
+#include <std_msgs/msg/StringPubSubTypes.h>
+
+int main()
+{
+    // Shares the topic with simplest_publisher
+    const std::string topic_name{"provizio_dds_test_simplest_pub_sub_topic"};
+    const std::string expected_value{"provizio_dds_test"};
+    const std::chrono::seconds wait_time{3};
+    const std::chrono::milliseconds poll_period{1};
+
+    const auto subscriber = provizio::dds::make_latest_value_subscriber<std_msgs::msg::StringPubSubType>(
+        provizio::dds::make_domain_participant(), topic_name);
+
+    // Polls like a control loop would, until a couple of samples are received
+    std_msgs::msg::String message;
+    std::uint64_t first_sequence = 0;
+    std::uint64_t sequence = 0;
+    const auto deadline = std::chrono::steady_clock::now() + wait_time;
+    while (std::chrono::steady_clock::now() < deadline && (first_sequence == 0 || sequence <= first_sequence))
+    {
+        if (subscriber->try_get_latest(message, &sequence))
+        {
+            if (message.data() != expected_value)
+            {
+                std::cerr << "latest_value_subscriber: " << expected_value << " was expected but " << message.data()
+                          << " was received!" << std::endl;
+                return 1;
+            }
+
+            first_sequence = first_sequence == 0 ? sequence : first_sequence;
+        }
+        std::this_thread::sleep_for(poll_period);
+    }
+
+    if (first_sequence == 0 || sequence <= first_sequence)
+    {
+        std::cerr << "latest_value_subscriber: Less than 2 samples received" << std::endl;
+        return 1;
+    }
+
+    std::uint64_t view_sequence = 0;
+    const auto *view = subscriber->get_latest_view(&view_sequence);
+    if (view == nullptr || view->data() != expected_value || view_sequence < sequence ||
+        subscriber->latest_sequence() < view_sequence)
+    {
+        std::cerr << "latest_value_subscriber: Inconsistent latest value view" << std::endl;
+        return 1;
+    }
+
+    std::cout << "latest_value_subscriber: Success" << std::endl;
+
+    return 0;
+}
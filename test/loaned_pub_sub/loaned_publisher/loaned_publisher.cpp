@@ -0,0 +1,121 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "provizio/dds/publisher.h"
+#include "provizio/dds/test/check.h"
+
+#include <std_msgs/msg/Int32PubSubTypes.h>
+
+namespace
+{
+    const provizio::dds::test::checker check{"loaned_publisher"};
+
+    // An external implementation, which only provides publish and relies on the defaults for the rest
+    class minimal_publisher final : public provizio::dds::data_publisher<std_msgs::msg::Int32PubSubType>
+    {
+      public:
+        bool publish(std_msgs::msg::Int32 &data) override
+        {
+            last_value = data.data();
+            return true;
+        }
+
+        std::int32_t last_value = 0;
+    };
+} // namespace
+
+int main()
+{
+    const std::string topic_name{"provizio_dds_test_loaned_pub_sub_topic"};
+    const std::int32_t value = 42;
+    const std::chrono::milliseconds wait_time{50};
+    const int publish_times = 60;
+
+    auto publisher = provizio::dds::make_publisher<std_msgs::msg::Int32PubSubType>(
+        provizio::dds::make_domain_participant(), topic_name);
+    auto other_publisher = provizio::dds::make_publisher<std_msgs::msg::Int32PubSubType>(
+        provizio::dds::make_domain_participant(), topic_name);
+
+    // Plain types are loaned from the DataWriter history
+    auto sample = publisher->loan();
+    bool success = check(sample && sample.is_middleware_owned(), "middleware owned loan of a plain type");
+
+    // An unpublished loan must be returned, so the next one succeeds
+    sample.reset();
+    sample = publisher->loan();
+    success = check(static_cast<bool>(sample), "loan after returning the previous loan") && success;
+    sample.reset();
+
+    // A loan from another publisher is returned to it rather than published
+    auto foreign_sample = other_publisher->loan();
+    foreign_sample->data(value);
+    success = check(!publisher->publish_loaned(std::move(foreign_sample)) && !foreign_sample, "foreign loan") &&
+              success;
+    success = check(publisher->metrics().published == 0, "foreign loan not published") && success;
+
+    int published = 0;
+    int write_failures = 0;
+    for (int i = 0; i < publish_times; ++i)
+    {
+        sample = publisher->loan();
+        if (sample)
+        {
+            sample->data(value);
+            if (publisher->publish_loaned(std::move(sample)))
+            {
+                ++published;
+            }
+            else
+            {
+                ++write_failures;
+            }
+        }
+        std::this_thread::sleep_for(wait_time);
+    }
+    success = check(published > 0, "published") && success;
+
+    const auto metrics = publisher->metrics();
+    success = check(metrics.published == static_cast<std::uint64_t>(published) &&
+                        metrics.write_failures == static_cast<std::uint64_t>(write_failures),
+                    "metrics") &&
+              success;
+
+    // Default implementations of data_publisher
+    minimal_publisher minimal;
+    auto minimal_sample = minimal.loan();
+    minimal_sample->data(value);
+    success = check(!minimal_sample.is_middleware_owned() && minimal.publish_loaned(std::move(minimal_sample)) &&
+                        minimal.last_value == value,
+                    "default loan") &&
+              success;
+    std_msgs::msg::Int32 message;
+    success = check(minimal.publish_with_status(message) == provizio::dds::publish_status::published &&
+                        minimal.metrics().published == 0,
+                    "default publish_with_status and metrics") &&
+              success;
+
+    if (!success)
+    {
+        return 1;
+    }
+
+    std::cout << "loaned_publisher: Successfully published " << published << " times" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <string>
+
+#include "provizio/dds/subscriber.h"
+
+#include <std_msgs/msg/Int32PubSubTypes.h>
+
+int main()
+{
+    const std::string topic_name{"provizio_dds_test_loaned_pub_sub_topic"};
+    const std::int32_t expected_value = 42;
+    const std::chrono::seconds wait_time{3};
+    const int expected_received = 5;
+
+    std::mutex mutex;
+    std::condition_variable condition_variable;
+    int received = 0;
+    const auto subscriber = provizio::dds::make_subscriber<std_msgs::msg::Int32PubSubType>(
+        provizio::dds::make_domain_participant(), topic_name, [&](const std_msgs::msg::Int32 &message) {
+            if (message.data() == expected_value)
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                ++received;
+                condition_variable.notify_one();
+            }
+        });
+
+    std::unique_lock<std::mutex> lock{mutex};
+    condition_variable.wait_for(lock, wait_time, [&]() { return received >= expected_received; });
+
+    if (received < expected_received)
+    {
+        std::cerr << "loaned_subscriber: " << expected_received << " samples were expected but " << received
+                  << " were received!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "loaned_subscriber: Success" << std::endl;
+
+    return 0;
+}
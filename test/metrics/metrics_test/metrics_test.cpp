@@ -0,0 +1,117 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "provizio/dds/publisher.h"
+#include "provizio/dds/subscriber.h"
+#include "provizio/dds/test/check.h"
+
+#include <std_msgs/msg/StringPubSubTypes.h>
+
+namespace
+{
+    const provizio::dds::test::checker check{"metrics_test"};
+} // namespace
+
+int main()
+{
+    const std::string topic_name{"provizio_dds_test_metrics_topic"};
+    const std::string value{"provizio_dds_test"};
+    const std::chrono::seconds wait_time{3};
+    const int expected_received = 5;
+
+    std::atomic<int> received{0};
+    auto subscriber = provizio::dds::make_subscriber<std_msgs::msg::StringPubSubType>(
+        provizio::dds::make_domain_participant(), topic_name, [&](const std_msgs::msg::String &message) {
+            if (message.data() == value)
+            {
+                ++received;
+            }
+        });
+    auto publisher = provizio::dds::make_publisher<std_msgs::msg::StringPubSubType>(
+        provizio::dds::make_domain_participant(), topic_name);
+
+    // Subscribers not invoking a function on data, such as polled ones, count the received bytes as well
+    auto polling_subscriber = provizio::dds::make_polling_subscriber<std_msgs::msg::StringPubSubType>(
+        provizio::dds::make_domain_participant(), topic_name);
+    polling_subscriber->count_received_bytes(true);
+
+    std_msgs::msg::String message;
+    message.data(value);
+    const auto publish_until_received = [&](const int count) {
+        int published = 0;
+        const auto deadline = std::chrono::steady_clock::now() + wait_time;
+        while (received < count && std::chrono::steady_clock::now() < deadline)
+        {
+            published += publisher->publish(message) ? 1 : 0;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        return published;
+    };
+
+    // Published bytes of a type that is not plain are only counted on demand
+    int published = publish_until_received(expected_received);
+    auto publisher_metrics = publisher->metrics();
+    bool success = check(received >= expected_received, "received");
+    success = check(publisher_metrics.published == static_cast<std::uint64_t>(published) &&
+                        publisher_metrics.write_failures == 0,
+                    "published samples") &&
+              success;
+    success = check(publisher_metrics.published_bytes == 0, "published bytes not counted by default") && success;
+    success = check(subscriber->metrics().received_bytes == 0, "received bytes not counted by default") && success;
+
+    publisher->count_published_bytes(true);
+    subscriber->count_received_bytes(true);
+    published += publish_until_received(received + expected_received);
+    publisher_metrics = publisher->metrics();
+    success = check(publisher_metrics.published == static_cast<std::uint64_t>(published), "published samples") &&
+              success;
+    success = check(publisher_metrics.published_bytes >= value.size() * expected_received, "published bytes") &&
+              success;
+
+    // Samples still in flight are delivered before the subscriber counters are compared
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    const auto subscriber_metrics = subscriber->metrics();
+    success = check(subscriber_metrics.received == static_cast<std::uint64_t>(received), "received samples") &&
+              success;
+    success = check(subscriber_metrics.latency.count == subscriber_metrics.received &&
+                        subscriber_metrics.callback_duration.count == subscriber_metrics.received,
+                    "latency and callback duration") &&
+              success;
+    success = check(subscriber_metrics.received_bytes >= value.size() * expected_received, "received bytes") &&
+              success;
+
+    std::uint64_t taken = 0;
+    while (polling_subscriber->take_into(message))
+    {
+        ++taken;
+    }
+    const auto polling_metrics = polling_subscriber->metrics();
+    success = check(taken > 0 && polling_metrics.received == taken, "polled samples") && success;
+    success = check(polling_metrics.received_bytes >= value.size() * taken, "polled bytes") && success;
+
+    if (!success)
+    {
+        return 1;
+    }
+
+    std::cout << "metrics_test: Success" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,175 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "provizio/dds/point_cloud2.h"
+#include "provizio/dds/quantized_point_cloud2.h"
+#include "provizio/dds/test/check.h"
+
+namespace
+{
+    const provizio::dds::test::checker check{"point_cloud2_test"};
+} // namespace
+
+int main()
+{
+    std_msgs::msg::Header header;
+    header.stamp().sec(10);
+    header.stamp().nanosec(20);
+    header.frame_id("test_frame");
+
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const std::vector<provizio::dds::radar_point> points{{0.1F, 0.2F, 0.3F, 0.4F, 0.5F, 0.6F},
+                                                         {1.0F, 2.0F, 3.0F, 4.0F, 5.0F, nan}};
+    auto cloud = provizio::dds::make_radar_point_cloud(header, points);
+
+    bool success = true;
+    success = check(cloud.header().stamp().sec() == 10 && cloud.header().frame_id() == "test_frame", "header") &&
+              success;
+    success =
+        check(cloud.height() == 1 && cloud.width() == 2 && cloud.point_step() == 24 && cloud.row_step() == 48 &&
+                  cloud.fields().size() == 6 && cloud.fields()[5].name() == "ground_relative_radial_velocity",
+              "metadata") &&
+        success;
+
+    // Typed views
+    const auto y = provizio::dds::make_point_field_view<float>(cloud, "y");
+    success = check(y.valid() && y.size() == 2 && y[0] == 0.2F && y[1] == 2.0F, "float view") && success;
+    success = check(std::accumulate(y.begin(), y.end(), 0.0F) == 0.2F + 2.0F, "view iteration") && success;
+    success = check(!provizio::dds::make_point_field_view<double>(cloud, "y"), "mismatching type") && success;
+    success = check(!provizio::dds::make_point_field_view<float>(cloud, "intensity"), "missing field") && success;
+
+    auto z = provizio::dds::make_mutable_point_field_view<float>(cloud, "z");
+    for (auto value : z)
+    {
+        value = value * 2;
+    }
+    success = check(z[0] == 0.6F && z[1] == 6.0F, "mutable view") && success;
+
+    // Structure of arrays
+    provizio::dds::radar_points_soa soa;
+    success = check(provizio::dds::read_radar_points(cloud, soa) && soa.size() == 2, "read_radar_points") && success;
+    success = check(soa.x[1] == 1.0F && soa.z[1] == 6.0F && soa.signal_to_noise_ratio[0] == 0.5F &&
+                        std::isnan(soa.ground_relative_radial_velocity[1]),
+                    "read_radar_points values") &&
+              success;
+
+    std::vector<double> x;
+    success = check(provizio::dds::read_point_field(cloud, "x", x) == 2 && x[1] == 1.0, "converting read") && success;
+
+    // Generic layout: only x, y and z of a wider point, in the opposite byte order
+    sensor_msgs::msg::PointCloud2 xyz_cloud;
+    xyz_cloud.height(1);
+    xyz_cloud.width(1);
+    xyz_cloud.point_step(16);
+    xyz_cloud.is_bigendian(!cloud.is_bigendian());
+    xyz_cloud.fields(std::vector<sensor_msgs::msg::PointField>(cloud.fields().begin(), cloud.fields().begin() + 3));
+    xyz_cloud.data(std::vector<std::uint8_t>{0x3F, 0x80, 0, 0, 0x40, 0, 0, 0, 0x40, 0x40, 0, 0, 0, 0, 0, 0});
+    if (cloud.is_bigendian())
+    {
+        for (std::size_t i = 0; i < 12; i += 4)
+        {
+            std::reverse(xyz_cloud.data().begin() + i, xyz_cloud.data().begin() + i + 4);
+        }
+    }
+    success = check(provizio::dds::read_radar_points(xyz_cloud, soa) && soa.size() == 1 && soa.x[0] == 1.0F &&
+                        soa.y[0] == 2.0F && soa.z[0] == 3.0F && std::isnan(soa.signal_to_noise_ratio[0]),
+                    "generic read_radar_points") &&
+              success;
+
+    // Quantization
+    sensor_msgs::msg::PointCloud2 quantized;
+    success = check(provizio::dds::quantize_point_cloud(cloud, quantized,
+                                                        provizio::dds::radar_point_cloud_quantization()),
+                    "quantizing") &&
+              success;
+    success = check(quantized.point_step() == 5 * sizeof(std::int16_t) + sizeof(float) &&
+                        quantized.data().size() == 2 * quantized.point_step() &&
+                        provizio::dds::point_field_scale(quantized, "x") == 0.02F &&
+                        provizio::dds::point_field_scale(quantized, "signal_to_noise_ratio") == 0,
+                    "quantized layout") &&
+              success;
+    success = check(provizio::dds::read_radar_points(quantized, soa) && soa.size() == 2 &&
+                        std::abs(soa.x[1] - 1.0F) < 0.005F && std::abs(soa.z[1] - 6.0F) < 0.005F &&
+                        soa.signal_to_noise_ratio[0] == 0.5F && std::isnan(soa.ground_relative_radial_velocity[1]),
+                    "reading quantized") &&
+              success;
+    success = check(!provizio::dds::quantize_point_cloud(cloud, quantized, {{"y", 0}}), "invalid scale") && success;
+
+    sensor_msgs::msg::PointCloud2 dequantized;
+    success = check(provizio::dds::dequantize_point_cloud(quantized, dequantized) &&
+                        dequantized.fields().size() == cloud.fields().size() &&
+                        dequantized.point_step() == cloud.point_step(),
+                    "dequantizing") &&
+              success;
+    const auto dequantized_y = provizio::dds::make_point_field_view<float>(dequantized, "y");
+    success = check(dequantized_y.valid() && std::abs(dequantized_y[0] - 0.2F) < 0.005F, "dequantized values") &&
+              success;
+
+    // Quantized clouds are published on a topic of their own, so plain subscribers keep the float fields
+    const std::string topic_name{"provizio_dds_test_point_cloud2_topic"};
+    const auto participant = provizio::dds::make_domain_participant();
+    std::mutex mutex;
+    std::uint8_t plain_datatype = 0;
+    float restored_y = 0;
+    auto plain_subscriber = provizio::dds::make_subscriber<sensor_msgs::msg::PointCloud2PubSubType>(
+        participant, topic_name, [&](const sensor_msgs::msg::PointCloud2 &received) {
+            const auto *field = provizio::dds::find_point_field(received, "y");
+            std::lock_guard<std::mutex> lock{mutex};
+            plain_datatype = field != nullptr ? field->datatype() : 0;
+        });
+    auto quantized_subscriber = provizio::dds::make_quantized_point_cloud2_subscriber(
+        participant, topic_name, [&](const sensor_msgs::msg::PointCloud2 &restored) {
+            const auto restored_view = provizio::dds::make_point_field_view<float>(restored, "y");
+            std::lock_guard<std::mutex> lock{mutex};
+            restored_y = restored_view.valid() && restored_view.size() > 0 ? restored_view[0] : 0;
+        });
+    auto publisher = provizio::dds::make_quantized_point_cloud2_publisher(participant, topic_name);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{3};
+    bool received = false;
+    while (!received && std::chrono::steady_clock::now() < deadline)
+    {
+        publisher->publish(cloud);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        std::lock_guard<std::mutex> lock{mutex};
+        received = plain_datatype != 0 && restored_y != 0;
+    }
+    success = check(plain_datatype == static_cast<std::uint8_t>(provizio::dds::point_field_datatype::float32),
+                    "plain subscriber receives float fields") &&
+              success;
+    success = check(std::abs(restored_y - 0.2F) < 0.011F, "quantized subscriber receives restored fields") && success;
+
+    // Refilling in place
+    const auto *const data = cloud.data().data();
+    provizio::dds::fill_radar_point_cloud(cloud, header, points.data(), 1);
+    success = check(cloud.width() == 1 && cloud.data().size() == 24 && cloud.data().data() == data, "refilling") &&
+              success;
+
+    if (success)
+    {
+        std::cout << "point_cloud2_test: Success" << std::endl;
+    }
+    return success ? 0 : 1;
+}
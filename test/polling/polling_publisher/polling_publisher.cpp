@@ -0,0 +1,53 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <thread>
+
+#include "provizio/dds/publisher.h"
+
+#include <std_msgs/msg/StringPubSubTypes.h>
+
+int main()
+{
+    const std::string first_topic_name{"provizio_dds_test_polling_first_topic"};
+    const std::string second_topic_name{"provizio_dds_test_polling_second_topic"};
+    const std::string value{"provizio_dds_test"};
+    const std::chrono::milliseconds wait_time{50};
+    // Each topic is published to for 2 seconds: first the second one only, so polling_subscriber can check that only
+    // its second subscriber gets ready, then the first one
+    const int publish_times = 40;
+
+    const auto participant = provizio::dds::make_domain_participant();
+    auto first_publisher =
+        provizio::dds::make_publisher<std_msgs::msg::StringPubSubType>(participant, first_topic_name);
+    auto second_publisher =
+        provizio::dds::make_publisher<std_msgs::msg::StringPubSubType>(participant, second_topic_name);
+    std_msgs::msg::String message;
+    message.data(value);
+
+    int successful_times = 0;
+    for (auto *publisher : {second_publisher.get(), first_publisher.get()})
+    {
+        for (int i = 0; i < publish_times; ++i)
+        {
+            successful_times += publisher->publish(message) ? 1 : 0;
+            std::this_thread::sleep_for(wait_time);
+        }
+    }
+
+    std::cout << "polling_publisher: Successfully published " << successful_times << " times" << std::endl;
+
+    return successful_times > 0 ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "provizio/dds/subscriber.h"
+#include "provizio/dds/test/check.h"
+#include "provizio/dds/wait_set.h"
+
+#include <std_msgs/msg/StringPubSubTypes.h>
+
+namespace
+{
+    const provizio::dds::test::checker check{"polling_subscriber"};
+} // namespace
+
+int main()
+{
+    const std::string first_topic_name{"provizio_dds_test_polling_first_topic"};
+    const std::string second_topic_name{"provizio_dds_test_polling_second_topic"};
+    const std::string value{"provizio_dds_test"};
+    const std::chrono::seconds wait_time{3};
+
+    const auto participant = provizio::dds::make_domain_participant();
+    auto first_subscriber =
+        provizio::dds::make_polling_subscriber<std_msgs::msg::StringPubSubType>(participant, first_topic_name);
+    auto second_subscriber =
+        provizio::dds::make_polling_subscriber<std_msgs::msg::StringPubSubType>(participant, second_topic_name);
+
+    bool success = check(!first_subscriber->poll(std::chrono::milliseconds(10)), "no data polled before publishing");
+
+    provizio::dds::wait_set wait_set;
+    const auto first_index = wait_set.attach(first_subscriber);
+    const auto second_index = wait_set.attach(second_subscriber);
+    success = check(first_index != provizio::dds::wait_set::npos && second_index != provizio::dds::wait_set::npos,
+                    "subscribers attached") &&
+              success;
+
+    // polling_publisher publishes to the second topic only, until it switches to the first one
+    const auto deadline = std::chrono::steady_clock::now() + wait_time;
+    bool second_ready = false;
+    while (!second_ready && std::chrono::steady_clock::now() < deadline)
+    {
+        second_ready = wait_set.wait(std::chrono::milliseconds(50)) > 0 && wait_set.ready(second_index);
+    }
+    success = check(second_ready, "second subscriber ready") && success;
+    success = check(!wait_set.ready(first_index), "first subscriber not ready") && success;
+
+    std_msgs::msg::String received;
+    success = check(second_subscriber->take_into(received), "sample taken") && success;
+    success = check(received.data() == value, "sample value taken") && success;
+    success = check(!first_subscriber->take_into(received), "no sample taken from the first subscriber") && success;
+    success = check(second_subscriber->metrics().received > 0, "taken samples counted") && success;
+
+    // A single subscriber can be polled on its own too
+    bool first_polled = false;
+    while (!first_polled && std::chrono::steady_clock::now() < deadline + wait_time)
+    {
+        first_polled = first_subscriber->poll(std::chrono::milliseconds(50));
+    }
+    success = check(first_polled, "first subscriber polled") && success;
+    success = check(first_subscriber->take_into(received) && received.data() == value, "polled sample taken") &&
+              success;
+
+    if (!success)
+    {
+        return 1;
+    }
+
+    std::cout << "polling_subscriber: Success" << std::endl;
+
+    return 0;
+}
@@ -15,6 +15,7 @@
 # limitations under the License.
 
 import sys
+import numpy as np
 import provizio_dds
 
 # Create a PointCloud2
@@ -53,4 +54,58 @@ assert str(
 assert str(
     read_points[1]) == "Point(x=1.0, y=2.0, z=3.0, radar_relative_radial_velocity=4.0, signal_to_noise_ratio=5.0, ground_relative_radial_velocity=nan)", "Got:" + str(read_points[1])
 
+# Read it as a numpy array, which is a copy by default and, on request, a view sharing the data of the cloud
+print("Reading the PointCloud2 as a numpy array...")
+numpy_points = provizio_dds.point_cloud2.read_points_numpy(cloud, copy=False)
+assert numpy_points.shape == (2, 6), "Got:" + str(numpy_points.shape)
+assert np.shares_memory(
+    numpy_points, provizio_dds.point_cloud2.read_points(cloud, copy=False))
+assert not np.shares_memory(
+    numpy_points, provizio_dds.point_cloud2.read_points(cloud))
+
+# Create it from NumPy columns, reusing the cloud and its data buffer
+print("Creating a PointCloud2 from NumPy arrays...")
+columns = {name: np.asarray(numpy_points[:, i]) for i, name in enumerate(
+    ["x", "y", "z", "radar_relative_radial_velocity", "signal_to_noise_ratio", "ground_relative_radial_velocity"])}
+reused = provizio_dds.point_cloud2.make_radar_point_cloud(
+    provizio_dds.point_cloud2.make_header(11, 21, "test_frame"), columns)
+reused_view = provizio_dds.point_cloud2.read_points(reused, copy=False)
+assert reused.width() == 2 and reused.row_step() == 48, "Got:" + str(reused.width())
+assert np.array_equal(provizio_dds.point_cloud2.read_points_numpy(reused), numpy_points, equal_nan=True)
+reused = provizio_dds.point_cloud2.make_radar_point_cloud(
+    provizio_dds.point_cloud2.make_header(12, 22, "test_frame"), numpy_points[::-1], cloud=reused)
+assert reused.header().stamp().sec() == 12
+reused_points = provizio_dds.point_cloud2.read_points(reused, copy=False)
+assert abs(reused_points[0]["x"] - 1.0) < 1e-6, "Got:" + str(reused_points[0]["x"])
+assert abs(reused_points[1]["x"] - 0.1) < 1e-6, "Got:" + str(reused_points[1]["x"])
+
+# Views read before refilling a cloud keep its previous data rather than pointing to freed memory
+print("Resizing a PointCloud2 after reading it...")
+assert not np.shares_memory(reused_view, reused_points)
+reused = provizio_dds.point_cloud2.make_radar_point_cloud(
+    provizio_dds.point_cloud2.make_header(13, 23, "test_frame"), np.zeros((1000, 6), dtype=np.float32), cloud=reused)
+assert reused.width() == 1000, "Got:" + str(reused.width())
+assert abs(reused_view[0]["x"] - 0.1) < 1e-6, "Got:" + str(reused_view[0]["x"])
+assert abs(reused_points[0]["x"] - 1.0) < 1e-6, "Got:" + str(reused_points[0]["x"])
+assert provizio_dds.point_cloud2.read_points_numpy(reused).sum() == 0
+del reused_view, reused_points
+
+# Quantize it and restore it
+print("Quantizing the PointCloud2...")
+quantized = provizio_dds.point_cloud2.quantize_cloud(cloud)
+assert quantized.point_step() == 14, "Got:" + str(quantized.point_step())
+dequantized_points = provizio_dds.point_cloud2.read_points_numpy(
+    provizio_dds.point_cloud2.dequantize_cloud(quantized))
+assert dequantized_points.shape == (2, 6), "Got:" + str(dequantized_points.shape)
+assert abs(dequantized_points[1][0] - 1.0) < 0.005, "Got:" + str(dequantized_points[1][0])
+assert np.isnan(dequantized_points[1][5])
+try:
+    provizio_dds.point_cloud2.quantize_cloud(cloud, {"x": 0.0})
+    assert False, "Quantized with a zero scale"
+except ValueError:
+    pass
+
+del cloud
+assert abs(numpy_points[1][2] - 3.0) < 1e-6, "Got:" + str(numpy_points[1][2])
+
 print("Success")
@@ -0,0 +1,51 @@
+#!/usr/bin/env python3
+
+# Copyright 2023 Provizio Ltd.
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""
+Test DDS publisher written in Python using asyncio
+"""
+import asyncio
+import sys
+import provizio_dds
+
+TEST_TOPIC_NAME = "provizio_dds_test_async_pub_sub_topic"
+TEST_VALUE = "provizio_dds_test"
+WAIT_TIME = 0.2
+MATCH_TIMEOUT = 6
+PUBLISH_TIMES = 25
+
+
+async def main():
+    publisher = provizio_dds.AsyncPublisher(
+        provizio_dds.make_domain_participant(), TEST_TOPIC_NAME, provizio_dds.StringPubSubType)
+
+    try:
+        await asyncio.wait_for(publisher.wait_for_subscriber(), MATCH_TIMEOUT)
+    except asyncio.TimeoutError:
+        print("python_async_publisher: never matched a subscriber")
+        return 1
+
+    message = provizio_dds.String()
+    message.data(TEST_VALUE)
+    successful_times = 0
+    for i in range(PUBLISH_TIMES):
+        successful_times += 1 if await publisher.publish_async(message) else 0
+        await asyncio.sleep(WAIT_TIME)
+
+    print(
+        f"python_async_publisher: Successfully published {successful_times} times")
+    return 0 if successful_times > 0 else 1
+
+sys.exit(asyncio.run(main()))
@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+
+# Copyright 2023 Provizio Ltd.
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""
+Test DDS subscriber written in Python using asyncio
+"""
+import asyncio
+import sys
+import provizio_dds
+
+TEST_TOPIC_NAME = "provizio_dds_test_async_pub_sub_topic"
+TEST_VALUE = "provizio_dds_test"
+WAIT_TIME = 6
+RECEIVE_TIMES = 3
+
+
+async def main():
+    subscriber = provizio_dds.AsyncSubscriber(
+        provizio_dds.make_domain_participant(), TEST_TOPIC_NAME, provizio_dds.StringPubSubType, provizio_dds.String)
+
+    try:
+        await asyncio.wait_for(subscriber.wait_for_publisher(), WAIT_TIME)
+    except asyncio.TimeoutError:
+        print("python_async_subscriber: never matched a publisher")
+        return 1
+
+    async def receive():
+        received = 0
+        async for message in subscriber:
+            if message.data() != TEST_VALUE:
+                print(
+                    f"python_async_subscriber: {TEST_VALUE} was expected but {message.data()} was received!")
+                return False
+            received += 1
+            if received == RECEIVE_TIMES:
+                return True
+
+    try:
+        if not await asyncio.wait_for(receive(), WAIT_TIME):
+            return 1
+    except asyncio.TimeoutError:
+        print("python_async_subscriber: Failed to receive samples")
+        return 1
+
+    # Stops waking up the event loop, which asyncio.run closes
+    subscriber.close()
+
+    print("python_async_subscriber: Success!")
+    return 0
+
+sys.exit(asyncio.run(main()))
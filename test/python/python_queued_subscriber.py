@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+
+# Copyright 2023 Provizio Ltd.
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""
+Test DDS subscriber written in Python, taking samples in batches from a queue
+"""
+import asyncio
+import sys
+import time
+import provizio_dds
+
+TEST_TOPIC_NAME = "provizio_dds_test_simplest_pub_sub_topic"
+TEST_VALUE = "provizio_dds_test"
+WAIT_TIME = 6
+
+subscriber = provizio_dds.QueuedSubscriber(
+    provizio_dds.make_domain_participant(), TEST_TOPIC_NAME, provizio_dds.StringPubSubType, provizio_dds.String)
+
+# Synchronously
+received = 0
+deadline = time.monotonic() + WAIT_TIME
+while received < 2 and time.monotonic() < deadline:
+    for message in subscriber.take_batch(timeout=deadline - time.monotonic()):
+        if message.data() != TEST_VALUE:
+            print(
+                f"python_queued_subscriber: {TEST_VALUE} was expected but {message.data()} was received!")
+            sys.exit(1)
+        received += 1
+
+if received < 2:
+    print("python_queued_subscriber: Failed to take samples")
+    sys.exit(1)
+
+
+# Asynchronously
+async def take_async():
+    async for batch in subscriber:
+        return batch[0].data()
+
+try:
+    received_string = asyncio.run(asyncio.wait_for(take_async(), WAIT_TIME))
+except asyncio.TimeoutError:
+    print("python_queued_subscriber: Failed to take samples asynchronously")
+    sys.exit(1)
+
+del subscriber
+
+if received_string != TEST_VALUE:
+    print(
+        f"python_queued_subscriber: {TEST_VALUE} was expected but {received_string} was received!")
+    sys.exit(1)
+
+print("python_queued_subscriber: Success!")
+sys.exit(0)
@@ -0,0 +1,133 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <string>
+
+#include "provizio/dds/publisher.h"
+#include "provizio/dds/subscriber.h"
+#include "provizio/dds/test/check.h"
+
+#include <sensor_msgs/msg/PointCloud2PubSubTypes.h>
+#include <std_msgs/msg/Int32PubSubTypes.h>
+#include <std_msgs/msg/StringPubSubTypes.h>
+
+namespace provizio
+{
+    namespace dds
+    {
+        // A specialization written before most of the policies were introduced, which must keep building
+        template <> struct qos_defaults<std_msgs::msg::StringPubSubType> final
+        {
+            static constexpr ReliabilityQosPolicyKind datawriter_reliability_kind = BEST_EFFORT_RELIABILITY_QOS;
+            static constexpr ReliabilityQosPolicyKind datareader_reliability_kind = BEST_EFFORT_RELIABILITY_QOS;
+            static constexpr auto memory_policy = eprosima::fastrtps::rtps::DYNAMIC_RESERVE_MEMORY_MODE;
+        };
+
+        // Preallocated with unlimited resource limits, so only the history depth is preallocated
+        template <> struct qos_defaults<std_msgs::msg::Int32PubSubType> final : default_qos_policies
+        {
+            static constexpr std::int32_t history_depth = 3;
+            static constexpr std::int32_t max_samples = LENGTH_UNLIMITED;
+            static constexpr std::int32_t max_samples_per_instance = LENGTH_UNLIMITED;
+            static constexpr bool preallocate = true;
+        };
+    } // namespace dds
+} // namespace provizio
+
+namespace
+{
+    const provizio::dds::test::checker check{"qos_defaults_test"};
+
+    // Fast-DDS refuses to create data writers and data readers with inconsistent resource limits
+    template <typename data_pub_sub_type> bool consistent_resource_limits()
+    {
+        using policies = provizio::dds::detail::qos_policies_of<data_pub_sub_type>;
+        return policies::max_instances * policies::max_samples_per_instance <= policies::max_samples &&
+               (policies::history_kind != eprosima::fastdds::dds::KEEP_LAST_HISTORY_QOS ||
+                policies::history_depth <= policies::max_samples_per_instance) &&
+               policies::allocated_samples <= policies::max_samples;
+    }
+
+    template <typename data_pub_sub_type> bool pub_sub_created(const std::string &topic_name)
+    {
+        auto participant = provizio::dds::make_domain_participant();
+        auto publisher = provizio::dds::make_publisher<data_pub_sub_type>(participant, topic_name);
+        auto subscriber = provizio::dds::make_subscriber<data_pub_sub_type>(
+            participant, topic_name, [](const typename data_pub_sub_type::type &) {});
+        return publisher != nullptr && subscriber != nullptr;
+    }
+} // namespace
+
+int main()
+{
+    using legacy_policies = provizio::dds::detail::qos_policies_of<std_msgs::msg::StringPubSubType>;
+    using default_policies = provizio::dds::default_qos_policies;
+
+    bool success =
+        check(legacy_policies::datareader_reliability_kind == eprosima::fastdds::dds::BEST_EFFORT_RELIABILITY_QOS &&
+                  legacy_policies::memory_policy == eprosima::fastrtps::rtps::DYNAMIC_RESERVE_MEMORY_MODE,
+              "declared policies of a legacy specialization");
+    success = check(legacy_policies::history_depth == default_policies::history_depth &&
+                        legacy_policies::max_samples == default_policies::max_samples &&
+                        legacy_policies::max_samples_per_instance == default_policies::max_samples_per_instance &&
+                        legacy_policies::publish_mode_kind == default_policies::publish_mode_kind &&
+                        legacy_policies::preallocate == default_policies::preallocate &&
+                        legacy_policies::lifespan_milliseconds == default_policies::lifespan_milliseconds,
+                    "fallback policies of a legacy specialization") &&
+              success;
+
+    success = check(consistent_resource_limits<std_msgs::msg::StringPubSubType>(), "default resource limits") &&
+              success;
+    success =
+        check(consistent_resource_limits<sensor_msgs::msg::PointCloud2PubSubType>(), "large data resource limits") &&
+        success;
+
+    eprosima::fastdds::dds::DataWriterQos writer_qos;
+    provizio::dds::detail::apply_qos_defaults<sensor_msgs::msg::PointCloud2PubSubType>(
+        writer_qos, eprosima::fastdds::dds::TypeSupport(new sensor_msgs::msg::PointCloud2PubSubType()));
+    success = check(writer_qos.history().depth == 1 && writer_qos.resource_limits().max_samples == 4 &&
+                        writer_qos.resource_limits().max_samples_per_instance == 4 &&
+                        writer_qos.resource_limits().allocated_samples == 2,
+                    "large data writer QOS") &&
+              success;
+
+    eprosima::fastdds::dds::DataReaderQos unlimited_reader_qos;
+    provizio::dds::detail::apply_qos_defaults<std_msgs::msg::Int32PubSubType>(
+        unlimited_reader_qos, eprosima::fastdds::dds::TypeSupport(new std_msgs::msg::Int32PubSubType()));
+    success = check(unlimited_reader_qos.resource_limits().max_samples == eprosima::fastdds::dds::LENGTH_UNLIMITED &&
+                        unlimited_reader_qos.resource_limits().allocated_samples == 3,
+                    "preallocated QOS with unlimited resource limits") &&
+              success;
+
+    success = check(pub_sub_created<std_msgs::msg::StringPubSubType>("provizio_dds_test_qos_defaults_legacy_topic"),
+                    "legacy specialization publisher and subscriber") &&
+              success;
+    success = check(pub_sub_created<sensor_msgs::msg::PointCloud2PubSubType>(
+                        "provizio_dds_test_qos_defaults_large_data_topic"),
+                    "large data publisher and subscriber") &&
+              success;
+    success = check(pub_sub_created<std_msgs::msg::Int32PubSubType>("provizio_dds_test_qos_defaults_unlimited_topic"),
+                    "preallocated publisher and subscriber with unlimited resource limits") &&
+              success;
+
+    if (!success)
+    {
+        return 1;
+    }
+
+    std::cout << "qos_defaults_test: Success" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,250 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "provizio/dds/publisher.h"
+#include "provizio/dds/recording.h"
+#include "provizio/dds/subscriber.h"
+#include "provizio/dds/test/check.h"
+
+#include <std_msgs/msg/StringPubSubTypes.h>
+
+namespace
+{
+    const std::string topic_name{"provizio_dds_test_recording_topic"};
+    const std::string recording_path{"provizio_dds_test_recording"};
+    constexpr int samples_count = 10;
+    const std::chrono::seconds wait_time{3};
+
+    const provizio::dds::test::checker check{"recording_test"};
+
+    std::string expected_value(const int i)
+    {
+        return "provizio_dds_test_" + std::to_string(i);
+    }
+
+    std::string deserialized_value(const provizio::dds::recorded_sample &sample)
+    {
+        eprosima::fastrtps::rtps::SerializedPayload_t payload(static_cast<std::uint32_t>(sample.size));
+        std::memcpy(payload.data, sample.data, sample.size);
+        payload.length = static_cast<std::uint32_t>(sample.size);
+
+        std_msgs::msg::StringPubSubType type;
+        std_msgs::msg::String message;
+        return type.deserialize(&payload, &message) ? message.data() : std::string{};
+    }
+
+    bool record()
+    {
+        // The recorder can't share a participant with the typed publisher
+        provizio::dds::recording_options options;
+        options.path = recording_path;
+        options.segment_size = 256; // A few samples per segment, to test rolling over
+        provizio::dds::recorder recorder{provizio::dds::make_domain_participant(), options};
+        if (!check(recorder.is_open(), "recording created") ||
+            !check(recorder.add_topic<std_msgs::msg::StringPubSubType>(topic_name,
+                                                                        provizio::dds::RELIABLE_RELIABILITY_QOS),
+                   "topic added"))
+        {
+            return false;
+        }
+
+        std::atomic<bool> matched{false};
+        auto publisher = provizio::dds::make_publisher<std_msgs::msg::StringPubSubType>(
+            provizio::dds::make_domain_participant(), topic_name,
+            [&](provizio::dds::data_publisher<std_msgs::msg::StringPubSubType> &, const bool has_subscriber) {
+                matched = has_subscriber;
+            },
+            provizio::dds::RELIABLE_RELIABILITY_QOS);
+        const auto deadline = std::chrono::steady_clock::now() + wait_time;
+        while (!matched && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        if (!check(matched, "recorder matched"))
+        {
+            return false;
+        }
+
+        std_msgs::msg::String message;
+        for (int i = 0; i < samples_count; ++i)
+        {
+            message.data(expected_value(i));
+            publisher->publish(message);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        publisher->wait_for_acknowledgments(wait_time);
+        recorder.close();
+
+        const auto statistics = recorder.statistics();
+        bool success = check(statistics.recorded_samples == samples_count, "all samples recorded");
+        success = check(statistics.dropped_samples == 0, "no samples dropped") && success;
+        success = check(statistics.segments > 1, "rolled over to new segments") && success;
+        return success;
+    }
+
+    bool read()
+    {
+        provizio::dds::recording_reader reader{recording_path};
+        if (!check(reader.is_open(), "recording opened"))
+        {
+            return false;
+        }
+
+        bool success = true;
+        std::vector<std::int64_t> times;
+        provizio::dds::recorded_sample sample;
+        while (reader.next(sample))
+        {
+            const auto i = static_cast<int>(times.size());
+            success = check(sample.channel->topic_name == topic_name, "topic name read") && success;
+            success = check(deserialized_value(sample) == expected_value(i), "sample read in order") && success;
+            success = check(times.empty() || sample.reception_time_ns >= times.back(), "ordered times") && success;
+            times.push_back(sample.reception_time_ns);
+        }
+        if (!check(times.size() == samples_count, "all samples read"))
+        {
+            return false;
+        }
+
+        const int middle = samples_count / 2;
+        success = check(reader.seek(times[middle]) && reader.next(sample), "seek") && success;
+        success = check(deserialized_value(sample) == expected_value(middle), "seeked to the sample") && success;
+        return success;
+    }
+
+    bool replay()
+    {
+        std::mutex mutex;
+        std::vector<std::string> received;
+        auto subscriber = provizio::dds::make_subscriber<std_msgs::msg::StringPubSubType>(
+            provizio::dds::make_domain_participant(), topic_name,
+            [&](const std_msgs::msg::String &message) {
+                std::lock_guard<std::mutex> lock{mutex};
+                received.push_back(message.data());
+            },
+            provizio::dds::RELIABLE_RELIABILITY_QOS);
+
+        provizio::dds::replay_options options;
+        options.speed = 4.0;
+        options.match_timeout = wait_time;
+        provizio::dds::replayer replayer{provizio::dds::make_domain_participant(), recording_path, options};
+        bool success = check(replayer.run() == samples_count, "all samples replayed");
+
+        const auto deadline = std::chrono::steady_clock::now() + wait_time;
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                if (received.size() >= samples_count)
+                {
+                    break;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        std::lock_guard<std::mutex> lock{mutex};
+        success = check(received.size() == samples_count, "all replayed samples received") && success;
+        for (std::size_t i = 0; i < received.size(); ++i)
+        {
+            success = check(received[i] == expected_value(static_cast<int>(i)), "replayed in order") && success;
+        }
+        return success;
+    }
+
+    bool reject_oversized_topic()
+    {
+        // The channel record of a topic must fit a segment along with the segment header
+        provizio::dds::recording_options options;
+        options.path = recording_path;
+        options.segment_size = 128;
+        provizio::dds::recorder recorder{provizio::dds::make_domain_participant(), options};
+        return check(recorder.is_open(), "small recording created") &&
+               check(!recorder.add_topic<std_msgs::msg::StringPubSubType>(std::string(128, 't')),
+                     "oversized topic rejected");
+    }
+
+    bool reject_topic_without_reader()
+    {
+        // The recorded type is already registered in its deserialized form, so no DataReader can be created for it
+        const auto participant = provizio::dds::make_domain_participant();
+        const auto subscriber = provizio::dds::make_subscriber<std_msgs::msg::StringPubSubType>(
+            participant, topic_name + "_typed", [](const std_msgs::msg::String &) {});
+        provizio::dds::recording_options options;
+        options.path = recording_path;
+        provizio::dds::recorder recorder{participant, options};
+        return check(subscriber != nullptr && recorder.is_open(), "recording sharing a participant created") &&
+               check(!recorder.add_topic<std_msgs::msg::StringPubSubType>(topic_name),
+                     "topic with no DataReader rejected");
+    }
+
+    bool handles_with_own_type_support()
+    {
+        // The constructors the recorder and the replayer rely on, which take a DDS Type Support of their own
+        const auto participant = provizio::dds::make_domain_participant();
+        const provizio::dds::publisher_handle<std_msgs::msg::StringPubSubType> publisher{
+            participant, topic_name + "_type_support",
+            provizio::dds::TypeSupport(new std_msgs::msg::StringPubSubType())};
+        const provizio::dds::subscriber_handle<std_msgs::msg::StringPubSubType> subscriber{
+            participant, topic_name + "_type_support",
+            provizio::dds::TypeSupport(new std_msgs::msg::StringPubSubType()), provizio::dds::content_filter{},
+            std::make_shared<provizio::dds::DataReaderListener>()};
+        return check(publisher.instance_handle() != eprosima::fastdds::dds::HANDLE_NIL,
+                     "publisher with its own type support") &&
+               check(subscriber.instance_handle() != eprosima::fastdds::dds::HANDLE_NIL,
+                     "subscriber with its own type support");
+    }
+
+    void remove_recording()
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            char suffix[32];
+            std::snprintf(suffix, sizeof(suffix), "_%04d.pvzrec", i);
+            std::remove((recording_path + suffix).c_str());
+        }
+    }
+} // namespace
+
+int main()
+{
+    remove_recording();
+
+    bool success = handles_with_own_type_support();
+    success = success && record();
+    success = success && read();
+    success = success && replay();
+    success = reject_oversized_topic() && success;
+    success = reject_topic_without_reader() && success;
+
+    remove_recording();
+
+    if (!success)
+    {
+        return 1;
+    }
+
+    std::cout << "recording_test: Success" << std::endl;
+
+    return 0;
+}
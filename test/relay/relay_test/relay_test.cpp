@@ -0,0 +1,90 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include "provizio/dds/publisher.h"
+#include "provizio/dds/relay.h"
+#include "provizio/dds/subscriber.h"
+#include "provizio/dds/test/check.h"
+
+#include <std_msgs/msg/StringPubSubTypes.h>
+
+namespace
+{
+    const provizio::dds::test::checker check{"relay_test"};
+} // namespace
+
+int main()
+{
+    const std::string source_topic_name{"provizio_dds_test_relay_source_topic"};
+    const std::string destination_topic_name{"provizio_dds_test_relay_destination_topic"};
+    const std::string value{"provizio_dds_test"};
+    const std::chrono::seconds wait_time{3};
+
+    // Relayed samples are received by a regular subscriber of another topic
+    std::mutex mutex;
+    std::string relayed_value;
+    auto subscriber = provizio::dds::make_subscriber<std_msgs::msg::StringPubSubType>(
+        provizio::dds::make_domain_participant(), destination_topic_name, [&](const std_msgs::msg::String &message) {
+            std::lock_guard<std::mutex> lock{mutex};
+            relayed_value = message.data();
+        });
+
+    // Raw samples are neither deserialized nor serialized, so the relay and the raw subscriber can't share a
+    // participant with the regular publisher and subscriber
+    const auto raw_participant = provizio::dds::make_domain_participant();
+    provizio::dds::relay_options options;
+    options.destination_topic_name = destination_topic_name;
+    auto relay = provizio::dds::make_relay<std_msgs::msg::StringPubSubType>(raw_participant, raw_participant,
+                                                                            source_topic_name, options);
+    std::atomic<std::size_t> raw_size{0};
+    auto raw_subscriber = provizio::dds::make_raw_subscriber(
+        raw_participant, source_topic_name, "std_msgs::msg::dds_::String_",
+        [&](const provizio::dds::serialized_sample &sample) { raw_size = sample.size(); });
+
+    auto publisher = provizio::dds::make_publisher<std_msgs::msg::StringPubSubType>(
+        provizio::dds::make_domain_participant(), source_topic_name);
+    std_msgs::msg::String message;
+    message.data(value);
+
+    const auto deadline = std::chrono::steady_clock::now() + wait_time;
+    bool relayed = false;
+    while (!relayed && std::chrono::steady_clock::now() < deadline)
+    {
+        publisher->publish(message);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        std::lock_guard<std::mutex> lock{mutex};
+        relayed = relayed_value == value;
+    }
+
+    bool success = check(relayed, "sample relayed");
+    success = check(raw_size > value.size(), "raw sample received") && success;
+    success = check(relay->metrics().received.received_bytes > 0, "relayed bytes counted") && success;
+    success = check(relay->metrics().forwarded.published > 0, "relayed samples counted") && success;
+    success = check(raw_subscriber->metrics().received_bytes >= raw_size, "raw bytes counted") && success;
+
+    if (!success)
+    {
+        return 1;
+    }
+
+    std::cout << "relay_test: Success" << std::endl;
+
+    return 0;
+}
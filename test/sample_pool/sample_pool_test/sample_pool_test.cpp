@@ -0,0 +1,171 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "provizio/dds/sample_pool.h"
+#include "provizio/dds/test/check.h"
+
+#include <std_msgs/msg/StringPubSubTypes.h>
+
+namespace
+{
+    const provizio::dds::test::checker check{"sample_pool_test"};
+
+    using string_pool = provizio::dds::sample_pool<std_msgs::msg::String>;
+
+    bool reuses_released_samples()
+    {
+        bool success = true;
+
+        string_pool pool{1};
+        success = check(pool.size() == 1, "pool size") && success;
+
+        std_msgs::msg::String *first = nullptr;
+        {
+            auto lease = pool.acquire();
+            first = lease.get().get();
+            lease->data("provizio_dds_test");
+        }
+
+        {
+            // The released sample is acquired again, along with its contents
+            auto lease = pool.acquire();
+            success = check(lease.get().get() == first, "released sample reused") && success;
+            success = check(lease->data() == "provizio_dds_test", "reused sample contents kept") && success;
+        }
+
+        {
+            // A sample retained beyond its lease is not acquired again, until the last copy is gone
+            std::shared_ptr<std_msgs::msg::String> retained = pool.acquire().get();
+            success = check(retained.get() == first, "pool sample retained") && success;
+            success = check(pool.acquire().get().get() != first, "retained sample not reused") && success;
+            retained.reset();
+            success = check(pool.acquire().get().get() == first, "sample reused once no longer retained") && success;
+        }
+
+        return success;
+    }
+
+    bool grows_when_all_samples_busy()
+    {
+        bool success = true;
+
+        string_pool pool;
+        success = check(pool.size() == string_pool::default_size, "default pool size") && success;
+
+        std::vector<string_pool::lease> leases;
+        for (std::size_t i = 0; i < string_pool::default_size; ++i)
+        {
+            leases.push_back(pool.acquire());
+        }
+        std::vector<std_msgs::msg::String *> pool_samples;
+        for (const auto &lease : leases)
+        {
+            pool_samples.push_back(lease.get().get());
+        }
+        std::sort(pool_samples.begin(), pool_samples.end());
+        success = check(std::unique(pool_samples.begin(), pool_samples.end()) == pool_samples.end(),
+                        "distinct samples leased") &&
+                  success;
+
+        // All pool samples are busy, so a new one is allocated that doesn't belong to the pool
+        const auto extra = pool.acquire();
+        success = check(extra.get() != nullptr, "extra sample allocated") && success;
+        success = check(!std::binary_search(pool_samples.begin(), pool_samples.end(), extra.get().get()),
+                        "extra sample not from the pool") &&
+                  success;
+        success = check(extra.get().use_count() == 1, "extra sample not kept by the pool") && success;
+
+        // Once released, only the pool samples are reused
+        leases.clear();
+        bool reused = true;
+        for (std::size_t i = 0; i < string_pool::default_size * 2; ++i)
+        {
+            reused = std::binary_search(pool_samples.begin(), pool_samples.end(), pool.acquire().get().get()) && reused;
+        }
+        success = check(reused, "pool samples reused after growing") && success;
+
+        return success;
+    }
+
+    bool samples_outlive_pool()
+    {
+        std::shared_ptr<std_msgs::msg::String> retained;
+        {
+            string_pool pool{2};
+            auto lease = pool.acquire();
+            lease->data("provizio_dds_test");
+            retained = lease.get();
+        }
+
+        return check(retained != nullptr && retained.use_count() == 1, "sample outlives the pool") &&
+               check(retained->data() == "provizio_dds_test", "contents of the sample outliving the pool");
+    }
+
+    bool concurrent_leases_are_exclusive()
+    {
+        const int threads_count = 4;
+        const int iterations = 10000;
+
+        string_pool pool{2};
+        std::atomic<bool> exclusive{true};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threads_count; ++t)
+        {
+            threads.emplace_back([&pool, &exclusive, t]() {
+                const std::string value = std::to_string(t);
+                for (int i = 0; i < iterations; ++i)
+                {
+                    auto lease = pool.acquire();
+                    lease->data(value);
+                    std::this_thread::yield();
+                    if (lease->data() != value)
+                    {
+                        exclusive = false;
+                    }
+                }
+            });
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        return check(exclusive, "concurrent leases exclusive");
+    }
+} // namespace
+
+int main()
+{
+    bool success = reuses_released_samples();
+    success = grows_when_all_samples_busy() && success;
+    success = samples_outlive_pool() && success;
+    success = concurrent_leases_are_exclusive() && success;
+
+    if (!success)
+    {
+        return 1;
+    }
+
+    std::cout << "sample_pool_test: Success" << std::endl;
+
+    return 0;
+}
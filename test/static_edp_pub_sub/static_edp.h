@@ -0,0 +1,53 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DDS_TEST_STATIC_EDP
+#define DDS_TEST_STATIC_EDP
+
+#include <cstdint>
+#include <string>
+
+#include "provizio/dds/domain_participant.h"
+
+#include <std_msgs/msg/StringPubSubTypes.h>
+
+namespace provizio
+{
+    namespace dds
+    {
+        namespace test
+        {
+            // Shared by static_edp_publisher and static_edp_subscriber, each describing the endpoint of the other
+            const std::string static_edp_topic_name{"provizio_dds_test_static_edp_pub_sub_topic"};
+            const std::string static_edp_publisher_name{"provizio_dds_test_static_edp_publisher"};
+            const std::string static_edp_subscriber_name{"provizio_dds_test_static_edp_subscriber"};
+            constexpr std::int16_t static_edp_writer_user_id = 1;
+            constexpr std::int16_t static_edp_reader_user_id = 2;
+
+            // Describes the single endpoint of a remote participant
+            inline std::string static_edp_xml(const std::string &participant_name, const char *endpoint_kind,
+                                              const std::int16_t user_id, const char *reliability)
+            {
+                return std::string{
+                           "<?xml version=\"1.0\" encoding=\"UTF-8\" ?><staticdiscovery><participant><name>"} +
+                       participant_name + "</name><" + endpoint_kind + "><userId>" + std::to_string(user_id) +
+                       "</userId><topicName>" + static_edp_topic_name + "</topicName><topicDataType>" +
+                       std_msgs::msg::StringPubSubType{}.getName() + "</topicDataType><reliabilityQos>" +
+                       reliability + "</reliabilityQos></" + endpoint_kind + "></participant></staticdiscovery>";
+            }
+        } // namespace test
+    } // namespace dds
+} // namespace provizio
+
+#endif // DDS_TEST_STATIC_EDP
@@ -0,0 +1,95 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "provizio/dds/publisher.h"
+#include "provizio/dds/test/check.h"
+
+#include "../static_edp.h"
+
+namespace
+{
+    const provizio::dds::test::checker check{"static_edp_publisher"};
+} // namespace
+
+int main()
+{
+    using namespace provizio::dds::test;
+
+    const std::string value{"provizio_dds_test"};
+    const std::chrono::milliseconds wait_time{50};
+    const int publish_times = 60;
+
+    provizio::dds::discovery_options discovery;
+    discovery.mode = provizio::dds::discovery_mode::static_edp;
+    discovery.participant_name = static_edp_publisher_name;
+    discovery.static_edp_xml =
+        static_edp_xml(static_edp_subscriber_name, "reader", static_edp_reader_user_id, "BEST_EFFORT_RELIABILITY_QOS");
+    discovery.static_endpoints.push_back(
+        {static_edp_topic_name, provizio::dds::static_endpoint_kind::writer, static_edp_writer_user_id});
+
+    const auto participant =
+        provizio::dds::make_domain_participant(0, provizio::dds::transport_profile::builtin, {}, discovery);
+    if (!check(participant != nullptr, "participant"))
+    {
+        return 1;
+    }
+
+    bool success = check(provizio::dds::static_endpoint_user_id(participant, static_edp_topic_name,
+                                                                provizio::dds::static_endpoint_kind::writer) ==
+                                 static_edp_writer_user_id &&
+                             provizio::dds::static_endpoint_user_id(participant, static_edp_topic_name,
+                                                                    provizio::dds::static_endpoint_kind::reader) == -1,
+                         "static endpoint user ids");
+
+    // Static EDP requires the name of the participant to be looked up in the XML
+    provizio::dds::discovery_options unnamed_discovery = discovery;
+    unnamed_discovery.participant_name.clear();
+    success = check(provizio::dds::make_domain_participant(0, provizio::dds::transport_profile::builtin, {},
+                                                           unnamed_discovery) == nullptr,
+                    "unnamed static EDP participant") &&
+              success;
+
+    // Discovery Servers can't be reached with no network transport
+    provizio::dds::discovery_options client_discovery;
+    client_discovery.mode = provizio::dds::discovery_mode::discovery_server_client;
+    success = check(provizio::dds::make_domain_participant(0, provizio::dds::transport_profile::shm_only, {},
+                                                           client_discovery) == nullptr,
+                    "shared memory only Discovery Server client") &&
+              success;
+
+    auto publisher = provizio::dds::make_publisher<std_msgs::msg::StringPubSubType>(participant, static_edp_topic_name);
+    std_msgs::msg::String message;
+    message.data(value);
+    int successful_times = 0;
+    for (int i = 0; i < publish_times; ++i)
+    {
+        successful_times += publisher->publish(message) ? 1 : 0;
+        std::this_thread::sleep_for(wait_time);
+    }
+    success = check(successful_times > 0, "published") && success;
+
+    if (!success)
+    {
+        return 1;
+    }
+
+    std::cout << "static_edp_publisher: Successfully published " << successful_times << " times" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <string>
+
+#include "provizio/dds/subscriber.h"
+
+#include "../static_edp.h"
+
+int main()
+{
+    using namespace provizio::dds::test;
+
+    const std::string expected_value{"provizio_dds_test"};
+    const std::chrono::seconds wait_time{3};
+    const int expected_received = 5;
+
+    provizio::dds::discovery_options discovery;
+    discovery.mode = provizio::dds::discovery_mode::static_edp;
+    discovery.participant_name = static_edp_subscriber_name;
+    discovery.static_edp_xml =
+        static_edp_xml(static_edp_publisher_name, "writer", static_edp_writer_user_id, "RELIABLE_RELIABILITY_QOS");
+    discovery.static_endpoints.push_back(
+        {static_edp_topic_name, provizio::dds::static_endpoint_kind::reader, static_edp_reader_user_id});
+
+    const auto participant =
+        provizio::dds::make_domain_participant(0, provizio::dds::transport_profile::builtin, {}, discovery);
+    if (participant == nullptr)
+    {
+        std::cerr << "static_edp_subscriber: Failed to create the participant" << std::endl;
+        return 1;
+    }
+
+    std::mutex mutex;
+    std::condition_variable condition_variable;
+    int received = 0;
+    const auto subscriber = provizio::dds::make_subscriber<std_msgs::msg::StringPubSubType>(
+        participant, static_edp_topic_name, [&](const std_msgs::msg::String &message) {
+            if (message.data() == expected_value)
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                ++received;
+                condition_variable.notify_one();
+            }
+        });
+
+    std::unique_lock<std::mutex> lock{mutex};
+    condition_variable.wait_for(lock, wait_time, [&]() { return received >= expected_received; });
+
+    if (received < expected_received)
+    {
+        std::cerr << "static_edp_subscriber: " << expected_received << " samples were expected but " << received
+                  << " were received via static endpoint discovery!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "static_edp_subscriber: Success" << std::endl;
+
+    return 0;
+}
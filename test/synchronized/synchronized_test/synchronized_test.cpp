@@ -0,0 +1,129 @@
+// Copyright 2023 Provizio Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include "provizio/dds/publisher.h"
+#include "provizio/dds/synchronized_subscriber.h"
+#include "provizio/dds/test/check.h"
+
+#include <sensor_msgs/msg/PointCloud2PubSubTypes.h>
+
+namespace
+{
+    const provizio::dds::test::checker check{"synchronized_test"};
+
+    std::shared_ptr<const sensor_msgs::msg::PointCloud2> make_cloud(const std::int32_t sec, const std::uint32_t nanosec)
+    {
+        auto cloud = std::make_shared<sensor_msgs::msg::PointCloud2>();
+        cloud->header().stamp().sec(sec);
+        cloud->header().stamp().nanosec(nanosec);
+        return cloud;
+    }
+} // namespace
+
+int main()
+{
+    using sensor_msgs::msg::PointCloud2;
+    using sensor_msgs::msg::PointCloud2PubSubType;
+
+    bool success = true;
+
+    // Matching policies, with no DDS involved
+    {
+        provizio::dds::synchronization_options options;
+        options.tolerance = std::chrono::milliseconds(10);
+        std::size_t matched = 0;
+        provizio::dds::detail::synchronizer<PointCloud2, PointCloud2> synchronizer(
+            [&](std::shared_ptr<const PointCloud2> /*first*/, std::shared_ptr<const PointCloud2> /*second*/) {
+                ++matched;
+            },
+            options);
+        synchronizer.on_sample<0>(make_cloud(1, 0));
+        synchronizer.on_sample<1>(make_cloud(1, 5000000));
+        success = check(matched == 1, "approximate match within tolerance") && success;
+        synchronizer.on_sample<0>(make_cloud(2, 0));
+        synchronizer.on_sample<1>(make_cloud(2, 50000000));
+        success = check(matched == 1, "approximate match beyond tolerance") && success;
+        synchronizer.on_sample<0>(make_cloud(2, 50000000));
+        success = check(matched == 2, "approximate match of a newer sample") && success;
+        success = check(synchronizer.statistics().emitted == 2, "emitted counted") && success;
+        success = check(synchronizer.statistics().dropped == 1, "dropped counted") && success;
+
+        options.policy = provizio::dds::synchronization_policy::exact;
+        std::size_t exactly_matched = 0;
+        provizio::dds::detail::synchronizer<PointCloud2, PointCloud2> exact_synchronizer(
+            [&](const std::shared_ptr<const PointCloud2> & /*first*/,
+                const std::shared_ptr<const PointCloud2> & /*second*/) { ++exactly_matched; },
+            options);
+        exact_synchronizer.on_sample<0>(make_cloud(1, 0));
+        exact_synchronizer.on_sample<1>(make_cloud(1, 1));
+        exact_synchronizer.on_sample<1>(make_cloud(1, 0));
+        success = check(exactly_matched == 1, "exact match") && success;
+    }
+
+    // Aligned samples of two topics are received as pairs
+    const std::string first_topic_name{"provizio_dds_test_synchronized_first_topic"};
+    const std::string second_topic_name{"provizio_dds_test_synchronized_second_topic"};
+    const std::chrono::seconds wait_time{3};
+
+    std::mutex mutex;
+    std::size_t pairs = 0;
+    bool aligned = true;
+    auto subscriber = provizio::dds::make_synchronized_subscriber<PointCloud2PubSubType, PointCloud2PubSubType>(
+        provizio::dds::make_domain_participant(), {{first_topic_name, second_topic_name}},
+        [&](const PointCloud2 &first, const PointCloud2 &second) {
+            std::lock_guard<std::mutex> lock{mutex};
+            ++pairs;
+            aligned = aligned && first.header().stamp().sec() == second.header().stamp().sec();
+        });
+
+    const auto publisher_participant = provizio::dds::make_domain_participant();
+    auto first_publisher =
+        provizio::dds::make_publisher<PointCloud2PubSubType>(publisher_participant, first_topic_name);
+    auto second_publisher =
+        provizio::dds::make_publisher<PointCloud2PubSubType>(publisher_participant, second_topic_name);
+
+    const auto deadline = std::chrono::steady_clock::now() + wait_time;
+    std::int32_t stamp = 0;
+    bool received = false;
+    while (!received && std::chrono::steady_clock::now() < deadline)
+    {
+        PointCloud2 cloud;
+        cloud.header().stamp().sec(++stamp);
+        first_publisher->publish(cloud);
+        second_publisher->publish(cloud);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        std::lock_guard<std::mutex> lock{mutex};
+        received = pairs > 0;
+    }
+
+    std::lock_guard<std::mutex> lock{mutex};
+    success = check(received, "synchronized pair received") && success;
+    success = check(aligned, "synchronized pairs aligned") && success;
+    success = check(subscriber->statistics().emitted == pairs, "synchronized pairs counted") && success;
+
+    if (!success)
+    {
+        return 1;
+    }
+
+    std::cout << "synchronized_test: Success" << std::endl;
+
+    return 0;
+}